@@ -0,0 +1,124 @@
+/**
+ * @file allocation_benchmark.cpp
+ * @brief Counts global allocations per forced element with and without a NodePool.
+ *
+ * The benchmark replaces the global operator new/delete with counting versions
+ * and forces the same lazy pipelines with default heap allocation and with a
+ * NodePool installed. It reports allocations and wall-clock time per forced
+ * element for each mode.
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/node_pool.hpp"
+#include "ranked_belief/operations/filter.hpp"
+#include "ranked_belief/operations/map.hpp"
+#include "ranked_belief/operations/merge_apply.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+namespace {
+
+std::atomic<std::size_t> allocation_count{0};
+
+// Kept out of line so the compiler does not pair the inlined free() with
+// operator new and flag a mismatched deallocation.
+[[gnu::noinline]] void release(void* p) noexcept { std::free(p); }
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    const auto align = static_cast<std::size_t>(alignment);
+    const std::size_t rounded = (size + align - 1) / align * align;
+    if (void* p = std::aligned_alloc(align, rounded == 0 ? align : rounded)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { release(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { release(p); }
+
+namespace rb = ranked_belief;
+
+namespace {
+
+struct Measurement {
+    std::size_t allocations;
+    double nanoseconds;
+};
+
+rb::RankingFunction<int> map_filter_pipeline() {
+    auto source = rb::from_generator<int>([](std::size_t i) {
+        return std::make_pair(static_cast<int>(i), rb::Rank::from_value(i));
+    });
+    auto mapped = rb::map(source, [](int x) { return x * 3; });
+    return rb::filter(mapped, [](int x) { return x % 2 == 0; });
+}
+
+rb::RankingFunction<int> merge_apply_pipeline() {
+    return rb::merge_apply(map_filter_pipeline(), [](int x) {
+        return rb::from_values_sequential<int>({x, x + 1});
+    });
+}
+
+/**
+ * @brief Build a pipeline under @p pool and force its first @p elements.
+ */
+template<typename Build>
+Measurement run_pipeline(Build build,
+                         std::size_t elements,
+                         const std::shared_ptr<rb::NodePool>& pool) {
+    const auto allocations_before = allocation_count.load();
+    const double ns = bench::time_call([&] {
+        rb::NodePoolScope scope(pool);
+        bench::check(rb::take_n(build(), elements).size() == elements, "unexpected result size");
+    });
+    return {allocation_count.load() - allocations_before, ns};
+}
+
+void report(const std::string& label, const Measurement& m, std::size_t elements) {
+    const auto n = static_cast<double>(elements);
+    bench::report(label, {static_cast<double>(m.allocations) / n, m.nanoseconds / n});
+}
+
+template<typename Build>
+void run_all_modes(const std::string& title, Build build, std::size_t elements) {
+    std::cout << "Forcing " << elements << " elements of " << title << "\n";
+    bench::header("mode", {"allocs/elem", "ns/elem"});
+
+    report("heap (make_shared)", run_pipeline(build, elements, nullptr), elements);
+    report("NodePool (synchronized)",
+           run_pipeline(build, elements, std::make_shared<rb::NodePool>()), elements);
+    report("NodePool (unsynchronized)",
+           run_pipeline(build, elements,
+                        std::make_shared<rb::NodePool>(rb::PoolSynchronization::Unsynchronized)),
+           elements);
+    std::cout << '\n';
+}
+
+}  // namespace
+
+int main() {
+    run_all_modes("map/filter", map_filter_pipeline, 100000);
+    run_all_modes("map/filter/merge_apply", merge_apply_pipeline, 5000);
+    return 0;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file any_equality_benchmark.cpp
+ * @brief Measures std::any equality lookups from many threads at once.
+ *
+ * Deduplicating a RankingFunction<std::any> compares neighbouring values
+ * through the any-equality registry. Each thread performs @c comparisons
+ * such comparisons; the registry's lock-free lookup is compared with a lookup
+ * of the same table under one global mutex (the registry's previous design).
+ * Throughput is reported in million comparisons per second, over all threads.
+ * Scaling is bounded by the number of hardware threads available.
+ *
+ * Usage: any_equality_benchmark [comparisons_per_thread] [max_threads]
+ */
+
+#include "ranked_belief/detail/any_equality_registry.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <algorithm>
+#include <any>
+#include <ratio>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <typeindex>
+#include <vector>
+
+namespace detail = ranked_belief::detail;
+
+namespace {
+
+std::mutex baseline_mutex;
+
+bool locked_values_equal(const std::any& lhs, const std::any& rhs) {
+    if (lhs.type() != rhs.type()) {
+        return false;
+    }
+    detail::AnyEqualityFn fn = nullptr;
+    {
+        std::scoped_lock lock(baseline_mutex);
+        fn = detail::find_any_equality(std::type_index(lhs.type()));
+    }
+    return fn && fn(lhs, rhs);
+}
+
+template<typename Equal>
+double run_threads(Equal equal, std::size_t threads, std::size_t comparisons) {
+    const std::any lhs{std::string("observation")};
+    const std::any rhs{std::string("observation")};
+    std::vector<std::size_t> matches(threads, 0);
+
+    const double seconds = bench::time_call<std::ratio<1>>([&] {
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                std::size_t local = 0;
+                for (std::size_t i = 0; i < comparisons; ++i) {
+                    local += equal(lhs, rhs) ? 1 : 0;
+                }
+                matches[t] = local;
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    });
+
+    bench::check(std::all_of(matches.begin(), matches.end(),
+                             [comparisons](std::size_t count) { return count == comparisons; }),
+                 "unexpected comparison result");
+    return static_cast<double>(threads * comparisons) / seconds / 1e6;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t comparisons = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const std::size_t max_threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 16;
+
+    std::cout << comparisons << " std::any comparisons per thread, "
+              << std::thread::hardware_concurrency() << " hardware threads\n\n";
+    bench::header("threads", {"lock-free", "mutex"}, {}, "   (M comparisons/s)");
+
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        bench::report(std::to_string(threads),
+                      {run_threads(detail::any_values_equal, threads, comparisons),
+                       run_threads(locked_values_equal, threads, comparisons)});
+    }
+    return 0;
+}
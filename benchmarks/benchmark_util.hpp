@@ -0,0 +1,75 @@
+/**
+ * @file benchmark_util.hpp
+ * @brief Timing, sanity checks and report tables shared by the benchmarks.
+ *
+ * Every benchmark prints one or more tables: a header row naming the
+ * columns, then one row per measured variant with a left-aligned label and
+ * right-aligned values to two decimals. Timings are wall-clock, taken with
+ * std::chrono::steady_clock around the whole measured loop.
+ */
+
+#ifndef RANKED_BELIEF_BENCHMARKS_BENCHMARK_UTIL_HPP
+#define RANKED_BELIEF_BENCHMARKS_BENCHMARK_UTIL_HPP
+
+#include <chrono>
+#include <cstdlib>
+#include <initializer_list>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <utility>
+
+namespace bench {
+
+/// Column widths of a report table.
+struct Columns {
+    int label = 28;
+    int value = 14;
+};
+
+/**
+ * @brief Wall-clock time of one call of @p body.
+ *
+ * @tparam Period Unit of the result (default: nanoseconds).
+ */
+template<typename Period = std::nano, typename Body>
+[[nodiscard]] double time_call(Body&& body) {
+    const auto start = std::chrono::steady_clock::now();
+    std::forward<Body>(body)();
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, Period>(stop - start).count();
+}
+
+/// Print @p message to std::cerr and exit unless @p ok (guards against measuring the wrong work).
+inline void check(bool ok, std::string_view message) {
+    if (!ok) {
+        std::cerr << message << '\n';
+        std::exit(1);
+    }
+}
+
+/// Print the header row of a table, followed by @p suffix.
+inline void header(std::string_view label,
+                   std::initializer_list<std::string_view> columns,
+                   Columns widths = {},
+                   std::string_view suffix = {}) {
+    std::cout << std::left << std::setw(widths.label) << label << std::right;
+    for (const auto column : columns) {
+        std::cout << std::setw(widths.value) << column;
+    }
+    std::cout << suffix << '\n';
+}
+
+/// Print one row of a table.
+inline void report(std::string_view label, std::initializer_list<double> values, Columns widths = {}) {
+    std::cout << std::left << std::setw(widths.label) << label << std::right << std::fixed
+              << std::setprecision(2);
+    for (const double value : values) {
+        std::cout << std::setw(widths.value) << value;
+    }
+    std::cout << '\n';
+}
+
+}  // namespace bench
+
+#endif  // RANKED_BELIEF_BENCHMARKS_BENCHMARK_UTIL_HPP
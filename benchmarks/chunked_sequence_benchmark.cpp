@@ -0,0 +1,93 @@
+/**
+ * @file chunked_sequence_benchmark.cpp
+ * @brief Compares forcing per-element and chunked lazy pipelines.
+ *
+ * The same generator/map/filter pipeline is built with several chunk sizes
+ * (see from_generator) and its first elements are forced with take_n. With a
+ * chunk size of K only one promise thunk runs per K elements at each stage.
+ * A second table forces a source whose generator carries a 4 KiB lookup
+ * table, one element at a time and in batches (see from_batch_generator).
+ * Time is reported per forced element.
+ *
+ * Usage: chunked_sequence_benchmark [elements]
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/operations/filter.hpp"
+#include "ranked_belief/operations/map.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rb = ranked_belief;
+
+namespace {
+
+double run_pipeline(std::size_t chunk_size, std::size_t elements) {
+    return bench::time_call([&] {
+        auto source = rb::from_generator<long>(
+            [](std::size_t i) { return std::make_pair(static_cast<long>(i), rb::Rank::from_value(i)); },
+            0, rb::Deduplication::Enabled, chunk_size);
+        auto mapped = rb::map(source, [](long x) { return x * 3; });
+        auto evens = rb::filter(mapped, [](long x) { return x % 2 == 0; });
+        bench::check(rb::take_n(evens, elements).size() == elements, "unexpected result size");
+    }) / static_cast<double>(elements);
+}
+
+/// Generator carrying a lookup table, as a precomputed model might.
+struct TableGenerator {
+    std::array<long, 512> table{};
+
+    TableGenerator() {
+        for (std::size_t i = 0; i < table.size(); ++i) {
+            table[i] = static_cast<long>(i * i);
+        }
+    }
+
+    std::pair<long, rb::Rank> operator()(std::size_t i) const {
+        return {table[i % table.size()] + static_cast<long>(i), rb::Rank::from_value(i)};
+    }
+
+    void operator()(std::size_t first, std::vector<std::pair<long, rb::Rank>>& batch) const {
+        for (std::size_t i = first; i < first + 16; ++i) {
+            batch.push_back((*this)(i));
+        }
+    }
+};
+
+template<typename Build>
+double run_source(Build build, std::size_t elements) {
+    return bench::time_call([&] {
+        bench::check(rb::take_n(build(), elements).size() == elements, "unexpected result size");
+    }) / static_cast<double>(elements);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t elements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+    std::cout << "Forcing " << elements << " elements of generator/map/filter\n\n";
+    bench::header("chunk size", {"ns/elem"});
+    for (std::size_t chunk_size : {1, 4, 16, 64}) {
+        bench::report(std::to_string(chunk_size), {run_pipeline(chunk_size, elements)});
+    }
+
+    std::cout << "\nForcing " << elements << " elements of a 4 KiB table generator\n\n";
+    bench::header("source", {"ns/elem"});
+    bench::report("from_generator", {run_source([] {
+        return rb::from_generator<long>(TableGenerator(), 0, rb::Deduplication::Disabled);
+    }, elements)});
+    bench::report("from_batch_generator / 16", {run_source([] {
+        return rb::from_batch_generator<long>(TableGenerator(), 0, rb::Deduplication::Disabled);
+    }, elements)});
+    return 0;
+}
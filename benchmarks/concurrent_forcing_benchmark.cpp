@@ -0,0 +1,116 @@
+/**
+ * @file concurrent_forcing_benchmark.cpp
+ * @brief Stress test for many threads iterating one shared lazy ranking.
+ *
+ * Several reader threads walk the same prefix of a lazily built
+ * map/filter ranking. Two strategies are compared:
+ *
+ * - external mutex: every reader holds one global lock while it iterates,
+ *   which is what callers needed before promises published their state
+ *   atomically;
+ * - shared: readers iterate concurrently; each link is forced exactly once by
+ *   whichever thread gets there first and read lock-free afterwards.
+ *
+ * Each strategy runs a cold pass (the prefix is forced during the run) and a
+ * warm pass (the prefix is already forced, so the run measures read-only
+ * traversal). Every reader checksums what it saw and all checksums must agree.
+ *
+ * Usage: concurrent_forcing_benchmark [threads] [prefix]
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/operations/filter.hpp"
+#include "ranked_belief/operations/map.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <ratio>
+#include <thread>
+#include <vector>
+
+namespace rb = ranked_belief;
+
+namespace {
+
+rb::RankingFunction<long> make_ranking() {
+    auto source = rb::from_generator<long>([](std::size_t i) {
+        return std::make_pair(static_cast<long>(i), rb::Rank::from_value(i));
+    });
+    auto mapped = rb::map(source, [](long x) { return x * 7 + 1; });
+    return rb::filter(mapped, [](long x) { return x % 3 != 0; });
+}
+
+long checksum_prefix(const rb::RankingFunction<long>& rf, std::size_t prefix) {
+    long sum = 0;
+    std::size_t seen = 0;
+    for (auto it = rf.begin(); it != rf.end() && seen < prefix; ++it, ++seen) {
+        sum += (*it).first ^ static_cast<long>(seen);
+    }
+    return sum;
+}
+
+/**
+ * @brief Run @p threads readers over @p rf and return elapsed milliseconds.
+ */
+double run_readers(const rb::RankingFunction<long>& rf,
+                   std::size_t threads,
+                   std::size_t prefix,
+                   std::mutex* external_lock) {
+    std::vector<long> checksums(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+
+    const double ms = bench::time_call<std::milli>([&] {
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                if (external_lock) {
+                    std::scoped_lock lock(*external_lock);
+                    checksums[t] = checksum_prefix(rf, prefix);
+                } else {
+                    checksums[t] = checksum_prefix(rf, prefix);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    });
+
+    bench::check(std::all_of(checksums.begin(), checksums.end(),
+                             [&checksums](long checksum) { return checksum == checksums.front(); }),
+                 "readers disagree on the shared prefix");
+    return ms;
+}
+
+constexpr bench::Columns kColumns{20, 12};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8;
+    const std::size_t prefix = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000;
+
+    std::cout << threads << " readers over a shared prefix of " << prefix << " elements ("
+              << std::thread::hardware_concurrency() << " hardware threads)\n\n";
+    bench::header("strategy", {"cold ms", "warm ms"}, kColumns);
+
+    {
+        std::mutex lock;
+        const auto rf = make_ranking();
+        const double cold = run_readers(rf, threads, prefix, &lock);
+        const double warm = run_readers(rf, threads, prefix, &lock);
+        bench::report("external mutex", {cold, warm}, kColumns);
+    }
+    {
+        const auto rf = make_ranking();
+        const double cold = run_readers(rf, threads, prefix, nullptr);
+        const double warm = run_readers(rf, threads, prefix, nullptr);
+        bench::report("shared", {cold, warm}, kColumns);
+    }
+    return 0;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file erased_operations_benchmark.cpp
+ * @brief Measures the per-call overhead of each RankingFunctionAny method.
+ *
+ * Every method is called on a small, already forced type-erased ranking of
+ * ints; lazy results are read up to their first element, so the figures are
+ * dominated by the wrapper (model allocation, type dispatch, callback
+ * boxing) rather than by the underlying operation. Global operator new is
+ * replaced with a counting version; allocations and wall-clock time are
+ * reported per call.
+ *
+ * Usage: erased_operations_benchmark [calls]
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/type_erasure.hpp"
+#include "ranked_belief/value_cell.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <any>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<std::size_t> allocation_count{0};
+
+// Kept out of line so the compiler does not pair the inlined free() with
+// operator new and flag a mismatched deallocation.
+[[gnu::noinline]] void release(void* p) noexcept { std::free(p); }
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+
+namespace rb = ranked_belief;
+
+namespace {
+
+using AnyFunction = std::function<rb::RankingFunctionAny(const std::any&)>;
+
+rb::RankingFunctionAny forced_ints() {
+    auto ints = rb::from_values_sequential<int>({0, 1, 2, 3, 4, 5, 6, 7}, rb::Rank::zero(),
+                                                rb::Deduplication::Disabled);
+    (void)rb::take_n(ints, 9);  // force the source up front
+    return rb::RankingFunctionAny{ints};
+}
+
+/// A lazy result is read up to its first element; anything else is used as is.
+bool touch(const rb::RankingFunctionAny& result) { return result.first_rank().has_value(); }
+bool touch(bool value) { return value; }
+template<typename Sequence>
+bool touch(const Sequence& values) { return !values.empty(); }
+
+template<typename Call>
+void measure(const std::string& label, Call call, std::size_t calls) {
+    const auto allocations_before = allocation_count.load();
+    const double ns = bench::time_call([&] {
+        for (std::size_t i = 0; i < calls; ++i) {
+            bench::check(touch(call()), "unexpected empty result");
+        }
+    });
+    const auto n = static_cast<double>(calls);
+    bench::report(label, {static_cast<double>(allocation_count.load() - allocations_before) / n, ns / n});
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t calls = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    const auto ints = forced_ints();
+    const rb::RankingFunctionAny strings{rb::from_list<std::string>({{"one", rb::Rank::zero()}})};
+    const rb::RankingFunctionAny functions{rb::from_list<AnyFunction>(
+        {{AnyFunction{[&ints](const std::any&) { return ints; }}, rb::Rank::zero()}},
+        rb::Deduplication::Disabled)};
+    const std::vector<rb::RankingFunctionAny> parts{ints, ints, ints};
+
+    std::cout << calls << " calls per method on an erased ranking of 8 ints\n\n";
+    bench::header("method", {"allocs/call", "ns/call"});
+
+    measure("is_empty", [&] { return !ints.is_empty(); }, calls);
+    measure("first_value", [&] { return ints.first_value().has_value(); }, calls);
+    measure("first_rank", [&] { return ints.first_rank().has_value(); }, calls);
+    measure("map", [&] {
+        return ints.map([](const std::any& value) { return value; }, rb::Deduplication::Disabled);
+    }, calls);
+    measure("map / ValueCell", [&] {
+        return ints.map([](const rb::ValueCell& value) { return rb::ValueCell{value}; },
+                        rb::Deduplication::Disabled);
+    }, calls);
+    measure("map_with_rank", [&] {
+        return ints.map_with_rank([](const std::any& value, rb::Rank rank) {
+            return std::pair{value, rank};
+        }, rb::Deduplication::Disabled);
+    }, calls);
+    measure("map_with_index", [&] {
+        return ints.map_with_index([](const std::any& value, std::size_t) { return value; },
+                                   rb::Deduplication::Disabled);
+    }, calls);
+    measure("filter", [&] {
+        return ints.filter([](const std::any&) { return true; }, rb::Deduplication::Disabled);
+    }, calls);
+    measure("filter / ValueCell", [&] {
+        return ints.filter([](const rb::ValueCell&) { return true; }, rb::Deduplication::Disabled);
+    }, calls);
+    measure("take", [&] { return ints.take(4); }, calls);
+    measure("take_while_rank", [&] { return ints.take_while_rank(rb::Rank::from_value(4)); }, calls);
+    measure("merge / same type", [&] { return ints.merge(ints, rb::Deduplication::Disabled); }, calls);
+    measure("merge / mixed types", [&] { return ints.merge(strings, rb::Deduplication::Disabled); }, calls);
+    measure("shift_ranks", [&] {
+        return ints.shift_ranks(rb::Rank::from_value(1), rb::Deduplication::Disabled);
+    }, calls);
+    measure("defer", [&] { return rb::RankingFunctionAny::defer([&ints] { return ints; }); }, calls);
+    measure("merge_all", [&] {
+        return rb::RankingFunctionAny::merge_all(parts, rb::Deduplication::Disabled);
+    }, calls);
+    measure("merge_apply", [&] { return ints.merge_apply(functions); }, calls);
+    measure("observe", [&] {
+        return ints.observe([](const std::any&) { return true; }, rb::Deduplication::Disabled);
+    }, calls);
+    measure("observe_value", [&] {
+        return ints.observe_value(std::any{0}, rb::Deduplication::Disabled);
+    }, calls);
+    measure("take_n", [&] { return ints.take_n(4); }, calls);
+    measure("take_n_cells", [&] { return ints.take_n_cells(4); }, calls);
+    measure("cast", [&] { return !ints.cast<int>().is_empty(); }, calls);
+    measure("to_any_ranking", [&] {
+        return !ints.to_any_ranking().is_empty();
+    }, calls);
+    return 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file erased_value_benchmark.cpp
+ * @brief Compares std::any and ValueCell on the RankingFunctionAny path.
+ *
+ * A type-erased ranking of 256-byte samples is read through the std::any API
+ * (every callback argument and result is a boxed copy) and through the
+ * ValueCell API (callbacks borrow each element; materialised values are
+ * copied once into a shared cell). The sample type counts its copies; copies
+ * and wall-clock time are reported per element. The source ranking is forced
+ * before measuring.
+ *
+ * Usage: erased_value_benchmark [elements] [repetitions]
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/type_erasure.hpp"
+#include "ranked_belief/value_cell.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <any>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rb = ranked_belief;
+
+namespace {
+
+std::size_t sample_copies = 0;
+
+struct Sample {
+    explicit Sample(double first) { values.fill(first); }
+    Sample(const Sample& other) : values(other.values) { ++sample_copies; }
+    Sample& operator=(const Sample&) = default;
+
+    friend bool operator==(const Sample& lhs, const Sample& rhs) { return lhs.values == rhs.values; }
+
+    std::array<double, 32> values;
+};
+
+rb::RankingFunctionAny forced_source(std::size_t elements) {
+    auto source = rb::from_generator<Sample>([](std::size_t i) {
+        return std::make_pair(Sample(static_cast<double>(i)), rb::Rank::from_value(i));
+    }, 0, rb::Deduplication::Disabled);
+    (void)rb::take_n(source, elements);  // force the source up front
+    return rb::RankingFunctionAny{source};
+}
+
+template<typename Run>
+void measure(const std::string& label, Run run, std::size_t elements, std::size_t repetitions) {
+    const std::size_t copies_before = sample_copies;
+    const double ns = bench::time_call([&] {
+        for (std::size_t r = 0; r < repetitions; ++r) {
+            bench::check(run() == elements, "unexpected result size");
+        }
+    });
+    const auto forced = static_cast<double>(elements * repetitions);
+    bench::report(label, {static_cast<double>(sample_copies - copies_before) / forced, ns / forced});
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t elements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const std::size_t repetitions = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+    const auto source = forced_source(elements);
+
+    std::cout << "Reading " << elements << " erased 256-byte values x " << repetitions
+              << " repetitions\n\n";
+    bench::header("operation", {"copies/elem", "ns/elem"});
+
+    measure("map / std::any", [&] {
+        return source.map([](const std::any& value) {
+            return std::any{std::any_cast<const Sample&>(value).values[0]};
+        }).take_n(elements).size();
+    }, elements, repetitions);
+    measure("map / ValueCell", [&] {
+        return source.map([](const rb::ValueCell& value) {
+            return rb::ValueCell{value.get<Sample>().values[0]};
+        }).take_n_cells(elements).size();
+    }, elements, repetitions);
+    measure("take_n / std::any", [&] { return source.take_n(elements).size(); }, elements, repetitions);
+    measure("take_n_cells / ValueCell", [&] {
+        return source.take_n_cells(elements).size();
+    }, elements, repetitions);
+    return 0;
+}
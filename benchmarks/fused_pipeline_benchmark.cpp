@@ -0,0 +1,103 @@
+/**
+ * @file fused_pipeline_benchmark.cpp
+ * @brief Compares chained operations with the equivalent fused views pipeline.
+ *
+ * Each stage combination is forced once as a chain of standalone operations
+ * (one node layer per operation) and once as a ranked_belief::views pipeline
+ * (one fused layer). Global operator new is replaced with a counting version;
+ * allocations and wall-clock time are reported per forced element. The source
+ * ranking is built before measuring, so only the pipeline's own work counts.
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/operations/filter.hpp"
+#include "ranked_belief/operations/map.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+#include "ranked_belief/operations/observe.hpp"
+#include "ranked_belief/operations/views.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+namespace {
+
+std::atomic<std::size_t> allocation_count{0};
+
+// Kept out of line so the compiler does not pair the inlined free() with
+// operator new and flag a mismatched deallocation.
+[[gnu::noinline]] void release(void* p) noexcept { std::free(p); }
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+
+namespace rb = ranked_belief;
+namespace views = ranked_belief::views;
+
+namespace {
+
+constexpr std::size_t kElements = 100000;
+constexpr bench::Columns kColumns{36, 14};
+
+rb::RankingFunction<long> forced_source() {
+    auto source = rb::from_generator<long>([](std::size_t i) {
+        return std::make_pair(static_cast<long>(i), rb::Rank::from_value(i));
+    });
+    (void)rb::take_n(source, 4 * kElements);  // force the source up front
+    return source;
+}
+
+template<typename Build>
+void measure(const std::string& label, Build build) {
+    const auto allocations_before = allocation_count.load();
+    std::size_t forced = 0;
+    const double ns = bench::time_call([&] { forced = rb::take_n(build(), kElements).size(); });
+    const auto allocations = allocation_count.load() - allocations_before;
+    bench::check(forced == kElements, "unexpected result size");
+    const auto n = static_cast<double>(kElements);
+    bench::report(label, {static_cast<double>(allocations) / n, ns / n}, kColumns);
+}
+
+}  // namespace
+
+int main() {
+    const auto source = forced_source();
+    auto times3 = [](long x) { return x * 3; };
+    auto is_even = [](long x) { return x % 2 == 0; };
+    auto is_large = [](long x) { return x >= 10; };
+
+    std::cout << "Forcing " << kElements << " elements\n";
+    bench::header("pipeline", {"allocs/elem", "ns/elem"}, kColumns);
+
+    measure("chained map/filter", [&]() { return rb::filter(rb::map(source, times3), is_even); });
+    measure("fused map/filter",
+            [&]() { return (source | views::map(times3) | views::filter(is_even)).ranking(); });
+
+    measure("chained take/map/filter", [&]() {
+        return rb::filter(rb::map(rb::take(source, 3 * kElements), times3), is_even);
+    });
+    measure("fused take/map/filter", [&]() {
+        return (source | views::take(3 * kElements) | views::map(times3) | views::filter(is_even))
+            .ranking();
+    });
+
+    measure("chained map/observe", [&]() { return rb::observe(rb::map(source, times3), is_large); });
+    measure("fused map/observe",
+            [&]() { return (source | views::map(times3) | views::observe(is_large)).ranking(); });
+    return 0;
+}
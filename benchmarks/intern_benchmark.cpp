@@ -0,0 +1,109 @@
+/**
+ * @file intern_benchmark.cpp
+ * @brief Measures interning of the small rankings rebuilt by merge_apply continuations.
+ *
+ * The model binds @c depth boolean choices (normally true, exceptionally
+ * false), rebuilding the choice with from_list() in every continuation, as
+ * examples/boolean_circuit.cpp does. It is run with and without an
+ * InternScope for bool, and every result is forced, inside the scope or after
+ * it ends (continuations then run with the tables merge_apply captured).
+ * Global operator new is
+ * replaced with a counting version; allocations and wall-clock time are
+ * reported per result.
+ *
+ * Usage: intern_benchmark [depth] [repetitions]
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/intern.hpp"
+#include "ranked_belief/operations/merge_apply.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+
+namespace {
+
+std::atomic<std::size_t> allocation_count{0};
+
+// Kept out of line so the compiler does not pair the inlined free() with
+// operator new and flag a mismatched deallocation.
+[[gnu::noinline]] void release(void* p) noexcept { std::free(p); }
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+
+namespace rb = ranked_belief;
+
+namespace {
+
+rb::RankingFunction<bool> choice() {
+    return rb::from_list<bool>({{true, rb::Rank::zero()}, {false, rb::Rank::from_value(1)}},
+                               rb::Deduplication::Disabled);
+}
+
+rb::RankingFunction<long> model(std::size_t depth, long bits) {
+    return rb::merge_apply(choice(), [depth, bits](bool b) {
+        const long next = bits * 2 + (b ? 1 : 0);
+        return depth == 1 ? rb::singleton(next) : model(depth - 1, next);
+    }, rb::Deduplication::Disabled);
+}
+
+enum class Interning { Off, ForcedInScope, ForcedAfterScope };
+
+void measure(const std::string& label, Interning intern, std::size_t depth, std::size_t repetitions) {
+    const std::size_t results = std::size_t{1} << depth;
+    const auto allocations_before = allocation_count.load();
+    const double ns = bench::time_call([&] {
+        for (std::size_t r = 0; r < repetitions; ++r) {
+            rb::RankingFunction<long> ranking;
+            {
+                rb::InternScope scope(intern == Interning::Off ? nullptr
+                                                               : std::make_shared<rb::InternTable<bool>>());
+                ranking = model(depth, 0);
+                if (intern != Interning::ForcedAfterScope) {
+                    bench::check(rb::take_n(ranking, results + 1).size() == results,
+                                 "unexpected result size");
+                    continue;
+                }
+            }
+            bench::check(rb::take_n(ranking, results + 1).size() == results, "unexpected result size");
+        }
+    });
+    const auto forced = static_cast<double>(results * repetitions);
+    bench::report(label, {static_cast<double>(allocation_count.load() - allocations_before) / forced,
+                          ns / forced});
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t depth = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 12;
+    const std::size_t repetitions = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+
+    std::cout << "Forcing all " << (std::size_t{1} << depth) << " results of a " << depth
+              << "-choice model x " << repetitions << " repetitions\n\n";
+    bench::header("choices", {"allocs/result", "ns/result"});
+
+    measure("rebuilt", Interning::Off, depth, repetitions);
+    measure("interned", Interning::ForcedInScope, depth, repetitions);
+    measure("interned, forced later", Interning::ForcedAfterScope, depth, repetitions);
+    return 0;
+}
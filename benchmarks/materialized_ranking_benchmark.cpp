@@ -0,0 +1,64 @@
+/**
+ * @file materialized_ranking_benchmark.cpp
+ * @brief Compares repeated traversal of a lazy ranking and a MaterializedRanking.
+ *
+ * A finite ranking is forced once and then summed several times, first by
+ * walking its (already forced) linked nodes with RankingIterator and then by
+ * scanning the contiguous MaterializedRanking built from it. Time is reported
+ * per element visited.
+ *
+ * Usage: materialized_ranking_benchmark [elements] [passes]
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/materialized_ranking.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+
+namespace rb = ranked_belief;
+
+namespace {
+
+template<typename Range>
+double time_passes(const Range& range, std::size_t passes, std::size_t elements, long& checksum) {
+    const double ns = bench::time_call([&] {
+        for (std::size_t pass = 0; pass < passes; ++pass) {
+            for (auto [value, rank] : range) {
+                checksum += value + static_cast<long>(rank.value());
+            }
+        }
+    });
+    return ns / static_cast<double>(passes * elements);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t elements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1'000'000;
+    const std::size_t passes = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10;
+
+    auto lazy = rb::from_generator<long>([](std::size_t i) {
+        return std::make_pair(static_cast<long>(i), rb::Rank::from_value(i / 4));
+    });
+
+    rb::MaterializedRanking<long> table;
+    const double materialize_ns = bench::time_call([&] { table = rb::materialize(lazy, elements); });
+    const auto finite = table.to_ranking_function();
+    (void)finite.size();  // force every node once
+
+    std::cout << passes << " passes over " << elements << " elements\n\n";
+    bench::header("representation", {"ns/elem"});
+
+    long lazy_checksum = 0;
+    long table_checksum = 0;
+    bench::report("RankingFunction (forced)", {time_passes(finite, passes, elements, lazy_checksum)});
+    bench::report("MaterializedRanking", {time_passes(table, passes, elements, table_checksum)});
+    bench::report("materialize (one pass)", {materialize_ns / static_cast<double>(elements)});
+
+    bench::check(lazy_checksum == table_checksum, "representations disagree");
+    return 0;
+}
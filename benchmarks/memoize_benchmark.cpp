@@ -0,0 +1,88 @@
+/**
+ * @file memoize_benchmark.cpp
+ * @brief Measures memoize_ranked on a model with shared subproblems.
+ *
+ * walk(n) merges walk(n - 1) with walk(n - 2) shifted by one rank, so a
+ * plain recursive definition rebuilds each sub-ranking exponentially often.
+ * The model is built and its first @c results elements forced, once as a
+ * plain recursive function and once through memoize_ranked (with and without
+ * the cache mutex). Model calls and wall-clock time are reported per build.
+ *
+ * Usage: memoize_benchmark [depth] [results] [repetitions]
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/memoize.hpp"
+#include "ranked_belief/operations/merge.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <ratio>
+#include <string>
+
+namespace rb = ranked_belief;
+
+namespace {
+
+std::size_t model_calls = 0;
+
+rb::RankingFunction<int> combine(const rb::RankingFunction<int>& shorter,
+                                 const rb::RankingFunction<int>& longer) {
+    return rb::merge(shorter, rb::shift_ranks(longer, rb::Rank::from_value(1)),
+                     rb::Deduplication::Disabled);
+}
+
+rb::RankingFunction<int> plain_walk(int n) {
+    ++model_calls;
+    if (n < 2) {
+        return rb::singleton(n);
+    }
+    return combine(plain_walk(n - 1), plain_walk(n - 2));
+}
+
+auto memoized_walk(rb::MemoSynchronization synchronization) {
+    return rb::memoize_ranked<int, int>([](const auto& self, int n) -> rb::RankingFunction<int> {
+        ++model_calls;
+        if (n < 2) {
+            return rb::singleton(n);
+        }
+        return combine(self(n - 1), self(n - 2));
+    }, rb::MemoOptions{.synchronization = synchronization});
+}
+
+template<typename Build>
+void measure(const std::string& label, Build build, std::size_t results, std::size_t repetitions) {
+    const std::size_t calls_before = model_calls;
+    const double us = bench::time_call<std::micro>([&] {
+        for (std::size_t r = 0; r < repetitions; ++r) {
+            bench::check(rb::take_n(build(), results).size() == results, "unexpected result size");
+        }
+    });
+    const auto builds = static_cast<double>(repetitions);
+    bench::report(label, {static_cast<double>(model_calls - calls_before) / builds, us / builds});
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int depth = argc > 1 ? std::atoi(argv[1]) : 22;
+    const std::size_t results = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+    const std::size_t repetitions = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 20;
+
+    std::cout << "Building walk(" << depth << ") and forcing " << results << " results x "
+              << repetitions << " repetitions\n\n";
+    bench::header("model", {"calls/build", "us/build"});
+
+    measure("plain recursion", [&] { return plain_walk(depth); }, results, repetitions);
+    measure("memoized / mutex", [&] {
+        return memoized_walk(rb::MemoSynchronization::Synchronized)(depth);
+    }, results, repetitions);
+    measure("memoized / unsynchronized", [&] {
+        return memoized_walk(rb::MemoSynchronization::Unsynchronized)(depth);
+    }, results, repetitions);
+    return 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file merge_all_benchmark.cpp
+ * @brief Compares the k-way merge_all against a left-fold chain of binary merges.
+ *
+ * For several input counts k, k infinite rankings with interleaved ranks are
+ * merged and a fixed number of output elements is forced. The left fold is
+ * what merge_all did before it kept a heap of input heads: each output element
+ * then passes through up to k merge layers. Time is reported per element.
+ *
+ * Usage: merge_all_benchmark [elements]
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/operations/merge.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace rb = ranked_belief;
+
+namespace {
+
+constexpr bench::Columns kColumns{10, 18};
+
+std::vector<rb::RankingFunction<long>> make_inputs(std::size_t k) {
+    std::vector<rb::RankingFunction<long>> inputs;
+    inputs.reserve(k);
+    for (std::size_t source = 0; source < k; ++source) {
+        inputs.push_back(rb::from_generator<long>([source, k](std::size_t i) {
+            return std::make_pair(static_cast<long>(source), rb::Rank::from_value(i * k + source));
+        }));
+    }
+    return inputs;
+}
+
+rb::RankingFunction<long> fold_merge(const std::vector<rb::RankingFunction<long>>& inputs) {
+    auto result = inputs.front();
+    for (std::size_t i = 1; i < inputs.size(); ++i) {
+        result = rb::merge(result, inputs[i], rb::Deduplication::Disabled);
+    }
+    return result;
+}
+
+template<typename Merge>
+double run(Merge merge, std::size_t k, std::size_t elements) {
+    const double ns = bench::time_call([&] {
+        auto merged = merge(make_inputs(k));
+        bench::check(rb::take_n(merged, elements).size() == elements, "unexpected result size");
+    });
+    return ns / static_cast<double>(elements);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t elements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+
+    std::cout << "Forcing " << elements << " merged elements\n\n";
+    bench::header("inputs", {"left fold ns/elem", "k-way ns/elem"}, kColumns);
+    for (std::size_t k : {2, 10, 100, 500}) {
+        const double fold = run(fold_merge, k, elements);
+        const double kway = run(
+            [](const std::vector<rb::RankingFunction<long>>& inputs) {
+                return rb::merge_all(inputs, rb::Deduplication::Disabled);
+            },
+            k, elements);
+        bench::report(std::to_string(k), {fold, kway}, kColumns);
+    }
+    return 0;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file merge_apply_benchmark.cpp
+ * @brief Compares the frontier merge_apply against the former nested-merge version.
+ *
+ * A 1,000-element input is bound to a continuation that returns a 1,000-element
+ * ranking, and a prefix of the result is forced. The nested version (kept here
+ * as legacy_merge_apply) merged each input element's results with the rest of
+ * the input through one merge layer per input element, so results of the i-th
+ * input sat under i layers. Time is reported per forced element.
+ *
+ * Usage: merge_apply_benchmark [input] [continuation] [elements]
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/operations/merge_apply.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace rb = ranked_belief;
+
+namespace legacy {
+
+template<typename T>
+using ElementPromisePtr = std::shared_ptr<rb::Promise<std::shared_ptr<rb::RankingElement<T>>>>;
+
+template<typename T>
+std::shared_ptr<rb::RankingElement<T>> merge_with_ranks(
+    std::shared_ptr<rb::RankingElement<T>> first,
+    rb::Rank first_rank,
+    ElementPromisePtr<T> second_promise,
+    rb::Rank second_min_rank)
+{
+    if (!first) {
+        return second_promise ? second_promise->force() : nullptr;
+    }
+    if (second_min_rank == rb::Rank::infinity() || !second_promise) {
+        return first;
+    }
+    if (first_rank <= second_min_rank) {
+        return std::make_shared<rb::RankingElement<T>>(
+            first->value(), first_rank,
+            rb::make_promise([first, second_promise, second_min_rank]() {
+                auto first_next = first->next();
+                rb::Rank next_rank = first_next ? first_next->rank() : rb::Rank::infinity();
+                return merge_with_ranks(first_next, next_rank, second_promise, second_min_rank);
+            }));
+    }
+
+    auto second = second_promise->force();
+    if (!second) {
+        return first;
+    }
+    auto second_next = second->next();
+    rb::Rank second_next_min_rank = second_next ? second_next->rank() : rb::Rank::infinity();
+    ElementPromisePtr<T> next_second_promise;
+    if (second_next) {
+        next_second_promise = std::make_shared<rb::Promise<std::shared_ptr<rb::RankingElement<T>>>>(
+            rb::make_promise([second_next]() { return second_next; }));
+    }
+    return std::make_shared<rb::RankingElement<T>>(
+        second->value(), second->rank(),
+        rb::make_promise([first, first_rank, next_second_promise, second_next_min_rank]() {
+            return merge_with_ranks(first, first_rank, next_second_promise, second_next_min_rank);
+        }));
+}
+
+template<typename T, typename U, typename Func>
+rb::RankingFunction<U> legacy_merge_apply(const rb::RankingFunction<T>& rf, Func func) {
+    using BuildFunc = std::function<std::shared_ptr<rb::RankingElement<U>>(
+        std::shared_ptr<rb::RankingElement<T>>)>;
+    auto build = std::make_shared<BuildFunc>();
+    std::weak_ptr<BuildFunc> weak_build = build;
+
+    *build = [weak_build, func](std::shared_ptr<rb::RankingElement<T>> elem)
+        -> std::shared_ptr<rb::RankingElement<U>> {
+        if (!elem) {
+            return nullptr;
+        }
+        auto build_ref = weak_build.lock();
+        auto shifted = rb::shift_ranks(func(elem->value()), elem->rank());
+        auto shifted_head = shifted.head();
+        auto next_input = elem->next();
+        rb::Rank rest_min_rank = next_input ? next_input->rank() : rb::Rank::infinity();
+
+        ElementPromisePtr<U> rest_promise;
+        if (next_input) {
+            rest_promise = std::make_shared<rb::Promise<std::shared_ptr<rb::RankingElement<U>>>>(
+                rb::make_promise([build_ref, next_input]() { return (*build_ref)(next_input); }));
+        }
+        return merge_with_ranks(
+            shifted_head, shifted_head ? shifted_head->rank() : rb::Rank::infinity(),
+            rest_promise, rest_min_rank);
+    };
+    return rb::RankingFunction<U>((*build)(rf.head()));
+}
+
+}  // namespace legacy
+
+namespace {
+
+std::vector<int> iota(std::size_t n) {
+    std::vector<int> values(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        values[i] = static_cast<int>(i);
+    }
+    return values;
+}
+
+template<typename Run>
+double time_per_element(Run run, std::size_t elements) {
+    const double ns = bench::time_call([&] {
+        bench::check(run() == elements, "unexpected result size");
+    });
+    return ns / static_cast<double>(elements);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t input_size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+    const std::size_t continuation_size = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+    const std::size_t elements = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 100000;
+
+    const auto input = rb::from_values_sequential(iota(input_size), rb::Rank::zero(), rb::Deduplication::Disabled);
+    const auto continuation_values = iota(continuation_size);
+    auto continuation = [&continuation_values](int) {
+        return rb::from_values_sequential(continuation_values, rb::Rank::zero(), rb::Deduplication::Disabled);
+    };
+
+    std::cout << "Forcing " << elements << " elements of a " << input_size << " x "
+              << continuation_size << " merge_apply\n\n";
+    bench::header("implementation", {"ns/elem"});
+
+    bench::report("nested (previous)", {time_per_element([&]() {
+        return rb::take_n(legacy::legacy_merge_apply<int, int>(input, continuation), elements).size();
+    }, elements)});
+    bench::report("frontier", {time_per_element([&]() {
+        return rb::take_n(rb::merge_apply(input, continuation, rb::Deduplication::Disabled), elements).size();
+    }, elements)});
+    return 0;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file parallel_merge_apply_benchmark.cpp
+ * @brief Compares merge_apply with parallel_merge_apply on slow continuations.
+ *
+ * Every continuation takes @c latency microseconds (a sleep, standing in for
+ * a model evaluation) and returns a small ranking. The whole result is forced.
+ * merge_apply runs the continuations one after another; parallel_merge_apply
+ * runs up to @c width of them at once on a WorkStealingPool. Time is reported
+ * per input element.
+ *
+ * Usage: parallel_merge_apply_benchmark [inputs] [latency_us] [workers]
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/executor.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+#include "ranked_belief/operations/parallel_merge_apply.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <ratio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rb = ranked_belief;
+
+namespace {
+
+template<typename Build>
+double run_inputs(Build build, std::size_t inputs) {
+    const double us = bench::time_call<std::micro>([&] {
+        bench::check(rb::take_n(build(), 3 * inputs + 1).size() == 3 * inputs, "unexpected element count");
+    });
+    return us / static_cast<double>(inputs);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t inputs = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500;
+    const auto latency = std::chrono::microseconds(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200);
+    const std::size_t workers = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 8;
+
+    std::vector<long> values(inputs);
+    for (std::size_t i = 0; i < inputs; ++i) {
+        values[i] = static_cast<long>(i);
+    }
+    const auto input = rb::from_values_sequential<long>(values);
+    auto slow = [latency](long x) {
+        std::this_thread::sleep_for(latency);
+        return rb::from_list<long>({{x, rb::Rank::zero()}, {-x - 1, rb::Rank::from_value(1)},
+                                    {x + 1000000, rb::Rank::from_value(2)}},
+                                   rb::Deduplication::Disabled);
+    };
+
+    std::cout << "Forcing merge_apply over " << inputs << " inputs, " << latency.count()
+              << " us per continuation, " << workers << " workers\n\n";
+    bench::header("strategy", {"us/input"});
+
+    bench::report("merge_apply", {run_inputs([&] { return rb::merge_apply(input, slow); }, inputs)});
+    auto pool = std::make_shared<rb::WorkStealingPool>(workers);
+    for (std::size_t width : {2, 8, 32}) {
+        bench::report("parallel / width " + std::to_string(width), {run_inputs([&] {
+            return rb::parallel_merge_apply(input, slow, pool, width);
+        }, inputs)});
+    }
+    return 0;
+}
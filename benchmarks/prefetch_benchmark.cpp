@@ -0,0 +1,81 @@
+/**
+ * @file prefetch_benchmark.cpp
+ * @brief Measures overlapping slow map() callbacks with the consumer via prefetch().
+ *
+ * Each value of a mapped ranking takes @c latency microseconds to compute
+ * (a sleep, standing in for I/O or a remote model call) and the consumer
+ * spends the same time on each element. Without read-ahead both run serially
+ * on the consumer's thread; with prefetch() the callbacks for the next
+ * @c depth elements run on a WorkStealingPool meanwhile. Time is reported per
+ * consumed element.
+ *
+ * Usage: prefetch_benchmark [elements] [latency_us] [workers]
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/executor.hpp"
+#include "ranked_belief/operations/map.hpp"
+#include "ranked_belief/operations/prefetch.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <ratio>
+#include <string>
+#include <thread>
+
+namespace rb = ranked_belief;
+
+namespace {
+
+template<typename Consume>
+double run_consumer(Consume consume, std::size_t elements) {
+    std::size_t consumed = 0;
+    const double us = bench::time_call<std::micro>([&] { consumed = consume(); });
+    bench::check(consumed == elements, "unexpected element count");
+    return us / static_cast<double>(elements);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t elements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    const auto latency = std::chrono::microseconds(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100);
+    const std::size_t workers = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 4;
+
+    auto make_mapped = [latency]() {
+        auto source = rb::from_generator<long>([](std::size_t i) {
+            return std::make_pair(static_cast<long>(i), rb::Rank::from_value(i));
+        });
+        return rb::map(source, [latency](long x) {
+            std::this_thread::sleep_for(latency);
+            return x * 3;
+        });
+    };
+    auto consume = [&](const rb::RankingFunction<long>& rf) {
+        std::size_t consumed = 0;
+        for (auto it = rf.begin(); consumed < elements; ++it) {
+            (void)(*it).first;
+            std::this_thread::sleep_for(latency);
+            ++consumed;
+        }
+        return consumed;
+    };
+
+    std::cout << "Consuming " << elements << " elements, " << latency.count()
+              << " us per callback and per element, " << workers << " workers\n\n";
+    bench::header("strategy", {"us/elem"});
+
+    bench::report("serial", {run_consumer([&] { return consume(make_mapped()); }, elements)});
+    auto pool = std::make_shared<rb::WorkStealingPool>(workers);
+    for (std::size_t depth : {1, 4, 16}) {
+        bench::report("prefetch / depth " + std::to_string(depth), {run_consumer([&] {
+            return consume(rb::prefetch(make_mapped(), depth, pool));
+        }, elements)});
+    }
+    return 0;
+}
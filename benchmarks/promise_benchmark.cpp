@@ -0,0 +1,56 @@
+/**
+ * @file promise_benchmark.cpp
+ * @brief Compares the cost of creating and forcing promises under each policy.
+ *
+ * Each run creates a batch of promises whose closures capture a shared_ptr
+ * (typical of the lazy operations), forces every promise twice and then
+ * destroys them. Time is reported per promise.
+ */
+
+#include "ranked_belief/promise.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace rb = ranked_belief;
+
+namespace {
+
+template<typename Policy>
+double run_batch(std::size_t count) {
+    auto shared = std::make_shared<long>(1);
+    long checksum = 0;
+
+    const double ns = bench::time_call([&] {
+        std::vector<rb::Promise<long, Policy>> promises;
+        promises.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            promises.push_back(rb::make_promise<Policy>(
+                [shared, i]() { return *shared + static_cast<long>(i); }));
+        }
+        for (auto& promise : promises) {
+            checksum += promise.force();
+            checksum += promise.force();
+        }
+    });
+
+    bench::check(checksum != 0, "unexpected checksum");
+    return ns / static_cast<double>(count);
+}
+
+}  // namespace
+
+int main() {
+    constexpr std::size_t count = 1'000'000;
+
+    std::cout << "Creating and forcing " << count << " promises\n\n";
+    bench::header("policy", {"ns/promise"});
+
+    bench::report("ThreadSafePolicy", {run_batch<rb::ThreadSafePolicy>(count)});
+    bench::report("SingleThreadedPolicy", {run_batch<rb::SingleThreadedPolicy>(count)});
+    return 0;
+}
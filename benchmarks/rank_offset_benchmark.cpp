@@ -0,0 +1,68 @@
+/**
+ * @file rank_offset_benchmark.cpp
+ * @brief Compares nested rank shifts built from nodes with carried offsets.
+ *
+ * A generated ranking is shifted @c depth times and then traversed. The
+ * node-wrapping strategy rebuilds the sequence once per shift (what
+ * shift_ranks did before rankings carried a rank offset); the offset strategy
+ * is shift_ranks itself. Time is reported per forced element.
+ *
+ * Usage: rank_offset_benchmark [elements]
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/operations/merge_apply.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace rb = ranked_belief;
+
+namespace {
+
+rb::RankingFunction<long> make_source() {
+    return rb::from_generator<long>([](std::size_t i) {
+        return std::make_pair(static_cast<long>(i), rb::Rank::from_value(i));
+    });
+}
+
+/// shift_ranks as it was implemented before rank offsets: one node layer per shift.
+rb::RankingFunction<long> wrap_shift(const rb::RankingFunction<long>& rf, rb::Rank amount) {
+    return rb::RankingFunction<long>(
+        rb::detail::remap_ranks<long>(rf.head(), [amount](rb::Rank rank) { return rank + amount; }),
+        rb::from_bool(rf.is_deduplicating()));
+}
+
+template<typename Shift>
+double run_shifts(Shift shift, std::size_t depth, std::size_t elements) {
+    const double ns = bench::time_call([&] {
+        auto rf = make_source();
+        for (std::size_t d = 0; d < depth; ++d) {
+            rf = shift(rf, rb::Rank::from_value(1));
+        }
+        bench::check(rb::take_n(rf, elements).back().second == rb::Rank::from_value(elements - 1 + depth),
+                     "unexpected ranks");
+    });
+    return ns / static_cast<double>(elements);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t elements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+
+    std::cout << "Traversing " << elements << " elements under nested shifts\n\n";
+    bench::header("strategy / depth", {"ns/elem"});
+    for (std::size_t depth : {1, 4, 16}) {
+        bench::report("node wrapping / " + std::to_string(depth), {run_shifts(wrap_shift, depth, elements)});
+        bench::report("rank offset / " + std::to_string(depth),
+                      {run_shifts([](const auto& rf, rb::Rank amount) { return rb::shift_ranks(rf, amount); },
+                                  depth, elements)});
+    }
+    return 0;
+}
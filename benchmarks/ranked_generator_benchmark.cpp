@@ -0,0 +1,84 @@
+/**
+ * @file ranked_generator_benchmark.cpp
+ * @brief Compares from_generator with a ranked_generator coroutine.
+ *
+ * Both produce the same stateful sequence (a linear congruential walk whose
+ * next value depends on the previous one). from_generator recomputes each
+ * element from its index, so the walk is replayed; the coroutine keeps its
+ * state in the frame. A third row forces the coroutine inside a NodePool,
+ * from which both the frame and the nodes are allocated. Time is reported per
+ * forced element.
+ *
+ * Usage: ranked_generator_benchmark [elements] [repetitions]
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/node_pool.hpp"
+#include "ranked_belief/ranked_generator.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+namespace rb = ranked_belief;
+
+namespace {
+
+std::uint64_t step(std::uint64_t x) {
+    return x * 6364136223846793005ULL + 1442695040888963407ULL;
+}
+
+rb::ranked_generator<std::uint64_t> walk() {
+    std::uint64_t x = 1;
+    for (std::uint64_t i = 0;; ++i, x = step(x)) {
+        co_yield {x, rb::Rank::from_value(i)};
+    }
+}
+
+template<typename Build>
+double run_forced(Build build, std::size_t elements, std::size_t repetitions) {
+    const double ns = bench::time_call([&] {
+        for (std::size_t r = 0; r < repetitions; ++r) {
+            const rb::RankingFunction<std::uint64_t> rf = build();
+            std::size_t forced = 0;
+            for (auto it = rf.begin(); forced < elements; ++it) {
+                (void)(*it).first;
+                ++forced;
+            }
+            bench::check(forced == elements, "unexpected element count");
+        }
+    });
+    return ns / static_cast<double>(elements * repetitions);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t elements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    const std::size_t repetitions = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20;
+
+    std::cout << "Forcing " << elements << " elements x " << repetitions << " repetitions\n\n";
+    bench::header("source", {"ns/elem"});
+
+    bench::report("from_generator (replay)", {run_forced([] {
+        return rb::from_generator<std::uint64_t>([](std::size_t i) {
+            std::uint64_t x = 1;
+            for (std::size_t k = 0; k < i; ++k) {
+                x = step(x);
+            }
+            return std::make_pair(x, rb::Rank::from_value(i));
+        });
+    }, elements, repetitions)});
+    bench::report("ranked_generator", {run_forced([] {
+        return rb::RankingFunction<std::uint64_t>(walk());
+    }, elements, repetitions)});
+    bench::report("ranked_generator / pool", {run_forced([] {
+        rb::NodePoolScope scope(std::make_shared<rb::NodePool>());
+        return rb::RankingFunction<std::uint64_t>(walk());
+    }, elements, repetitions)});
+    return 0;
+}
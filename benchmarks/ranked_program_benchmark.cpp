@@ -0,0 +1,112 @@
+/**
+ * @file ranked_program_benchmark.cpp
+ * @brief Compares nested merge_apply with the same model as a ranked_program.
+ *
+ * The model binds @c depth boolean choices (normally true, exceptionally
+ * false) and returns them as a bit pattern, so it has 2^depth results. It is
+ * written once as nested merge_apply calls and once as a ranked_program
+ * evaluated by from_program(), and every result is forced. Global operator
+ * new is replaced with a counting version; allocations and wall-clock time
+ * are reported per result.
+ *
+ * Usage: ranked_program_benchmark [depth] [repetitions]
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/node_pool.hpp"
+#include "ranked_belief/operations/merge_apply.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+#include "ranked_belief/ranked_program.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+
+namespace {
+
+std::atomic<std::size_t> allocation_count{0};
+
+// Kept out of line so the compiler does not pair the inlined free() with
+// operator new and flag a mismatched deallocation.
+[[gnu::noinline]] void release(void* p) noexcept { std::free(p); }
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+
+namespace rb = ranked_belief;
+
+namespace {
+
+const rb::RankingFunction<bool>& choice() {
+    static const auto ranking = rb::from_list<bool>(
+        {{true, rb::Rank::zero()}, {false, rb::Rank::from_value(1)}}, rb::Deduplication::Disabled);
+    return ranking;
+}
+
+rb::RankingFunction<long> nested(std::size_t depth, long bits) {
+    return rb::merge_apply(choice(), [depth, bits](bool b) {
+        const long next = bits * 2 + (b ? 1 : 0);
+        return depth == 1 ? rb::singleton(next) : nested(depth - 1, next);
+    }, rb::Deduplication::Disabled);
+}
+
+rb::ranked_program<long> program(std::size_t depth) {
+    long bits = 0;
+    for (std::size_t i = 0; i < depth; ++i) {
+        const bool b = co_await choice();
+        bits = bits * 2 + (b ? 1 : 0);
+    }
+    co_return bits;
+}
+
+template<typename Build>
+void measure(const std::string& label, Build build, std::size_t results, std::size_t repetitions) {
+    const auto allocations_before = allocation_count.load();
+    const double ns = bench::time_call([&] {
+        for (std::size_t r = 0; r < repetitions; ++r) {
+            bench::check(rb::take_n(build(), results + 1).size() == results, "unexpected result size");
+        }
+    });
+    const auto forced = static_cast<double>(results * repetitions);
+    bench::report(label, {static_cast<double>(allocation_count.load() - allocations_before) / forced,
+                          ns / forced});
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t depth = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10;
+    const std::size_t repetitions = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20;
+    const std::size_t results = std::size_t{1} << depth;
+    (void)choice();
+
+    std::cout << "Forcing all " << results << " results of a " << depth << "-bind model x "
+              << repetitions << " repetitions\n\n";
+    bench::header("model", {"allocs/result", "ns/result"});
+
+    measure("nested merge_apply", [&] { return nested(depth, 0); }, results, repetitions);
+    measure("ranked_program", [&] {
+        return rb::from_program([depth] { return program(depth); }, rb::Deduplication::Disabled);
+    }, results, repetitions);
+    measure("ranked_program / pool", [&] {
+        rb::NodePoolScope scope(std::make_shared<rb::NodePool>(rb::PoolSynchronization::Unsynchronized));
+        return rb::from_program([depth] { return program(depth); }, rb::Deduplication::Disabled);
+    }, results, repetitions);
+    return 0;
+}
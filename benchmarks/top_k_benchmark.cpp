@@ -0,0 +1,72 @@
+/**
+ * @file top_k_benchmark.cpp
+ * @brief Compares paging through a ranking with take_n and with a TopKCursor.
+ *
+ * A forced ranking is read in pages of @c page entries. The take_n strategy
+ * asks for a growing prefix and keeps its last page (what paginated callers
+ * did before top_k); the cursor strategy asks one TopKCursor for each page.
+ * Time is reported per returned entry.
+ *
+ * Usage: top_k_benchmark [elements] [page]
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+#include "ranked_belief/operations/top_k.hpp"
+
+#include "benchmark_util.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace rb = ranked_belief;
+
+namespace {
+
+template<typename Pages>
+double run_pages(Pages pages, std::size_t elements) {
+    std::size_t returned = 0;
+    const double ns = bench::time_call([&] { returned = pages(); });
+    bench::check(returned == elements, "unexpected entry count");
+    return ns / static_cast<double>(elements);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t elements = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    const std::size_t page = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+
+    auto rf = rb::from_generator<std::string>([](std::size_t i) {
+        return std::make_pair("value-" + std::to_string(i), rb::Rank::from_value(i));
+    });
+    (void)rb::take_n(rf, elements + 1);  // force the ranking up front
+
+    std::cout << "Paging through " << elements << " entries, " << page << " per page\n\n";
+    bench::header("strategy", {"ns/entry"});
+
+    bench::report("take_n growing prefix", {run_pages([&] {
+        std::size_t returned = 0;
+        for (std::size_t end = page; returned < elements; end += page) {
+            auto prefix = rb::take_n(rf, std::min(end, elements));
+            returned += prefix.size() - returned;
+        }
+        return returned;
+    }, elements)});
+
+    bench::report("TopKCursor pages", {run_pages([&] {
+        rb::TopKCursor<std::string> cursor(rf);
+        std::vector<std::pair<std::string, rb::Rank>> buffer;
+        std::size_t returned = 0;
+        while (returned < elements) {
+            buffer.clear();
+            returned += cursor.append(buffer, std::min(page, elements - returned));
+        }
+        return returned;
+    }, elements)});
+    return 0;
+}
@@ -22,6 +22,7 @@
 #include "ranked_belief/ranking_function.hpp"
 #include "ranked_belief/detail/any_equality_registry.hpp"
 #include "ranked_belief/type_erasure.hpp"
+#include "ranked_belief/value_cell.hpp"
 
 namespace py = pybind11;
 namespace rb = ranked_belief;
@@ -79,6 +80,20 @@ struct PyValue {
     return result == 1;
 }
 
+} // namespace
+
+namespace ranked_belief {
+
+// A PyValue is one reference: keep it inline, copies only bump the refcount.
+template<>
+inline constexpr bool value_cell_inline<PyValue> = true;
+
+} // namespace ranked_belief
+
+namespace {
+
+// Rankings that fall back to std::any (normal_exceptional, mixed merges)
+// still compare PyValues through the registry.
 [[maybe_unused]] const bool registered_pyvalue_equality = [] {
     rb::detail::register_any_equality(
         std::type_index(typeid(PyValue)),
@@ -88,11 +103,6 @@ struct PyValue {
     return true;
 }();
 
-[[nodiscard]] std::any py_to_any(py::handle handle)
-{
-    return std::any{PyValue(handle)};
-}
-
 [[nodiscard]] py::object any_to_py(const std::any& value)
 {
     if (value.type() == typeid(PyValue)) {
@@ -144,25 +154,41 @@ struct PyValue {
     throw py::type_error("Unsupported value stored in RankingFunctionAny; expected a Python-managed object");
 }
 
-[[nodiscard]] std::vector<std::pair<std::any, rb::Rank>> parse_value_rank_pairs(const py::iterable& pairs)
+[[nodiscard]] rb::ValueCell py_to_cell(py::handle handle)
 {
-    std::vector<std::pair<std::any, rb::Rank>> result;
+    return rb::ValueCell{PyValue(handle)};
+}
+
+[[nodiscard]] py::object cell_to_py(const rb::ValueCell& value)
+{
+    if (const auto* wrapped = value.get_if<PyValue>()) {
+        return wrapped->object;
+    }
+    if (const auto* boxed = value.get_if<std::any>()) {
+        return any_to_py(*boxed);
+    }
+    return any_to_py(value.to_any());
+}
+
+[[nodiscard]] std::vector<std::pair<rb::ValueCell, rb::Rank>> parse_value_rank_pairs(const py::iterable& pairs)
+{
+    std::vector<std::pair<rb::ValueCell, rb::Rank>> result;
     for (auto item : pairs) {
         auto tuple = py::reinterpret_borrow<py::sequence>(item);
         if (py::len(tuple) != 2) {
             throw py::value_error("Expected (value, Rank) pairs");
         }
         auto rank_obj = tuple[1];
-        result.emplace_back(py_to_any(tuple[0]), rank_obj.cast<rb::Rank>());
+        result.emplace_back(py_to_cell(tuple[0]), rank_obj.cast<rb::Rank>());
     }
     return result;
 }
 
-[[nodiscard]] py::list pairs_to_python_list(const std::vector<std::pair<std::any, rb::Rank>>& pairs)
+[[nodiscard]] py::list pairs_to_python_list(const std::vector<std::pair<rb::ValueCell, rb::Rank>>& pairs)
 {
     py::list result;
     for (const auto& [value, rank] : pairs) {
-        result.append(py::make_tuple(any_to_py(value), rank));
+        result.append(py::make_tuple(cell_to_py(value), rank));
     }
     return result;
 }
@@ -524,7 +550,7 @@ Create an empty ranking with no elements.
 )pbdoc")
         .def_static("singleton",
             [](py::object value, const rb::Rank& rank) {
-                auto native = rb::singleton<std::any>(py_to_any(value), rank);
+                auto native = rb::singleton<rb::ValueCell>(py_to_cell(value), rank);
                 return rb::RankingFunctionAny{std::move(native)};
             },
             py::arg("value"),
@@ -533,7 +559,7 @@ Create an empty ranking with no elements.
         .def_static("from_list",
             [](py::iterable pairs, bool deduplicate) {
                 auto native_pairs = parse_value_rank_pairs(pairs);
-                auto native = rb::from_list<std::any>(std::move(native_pairs), to_deduplication(deduplicate));
+                auto native = rb::from_list<rb::ValueCell>(std::move(native_pairs), to_deduplication(deduplicate));
                 return rb::RankingFunctionAny{std::move(native)};
             },
             py::arg("pairs"),
@@ -541,9 +567,7 @@ Create an empty ranking with no elements.
             R"pbdoc(Construct a ranking from explicit ``(value, Rank)`` pairs of Python objects.)pbdoc")
         .def_static("from_generator",
             [](py::function generator, std::size_t start_index, bool deduplicate) {
-                // Note: Cannot use from_generator<std::any> because std::any doesn't satisfy
-                // EqualityComparableValue. Manually construct using make_infinite_sequence.
-                auto head = rb::make_infinite_sequence<std::any>(
+                auto native = rb::from_generator<rb::ValueCell>(
                     [generator = std::move(generator)](std::size_t index) {
                         py::gil_scoped_acquire gil;
                         py::object result = generator(index);
@@ -552,10 +576,10 @@ Create an empty ranking with no elements.
                             throw py::value_error("Generator must yield (value, Rank) tuples");
                         }
                         auto rank_obj = tuple[1];
-                        return std::make_pair(py_to_any(tuple[0]), rank_obj.cast<rb::Rank>());
+                        return std::make_pair(py_to_cell(tuple[0]), rank_obj.cast<rb::Rank>());
                     },
-                    start_index);
-                auto native = rb::RankingFunction<std::any>(head, to_deduplication(deduplicate));
+                    start_index,
+                    to_deduplication(deduplicate));
                 return rb::RankingFunctionAny{std::move(native)};
             },
             py::arg("generator"),
@@ -571,7 +595,7 @@ Create an empty ranking with no elements.
                 if (!rank) {
                     return std::nullopt;
                 }
-                return std::make_optional(std::make_pair(any_to_py(self.first_value()), *rank));
+                return std::make_optional(std::make_pair(cell_to_py(self.first_cell()), *rank));
             },
             R"pbdoc(Return the most normal element as ``(value, Rank)`` or ``None`` if empty.)pbdoc")
         .def("map",
@@ -580,14 +604,14 @@ Create an empty ranking with no elements.
                 if (!func_handle) {
                     throw py::value_error("map expects a callable");
                 }
-                auto mapper = [func_handle](const std::any& value) -> std::any {
+                auto mapper = [func_handle](const rb::ValueCell& value) -> rb::ValueCell {
                     if (!func_handle) {
                         throw py::value_error("map callable is no longer available");
                     }
                     py::gil_scoped_acquire gil;
                     py::function callable = py::reinterpret_borrow<py::function>(func_handle.get());
-                    py::object transformed = callable(any_to_py(value));
-                    return py_to_any(std::move(transformed));
+                    py::object transformed = callable(cell_to_py(value));
+                    return py_to_cell(transformed);
                 };
                 try {
                     return self.map(mapper, to_deduplication(deduplicate));
@@ -604,19 +628,19 @@ Create an empty ranking with no elements.
                 if (!func_handle) {
                     throw py::value_error("map_with_rank expects a callable");
                 }
-                auto mapper = [func_handle](const std::any& value, rb::Rank rank) {
+                auto mapper = [func_handle](const rb::ValueCell& value, rb::Rank rank) {
                     if (!func_handle) {
                         throw py::value_error("map_with_rank callable is no longer available");
                     }
                     py::gil_scoped_acquire gil;
                     py::function callable = py::reinterpret_borrow<py::function>(func_handle.get());
-                    py::object result = callable(any_to_py(value), rank);
+                    py::object result = callable(cell_to_py(value), rank);
                     auto tuple = result.cast<py::sequence>();
                     if (py::len(tuple) != 2) {
                         throw py::value_error("map_with_rank callback must return (value, Rank)");
                     }
                     auto rank_obj = tuple[1];
-                    return std::make_pair(py_to_any(tuple[0]), rank_obj.cast<rb::Rank>());
+                    return std::make_pair(py_to_cell(tuple[0]), rank_obj.cast<rb::Rank>());
                 };
                 try {
                     return self.map_with_rank(mapper, to_deduplication(deduplicate));
@@ -633,14 +657,14 @@ Create an empty ranking with no elements.
                 if (!func_handle) {
                     throw py::value_error("map_with_index expects a callable");
                 }
-                auto mapper = [func_handle](const std::any& value, std::size_t index) -> std::any {
+                auto mapper = [func_handle](const rb::ValueCell& value, std::size_t index) -> rb::ValueCell {
                     if (!func_handle) {
                         throw py::value_error("map_with_index callable is no longer available");
                     }
                     py::gil_scoped_acquire gil;
                     py::function callable = py::reinterpret_borrow<py::function>(func_handle.get());
-                    py::object transformed = callable(any_to_py(value), index);
-                    return py_to_any(std::move(transformed));
+                    py::object transformed = callable(cell_to_py(value), index);
+                    return py_to_cell(transformed);
                 };
                 try {
                     return self.map_with_index(mapper, to_deduplication(deduplicate));
@@ -657,13 +681,13 @@ Create an empty ranking with no elements.
                 if (!predicate_handle) {
                     throw py::value_error("filter expects a callable predicate");
                 }
-                auto pred = [predicate_handle](const std::any& value) {
+                auto pred = [predicate_handle](const rb::ValueCell& value) {
                     if (!predicate_handle) {
                         throw py::value_error("filter predicate is no longer available");
                     }
                     py::gil_scoped_acquire gil;
                     py::function callable = py::reinterpret_borrow<py::function>(predicate_handle.get());
-                    return callable(any_to_py(value)).template cast<bool>();
+                    return callable(cell_to_py(value)).template cast<bool>();
                 };
                 try {
                     return self.filter(pred, to_deduplication(deduplicate));
@@ -714,22 +738,21 @@ Create an empty ranking with no elements.
                 if (!func_handle) {
                     throw py::value_error("merge_apply expects a callable");
                 }
-                auto native = self.to_any_ranking(to_deduplication(deduplicate));
-                auto merged = rb::merge_apply<std::any>(
+                auto native = self.to_cell_ranking(to_deduplication(deduplicate));
+                auto merged = rb::merge_apply<rb::ValueCell>(
                     native,
-                    [func_handle](const std::any& value) {
+                    [func_handle](const rb::ValueCell& value) {
                         if (!func_handle) {
                             throw py::value_error("merge_apply callable is no longer available");
                         }
                         py::gil_scoped_acquire gil;
                         py::function callable = py::reinterpret_borrow<py::function>(func_handle.get());
-                        py::object returned = callable(any_to_py(value));
+                        py::object returned = callable(cell_to_py(value));
                         try {
                             auto rf_any = returned.cast<rb::RankingFunctionAny>();
-                            return rf_any.to_any_ranking(rb::Deduplication::Disabled);
+                            return rf_any.to_cell_ranking(rb::Deduplication::Disabled);
                         } catch (const py::cast_error&) {
-                            auto singleton = rb::singleton<std::any>(py_to_any(returned), rb::Rank::zero());
-                            return singleton;
+                            return rb::singleton<rb::ValueCell>(py_to_cell(returned), rb::Rank::zero());
                         }
                     },
                     to_deduplication(deduplicate));
@@ -744,13 +767,13 @@ Create an empty ranking with no elements.
                 if (!predicate_handle) {
                     throw py::value_error("observe expects a callable predicate");
                 }
-                auto pred = [predicate_handle](const std::any& value) {
+                auto pred = [predicate_handle](const rb::ValueCell& value) {
                     if (!predicate_handle) {
                         throw py::value_error("observe predicate is no longer available");
                     }
                     py::gil_scoped_acquire gil;
                     py::function callable = py::reinterpret_borrow<py::function>(predicate_handle.get());
-                    return callable(any_to_py(value)).template cast<bool>();
+                    return callable(cell_to_py(value)).template cast<bool>();
                 };
                 try {
                     return self.observe(pred, to_deduplication(deduplicate));
@@ -764,7 +787,7 @@ Create an empty ranking with no elements.
         .def("observe_value",
             [](const rb::RankingFunctionAny& self, py::object value, bool deduplicate) {
                 try {
-                    return self.observe_value(py_to_any(value), to_deduplication(deduplicate));
+                    return self.observe_value(py_to_cell(value), to_deduplication(deduplicate));
                 } catch (const std::logic_error& error) {
                     throw py::value_error(error.what());
                 }
@@ -774,13 +797,13 @@ Create an empty ranking with no elements.
             R"pbdoc(Condition the ranking on equality with ``value``.)pbdoc")
         .def("take_n",
             [](const rb::RankingFunctionAny& self, std::size_t count) {
-                return pairs_to_python_list(self.take_n(count));
+                return pairs_to_python_list(self.take_n_cells(count));
             },
             py::arg("count"),
             R"pbdoc(Materialise at most ``count`` elements as ``(value, Rank)`` tuples.)pbdoc")
         .def("materialize",
             [](const rb::RankingFunctionAny& self, std::size_t count) {
-                return pairs_to_python_list(self.take_n(count));
+                return pairs_to_python_list(self.take_n_cells(count));
             },
             py::arg("count"),
             R"pbdoc(Alias for :py:meth:`take_n`.)pbdoc")
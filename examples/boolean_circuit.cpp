@@ -1,12 +1,15 @@
 #include "ranked_belief/constructors.hpp"
+#include "ranked_belief/intern.hpp"
 #include "ranked_belief/operations/merge_apply.hpp"
 #include "ranked_belief/operations/nrm_exc.hpp"
 #include "ranked_belief/operations/observe.hpp"
 #include "ranked_belief/rank.hpp"
+#include "ranked_belief/ranked_program.hpp"
 #include "ranked_belief/ranking_function.hpp"
 
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <tuple>
 #include <vector>
 
@@ -97,6 +100,30 @@ std::ostream& operator<<(std::ostream& os, const CircuitOutcome& outcome) {
     rb::Deduplication::Disabled);
 }
 
+/**
+ * @brief The same circuit written as a ranked program.
+ *
+ * Each @c co_await binds one gate's state, like one level of merge-apply
+ * above; from_program() searches the combinations best-first without
+ * building the intermediate rankings.
+ */
+[[nodiscard]] rb::ranked_program<CircuitOutcome> circuit_program(
+    bool input1,
+    bool input2,
+    bool input3)
+{
+    const bool n_gate = co_await normal_exceptional(true, false);
+    const bool l1 = n_gate ? (!input1) : false;
+
+    const bool o1_gate = co_await normal_exceptional(true, false);
+    const bool l2 = o1_gate ? (l1 || input2) : false;
+
+    const bool o2_gate = co_await normal_exceptional(true, false);
+    const bool output = o2_gate ? (l2 || input3) : false;
+
+    co_return CircuitOutcome{output, n_gate, o1_gate, o2_gate};
+}
+
 /**
  * @brief Entry point showcasing boolean circuit diagnosis with ranked belief.
  */
@@ -108,6 +135,10 @@ int main() {
     const bool input3 = true;
     const bool observed_output = false;
 
+    // Every gate rebuilds the same normal/exceptional boolean; interning
+    // lets those rebuilds share one ranking.
+    rb::InternScope<bool> intern_scope(std::make_shared<rb::InternTable<bool>>());
+
     const auto prior = circuit(input1, input2, input3);
     const auto posterior = rb::observe(
         prior,
@@ -129,5 +160,15 @@ int main() {
         std::cout << "No explanations within finite rank." << std::endl;
     }
 
+    const auto program_posterior = rb::observe(
+        rb::from_program([=] { return circuit_program(input1, input2, input3); },
+                         rb::Deduplication::Disabled),
+        [expected = observed_output](const CircuitOutcome& outcome) {
+            return outcome.output == expected;
+        },
+        rb::Deduplication::Disabled);
+    std::cout << "Ranked-program formulation agrees: "
+              << (rb::take_n(program_posterior, 6) == explanations) << '\n';
+
     return 0;
 }
@@ -0,0 +1,27 @@
+/**
+ * @file abi.hpp
+ * @brief Inline namespace that keys every library symbol on the promise policy.
+ *
+ * RANKED_BELIEF_SINGLE_THREADED changes DefaultPromisePolicy and with it the
+ * layout of RankingElement<T>, RankingFunction<T> and everything built on
+ * them with the default policy argument.
+ * All declarations of the library therefore live in the inline namespace
+ * ranked_belief::RANKED_BELIEF_ABI (thread_safe or single_threaded), so
+ * translation units built with different settings get distinct symbols:
+ * a function taking a RankingFunction<T>, defined in one and called from the
+ * other, fails to link instead of silently mixing two layouts.
+ *
+ * Code names the library through ranked_belief:: as before; the inline
+ * namespace only shows up in mangled names and diagnostics.
+ */
+
+#ifndef RANKED_BELIEF_ABI_HPP
+#define RANKED_BELIEF_ABI_HPP
+
+#ifdef RANKED_BELIEF_SINGLE_THREADED
+#define RANKED_BELIEF_ABI single_threaded
+#else
+#define RANKED_BELIEF_ABI thread_safe
+#endif
+
+#endif  // RANKED_BELIEF_ABI_HPP
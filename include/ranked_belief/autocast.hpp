@@ -6,7 +6,7 @@
 #include <type_traits>
 #include <utility>
 
-namespace ranked_belief {
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
 
 namespace detail {
 
@@ -14,8 +14,8 @@ namespace detail {
 template<typename T>
 struct is_ranking_function : std::false_type {};
 
-template<typename T>
-struct is_ranking_function<RankingFunction<T>> : std::true_type {};
+template<typename T, typename Policy>
+struct is_ranking_function<RankingFunction<T, Policy>> : std::true_type {};
 
 } // namespace detail
 
@@ -36,15 +36,16 @@ concept IsRankingFunction = detail::is_ranking_function<std::remove_cvref_t<T>>:
  * supplied value at rank zero. Construction preserves laziness guarantees of
  * the underlying constructors and enables seamless operator overloading.
  *
+ * @tparam Policy Promise policy of the result (default: DefaultPromisePolicy).
  * @tparam T Plain value type (non-ranking).
  * @param value The value to lift into ranking space.
  * @return Ranking function containing @p value at rank zero.
  */
-template<typename T>
+template<typename Policy = DefaultPromisePolicy, typename T>
 requires (!IsRankingFunction<T>)
 [[nodiscard]] auto autocast(T&& value)
 {
-    return singleton(std::forward<T>(value));
+    return singleton<std::decay_t<T>, Policy>(std::forward<T>(value));
 }
 
 /**
@@ -54,15 +55,16 @@ requires (!IsRankingFunction<T>)
  * argument, preserving value category (lvalue references stay references,
  * rvalues remain movable temporaries) and deduplication semantics.
  *
+ * @tparam Policy Ignored; accepted so callers can pass the same argument to both overloads.
  * @tparam RF Any ranking function instantiation.
  * @param rf Ranking function to forward.
  * @return Forwarded ranking function.
  */
-template<typename RF>
+template<typename Policy = DefaultPromisePolicy, typename RF>
 requires IsRankingFunction<RF>
 [[nodiscard]] constexpr RF&& autocast(RF&& rf) noexcept
 {
     return std::forward<RF>(rf);
 }
 
-} // namespace ranked_belief
+} // namespace ranked_belief::inline RANKED_BELIEF_ABI
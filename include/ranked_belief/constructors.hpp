@@ -7,7 +7,9 @@
  * - from_list: Create from value-rank pairs
  * - from_values: Create with uniform or custom rank assignment
  * - from_generator: Create infinite sequences from generator functions
+ * - from_batch_generator: Create sequences from generators producing batches
  * - from_range: Create from C++20 ranges
+ * - lazy_from_range: Read C++20 ranges on demand
  *
  * These functions complement the basic factory functions in ranking_function.hpp,
  * providing more convenient and expressive ways to construct ranking functions
@@ -19,6 +21,9 @@
  * - Flexible rank assignment: Uniform, sequential, or custom
  * - C++20 ranges support: Works with any range type
  * - Builder pattern: Chainable configuration options
+ * - Promise policy: every constructor takes an optional Policy template
+ *   argument (default: DefaultPromisePolicy) selecting the policy of the
+ *   ranking it builds. Interning applies to the default policy only.
  */
 
 #ifndef RANKED_BELIEF_CONSTRUCTORS_HPP
@@ -26,12 +31,17 @@
 
 #include "ranking_function.hpp"
 #include "concepts.hpp"
+#include "intern.hpp"
 #include <concepts>
+#include <cstddef>
+#include <optional>
 #include <ranges>
+#include <span>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
-namespace ranked_belief {
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
 
 /**
  * @brief Create a ranking function from a vector of value-rank pairs.
@@ -53,23 +63,28 @@ namespace ranked_belief {
  * });
  * @endcode
  */
-template<ValueType T>
-[[nodiscard]] RankingFunction<T> from_list(
+template<ValueType T, typename Policy = DefaultPromisePolicy>
+[[nodiscard]] RankingFunction<T, Policy> from_list(
     const std::vector<std::pair<T, Rank>>& pairs,
     Deduplication deduplicate = Deduplication::Enabled)
 {
     if (pairs.empty()) {
-        return RankingFunction<T>();
+        return RankingFunction<T, Policy>();
+    }
+    if constexpr (Internable<T> && std::is_same_v<Policy, DefaultPromisePolicy>) {
+        if (const auto table = current_intern_table<T>()) {
+            return table->intern(pairs, deduplicate);
+        }
     }
     
     // Build the sequence from back to front
-    std::shared_ptr<RankingElement<T>> head = nullptr;
+    std::shared_ptr<RankingElement<T, Policy>> head = nullptr;
     for (auto it = pairs.rbegin(); it != pairs.rend(); ++it) {
         auto next = head;
         head = make_element(it->first, it->second, next);
     }
     
-    return RankingFunction<T>(head, deduplicate);
+    return RankingFunction<T, Policy>(head, deduplicate);
 }
 
 /**
@@ -89,23 +104,23 @@ template<ValueType T>
  * auto rf = from_values_uniform({1, 2, 3, 4, 5});  // All at rank 0
  * @endcode
  */
-template<ValueType T>
-[[nodiscard]] RankingFunction<T> from_values_uniform(
+template<ValueType T, typename Policy = DefaultPromisePolicy>
+[[nodiscard]] RankingFunction<T, Policy> from_values_uniform(
     const std::vector<T>& values,
     Rank rank = Rank::zero(),
     Deduplication deduplicate = Deduplication::Enabled)
 {
     if (values.empty()) {
-        return RankingFunction<T>();
+        return RankingFunction<T, Policy>();
     }
     
-    std::shared_ptr<RankingElement<T>> head = nullptr;
+    std::shared_ptr<RankingElement<T, Policy>> head = nullptr;
     for (auto it = values.rbegin(); it != values.rend(); ++it) {
         auto next = head;
         head = make_element(*it, rank, next);
     }
     
-    return RankingFunction<T>(head, deduplicate);
+    return RankingFunction<T, Policy>(head, deduplicate);
 }
 
 /**
@@ -127,17 +142,17 @@ template<ValueType T>
  * // Creates: 1@0, 2@1, 3@2
  * @endcode
  */
-template<ValueType T>
-[[nodiscard]] RankingFunction<T> from_values_sequential(
+template<ValueType T, typename Policy = DefaultPromisePolicy>
+[[nodiscard]] RankingFunction<T, Policy> from_values_sequential(
     const std::vector<T>& values,
     Rank start_rank = Rank::zero(),
     Deduplication deduplicate = Deduplication::Enabled)
 {
     if (values.empty()) {
-        return RankingFunction<T>();
+        return RankingFunction<T, Policy>();
     }
     
-    std::shared_ptr<RankingElement<T>> head = nullptr;
+    std::shared_ptr<RankingElement<T, Policy>> head = nullptr;
     
     // Build list in reverse, computing rank for each position
     for (size_t i = values.size(); i > 0; --i) {
@@ -147,7 +162,7 @@ template<ValueType T>
         head = make_element(values[index], rank, next);
     }
     
-    return RankingFunction<T>(head, deduplicate);
+    return RankingFunction<T, Policy>(head, deduplicate);
 }
 
 /**
@@ -173,16 +188,16 @@ template<ValueType T>
  * // Creates: 1@1, 2@4, 3@9, 4@16, 5@25
  * @endcode
  */
-template<EqualityComparableValue T, typename F>
+template<EqualityComparableValue T, typename Policy = DefaultPromisePolicy, typename F>
 requires std::invocable<F, const T&, std::size_t> &&
          std::same_as<std::invoke_result_t<F, const T&, std::size_t>, Rank>
-[[nodiscard]] RankingFunction<T> from_values_with_ranker(
+[[nodiscard]] RankingFunction<T, Policy> from_values_with_ranker(
     const std::vector<T>& values,
     F rank_fn,
     Deduplication deduplicate = Deduplication::Enabled)
 {
     if (values.empty()) {
-        return RankingFunction<T>();
+        return RankingFunction<T, Policy>();
     }
     
     // Build pairs first, then construct
@@ -193,7 +208,7 @@ requires std::invocable<F, const T&, std::size_t> &&
         pairs.emplace_back(values[i], rank_fn(values[i], i));
     }
     
-    return from_list(pairs, deduplicate);
+    return from_list<T, Policy>(pairs, deduplicate);
 }
 
 /**
@@ -207,6 +222,9 @@ requires std::invocable<F, const T&, std::size_t> &&
  * @param generator Function mapping index to (value, rank): size_t -> std::pair<T, Rank>
  * @param start_index The starting index for generation (default: 0)
  * @param deduplicate If true, enable deduplication (default: true)
+ * @param chunk_size Elements generated per lazy step (default: 1). Values above
+ *        1 build the sequence with make_chunked_sequence(); map and filter then
+ *        keep the same granularity.
  * @return RankingFunction representing the infinite sequence
  *
  * @warning The resulting sequence is infinite. Operations like size() will
@@ -220,22 +238,60 @@ requires std::invocable<F, const T&, std::size_t> &&
  * // Creates infinite sequence: 0@0, 1@1, 2@2, ...
  * @endcode
  */
-template<EqualityComparableValue T, typename F>
+template<EqualityComparableValue T, typename Policy = DefaultPromisePolicy, typename F>
 requires std::invocable<F, std::size_t> &&
          std::same_as<std::invoke_result_t<F, std::size_t>, std::pair<T, Rank>>
-[[nodiscard]] RankingFunction<T> from_generator(
+[[nodiscard]] RankingFunction<T, Policy> from_generator(
+    F generator,
+    std::size_t start_index = 0,
+    Deduplication deduplicate = Deduplication::Enabled,
+    std::size_t chunk_size = 1)
+{
+    if (chunk_size > 1) {
+        auto head = make_chunked_sequence<T, Policy>(std::move(generator), chunk_size, start_index);
+        return RankingFunction<T, Policy>(head, deduplicate, chunk_size);
+    }
+
+    auto head = make_infinite_sequence<T, Policy>(std::move(generator), start_index);
+    return RankingFunction<T, Policy>(head, deduplicate);
+}
+
+/**
+ * @brief Create a ranking function from a generator that produces batches.
+ *
+ * The generator is called as `generator(first_index, batch)` and appends the
+ * (value, rank) pairs for consecutive indices starting at first_index; see
+ * make_batched_sequence(). Use it when producing many elements at once is
+ * cheaper than one at a time (a table scan, a vectorised kernel, a paged
+ * query). An empty batch ends the ranking. The generator is stored once,
+ * however many elements are forced.
+ *
+ * @tparam T The value type
+ * @tparam F The batch generator type (deduced from generator)
+ * @param generator Function appending the batch that starts at a given index
+ * @param start_index The index passed to the first call (default: 0)
+ * @param deduplicate If true, enable deduplication (default: true)
+ * @return RankingFunction over all batches, in order
+ *
+ * Example:
+ * @code
+ * auto rf = from_batch_generator<int>(
+ *     [](std::size_t first, std::vector<std::pair<int, Rank>>& batch) {
+ *         for (std::size_t i = first; i < first + 16; ++i) {
+ *             batch.emplace_back(static_cast<int>(i), Rank::from_value(i));
+ *         }
+ *     });
+ * @endcode
+ */
+template<EqualityComparableValue T, typename Policy = DefaultPromisePolicy, typename F>
+requires std::invocable<F&, std::size_t, std::vector<std::pair<T, Rank>>&>
+[[nodiscard]] RankingFunction<T, Policy> from_batch_generator(
     F generator,
     std::size_t start_index = 0,
     Deduplication deduplicate = Deduplication::Enabled)
 {
-    auto head = make_infinite_sequence<T>(
-        [gen = std::move(generator)](std::size_t i) {
-            return gen(i);
-        },
-        start_index
-    );
-    
-    return RankingFunction<T>(head, deduplicate);
+    return RankingFunction<T, Policy>(
+        make_batched_sequence<T, Policy>(std::move(generator), start_index), deduplicate);
 }
 
 /**
@@ -251,7 +307,8 @@ requires std::invocable<F, std::size_t> &&
  * @return RankingFunction containing the range values
  *
  * @note This eagerly evaluates the range into a vector, then constructs
- *       the ranking function. For infinite ranges, this will not terminate.
+ *       the ranking function. For infinite ranges, this will not terminate;
+ *       lazy_from_range() reads the range on demand instead.
  *
  * Example:
  * @code
@@ -260,7 +317,7 @@ requires std::invocable<F, std::size_t> &&
  * // Creates: 2@0, 4@1
  * @endcode
  */
-template<std::ranges::input_range R>
+template<typename Policy = DefaultPromisePolicy, std::ranges::input_range R>
 [[nodiscard]] auto from_range(
     R&& range,
     Rank start_rank = Rank::zero(),
@@ -273,7 +330,7 @@ template<std::ranges::input_range R>
         values.push_back(std::forward<decltype(value)>(value));
     }
     
-    return from_values_sequential(values, start_rank, deduplicate);
+    return from_values_sequential<T, Policy>(values, start_rank, deduplicate);
 }
 
 /**
@@ -293,7 +350,7 @@ template<std::ranges::input_range R>
  * auto rf = from_pair_range(map);
  * @endcode
  */
-template<std::ranges::input_range R>
+template<typename Policy = DefaultPromisePolicy, std::ranges::input_range R>
 requires requires(R r) {
     { std::ranges::range_value_t<R>::first } -> std::convertible_to<typename std::ranges::range_value_t<R>::first_type>;
     { std::ranges::range_value_t<R>::second } -> std::convertible_to<Rank>;
@@ -311,7 +368,143 @@ requires requires(R r) {
         pairs.emplace_back(value, rank);
     }
     
-    return from_list<T>(pairs, deduplicate);
+    return from_list<T, Policy>(pairs, deduplicate);
+}
+
+namespace detail {
+
+/**
+ * @brief Batch generator pulling elements from a range on demand.
+ *
+ * Holds the view and its iterator; make_batched_sequence() stores one reader
+ * per ranking and calls it each time the ranking's tail is forced. The
+ * iterator is advanced past an element only when the next one is wanted, so
+ * single-pass ranges such as std::views::istream never read ahead of the
+ * forced prefix.
+ *
+ * @tparam View The view over the source range.
+ * @tparam Make Callable mapping (element, index) to a (value, rank) pair.
+ */
+template<std::ranges::input_range View, typename Make>
+struct RangeReader {
+    View view;
+    Make make;
+    std::size_t chunk_size;
+    std::optional<std::ranges::iterator_t<View>> position;
+    bool consumed = false;  ///< Whether *position has been taken already
+
+    template<typename T>
+    void operator()(std::size_t first, std::vector<std::pair<T, Rank>>& batch) {
+        if (!position) {
+            position.emplace(std::ranges::begin(view));
+        }
+        auto& it = *position;
+        for (std::size_t i = 0; i < chunk_size; ++i) {
+            if (consumed) {
+                ++it;
+                consumed = false;
+            }
+            if (it == std::ranges::end(view)) {
+                return;
+            }
+            batch.push_back(make(*it, first + i));
+            consumed = true;
+        }
+    }
+};
+
+/// Build the ranking over a RangeReader for @p range.
+template<typename T, typename Policy, typename R, typename Make>
+[[nodiscard]] RankingFunction<T, Policy> read_range(R&& range,
+                                                    Make make,
+                                                    Deduplication deduplicate,
+                                                    std::size_t chunk_size) {
+    chunk_size = chunk_size == 0 ? 1 : chunk_size;
+    using Reader = RangeReader<std::views::all_t<R>, Make>;
+    auto head = make_batched_sequence<T, Policy>(
+        Reader{std::views::all(std::forward<R>(range)), std::move(make), chunk_size, std::nullopt});
+    return RankingFunction<T, Policy>(std::move(head), deduplicate, chunk_size);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Create a ranking function that reads a range lazily.
+ *
+ * Like from_range(), but keeps the range's iterator in the ranking and pulls
+ * @p chunk_size elements each time the ranking's tail is forced, instead of
+ * copying the whole range first. Unbounded and single-pass ranges work
+ * (std::views::iota, std::views::istream, generator-backed views), the first
+ * element is available before the rest of the input has been read, and only
+ * the forced prefix is held in memory.
+ *
+ * An rvalue range (including a view pipeline) is moved into the ranking; an
+ * lvalue range is referenced and must outlive the ranking and stay
+ * unmodified while it is read. The range is read from at most one thread at
+ * a time, in order.
+ *
+ * @tparam R The range type (deduced from range)
+ * @param range The input range of values
+ * @param start_rank The rank for the first value (default: Rank::zero())
+ * @param deduplicate If true, enable deduplication (default: true)
+ * @param chunk_size Elements read per lazy step (default: 1)
+ * @return RankingFunction with ranks start_rank, start_rank + 1, ...
+ *
+ * Example:
+ * @code
+ * std::ifstream log("events.txt");
+ * auto events = lazy_from_range(std::views::istream<Event>(log));
+ * auto first = take_n(filter(events, is_error), 10);  // reads only what it needs
+ * @endcode
+ */
+template<typename Policy = DefaultPromisePolicy, std::ranges::input_range R>
+requires std::ranges::viewable_range<R>
+[[nodiscard]] auto lazy_from_range(
+    R&& range,
+    Rank start_rank = Rank::zero(),
+    Deduplication deduplicate = Deduplication::Enabled,
+    std::size_t chunk_size = 1)
+{
+    using T = std::ranges::range_value_t<R>;
+    return detail::read_range<T, Policy>(
+        std::forward<R>(range),
+        [start_rank](auto&& value, std::size_t index) {
+            return std::pair<T, Rank>(std::forward<decltype(value)>(value),
+                                      start_rank + Rank::from_value(index));
+        },
+        deduplicate, chunk_size);
+}
+
+/**
+ * @brief Create a ranking function that reads a range of value-rank pairs lazily.
+ *
+ * The lazy counterpart of from_pair_range(); see lazy_from_range() for how
+ * the range is read and owned. As with from_pair_range(), the pairs are
+ * taken in range order, so their ranks should be non-decreasing.
+ *
+ * @tparam R The range type (deduced from range)
+ * @param range The input range of (value, rank) pairs
+ * @param deduplicate If true, enable deduplication (default: true)
+ * @param chunk_size Pairs read per lazy step (default: 1)
+ * @return RankingFunction containing the pairs
+ */
+template<typename Policy = DefaultPromisePolicy, std::ranges::input_range R>
+requires std::ranges::viewable_range<R> && requires(R r) {
+    { std::ranges::range_value_t<R>::first } -> std::convertible_to<typename std::ranges::range_value_t<R>::first_type>;
+    { std::ranges::range_value_t<R>::second } -> std::convertible_to<Rank>;
+}
+[[nodiscard]] auto lazy_from_pair_range(
+    R&& range,
+    Deduplication deduplicate = Deduplication::Enabled,
+    std::size_t chunk_size = 1)
+{
+    using T = std::remove_const_t<typename std::ranges::range_value_t<R>::first_type>;
+    return detail::read_range<T, Policy>(
+        std::forward<R>(range),
+        [](const auto& pair, std::size_t) {
+            return std::pair<T, Rank>(pair.first, pair.second);
+        },
+        deduplicate, chunk_size);
 }
 
 /**
@@ -324,9 +517,15 @@ requires requires(R r) {
  * @param rank The rank (default: Rank::zero())
  * @return RankingFunction with single element
  */
-template<ValueType T>
-[[nodiscard]] RankingFunction<T> singleton(T value, Rank rank = Rank::zero()) {
-    return make_singleton_ranking(std::move(value), rank);
+template<ValueType T, typename Policy = DefaultPromisePolicy>
+[[nodiscard]] RankingFunction<T, Policy> singleton(T value, Rank rank = Rank::zero()) {
+    if constexpr (Internable<T> && std::is_same_v<Policy, DefaultPromisePolicy>) {
+        if (const auto table = current_intern_table<T>()) {
+            const std::pair<T, Rank> element{std::move(value), rank};
+            return table->intern(std::span(&element, 1), Deduplication::Enabled);
+        }
+    }
+    return make_singleton_ranking<T, Policy>(std::move(value), rank);
 }
 
 /**
@@ -337,11 +536,11 @@ template<ValueType T>
  * @tparam T The value type
  * @return Empty RankingFunction
  */
-template<ValueType T>
-[[nodiscard]] RankingFunction<T> empty() {
-    return make_empty_ranking<T>();
+template<ValueType T, typename Policy = DefaultPromisePolicy>
+[[nodiscard]] RankingFunction<T, Policy> empty() {
+    return make_empty_ranking<T, Policy>();
 }
 
-} // namespace ranked_belief
+} // namespace ranked_belief::inline RANKED_BELIEF_ABI
 
 #endif // RANKED_BELIEF_CONSTRUCTORS_HPP
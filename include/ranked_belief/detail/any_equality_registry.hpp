@@ -1,23 +1,69 @@
 #ifndef RANKED_BELIEF_DETAIL_ANY_EQUALITY_REGISTRY_HPP
 #define RANKED_BELIEF_DETAIL_ANY_EQUALITY_REGISTRY_HPP
 
+#include "ranked_belief/abi.hpp"
+
 #include <any>
+#include <atomic>
 #include <cstddef>
 #include <mutex>
 #include <string>
 #include <typeindex>
 #include <unordered_map>
 
-namespace ranked_belief::detail {
+namespace ranked_belief::inline RANKED_BELIEF_ABI::detail {
 
 using AnyEqualityFn = bool (*)(const std::any&, const std::any&);
 
-inline std::unordered_map<std::type_index, AnyEqualityFn>& any_equality_registry()
+/**
+ * @brief Immutable view of the registered equality functions.
+ *
+ * Registration publishes a new table (copy, insert, atomic store) and never
+ * modifies a published one, so lookups read the current table with one
+ * acquire load and no lock (read-copy-update). Replaced tables are never
+ * freed, since a reader may still be using one; registrations happen a
+ * handful of times per process, so they are cheap to keep.
+ */
+struct AnyEqualityTable {
+    std::unordered_map<std::type_index, AnyEqualityFn> functions;
+};
+
+template<typename T>
+inline bool any_equals_cast(const std::any& lhs, const std::any& rhs)
+{
+    return std::any_cast<const T&>(lhs) == std::any_cast<const T&>(rhs);
+}
+
+template<typename T>
+inline void add_any_equality(AnyEqualityTable& table)
+{
+    table.functions[std::type_index(typeid(T))] = &any_equals_cast<T>;
+}
+
+inline const AnyEqualityTable* make_builtin_any_equalities()
+{
+    auto* table = new AnyEqualityTable();
+    add_any_equality<std::nullptr_t>(*table);
+    add_any_equality<bool>(*table);
+    add_any_equality<int>(*table);
+    add_any_equality<long>(*table);
+    add_any_equality<long long>(*table);
+    add_any_equality<unsigned long>(*table);
+    add_any_equality<unsigned long long>(*table);
+    add_any_equality<float>(*table);
+    add_any_equality<double>(*table);
+    add_any_equality<std::string>(*table);
+    return table;
+}
+
+/// The published table; starts out with the built-in types.
+inline std::atomic<const AnyEqualityTable*>& any_equality_table()
 {
-    static auto& registry = *new std::unordered_map<std::type_index, AnyEqualityFn>();
-    return registry;
+    static auto& table = *new std::atomic<const AnyEqualityTable*>(make_builtin_any_equalities());
+    return table;
 }
 
+/// Serialises registrations; lookups never take it.
 inline std::mutex& any_equality_registry_mutex()
 {
     static auto& mutex = *new std::mutex();
@@ -27,13 +73,10 @@ inline std::mutex& any_equality_registry_mutex()
 inline void register_any_equality(std::type_index type, AnyEqualityFn fn)
 {
     std::scoped_lock lock(any_equality_registry_mutex());
-    any_equality_registry()[type] = fn;
-}
-
-template<typename T>
-inline bool any_equals_cast(const std::any& lhs, const std::any& rhs)
-{
-    return std::any_cast<const T&>(lhs) == std::any_cast<const T&>(rhs);
+    auto& published = any_equality_table();
+    auto* table = new AnyEqualityTable(*published.load(std::memory_order_relaxed));
+    table->functions[type] = fn;
+    published.store(table, std::memory_order_release);
 }
 
 template<typename T>
@@ -42,28 +85,16 @@ inline void register_any_equality()
     register_any_equality(std::type_index(typeid(T)), &any_equals_cast<T>);
 }
 
-inline void register_builtin_any_equalities()
+/// Equality function registered for @p type, or nullptr. Lock-free.
+[[nodiscard]] inline AnyEqualityFn find_any_equality(std::type_index type)
 {
-    static const bool registered = [] {
-        register_any_equality<std::nullptr_t>();
-        register_any_equality<bool>();
-        register_any_equality<int>();
-        register_any_equality<long>();
-        register_any_equality<long long>();
-        register_any_equality<unsigned long>();
-        register_any_equality<unsigned long long>();
-        register_any_equality<float>();
-        register_any_equality<double>();
-        register_any_equality<std::string>();
-        return true;
-    }();
-    (void)registered;
+    const AnyEqualityTable* table = any_equality_table().load(std::memory_order_acquire);
+    const auto it = table->functions.find(type);
+    return it == table->functions.end() ? nullptr : it->second;
 }
 
 inline bool any_values_equal(const std::any& lhs, const std::any& rhs)
 {
-    register_builtin_any_equalities();
-
     if (!lhs.has_value() && !rhs.has_value()) {
         return true;
     }
@@ -74,17 +105,7 @@ inline bool any_values_equal(const std::any& lhs, const std::any& rhs)
         return false;
     }
 
-    const auto type = std::type_index(lhs.type());
-
-    AnyEqualityFn fn = nullptr;
-    {
-        std::scoped_lock lock(any_equality_registry_mutex());
-        auto it = any_equality_registry().find(type);
-        if (it != any_equality_registry().end()) {
-            fn = it->second;
-        }
-    }
-
+    const AnyEqualityFn fn = find_any_equality(std::type_index(lhs.type()));
     if (!fn) {
         return false;
     }
@@ -92,6 +113,6 @@ inline bool any_values_equal(const std::any& lhs, const std::any& rhs)
     return fn(lhs, rhs);
 }
 
-} // namespace ranked_belief::detail
+} // namespace ranked_belief::inline RANKED_BELIEF_ABI::detail
 
 #endif // RANKED_BELIEF_DETAIL_ANY_EQUALITY_REGISTRY_HPP
@@ -0,0 +1,76 @@
+/**
+ * @file coroutine_frame.hpp
+ * @brief Coroutine frame allocation from the current NodePool.
+ *
+ * Promise types of the library's coroutines derive from PooledFrame, so a
+ * coroutine called while a NodePoolScope is active places its frame in that
+ * pool; otherwise the frame comes from the global heap. A small header in
+ * front of the frame records the pool, keeping it alive until the frame is
+ * released.
+ */
+
+#ifndef RANKED_BELIEF_DETAIL_COROUTINE_FRAME_HPP
+#define RANKED_BELIEF_DETAIL_COROUTINE_FRAME_HPP
+
+#include "ranked_belief/node_pool.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace ranked_belief::inline RANKED_BELIEF_ABI::detail {
+
+/**
+ * @brief Header stored in front of a coroutine frame, recording where it came from.
+ */
+struct FrameHeader {
+    std::shared_ptr<NodePool> pool;  ///< Pool the frame was carved from (null: global heap)
+};
+
+/// Header size rounded up so the frame keeps the default new alignment.
+inline constexpr std::size_t kFrameHeaderSize =
+    (sizeof(FrameHeader) + __STDCPP_DEFAULT_NEW_ALIGNMENT__ - 1) /
+    __STDCPP_DEFAULT_NEW_ALIGNMENT__ * __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+/**
+ * @brief Allocate a coroutine frame from the current NodePool, or the heap.
+ */
+[[nodiscard]] inline void* allocate_frame(std::size_t size) {
+    auto pool = current_node_pool();
+    const std::size_t total = size + kFrameHeaderSize;
+    void* raw = pool ? pool->allocate(total, __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                     : ::operator new(total);
+    ::new (raw) FrameHeader{std::move(pool)};
+    return static_cast<std::byte*>(raw) + kFrameHeaderSize;
+}
+
+/**
+ * @brief Release a frame obtained from allocate_frame().
+ */
+inline void deallocate_frame(void* frame, std::size_t size) noexcept {
+    void* raw = static_cast<std::byte*>(frame) - kFrameHeaderSize;
+    auto* header = static_cast<FrameHeader*>(raw);
+    auto pool = std::move(header->pool);
+    header->~FrameHeader();
+    if (pool) {
+        pool->deallocate(raw, size + kFrameHeaderSize, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    } else {
+        ::operator delete(raw);
+    }
+}
+
+/**
+ * @brief Base for promise types whose frames are allocated with allocate_frame().
+ */
+struct PooledFrame {
+    static void* operator new(std::size_t size) { return allocate_frame(size); }
+
+    static void operator delete(void* frame, std::size_t size) noexcept {
+        deallocate_frame(frame, size);
+    }
+};
+
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI::detail
+
+#endif  // RANKED_BELIEF_DETAIL_COROUTINE_FRAME_HPP
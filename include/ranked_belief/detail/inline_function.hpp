@@ -0,0 +1,148 @@
+/**
+ * @file inline_function.hpp
+ * @brief Move-only nullary callable with small-buffer storage.
+ *
+ * InlineFunction<R> is the callable holder used by both Promise policies.
+ * Unlike std::function it is move-only (so it accepts move-only captures) and
+ * stores callables of up to kInlineFunctionCapacity bytes inside the object,
+ * which covers the closures built by every lazy operation in the library.
+ * Larger callables fall back to one heap allocation.
+ */
+
+#ifndef RANKED_BELIEF_DETAIL_INLINE_FUNCTION_HPP
+#define RANKED_BELIEF_DETAIL_INLINE_FUNCTION_HPP
+
+#include "ranked_belief/abi.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ranked_belief::inline RANKED_BELIEF_ABI::detail {
+
+/// Bytes of inline storage reserved for a callable before spilling to the heap.
+inline constexpr std::size_t kInlineFunctionCapacity = 6 * sizeof(void*);
+
+/**
+ * @class InlineFunction
+ * @brief Type-erased, move-only `R()` callable with small-buffer optimisation.
+ *
+ * @tparam R The callable's return type.
+ */
+template<typename R>
+class InlineFunction {
+public:
+    InlineFunction() noexcept = default;
+
+    /**
+     * @brief Store @p callable, inline when it fits and is nothrow-movable.
+     */
+    template<typename F>
+    requires(!std::same_as<std::remove_cvref_t<F>, InlineFunction> &&
+             std::invocable<std::decay_t<F>&> &&
+             std::convertible_to<std::invoke_result_t<std::decay_t<F>&>, R>)
+    explicit InlineFunction(F&& callable) {
+        using Stored = std::decay_t<F>;
+        if constexpr (stored_inline<Stored>) {
+            ::new (static_cast<void*>(&storage_)) Stored(std::forward<F>(callable));
+        } else {
+            heap_ = new Stored(std::forward<F>(callable));
+        }
+        ops_ = &ops_for<Stored>;
+    }
+
+    InlineFunction(InlineFunction&& other) noexcept { take(other); }
+
+    InlineFunction& operator=(InlineFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    InlineFunction(const InlineFunction&) = delete;
+    InlineFunction& operator=(const InlineFunction&) = delete;
+
+    ~InlineFunction() { reset(); }
+
+    /**
+     * @brief Invoke the stored callable.
+     * @pre The function is non-empty.
+     */
+    R operator()() { return ops_->invoke(*this); }
+
+    [[nodiscard]] explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+    /**
+     * @brief Destroy the stored callable, leaving the function empty.
+     */
+    void reset() noexcept {
+        if (ops_) {
+            ops_->destroy(*this);
+            ops_ = nullptr;
+        }
+    }
+
+private:
+    struct Ops {
+        R (*invoke)(InlineFunction&);
+        void (*relocate)(InlineFunction& from, InlineFunction& to) noexcept;
+        void (*destroy)(InlineFunction&) noexcept;
+    };
+
+    template<typename Stored>
+    static constexpr bool stored_inline =
+        sizeof(Stored) <= kInlineFunctionCapacity &&
+        alignof(Stored) <= alignof(void*) &&
+        std::is_nothrow_move_constructible_v<Stored>;
+
+    template<typename Stored>
+    static Stored& target(InlineFunction& self) noexcept {
+        if constexpr (stored_inline<Stored>) {
+            return *std::launder(reinterpret_cast<Stored*>(&self.storage_));
+        } else {
+            return *static_cast<Stored*>(self.heap_);
+        }
+    }
+
+    template<typename Stored>
+    static constexpr Ops ops_for{
+        [](InlineFunction& self) -> R { return std::invoke(target<Stored>(self)); },
+        [](InlineFunction& from, InlineFunction& to) noexcept {
+            if constexpr (stored_inline<Stored>) {
+                Stored& source = target<Stored>(from);
+                ::new (static_cast<void*>(&to.storage_)) Stored(std::move(source));
+                source.~Stored();
+            } else {
+                to.heap_ = std::exchange(from.heap_, nullptr);
+            }
+        },
+        [](InlineFunction& self) noexcept {
+            if constexpr (stored_inline<Stored>) {
+                target<Stored>(self).~Stored();
+            } else {
+                delete static_cast<Stored*>(self.heap_);
+            }
+        }};
+
+    void take(InlineFunction& other) noexcept {
+        if (other.ops_) {
+            other.ops_->relocate(other, *this);
+            ops_ = std::exchange(other.ops_, nullptr);
+        }
+    }
+
+    union {
+        alignas(void*) std::byte storage_[kInlineFunctionCapacity];
+        void* heap_;
+    };
+    const Ops* ops_ = nullptr;  ///< Operations for the stored type (null when empty)
+};
+
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI::detail
+
+#endif  // RANKED_BELIEF_DETAIL_INLINE_FUNCTION_HPP
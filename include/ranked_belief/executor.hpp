@@ -0,0 +1,271 @@
+/**
+ * @file executor.hpp
+ * @brief Minimal task executor abstraction and a work-stealing thread pool.
+ *
+ * Operations that run work off the consumer's thread (see prefetch() in
+ * operations/prefetch.hpp) submit it to an Executor:
+ *
+ * - Executor: interface with a single submit() taking a move-only task
+ * - WorkStealingPool: fixed set of worker threads with per-worker deques
+ * - InlineExecutor: runs each task on the submitting thread
+ * - default_executor() / set_default_executor(): process-wide executor used
+ *   when an operation is not given one explicitly
+ *
+ * Tasks must not throw; an exception escaping a task is discarded. Work that
+ * can fail should capture its outcome itself (forcing a Promise does).
+ */
+
+#ifndef RANKED_BELIEF_EXECUTOR_HPP
+#define RANKED_BELIEF_EXECUTOR_HPP
+
+#include "detail/inline_function.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
+
+/**
+ * @class Executor
+ * @brief Runs submitted tasks, typically on other threads.
+ *
+ * Implementations must be safe to call submit() on from any thread, including
+ * from inside a running task, and must eventually run every submitted task.
+ */
+class Executor {
+public:
+    /// A move-only nullary task.
+    using Task = detail::InlineFunction<void>;
+
+    virtual ~Executor() = default;
+
+    /**
+     * @brief Schedule @p task to run.
+     */
+    virtual void submit(Task task) = 0;
+};
+
+/**
+ * @class InlineExecutor
+ * @brief Executor that runs each task immediately on the submitting thread.
+ *
+ * Useful to disable background work without changing call sites.
+ */
+class InlineExecutor final : public Executor {
+public:
+    void submit(Task task) override {
+        try {
+            task();
+        } catch (...) {
+            // Tasks must not throw (see executor.hpp).
+        }
+    }
+};
+
+/**
+ * @class WorkStealingPool
+ * @brief Fixed-size thread pool with one task deque per worker.
+ *
+ * A task submitted from one of the pool's workers goes to the back of that
+ * worker's deque and is popped from the back (LIFO), which keeps follow-up
+ * work on the thread whose caches hold its data. Tasks from other threads are
+ * distributed round-robin. An idle worker steals from the front of the other
+ * deques before going to sleep.
+ *
+ * The destructor lets the workers run every task already submitted, then joins
+ * them. Tasks may own the pool (for example through the shared state of a
+ * prefetch); if the last owner is released by a task, the worker running it
+ * is detached instead of joined and exits once the queues are empty.
+ */
+class WorkStealingPool final : public Executor {
+public:
+    /**
+     * @brief Start @p threads workers (at least one).
+     *
+     * @param threads Number of workers; defaults to the hardware concurrency.
+     */
+    explicit WorkStealingPool(std::size_t threads = std::thread::hardware_concurrency())
+        : core_(std::make_shared<Core>(std::max<std::size_t>(threads, 1)))
+    {
+        workers_.reserve(core_->queues.size());
+        for (std::size_t i = 0; i < core_->queues.size(); ++i) {
+            workers_.emplace_back([core = core_, i]() { core->run(i); });
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    ~WorkStealingPool() override {
+        {
+            std::lock_guard lock(core_->sleep_mutex);
+            core_->stopping = true;
+        }
+        core_->wake.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.get_id() == std::this_thread::get_id()) {
+                worker.detach();
+            } else {
+                worker.join();
+            }
+        }
+    }
+
+    void submit(Task task) override { core_->submit(std::move(task)); }
+
+    /// Number of worker threads.
+    [[nodiscard]] std::size_t size() const noexcept { return workers_.size(); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /// State shared with the workers, which keep it alive until they exit.
+    struct Core {
+        explicit Core(std::size_t threads) {
+            queues.reserve(threads);
+            for (std::size_t i = 0; i < threads; ++i) {
+                queues.push_back(std::make_unique<Queue>());
+            }
+        }
+
+        void submit(Task task) {
+            const std::size_t index = current_worker_core == this
+                ? current_worker_index
+                : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+            // Count the task before it becomes visible, so a worker that pops
+            // it at once never decrements pending below zero. Until the push
+            // lands, a woken worker just finds the deques empty and retries.
+            pending.fetch_add(1, std::memory_order_release);
+            try {
+                std::lock_guard lock(queues[index]->mutex);
+                queues[index]->tasks.push_back(std::move(task));
+            } catch (...) {
+                pending.fetch_sub(1, std::memory_order_relaxed);
+                throw;
+            }
+            {
+                // Taking the lock orders this notify after a sleeper's predicate check.
+                std::lock_guard lock(sleep_mutex);
+            }
+            wake.notify_one();
+        }
+
+        /// Pop from the back of worker @p index's deque, else steal from the front of another.
+        bool try_pop(std::size_t index, Task& task) {
+            {
+                auto& own = *queues[index];
+                std::lock_guard lock(own.mutex);
+                if (!own.tasks.empty()) {
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    return true;
+                }
+            }
+            for (std::size_t offset = 1; offset < queues.size(); ++offset) {
+                auto& victim = *queues[(index + offset) % queues.size()];
+                std::lock_guard lock(victim.mutex);
+                if (!victim.tasks.empty()) {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void run(std::size_t index) {
+            current_worker_core = this;
+            current_worker_index = index;
+            for (;;) {
+                Task task;
+                if (try_pop(index, task)) {
+                    pending.fetch_sub(1, std::memory_order_relaxed);
+                    try {
+                        task();
+                    } catch (...) {
+                        // Tasks must not throw (see executor.hpp).
+                    }
+                    continue;
+                }
+                std::unique_lock lock(sleep_mutex);
+                wake.wait(lock, [this]() {
+                    return stopping || pending.load(std::memory_order_acquire) > 0;
+                });
+                if (stopping && pending.load(std::memory_order_acquire) == 0) {
+                    return;
+                }
+            }
+        }
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::atomic<std::size_t> pending{0};     ///< Tasks submitted and not yet popped
+        std::atomic<std::size_t> next_queue{0};  ///< Round-robin cursor for external submits
+        std::mutex sleep_mutex;
+        std::condition_variable wake;
+        bool stopping = false;                   ///< Guarded by sleep_mutex
+    };
+
+    static inline thread_local const Core* current_worker_core = nullptr;
+    static inline thread_local std::size_t current_worker_index = 0;
+
+    std::shared_ptr<Core> core_;
+    std::vector<std::thread> workers_;
+};
+
+namespace detail {
+
+struct DefaultExecutorSlot {
+    std::mutex mutex;
+    std::shared_ptr<Executor> executor;
+};
+
+inline DefaultExecutorSlot& default_executor_slot() {
+    static DefaultExecutorSlot slot;
+    return slot;
+}
+
+}  // namespace detail
+
+/**
+ * @brief The process-wide executor used when none is given explicitly.
+ *
+ * Unless replaced with set_default_executor(), this is a WorkStealingPool
+ * with one worker per hardware thread, created on first use.
+ */
+[[nodiscard]] inline std::shared_ptr<Executor> default_executor() {
+    auto& slot = detail::default_executor_slot();
+    std::lock_guard lock(slot.mutex);
+    if (!slot.executor) {
+        slot.executor = std::make_shared<WorkStealingPool>();
+    }
+    return slot.executor;
+}
+
+/**
+ * @brief Replace the process-wide executor.
+ *
+ * Operations already holding the previous executor keep using it.
+ *
+ * @param executor The new default; nullptr restores a lazily created WorkStealingPool.
+ * @return The previous default (nullptr if none had been created).
+ */
+inline std::shared_ptr<Executor> set_default_executor(std::shared_ptr<Executor> executor) {
+    auto& slot = detail::default_executor_slot();
+    std::lock_guard lock(slot.mutex);
+    return std::exchange(slot.executor, std::move(executor));
+}
+
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI
+
+#endif  // RANKED_BELIEF_EXECUTOR_HPP
@@ -0,0 +1,350 @@
+/**
+ * @file intern.hpp
+ * @brief Opt-in interning (hash-consing) of finite, fully forced rankings.
+ *
+ * Models often rebuild the same small ranking, such as a normal/exceptional
+ * boolean or a singleton, inside every merge_apply continuation. Each
+ * rebuild allocates fresh nodes, and rankings with distinct nodes never hit
+ * the pointer-equality shortcut in merge(). An InternTable maps the content
+ * of finite rankings (their values, ranks and deduplication setting) to one
+ * canonical ranking, so equal rankings share their nodes:
+ *
+ * - InternTable<T>::intern(elements) returns the canonical ranking for the
+ *   given (value, rank) pairs, building it on first use; a hit allocates
+ *   nothing.
+ * - InternTable<T>::intern(rf) returns the canonical ranking equal to @c rf
+ *   if @c rf is finite and its structure fully forced, and @c rf otherwise.
+ * - InternScope: RAII helper installing a table as the calling thread's
+ *   table for T. While one is installed, from_list() and singleton()
+ *   (constructors.hpp) return canonical rankings.
+ * - current_intern_tables() / InternTablesScope: capture every installed
+ *   table and reinstall the set later, as lazy operations do.
+ *
+ * Design decisions:
+ * - Interning is opt-in and per value type; T must be hashable with
+ *   std::hash and equality comparable.
+ * - Like the NodePool, installed tables are captured by merge_apply() and
+ *   normal_exceptional() when they are built, so continuations they run
+ *   later, outside the scope or on other threads, still intern. Other lazy
+ *   operations copy nodes rather than build rankings, and capture nothing.
+ * - Canonical rankings live as long as the table (or until clear()).
+ */
+
+#ifndef RANKED_BELIEF_INTERN_HPP
+#define RANKED_BELIEF_INTERN_HPP
+
+#include "rank.hpp"
+#include "ranking_element.hpp"
+#include "ranking_function.hpp"
+#include "types.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
+
+/**
+ * @concept Internable
+ * @brief Value types an InternTable can key on.
+ */
+template<typename T>
+concept Internable = std::equality_comparable<T> && requires(const T& value) {
+    { std::hash<T>{}(value) } -> std::convertible_to<std::size_t>;
+};
+
+/**
+ * @class InternTable
+ * @brief Maps ranking content to one canonical, shared ranking.
+ *
+ * Thread Safety: all members may be called concurrently; lookups take a
+ * mutex.
+ *
+ * Example:
+ * @code
+ * auto table = std::make_shared<InternTable<bool>>();
+ * auto a = table->intern({{true, Rank::zero()}, {false, Rank::from_value(1)}});
+ * auto b = table->intern({{true, Rank::zero()}, {false, Rank::from_value(1)}});
+ * assert(a.raw_head() == b.raw_head());
+ * @endcode
+ *
+ * @tparam T The value type.
+ */
+template<Internable T>
+class InternTable {
+public:
+    using Element = std::pair<T, Rank>;
+
+    /**
+     * @brief The canonical ranking with exactly @p elements, in order.
+     *
+     * On a miss the ranking is built (from the current NodePool) and becomes
+     * canonical; on a hit nothing is allocated. Like from_list(), the
+     * elements must be in rank order. The canonical ranking holds one node
+     * per element, duplicates included, so operations that walk raw nodes
+     * (take(), map_with_index()) see the same sequence as from_list().
+     */
+    [[nodiscard]] RankingFunction<T> intern(
+        std::span<const Element> elements,
+        Deduplication deduplicate = Deduplication::Enabled) {
+        const KeyView view{elements, deduplicate};
+        std::scoped_lock lock(mutex_);
+        if (const auto it = table_.find(view); it != table_.end()) {
+            ++hits_;
+            return it->second;
+        }
+        auto ranking = build(elements, deduplicate);
+        table_.emplace(Key{{elements.begin(), elements.end()}, deduplicate}, ranking);
+        return ranking;
+    }
+
+    /// @copydoc intern(std::span<const Element>, Deduplication)
+    [[nodiscard]] RankingFunction<T> intern(
+        std::initializer_list<Element> elements,
+        Deduplication deduplicate = Deduplication::Enabled) {
+        return intern(std::span<const Element>(elements.begin(), elements.size()), deduplicate);
+    }
+
+    /**
+     * @brief The canonical ranking equal to @p rf, if @p rf can be interned.
+     *
+     * Only finite rankings whose every tail is already forced are interned
+     * (their values are read, which forces any lazy values). Two rankings are
+     * equal if their nodes hold the same (value, rank) sequence, ranks read
+     * through the rank offset, and they agree on deduplication; this is the
+     * key intern(elements) uses for the same pairs. On a miss @p rf itself becomes canonical. Rankings with
+     * unforced tails are returned unchanged, so interning never forces the
+     * structure of a lazy ranking.
+     */
+    [[nodiscard]] RankingFunction<T> intern(const RankingFunction<T>& rf) {
+        for (auto node = rf.raw_head(); node; node = node->next()) {
+            if (!node->next_is_forced()) {
+                return rf;
+            }
+        }
+        std::vector<Element> elements;
+        for (auto node = rf.raw_head(); node; node = node->next()) {
+            elements.emplace_back(node->value(), rf.rank_of(*node));
+        }
+        const Deduplication deduplicate =
+            rf.is_deduplicating() ? Deduplication::Enabled : Deduplication::Disabled;
+        std::scoped_lock lock(mutex_);
+        const auto [it, inserted] = table_.try_emplace(Key{std::move(elements), deduplicate}, rf);
+        if (!inserted) {
+            ++hits_;
+        }
+        return it->second;
+    }
+
+    /// Number of canonical rankings held.
+    [[nodiscard]] std::size_t size() const {
+        std::scoped_lock lock(mutex_);
+        return table_.size();
+    }
+
+    /// Lookups answered with an existing canonical ranking.
+    [[nodiscard]] std::size_t hits() const {
+        std::scoped_lock lock(mutex_);
+        return hits_;
+    }
+
+    /// Release every canonical ranking.
+    void clear() {
+        Table cleared;  // destroyed after unlocking
+        std::scoped_lock lock(mutex_);
+        cleared.swap(table_);
+    }
+
+private:
+    struct Key {
+        std::vector<Element> elements;
+        Deduplication deduplicate;
+    };
+
+    struct KeyView {
+        std::span<const Element> elements;
+        Deduplication deduplicate;
+    };
+
+    /// Hash and equality shared by stored keys and borrowed views.
+    struct KeyOps {
+        using is_transparent = void;
+
+        [[nodiscard]] static KeyView view(const Key& key) noexcept {
+            return {key.elements, key.deduplicate};
+        }
+        [[nodiscard]] static KeyView view(const KeyView& key) noexcept { return key; }
+
+        template<typename K>
+        [[nodiscard]] std::size_t operator()(const K& key) const {
+            const KeyView v = view(key);
+            std::size_t seed = v.deduplicate == Deduplication::Enabled ? 1 : 0;
+            for (const auto& [value, rank] : v.elements) {
+                seed = combine(seed, std::hash<T>{}(value));
+                seed = combine(seed, std::hash<std::uint64_t>{}(rank.value_or(~std::uint64_t{0})));
+            }
+            return seed;
+        }
+
+        template<typename L, typename R>
+        [[nodiscard]] bool operator()(const L& lhs, const R& rhs) const {
+            const KeyView a = view(lhs);
+            const KeyView b = view(rhs);
+            return a.deduplicate == b.deduplicate
+                && std::equal(a.elements.begin(), a.elements.end(), b.elements.begin(), b.elements.end());
+        }
+
+        [[nodiscard]] static std::size_t combine(std::size_t seed, std::size_t hash) noexcept {
+            return seed ^ (hash + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+        }
+    };
+
+    using Table = std::unordered_map<Key, RankingFunction<T>, KeyOps, KeyOps>;
+
+    [[nodiscard]] static RankingFunction<T> build(
+        std::span<const Element> elements,
+        Deduplication deduplicate) {
+        std::shared_ptr<RankingElement<T>> head;
+        for (auto it = elements.rbegin(); it != elements.rend(); ++it) {
+            head = make_element(it->first, it->second, std::move(head));
+        }
+        return RankingFunction<T>(std::move(head), deduplicate);
+    }
+
+    mutable std::mutex mutex_;
+    Table table_;
+    std::size_t hits_ = 0;
+};
+
+namespace detail {
+
+/**
+ * @brief Intern tables installed on a thread, keyed by value type.
+ *
+ * Immutable once installed: scopes install an extended copy, so lazy
+ * operations can capture the whole set by copying one pointer.
+ */
+struct InternContext {
+    std::unordered_map<std::type_index, std::shared_ptr<void>> tables;
+};
+
+/// Tables installed on the calling thread by the innermost scope.
+inline thread_local std::shared_ptr<const InternContext> current_intern_context_slot;
+
+}  // namespace detail
+
+/// Every intern table installed on a thread, as captured by lazy operations.
+using InternTables = std::shared_ptr<const detail::InternContext>;
+
+/**
+ * @brief Get the intern table for T installed on the calling thread.
+ *
+ * @return The innermost active table, or nullptr if none is installed.
+ */
+template<Internable T>
+[[nodiscard]] std::shared_ptr<InternTable<T>> current_intern_table() {
+    const auto& context = detail::current_intern_context_slot;
+    if (!context) {
+        return nullptr;
+    }
+    const auto it = context->tables.find(std::type_index(typeid(T)));
+    if (it == context->tables.end()) {
+        return nullptr;
+    }
+    return std::static_pointer_cast<InternTable<T>>(it->second);
+}
+
+/**
+ * @brief Get every intern table installed on the calling thread.
+ *
+ * merge_apply() and normal_exceptional() capture this at construction and
+ * reinstall it (with InternTablesScope) around the continuations they run
+ * later, possibly on other threads.
+ */
+[[nodiscard]] inline InternTables current_intern_tables() noexcept {
+    return detail::current_intern_context_slot;
+}
+
+/**
+ * @class InternScope
+ * @brief RAII guard that installs an intern table for T on the calling thread.
+ *
+ * Scopes nest: the previous table is restored when the scope ends. Passing
+ * nullptr temporarily disables interning of T. Tables for other value types
+ * stay installed.
+ *
+ * Example:
+ * @code
+ * InternScope scope(std::make_shared<InternTable<bool>>());
+ * auto a = from_list<bool>({{true, Rank::zero()}, {false, Rank::from_value(1)}});
+ * auto b = from_list<bool>({{true, Rank::zero()}, {false, Rank::from_value(1)}});
+ * // a and b share their nodes; merge(a, b) returns a's nodes directly.
+ * @endcode
+ */
+template<Internable T>
+class InternScope {
+public:
+    /**
+     * @brief Install @p table for the lifetime of this scope.
+     * @param table The table to install (may be nullptr).
+     */
+    explicit InternScope(std::shared_ptr<InternTable<T>> table)
+        : previous_(detail::current_intern_context_slot) {
+        auto context = previous_ ? std::make_shared<detail::InternContext>(*previous_)
+                                 : std::make_shared<detail::InternContext>();
+        context->tables[std::type_index(typeid(T))] = std::move(table);
+        detail::current_intern_context_slot = std::move(context);
+    }
+
+    InternScope(const InternScope&) = delete;
+    InternScope& operator=(const InternScope&) = delete;
+    InternScope(InternScope&&) = delete;
+    InternScope& operator=(InternScope&&) = delete;
+
+    ~InternScope() { detail::current_intern_context_slot = std::move(previous_); }
+
+private:
+    InternTables previous_;  ///< Tables restored on destruction
+};
+
+/**
+ * @class InternTablesScope
+ * @brief RAII guard that installs a captured set of intern tables.
+ *
+ * Used by lazy operations to run continuations with the tables that were
+ * installed when the operation was built.
+ */
+class InternTablesScope {
+public:
+    /**
+     * @brief Install @p tables for the lifetime of this scope.
+     * @param tables Tables from current_intern_tables() (may be nullptr).
+     */
+    explicit InternTablesScope(InternTables tables) noexcept
+        : previous_(std::exchange(detail::current_intern_context_slot, std::move(tables))) {}
+
+    InternTablesScope(const InternTablesScope&) = delete;
+    InternTablesScope& operator=(const InternTablesScope&) = delete;
+    InternTablesScope(InternTablesScope&&) = delete;
+    InternTablesScope& operator=(InternTablesScope&&) = delete;
+
+    ~InternTablesScope() { detail::current_intern_context_slot = std::move(previous_); }
+
+private:
+    InternTables previous_;  ///< Tables restored on destruction
+};
+
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI
+
+#endif  // RANKED_BELIEF_INTERN_HPP
@@ -0,0 +1,414 @@
+/**
+ * @file materialized_ranking.hpp
+ * @brief Contiguous, fully evaluated representation of finite rankings.
+ *
+ * MaterializedRanking<T> stores a finite ranking as two parallel arrays (values
+ * and ranks) instead of a linked list of lazily evaluated nodes. It offers the
+ * same range interface as RankingFunction, plus O(1) size() and random access.
+ * Walking it is a linear scan over contiguous memory, which makes it the right
+ * representation for finite tables that are read many times.
+ *
+ * Conversions:
+ * - materialize(rf) forces a (finite) RankingFunction into a MaterializedRanking
+ *   in one pass.
+ * - to_ranking_function() exposes a MaterializedRanking as a lazy
+ *   RankingFunction in O(1); nodes are created only as the result is walked and
+ *   share the materialized storage.
+ *
+ * Overloads of take_n, most_normal (nrm_exc.hpp) and observe (observe.hpp)
+ * operate on MaterializedRanking directly without building nodes.
+ */
+
+#ifndef RANKED_BELIEF_MATERIALIZED_RANKING_HPP
+#define RANKED_BELIEF_MATERIALIZED_RANKING_HPP
+
+#include "node_pool.hpp"
+#include "promise.hpp"
+#include "rank.hpp"
+#include "ranking_element.hpp"
+#include "ranking_function.hpp"
+#include "ranking_iterator.hpp"
+#include "types.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
+
+namespace detail {
+
+/// Wrapper that keeps std::vector<bool> from bit-packing materialized values.
+template<typename T>
+struct ValueSlot {
+    T value;
+};
+
+/// Contiguous storage for materialized values (never std::vector<bool>).
+template<typename T>
+using MaterializedValues =
+    std::vector<std::conditional_t<std::is_same_v<T, bool>, ValueSlot<bool>, T>>;
+
+/**
+ * @brief Shared, immutable structure-of-arrays storage.
+ */
+template<typename T>
+struct MaterializedStorage {
+    MaterializedValues<T> values;  ///< Values in rank order
+    std::vector<Rank> ranks;       ///< ranks[i] is the rank of values[i]
+};
+
+template<typename T>
+[[nodiscard]] const T& stored_value(const MaterializedValues<T>& values, std::size_t index) {
+    if constexpr (std::is_same_v<T, bool>) {
+        return values[index].value;
+    } else {
+        return values[index];
+    }
+}
+
+/**
+ * @brief Build the lazy node for position @p index of @p storage.
+ *
+ * The node's successor is created only when forced, so exposing a
+ * materialized ranking lazily costs one node per element actually visited.
+ */
+template<typename T>
+[[nodiscard]] std::shared_ptr<RankingElement<T>> materialized_node(
+    std::shared_ptr<const MaterializedStorage<T>> storage,
+    std::size_t index,
+    const std::shared_ptr<NodePool>& pool)
+{
+    if (index >= storage->ranks.size()) {
+        return nullptr;
+    }
+    const T& value = stored_value<T>(storage->values, index);
+    const Rank rank = storage->ranks[index];
+    return allocate_pooled<RankingElement<T>>(
+        pool,
+        value,
+        rank,
+        make_promise([storage = std::move(storage), index, pool]() {
+            return materialized_node<T>(storage, index + 1, pool);
+        }));
+}
+
+}  // namespace detail
+
+/**
+ * @class MaterializedRanking
+ * @brief A finite ranking stored as contiguous value and rank arrays.
+ *
+ * The ranking is immutable after construction and cheap to copy: copies share
+ * the same storage. Ranks must be non-decreasing. When deduplication is
+ * enabled, consecutive equal values are collapsed once at construction
+ * (keeping the first, lowest-ranked occurrence), so size() and indexing
+ * always refer to the deduplicated sequence.
+ *
+ * @tparam T The value type.
+ *
+ * Example:
+ * @code
+ * MaterializedRanking<int> table({1, 2, 3}, {Rank::zero(), Rank::from_value(1), Rank::from_value(1)});
+ * table.size();      // 3
+ * table.value(2);    // 3
+ * for (auto [value, rank] : table) { ... }
+ * auto lazy = table.to_ranking_function();  // O(1)
+ * @endcode
+ */
+template<typename T>
+class MaterializedRanking {
+public:
+    /// Value type yielded by iteration (matches RankingFunction)
+    using value_type = std::pair<T, Rank>;
+    using size_type = std::size_t;
+
+    /**
+     * @class iterator
+     * @brief Random-access iterator over (value, rank) pairs.
+     *
+     * Dereferencing yields a pair by value, like RankingIterator. Use
+     * MaterializedRanking::value() or values() to read without copying.
+     */
+    class iterator {
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::pair<T, Rank>;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type;
+
+        iterator() noexcept = default;
+
+        [[nodiscard]] value_type operator*() const {
+            return {detail::stored_value<T>(storage_->values, index_), storage_->ranks[index_]};
+        }
+
+        [[nodiscard]] value_type operator[](difference_type offset) const {
+            return *(*this + offset);
+        }
+
+        iterator& operator++() noexcept { ++index_; return *this; }
+        iterator operator++(int) noexcept { iterator tmp = *this; ++index_; return tmp; }
+        iterator& operator--() noexcept { --index_; return *this; }
+        iterator operator--(int) noexcept { iterator tmp = *this; --index_; return tmp; }
+
+        iterator& operator+=(difference_type offset) noexcept {
+            index_ = static_cast<std::size_t>(static_cast<difference_type>(index_) + offset);
+            return *this;
+        }
+        iterator& operator-=(difference_type offset) noexcept { return *this += -offset; }
+
+        [[nodiscard]] friend iterator operator+(iterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+        [[nodiscard]] friend iterator operator+(difference_type offset, iterator it) noexcept {
+            return it += offset;
+        }
+        [[nodiscard]] friend iterator operator-(iterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+        [[nodiscard]] friend difference_type operator-(const iterator& lhs, const iterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        [[nodiscard]] bool operator==(const iterator& other) const noexcept {
+            return index_ == other.index_;
+        }
+        [[nodiscard]] auto operator<=>(const iterator& other) const noexcept {
+            return index_ <=> other.index_;
+        }
+
+    private:
+        friend class MaterializedRanking;
+
+        iterator(const detail::MaterializedStorage<T>* storage, std::size_t index) noexcept
+            : storage_(storage), index_(index) {}
+
+        const detail::MaterializedStorage<T>* storage_ = nullptr;
+        std::size_t index_ = 0;
+    };
+
+    using const_iterator = iterator;
+
+    /**
+     * @brief Construct an empty ranking.
+     */
+    MaterializedRanking()
+        : storage_(std::make_shared<detail::MaterializedStorage<T>>()),
+          deduplicate_(true) {}
+
+    /**
+     * @brief Construct from parallel value and rank arrays.
+     *
+     * @param values Values in rank order.
+     * @param ranks Rank of each value (same length, non-decreasing).
+     * @param deduplicate Whether consecutive equal values are collapsed.
+     * @throws std::invalid_argument if the lengths differ or ranks decrease.
+     */
+    MaterializedRanking(std::vector<T> values,
+                        std::vector<Rank> ranks,
+                        Deduplication deduplicate = Deduplication::Enabled)
+        : deduplicate_(to_bool(deduplicate))
+    {
+        if (values.size() != ranks.size()) {
+            throw std::invalid_argument("MaterializedRanking requires one rank per value");
+        }
+        auto storage = std::make_shared<detail::MaterializedStorage<T>>();
+        if constexpr (std::is_same_v<T, bool>) {
+            storage->values.reserve(values.size());
+            for (bool value : values) {
+                storage->values.push_back({value});
+            }
+        } else {
+            storage->values = std::move(values);
+        }
+        storage->ranks = std::move(ranks);
+        finalize(*storage);
+        storage_ = std::move(storage);
+    }
+
+    /**
+     * @brief Construct from (value, rank) pairs, as accepted by from_list().
+     *
+     * @throws std::invalid_argument if ranks decrease.
+     */
+    explicit MaterializedRanking(const std::vector<std::pair<T, Rank>>& pairs,
+                                 Deduplication deduplicate = Deduplication::Enabled)
+        : deduplicate_(to_bool(deduplicate))
+    {
+        auto storage = std::make_shared<detail::MaterializedStorage<T>>();
+        storage->values.reserve(pairs.size());
+        storage->ranks.reserve(pairs.size());
+        for (const auto& [value, rank] : pairs) {
+            if constexpr (std::is_same_v<T, bool>) {
+                storage->values.push_back({value});
+            } else {
+                storage->values.push_back(value);
+            }
+            storage->ranks.push_back(rank);
+        }
+        finalize(*storage);
+        storage_ = std::move(storage);
+    }
+
+    /**
+     * @brief Number of elements. O(1).
+     */
+    [[nodiscard]] size_type size() const noexcept { return storage_->ranks.size(); }
+
+    /**
+     * @brief Whether the ranking has no elements.
+     */
+    [[nodiscard]] bool is_empty() const noexcept { return storage_->ranks.empty(); }
+
+    /**
+     * @brief Whether consecutive duplicates were collapsed at construction.
+     */
+    [[nodiscard]] bool is_deduplicating() const noexcept { return deduplicate_; }
+
+    /**
+     * @brief The (value, rank) pair at @p index (unchecked).
+     */
+    [[nodiscard]] value_type operator[](size_type index) const {
+        return {value(index), rank(index)};
+    }
+
+    /**
+     * @brief The value at @p index without copying (unchecked).
+     */
+    [[nodiscard]] const T& value(size_type index) const {
+        return detail::stored_value<T>(storage_->values, index);
+    }
+
+    /**
+     * @brief The rank at @p index (unchecked).
+     */
+    [[nodiscard]] Rank rank(size_type index) const noexcept { return storage_->ranks[index]; }
+
+    /**
+     * @brief The (value, rank) pair at @p index.
+     * @throws std::out_of_range if @p index >= size().
+     */
+    [[nodiscard]] value_type at(size_type index) const {
+        if (index >= size()) {
+            throw std::out_of_range("MaterializedRanking index out of range");
+        }
+        return (*this)[index];
+    }
+
+    /**
+     * @brief Contiguous view of all values (not available for bool).
+     */
+    [[nodiscard]] std::span<const T> values() const noexcept
+    requires(!std::is_same_v<T, bool>)
+    {
+        return storage_->values;
+    }
+
+    /**
+     * @brief Contiguous view of all ranks.
+     */
+    [[nodiscard]] std::span<const Rank> ranks() const noexcept { return storage_->ranks; }
+
+    /**
+     * @brief The first (most normal) element, or std::nullopt if empty.
+     */
+    [[nodiscard]] std::optional<value_type> first() const {
+        if (is_empty()) {
+            return std::nullopt;
+        }
+        return (*this)[0];
+    }
+
+    [[nodiscard]] iterator begin() const noexcept { return iterator(storage_.get(), 0); }
+    [[nodiscard]] iterator end() const noexcept { return iterator(storage_.get(), size()); }
+
+    /**
+     * @brief Expose this ranking as a lazy RankingFunction in O(1).
+     *
+     * The returned ranking shares this ranking's storage. Its nodes are built
+     * on demand (from the current thread's NodePool, if any) as it is walked.
+     */
+    [[nodiscard]] RankingFunction<T> to_ranking_function() const {
+        return RankingFunction<T>(
+            detail::materialized_node<T>(storage_, 0, current_node_pool()),
+            from_bool(deduplicate_));
+    }
+
+private:
+    /**
+     * @brief Validate rank order and collapse duplicates if requested.
+     */
+    void finalize(detail::MaterializedStorage<T>& storage) const {
+        auto& values = storage.values;
+        auto& ranks = storage.ranks;
+        for (std::size_t i = 1; i < ranks.size(); ++i) {
+            if (ranks[i] < ranks[i - 1]) {
+                throw std::invalid_argument("MaterializedRanking ranks must be non-decreasing");
+            }
+        }
+
+        if (!deduplicate_ || values.size() < 2) {
+            return;
+        }
+        // Same comparison as the iterator, so storage matches to_ranking_function().
+        std::size_t kept = 1;
+        for (std::size_t i = 1; i < values.size(); ++i) {
+            if (detail::duplicate_values<T>(detail::stored_value<T>(values, i),
+                                            detail::stored_value<T>(values, kept - 1))) {
+                continue;
+            }
+            if (i != kept) {
+                values[kept] = std::move(values[i]);
+                ranks[kept] = ranks[i];
+            }
+            ++kept;
+        }
+        values.erase(values.begin() + static_cast<std::ptrdiff_t>(kept), values.end());
+        ranks.resize(kept);
+    }
+
+    std::shared_ptr<const detail::MaterializedStorage<T>> storage_;  ///< Shared immutable arrays
+    bool deduplicate_;  ///< Whether duplicates were collapsed
+};
+
+/**
+ * @brief Force a finite ranking function into contiguous storage.
+ *
+ * Walks @p rf once (honouring its deduplication flag) and copies at most
+ * @p max_elements pairs.
+ *
+ * @tparam T The value type.
+ * @param rf The ranking to materialize.
+ * @param max_elements Upper bound on copied elements (default: unbounded).
+ * @return The materialized ranking.
+ *
+ * @warning Without a bound this does not terminate for infinite rankings.
+ */
+template<typename T>
+[[nodiscard]] MaterializedRanking<T> materialize(
+    const RankingFunction<T>& rf,
+    std::size_t max_elements = std::numeric_limits<std::size_t>::max())
+{
+    std::vector<T> values;
+    std::vector<Rank> ranks;
+    std::size_t count = 0;
+    for (auto it = rf.begin(); it != rf.end() && count < max_elements; ++it, ++count) {
+        auto [value, rank] = *it;
+        values.push_back(std::move(value));
+        ranks.push_back(rank);
+    }
+    return MaterializedRanking<T>(std::move(values), std::move(ranks), from_bool(rf.is_deduplicating()));
+}
+
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI
+
+#endif  // RANKED_BELIEF_MATERIALIZED_RANKING_HPP
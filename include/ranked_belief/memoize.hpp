@@ -0,0 +1,304 @@
+/**
+ * @file memoize.hpp
+ * @brief Memoized ranked functions keyed by argument.
+ *
+ * Recursive models often rebuild the same sub-ranking for the same argument
+ * in many branches of a merge_apply. memoize_ranked(f) wraps a function
+ * returning RankingFunction<T> so that each argument is evaluated once; later
+ * calls return the cached ranking. Copies of a RankingFunction share their
+ * nodes, so the cached ranking carries every element already forced through
+ * any earlier call: shared subproblems are forced once and reused.
+ *
+ * The cache can be bounded, evicting either the least recently used argument
+ * or the oldest one, and is guarded by a mutex unless the caller opts out.
+ *
+ * Recursion: the wrapped function may take the memoized function as its
+ * first parameter and call it for sub-arguments. That handle refers to the
+ * cache weakly, so rankings captured in the cache never keep it alive; once
+ * the memoized function is destroyed the handle simply stops caching.
+ */
+
+#ifndef RANKED_BELIEF_MEMOIZE_HPP
+#define RANKED_BELIEF_MEMOIZE_HPP
+
+#include "rank_horizon.hpp"
+#include "ranking_function.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
+
+/**
+ * @enum MemoEviction
+ * @brief Chooses which argument a bounded memo cache evicts when full.
+ */
+enum class MemoEviction : bool {
+    LeastRecentlyUsed = true,  ///< Evict the argument looked up least recently (default)
+    InsertionOrder = false     ///< Evict the argument cached first; hits never reorder
+};
+
+/**
+ * @enum MemoSynchronization
+ * @brief Controls whether a memoized function may be called from several threads.
+ */
+enum class MemoSynchronization : bool {
+    Synchronized = true,    ///< Cache guarded by a mutex (default)
+    Unsynchronized = false  ///< Single-threaded use only; avoids locking entirely
+};
+
+/**
+ * @brief Cache configuration for memoize_ranked().
+ */
+struct MemoOptions {
+    std::size_t capacity = 0;  ///< Most arguments kept; 0 keeps every argument
+    MemoEviction eviction = MemoEviction::LeastRecentlyUsed;
+    MemoSynchronization synchronization = MemoSynchronization::Synchronized;
+};
+
+namespace detail {
+
+/**
+ * @brief Argument-keyed cache of rankings with optional size bound.
+ *
+ * Entries live in a hash table; a list of pointers to their keys records
+ * the eviction order (most recent at the front).
+ */
+template<typename Arg, typename T, typename Hash, typename KeyEqual>
+class MemoTable {
+public:
+    explicit MemoTable(MemoOptions options)
+        : options_(options) {}
+
+    /// The cached ranking for @p arg, refreshing its position under LRU.
+    [[nodiscard]] std::optional<RankingFunction<T>> find(const Arg& arg) {
+        auto lock = guard();
+        const auto it = table_.find(arg);
+        if (it == table_.end()) {
+            ++misses_;
+            return std::nullopt;
+        }
+        ++hits_;
+        if (options_.eviction == MemoEviction::LeastRecentlyUsed) {
+            order_.splice(order_.begin(), order_, it->second.position);
+        }
+        return it->second.ranking;
+    }
+
+    /**
+     * @brief Cache @p ranking for @p arg and return the cached ranking.
+     *
+     * If another caller cached @p arg meanwhile, its ranking wins, so every
+     * caller shares one ranking per argument.
+     */
+    [[nodiscard]] RankingFunction<T> insert(const Arg& arg, RankingFunction<T> ranking) {
+        std::optional<RankingFunction<T>> evicted;  // destroyed after unlocking
+        auto lock = guard();
+        auto [it, inserted] = table_.try_emplace(arg, Slot{std::move(ranking), {}});
+        if (!inserted) {
+            return it->second.ranking;
+        }
+        order_.push_front(&it->first);
+        it->second.position = order_.begin();
+        if (options_.capacity != 0 && table_.size() > options_.capacity) {
+            const auto oldest = table_.find(*order_.back());
+            order_.pop_back();
+            evicted.emplace(std::move(oldest->second.ranking));
+            table_.erase(oldest);
+        }
+        return it->second.ranking;
+    }
+
+    [[nodiscard]] std::size_t size() {
+        auto lock = guard();
+        return table_.size();
+    }
+
+    [[nodiscard]] std::size_t hits() {
+        auto lock = guard();
+        return hits_;
+    }
+
+    [[nodiscard]] std::size_t misses() {
+        auto lock = guard();
+        return misses_;
+    }
+
+    void clear() {
+        std::unordered_map<Arg, Slot, Hash, KeyEqual> cleared;  // destroyed after unlocking
+        auto lock = guard();
+        order_.clear();
+        cleared.swap(table_);
+    }
+
+private:
+    using Order = std::list<const Arg*>;
+
+    struct Slot {
+        RankingFunction<T> ranking;
+        typename Order::iterator position;
+    };
+
+    [[nodiscard]] std::unique_lock<std::mutex> guard() {
+        if (options_.synchronization == MemoSynchronization::Synchronized) {
+            return std::unique_lock<std::mutex>(mutex_);
+        }
+        return std::unique_lock<std::mutex>(mutex_, std::defer_lock);
+    }
+
+    MemoOptions options_;
+    std::mutex mutex_;
+    std::unordered_map<Arg, Slot, Hash, KeyEqual> table_;
+    Order order_;
+    std::size_t hits_ = 0;
+    std::size_t misses_ = 0;
+};
+
+}  // namespace detail
+
+/**
+ * @class MemoizedRanked
+ * @brief A function returning rankings whose results are cached per argument.
+ *
+ * Copies share the function and the cache. The wrapped function receives the
+ * memoized function itself (as a non-owning handle) and the argument, so it
+ * can recurse through the cache.
+ *
+ * @tparam Arg Argument type; must be hashable with @p Hash and copyable.
+ * @tparam T Value type of the returned rankings.
+ */
+template<typename Arg, typename T, typename Hash = std::hash<Arg>, typename KeyEqual = std::equal_to<Arg>>
+class MemoizedRanked {
+public:
+    using Function = std::function<RankingFunction<T>(const MemoizedRanked&, const Arg&)>;
+
+    /**
+     * @brief Wrap @p function with a new, empty cache.
+     *
+     * @throws std::invalid_argument if @p function is empty.
+     */
+    explicit MemoizedRanked(Function function, MemoOptions options = {})
+        : function_(std::make_shared<const Function>(std::move(function)))
+        , owned_(std::make_shared<Table>(options))
+        , table_(owned_) {
+        if (!*function_) {
+            throw std::invalid_argument("memoize_ranked requires a callable function");
+        }
+    }
+
+    /**
+     * @brief The ranking for @p arg, computed on the first call and cached.
+     *
+     * The function runs outside the cache lock, so it may call the memoized
+     * function recursively. Should two threads miss on the same argument at
+     * once, both compute it but only the first result is kept and returned.
+     *
+     * The cached ranking is always built without a rank horizon: a ranking
+     * pruned for one caller's horizon (rank_horizon.hpp) would otherwise be
+     * served to callers that need the elements above it.
+     */
+    [[nodiscard]] RankingFunction<T> operator()(const Arg& arg) const {
+        const auto table = table_.lock();
+        if (!table) {
+            return (*function_)(*this, arg);
+        }
+        if (auto cached = table->find(arg)) {
+            return *std::move(cached);
+        }
+        RankHorizonScope unbounded(Rank::infinity());
+        auto ranking = owned_ ? (*function_)(MemoizedRanked(function_, table_), arg)
+                              : (*function_)(*this, arg);
+        return table->insert(arg, std::move(ranking));
+    }
+
+    /// Number of cached arguments (0 once the cache has been destroyed).
+    [[nodiscard]] std::size_t size() const { return with_table(&Table::size); }
+
+    /// Calls answered from the cache.
+    [[nodiscard]] std::size_t hits() const { return with_table(&Table::hits); }
+
+    /// Calls that had to evaluate the function.
+    [[nodiscard]] std::size_t misses() const { return with_table(&Table::misses); }
+
+    /// Drop every cached ranking.
+    void clear() const {
+        if (const auto table = table_.lock()) {
+            table->clear();
+        }
+    }
+
+private:
+    using Table = detail::MemoTable<Arg, T, Hash, KeyEqual>;
+
+    MemoizedRanked(std::shared_ptr<const Function> function, std::weak_ptr<Table> table)
+        : function_(std::move(function))
+        , table_(std::move(table)) {}
+
+    [[nodiscard]] std::size_t with_table(std::size_t (Table::*query)()) const {
+        const auto table = table_.lock();
+        return table ? ((*table).*query)() : 0;
+    }
+
+    std::shared_ptr<const Function> function_;
+    std::shared_ptr<Table> owned_;  ///< Null in the handle passed to the function
+    std::weak_ptr<Table> table_;
+};
+
+/**
+ * @brief Memoize a function returning rankings, keyed by its argument.
+ *
+ * @p f is called either as `f(arg)` or, for recursive models, as
+ * `f(self, arg)` where `self` is the memoized function. The value type is
+ * deduced for the first form; the recursive form needs it spelled out.
+ *
+ * @tparam Arg Argument type used as the cache key.
+ * @tparam T Value type of the rankings (deduced when @p f takes only @p arg).
+ * @param f Function returning RankingFunction<T>.
+ * @param options Cache bound, eviction policy and synchronization.
+ *
+ * Example:
+ * @code
+ * // Position after n steps, each normally +1 and exceptionally +2.
+ * auto walk = memoize_ranked<int, int>(
+ *     [](const auto& self, int n) -> RankingFunction<int> {
+ *         if (n == 0) return singleton(0);
+ *         return merge_apply(self(n - 1), [](int x) {
+ *             return normal_exceptional(singleton(x + 1), [x] { return singleton(x + 2); });
+ *         });
+ *     },
+ *     MemoOptions{.capacity = 1024});
+ * auto ranking = walk(30);  // each walk(k) is built once
+ * @endcode
+ */
+template<typename Arg, typename T = void, typename Hash = std::hash<Arg>,
+         typename KeyEqual = std::equal_to<Arg>, typename F>
+[[nodiscard]] auto memoize_ranked(F&& f, MemoOptions options = {}) {
+    if constexpr (std::is_void_v<T>) {
+        static_assert(std::is_invocable_v<std::decay_t<F>&, const Arg&>,
+                      "memoize_ranked: specify the value type T when f takes the memoized function");
+        using Ranking = std::decay_t<std::invoke_result_t<std::decay_t<F>&, const Arg&>>;
+        return memoize_ranked<Arg, typename Ranking::value_type::first_type, Hash, KeyEqual>(
+            std::forward<F>(f), options);
+    } else {
+        using Memoized = MemoizedRanked<Arg, T, Hash, KeyEqual>;
+        if constexpr (std::is_invocable_v<std::decay_t<F>&, const Memoized&, const Arg&>) {
+            return Memoized(typename Memoized::Function(std::forward<F>(f)), options);
+        } else {
+            return Memoized(
+                [f = std::forward<F>(f)](const Memoized&, const Arg& arg) { return f(arg); },
+                options);
+        }
+    }
+}
+
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI
+
+#endif  // RANKED_BELIEF_MEMOIZE_HPP
@@ -0,0 +1,301 @@
+/**
+ * @file node_pool.hpp
+ * @brief Pooled allocation for ranking sequence nodes.
+ *
+ * Every lazy operation in the library allocates one RankingElement per forced
+ * element. For large queries the general-purpose allocator dominates the cost
+ * of forcing, so this header provides an opt-in pooling layer:
+ *
+ * - NodePool: a size-class freelist arena built on std::pmr pool resources
+ * - NodeAllocator<T>: a standard allocator that keeps its pool alive
+ * - NodePoolScope: RAII helper installing a pool as the current thread's pool
+ *
+ * Factories in ranking_element.hpp accept an explicit pool and default to the
+ * current thread's pool. Operations in operations/ capture the pool that is
+ * current when they are constructed and allocate every node they later build
+ * (including nodes created while forcing lazy tails on other threads) from it.
+ * A ranking built under an Unsynchronized pool must therefore only be forced
+ * on the thread that built it.
+ *
+ * Design decisions:
+ * - Nodes are allocated with std::allocate_shared so the control block and the
+ *   node share one pooled allocation.
+ * - Each allocator holds a std::shared_ptr to its pool, so a pool outlives every
+ *   node carved from it regardless of the order in which scopes unwind.
+ * - Without an active pool the library falls back to std::make_shared, keeping
+ *   the default behaviour unchanged.
+ */
+
+#ifndef RANKED_BELIEF_NODE_POOL_HPP
+#define RANKED_BELIEF_NODE_POOL_HPP
+
+#include "abi.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
+
+/**
+ * @enum PoolSynchronization
+ * @brief Controls whether a NodePool may be shared between threads.
+ *
+ * Operations capture the pool they are built under, so a ranking built under
+ * an Unsynchronized pool allocates from it whenever its tails are forced.
+ * prefetch() and parallel_merge_apply() therefore run sequentially while such
+ * a pool is current, and rankings built under one must not be forced on other
+ * threads after its scope ends.
+ */
+enum class PoolSynchronization : bool {
+    Synchronized = true,    ///< Safe to allocate and release from any thread
+    Unsynchronized = false  ///< Single-threaded use only; avoids locking entirely
+};
+
+/**
+ * @class NodePool
+ * @brief Size-class freelist arena for ranking nodes and their control blocks.
+ *
+ * NodePool wraps a std::pmr pool resource. Allocations are served from
+ * per-size-class freelists carved out of large chunks obtained from the
+ * upstream resource, so steady-state node churn performs no calls into the
+ * global allocator. Memory is returned to the upstream resource only when the
+ * pool itself is destroyed.
+ *
+ * Thread Safety: A Synchronized pool may be used concurrently from any number
+ * of threads. An Unsynchronized pool must only be touched by one thread at a
+ * time, including the thread that eventually destroys the nodes.
+ *
+ * Example:
+ * @code
+ * auto pool = std::make_shared<NodePool>();
+ * NodePoolScope scope(pool);
+ * auto rf = map(from_values_sequential({1, 2, 3}), [](int x) { return x * 2; });
+ * // Every node built by map (now or when forced later) comes from pool.
+ * @endcode
+ */
+class NodePool {
+public:
+    /**
+     * @brief Construct a pool.
+     *
+     * @param synchronization Whether the pool may be shared between threads.
+     * @param largest_pooled_size Allocations above this size bypass the freelists.
+     * @param upstream Resource used to obtain chunks (default: new/delete).
+     */
+    explicit NodePool(
+        PoolSynchronization synchronization = PoolSynchronization::Synchronized,
+        std::size_t largest_pooled_size = 512,
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : resource_(make_resource(synchronization, largest_pooled_size, upstream)),
+          synchronization_(synchronization) {}
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+    NodePool(NodePool&&) = delete;
+    NodePool& operator=(NodePool&&) = delete;
+    ~NodePool() = default;
+
+    /**
+     * @brief Allocate raw storage from the pool.
+     *
+     * @param bytes Number of bytes to allocate.
+     * @param alignment Required alignment.
+     * @return Pointer to uninitialised storage.
+     * @throws std::bad_alloc if the upstream resource is exhausted.
+     */
+    [[nodiscard]] void* allocate(std::size_t bytes, std::size_t alignment) {
+        return resource_->allocate(bytes, alignment);
+    }
+
+    /**
+     * @brief Return storage previously obtained from allocate().
+     */
+    void deallocate(void* pointer, std::size_t bytes, std::size_t alignment) noexcept {
+        resource_->deallocate(pointer, bytes, alignment);
+    }
+
+    /**
+     * @brief Access the underlying memory resource.
+     *
+     * Useful for placing auxiliary per-query containers in the same arena.
+     */
+    [[nodiscard]] std::pmr::memory_resource* resource() const noexcept {
+        return resource_.get();
+    }
+
+    /**
+     * @brief Whether this pool may be shared between threads.
+     */
+    [[nodiscard]] PoolSynchronization synchronization() const noexcept {
+        return synchronization_;
+    }
+
+private:
+    [[nodiscard]] static std::unique_ptr<std::pmr::memory_resource> make_resource(
+        PoolSynchronization synchronization,
+        std::size_t largest_pooled_size,
+        std::pmr::memory_resource* upstream) {
+        std::pmr::pool_options options;
+        options.largest_required_pool_block = largest_pooled_size;
+        if (synchronization == PoolSynchronization::Synchronized) {
+            return std::make_unique<std::pmr::synchronized_pool_resource>(options, upstream);
+        }
+        return std::make_unique<std::pmr::unsynchronized_pool_resource>(options, upstream);
+    }
+
+    std::unique_ptr<std::pmr::memory_resource> resource_;  ///< Freelist resource
+    PoolSynchronization synchronization_;                   ///< Set at construction
+};
+
+/**
+ * @class NodeAllocator
+ * @brief Standard allocator drawing from a shared NodePool.
+ *
+ * The allocator shares ownership of its pool, so containers or shared_ptr
+ * control blocks created with it keep the pool alive until they are released.
+ *
+ * @tparam T The value type to allocate.
+ */
+template<typename T>
+class NodeAllocator {
+public:
+    using value_type = T;
+
+    /**
+     * @brief Construct an allocator bound to @p pool.
+     * @param pool The pool to draw from (must not be null).
+     */
+    explicit NodeAllocator(std::shared_ptr<NodePool> pool) noexcept : pool_(std::move(pool)) {}
+
+    /**
+     * @brief Rebinding constructor required by the Allocator requirements.
+     */
+    template<typename U>
+    NodeAllocator(const NodeAllocator<U>& other) noexcept : pool_(other.pool()) {}
+
+    [[nodiscard]] T* allocate(std::size_t count) {
+        return static_cast<T*>(pool_->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t count) noexcept {
+        pool_->deallocate(pointer, count * sizeof(T), alignof(T));
+    }
+
+    /**
+     * @brief The pool this allocator draws from.
+     */
+    [[nodiscard]] const std::shared_ptr<NodePool>& pool() const noexcept { return pool_; }
+
+    template<typename U>
+    [[nodiscard]] bool operator==(const NodeAllocator<U>& other) const noexcept {
+        return pool_ == other.pool();
+    }
+
+private:
+    std::shared_ptr<NodePool> pool_;  ///< Owning reference to the backing pool
+};
+
+namespace detail {
+
+/// Pool installed on the calling thread by the innermost NodePoolScope.
+inline thread_local std::shared_ptr<NodePool> current_node_pool_slot;
+
+}  // namespace detail
+
+/**
+ * @brief Get the pool installed on the calling thread.
+ *
+ * @return The innermost active pool, or nullptr if none is installed.
+ */
+[[nodiscard]] inline std::shared_ptr<NodePool> current_node_pool() noexcept {
+    return detail::current_node_pool_slot;
+}
+
+/**
+ * @brief Get the calling thread's pool for use by other threads.
+ *
+ * Operations that build nodes on worker threads capture this instead of
+ * current_node_pool(): an Unsynchronized pool must not be touched
+ * concurrently, so those workers fall back to the global heap.
+ *
+ * @return The innermost active pool if it is Synchronized, nullptr otherwise.
+ */
+[[nodiscard]] inline std::shared_ptr<NodePool> current_shared_node_pool() noexcept {
+    const auto& pool = detail::current_node_pool_slot;
+    if (pool && pool->synchronization() == PoolSynchronization::Synchronized) {
+        return pool;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Whether rankings built on the calling thread may be forced on other threads.
+ *
+ * False while an Unsynchronized pool is current: lazy operations built under
+ * it allocate from that pool when their tails are forced, on whatever thread
+ * forces them.
+ */
+[[nodiscard]] inline bool current_node_pool_is_shareable() noexcept {
+    const auto& pool = detail::current_node_pool_slot;
+    return !pool || pool->synchronization() == PoolSynchronization::Synchronized;
+}
+
+/**
+ * @class NodePoolScope
+ * @brief RAII guard that installs a pool as the calling thread's current pool.
+ *
+ * Scopes nest: the previous pool is restored when the scope ends. Passing
+ * nullptr temporarily reverts to the default heap allocation.
+ *
+ * Example:
+ * @code
+ * NodePoolScope scope(std::make_shared<NodePool>());
+ * auto rf = from_generator<int>(gen);  // nodes come from the scoped pool
+ * @endcode
+ */
+class NodePoolScope {
+public:
+    /**
+     * @brief Install @p pool for the lifetime of this scope.
+     * @param pool The pool to install (may be nullptr).
+     */
+    explicit NodePoolScope(std::shared_ptr<NodePool> pool) noexcept
+        : previous_(std::exchange(detail::current_node_pool_slot, std::move(pool))) {}
+
+    NodePoolScope(const NodePoolScope&) = delete;
+    NodePoolScope& operator=(const NodePoolScope&) = delete;
+    NodePoolScope(NodePoolScope&&) = delete;
+    NodePoolScope& operator=(NodePoolScope&&) = delete;
+
+    ~NodePoolScope() { detail::current_node_pool_slot = std::move(previous_); }
+
+private:
+    std::shared_ptr<NodePool> previous_;  ///< Pool restored on destruction
+};
+
+/**
+ * @brief Allocate a shared object from @p pool, or from the heap if none.
+ *
+ * This is the single allocation point used by every node factory. The control
+ * block and the object share one allocation in both cases.
+ *
+ * @tparam Node The object type to create.
+ * @param pool The pool to allocate from (nullptr selects std::make_shared).
+ * @param args Constructor arguments forwarded to Node.
+ * @return Shared pointer owning the new object.
+ */
+template<typename Node, typename... Args>
+[[nodiscard]] std::shared_ptr<Node> allocate_pooled(
+    const std::shared_ptr<NodePool>& pool,
+    Args&&... args) {
+    if (pool) {
+        return std::allocate_shared<Node>(NodeAllocator<Node>(pool), std::forward<Args>(args)...);
+    }
+    return std::make_shared<Node>(std::forward<Args>(args)...);
+}
+
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI
+
+#endif  // RANKED_BELIEF_NODE_POOL_HPP
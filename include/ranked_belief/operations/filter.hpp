@@ -15,13 +15,163 @@
 
 #include "ranked_belief/promise.hpp"
 #include "ranked_belief/rank.hpp"
+#include "ranked_belief/rank_horizon.hpp"
 #include "ranked_belief/ranking_element.hpp"
 #include "ranked_belief/ranking_function.hpp"
+#include <algorithm>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
-namespace ranked_belief {
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
+
+/**
+ * @brief Bounds on the work filter() and observe() may do to find a match.
+ *
+ * A predicate that rejects a long (or endless) run of input would otherwise
+ * keep the forcing thread scanning indefinitely.
+ */
+struct FilterLimits {
+    /// Maximum number of consecutive rejected elements scanned while looking
+    /// for the next match. Exceeding it throws std::length_error from the
+    /// force that triggered the scan.
+    std::size_t max_scanned = std::numeric_limits<std::size_t>::max();
+
+    /// Input elements ranked above the horizon end the filtered sequence.
+    Rank horizon = Rank::infinity();
+};
+
+namespace detail {
+
+/**
+ * @brief Count one rejected element against @p limits.
+ * @throws std::length_error once the scan budget is exhausted.
+ */
+inline void count_rejected(std::size_t& rejected, const FilterLimits& limits) {
+    if (++rejected > limits.max_scanned) {
+        throw std::length_error("filter: scan budget exhausted before the next match");
+    }
+}
+
+/**
+ * @brief Whether @p elem lies beyond the horizon of @p limits.
+ *
+ * The stored rank is read through the rank offset of the filtered ranking.
+ */
+template<typename T, typename Policy>
+[[nodiscard]] bool beyond_horizon(const RankingElement<T, Policy>& elem,
+                                  const FilterLimits& limits,
+                                  std::int64_t rank_offset,
+                                  RankOverflow overflow)
+{
+    return !limits.horizon.is_infinity() &&
+           offset_rank(elem.rank(), rank_offset, overflow) > limits.horizon;
+}
+
+/// Shared state of a chunked filter: the predicate, chunk size, limits, input rank offset and node pool.
+template<typename Pred>
+struct ChunkedFilterState {
+    Pred predicate;
+    std::size_t chunk_size;
+    FilterLimits limits;
+    std::int64_t rank_offset;
+    RankOverflow overflow;
+    std::shared_ptr<NodePool> pool;
+};
+
+/**
+ * @brief Collect the accepted elements of one input chunk starting at @p elem.
+ *
+ * Input is scanned in a loop up to the end of the input chunk holding
+ * @p elem (the first element whose successor is still lazy), or for at most
+ * chunk_size elements if the input is already forced further. A chunk with no
+ * match keeps scanning into the next input chunk, as the unchunked filter
+ * does. The scan resumes after the last inspected element when the chunk's
+ * lazy tail is forced.
+ */
+template<typename T, typename Policy, typename Pred>
+[[nodiscard]] std::shared_ptr<RankingElement<T, Policy>> filter_chunk(
+    std::shared_ptr<RankingElement<T, Policy>> elem,
+    std::shared_ptr<const ChunkedFilterState<Pred>> state)
+{
+    std::vector<std::pair<T, Rank>> items;
+    std::shared_ptr<RankingElement<T, Policy>> last;
+    std::size_t rejected = 0;
+    std::size_t scanned = 0;
+    while (elem && !beyond_horizon(*elem, state->limits, state->rank_offset, state->overflow)) {
+        ++scanned;
+        if (state->predicate(elem->value())) {
+            items.emplace_back(elem->value(), elem->rank());
+            rejected = 0;
+        } else {
+            count_rejected(rejected, state->limits);
+        }
+        if (!items.empty() && (!elem->next_is_forced() || scanned >= state->chunk_size)) {
+            last = std::move(elem);
+            break;
+        }
+        elem = elem->next();
+    }
+
+    if (items.empty()) {
+        return nullptr;
+    }
+    if (!last) {
+        return link_chunk<T>(
+            std::move(items),
+            make_promise_value<Policy>(std::shared_ptr<RankingElement<T, Policy>>(nullptr)),
+            state->pool);
+    }
+
+    const auto pool = state->pool;
+    return link_chunk<T>(
+        std::move(items),
+        make_promise<Policy>([last, state]() {
+            return filter_chunk<T, Policy>(last->next(), state);
+        }),
+        pool);
+}
+
+/**
+ * @brief Build the head of a chunked filter.
+ *
+ * Only the first accepted element is found eagerly, as in the unchunked
+ * filter; the rest of its input chunk is filtered when the head's successor
+ * is forced.
+ */
+template<typename T, typename Policy, typename Pred>
+[[nodiscard]] std::shared_ptr<RankingElement<T, Policy>> filter_first_chunk(
+    std::shared_ptr<RankingElement<T, Policy>> elem,
+    std::shared_ptr<const ChunkedFilterState<Pred>> state)
+{
+    std::size_t rejected = 0;
+    for (;; elem = elem->next()) {
+        if (!elem || beyond_horizon(*elem, state->limits, state->rank_offset, state->overflow)) {
+            return nullptr;
+        }
+        if (state->predicate(elem->value())) {
+            break;
+        }
+        count_rejected(rejected, state->limits);
+    }
+
+    const auto pool = state->pool;
+    return allocate_pooled<RankingElement<T, Policy>>(
+        pool,
+        elem->value(),
+        elem->rank(),
+        make_promise<Policy>([elem, state]() {
+            return filter_chunk<T, Policy>(elem->next(), state);
+        }));
+}
+
+}  // namespace detail
 
 /**
  * @brief Filter a ranking function by a value predicate.
@@ -36,16 +186,29 @@ namespace ranked_belief {
  * - Original ranks preserved for elements that pass
  * - Results memoized after first access
  *
+ * If @p rf is chunked (rf.chunk_size() > 1), the result is chunked too: each
+ * lazy step filters the rest of one input chunk (further if that chunk has no
+ * match), so a sparse predicate does not scan ahead for matches nobody asked
+ * for.
+ *
+ * Rejected elements are skipped in a loop, so long runs of them use constant
+ * stack. @p limits bounds how far one search may scan; its horizon is lowered
+ * to the current rank horizon (see rank_horizon.hpp). The result carries the
+ * rank offset of @p rf.
+ *
  * @tparam T The value type in the ranking function.
  * @tparam Pred The predicate type (must be invocable with const T&).
  * @param rf The source ranking function.
  * @param predicate A function that returns true for values to keep.
  * @param deduplicate Whether to deduplicate consecutive equal values.
+ * @param limits Scan budget and rank horizon (default: unbounded).
  * @return A new ranking function with only elements satisfying the predicate.
+ * @throws std::length_error when the scan budget is exhausted, either from
+ *         this call (while finding the head) or from the force that scans.
  *
  * @par Complexity
  * Time: O(1) to create the filtered ranking, O(n) to traverse all elements.
- * Space: O(1) for the initial call, O(depth) for recursive structure.
+ * Space: O(1) stack per forced element, however many inputs are rejected.
  *
  * @par Example
  * @code
@@ -54,57 +217,56 @@ namespace ranked_belief {
  * // evens contains {2, 4} with ranks {1, 3}
  * @endcode
  */
-template<typename T, typename Pred>
+template<typename T, typename Pred, typename Policy>
 requires std::invocable<Pred, const T&> && 
          std::same_as<std::invoke_result_t<Pred, const T&>, bool>
-[[nodiscard]] RankingFunction<T> filter(
-    const RankingFunction<T>& rf,
+[[nodiscard]] RankingFunction<T, Policy> filter(
+    const RankingFunction<T, Policy>& rf,
     Pred predicate,
-    Deduplication deduplicate = Deduplication::Enabled)
+    Deduplication deduplicate = Deduplication::Enabled,
+    FilterLimits limits = {})
 {
+    limits.horizon = std::min(limits.horizon, current_rank_horizon());
+
+    if (rf.chunk_size() > 1) {
+        auto state = std::make_shared<const detail::ChunkedFilterState<Pred>>(
+            detail::ChunkedFilterState<Pred>{std::move(predicate), rf.chunk_size(), limits,
+                                             rf.rank_offset(), rf.rank_overflow(), current_node_pool()});
+        return RankingFunction<T, Policy>(
+            detail::filter_first_chunk<T, Policy>(rf.raw_head(), std::move(state)), deduplicate, rf.chunk_size())
+            .with_rank_offset(rf.rank_offset(), rf.rank_overflow());
+    }
+
     // Helper function to recursively build the filtered sequence
     // Use shared_ptr to allow safe capture in lazy computations
-    using BuildFunc = std::function<std::shared_ptr<RankingElement<T>>(
-        std::shared_ptr<RankingElement<T>>)>;
+    using BuildFunc = std::function<std::shared_ptr<RankingElement<T, Policy>>(
+        std::shared_ptr<RankingElement<T, Policy>>)>;
     auto build_filtered = std::make_shared<BuildFunc>();
     std::weak_ptr<BuildFunc> weak_build = build_filtered;
     
-    *build_filtered = [predicate, weak_build](
-        std::shared_ptr<RankingElement<T>> elem)
-        -> std::shared_ptr<RankingElement<T>>
+    *build_filtered = [predicate, limits, weak_build, rank_offset = rf.rank_offset(),
+                       overflow = rf.rank_overflow(), pool = current_node_pool()](
+        std::shared_ptr<RankingElement<T, Policy>> elem)
+        -> std::shared_ptr<RankingElement<T, Policy>>
     {
-        if (!elem) {
-            return nullptr;
-        }
-
         auto build_ref = weak_build.lock();
-        
-        // Check if current element satisfies predicate (lazy evaluation)
-        if (predicate(elem->value())) {
-            // Keep this element - create lazy computation for next
-            auto compute_next = [weak_build, build_ref, elem]() 
-                -> std::shared_ptr<RankingElement<T>>
-            {
-                auto next_elem = elem->next();
-
-                if (auto locked = weak_build.lock()) {
-                    return (*locked)(next_elem);
-                }
-
-                if (build_ref) {
-                    return (*build_ref)(next_elem);
-                }
+
+        // Skip rejected elements iteratively (lazy evaluation of each predicate)
+        std::size_t rejected = 0;
+        for (;; elem = elem->next()) {
+            if (!elem || detail::beyond_horizon(*elem, limits, rank_offset, overflow)) {
                 return nullptr;
-            };
-            
-            // Create new element with same value/rank, filtered next
-            return std::make_shared<RankingElement<T>>(
-                elem->value(),
-                elem->rank(),
-                make_promise(std::move(compute_next))
-            );
-        } else {
-            // Skip this element - recursively try next
+            }
+            if (predicate(elem->value())) {
+                break;
+            }
+            detail::count_rejected(rejected, limits);
+        }
+
+        // Keep this element - create lazy computation for next
+        auto compute_next = [weak_build, build_ref, elem]() 
+            -> std::shared_ptr<RankingElement<T, Policy>>
+        {
             auto next_elem = elem->next();
 
             if (auto locked = weak_build.lock()) {
@@ -115,13 +277,22 @@ requires std::invocable<Pred, const T&> &&
                 return (*build_ref)(next_elem);
             }
             return nullptr;
-        }
+        };
+        
+        // Create new element with same value/rank, filtered next
+        return allocate_pooled<RankingElement<T, Policy>>(
+            pool,
+            elem->value(),
+            elem->rank(),
+            make_promise<Policy>(std::move(compute_next))
+        );
     };
     
     // Build the head of the filtered sequence
-    auto filtered_head = (*build_filtered)(rf.head());
+    auto filtered_head = (*build_filtered)(rf.raw_head());
     
-    return RankingFunction<T>(filtered_head, deduplicate);
+    return RankingFunction<T, Policy>(filtered_head, deduplicate)
+        .with_rank_offset(rf.rank_offset(), rf.rank_overflow());
 }
 
 /**
@@ -151,28 +322,28 @@ requires std::invocable<Pred, const T&> &&
  * // first_three contains {1, 2, 3} with rank 0
  * @endcode
  */
-template<typename T>
-[[nodiscard]] RankingFunction<T> take(
-    const RankingFunction<T>& rf,
+template<typename T, typename Policy>
+[[nodiscard]] RankingFunction<T, Policy> take(
+    const RankingFunction<T, Policy>& rf,
     std::size_t n,
     Deduplication deduplicate = Deduplication::Enabled)
 {
     // Base case: if n is 0, return empty ranking
     if (n == 0) {
-        return RankingFunction<T>();
+        return RankingFunction<T, Policy>();
     }
     
     // Helper function to recursively build the taken sequence
     // Use shared_ptr to allow safe capture in lazy computations
-    using BuildFunc = std::function<std::shared_ptr<RankingElement<T>>(
-        std::shared_ptr<RankingElement<T>>, std::size_t)>;
+    using BuildFunc = std::function<std::shared_ptr<RankingElement<T, Policy>>(
+        std::shared_ptr<RankingElement<T, Policy>>, std::size_t)>;
     auto build_taken = std::make_shared<BuildFunc>();
     std::weak_ptr<BuildFunc> weak_build = build_taken;
     
-    *build_taken = [weak_build](
-        std::shared_ptr<RankingElement<T>> elem,
+    *build_taken = [weak_build, pool = current_node_pool()](
+        std::shared_ptr<RankingElement<T, Policy>> elem,
         std::size_t remaining)
-        -> std::shared_ptr<RankingElement<T>>
+        -> std::shared_ptr<RankingElement<T, Policy>>
     {
         // If no more elements to take or reached end, return nullptr
         if (remaining == 0 || !elem) {
@@ -183,7 +354,7 @@ template<typename T>
         
         // Create lazy computation for next element (with decremented count)
         auto compute_next = [weak_build, build_ref, elem, remaining]() 
-            -> std::shared_ptr<RankingElement<T>>
+            -> std::shared_ptr<RankingElement<T, Policy>>
         {
             auto next_elem = elem->next();
 
@@ -198,17 +369,19 @@ template<typename T>
         };
         
         // Create new element with same value/rank, limited next
-        return std::make_shared<RankingElement<T>>(
+        return allocate_pooled<RankingElement<T, Policy>>(
+            pool,
             elem->value(),
             elem->rank(),
-            make_promise(std::move(compute_next))
+            make_promise<Policy>(std::move(compute_next))
         );
     };
     
     // Build the head of the taken sequence
-    auto taken_head = (*build_taken)(rf.head(), n);
+    auto taken_head = (*build_taken)(rf.raw_head(), n);
     
-    return RankingFunction<T>(taken_head, deduplicate);
+    return RankingFunction<T, Policy>(taken_head, deduplicate)
+        .with_rank_offset(rf.rank_offset(), rf.rank_overflow());
 }
 
 /**
@@ -238,25 +411,27 @@ template<typename T>
  * // low_rank contains {1, 2, 3} with ranks {0, 1, 2}
  * @endcode
  */
-template<typename T>
-[[nodiscard]] RankingFunction<T> take_while_rank(
-    const RankingFunction<T>& rf,
+template<typename T, typename Policy>
+[[nodiscard]] RankingFunction<T, Policy> take_while_rank(
+    const RankingFunction<T, Policy>& rf,
     Rank max_rank,
     Deduplication deduplicate = Deduplication::Enabled)
 {
     // Helper function to recursively build the rank-filtered sequence
     // Use shared_ptr to allow safe capture in lazy computations
-    using BuildFunc = std::function<std::shared_ptr<RankingElement<T>>(
-        std::shared_ptr<RankingElement<T>>)>;
+    using BuildFunc = std::function<std::shared_ptr<RankingElement<T, Policy>>(
+        std::shared_ptr<RankingElement<T, Policy>>)>;
     auto build_filtered = std::make_shared<BuildFunc>();
     std::weak_ptr<BuildFunc> weak_build = build_filtered;
     
-    *build_filtered = [max_rank, weak_build](
-        std::shared_ptr<RankingElement<T>> elem)
-        -> std::shared_ptr<RankingElement<T>>
+    *build_filtered = [max_rank, weak_build, pool = current_node_pool(),
+                       offset = rf.rank_offset(), overflow = rf.rank_overflow()](
+        std::shared_ptr<RankingElement<T, Policy>> elem)
+        -> std::shared_ptr<RankingElement<T, Policy>>
     {
-        // If reached end or rank exceeds threshold, terminate
-        if (!elem || elem->rank() > max_rank) {
+        // If reached end or rank exceeds threshold, terminate. Stored ranks
+        // are copied as is; the result carries the input's offset.
+        if (!elem || detail::offset_rank(elem->rank(), offset, overflow) > max_rank) {
             return nullptr;
         }
 
@@ -264,7 +439,7 @@ template<typename T>
         
         // Keep this element - create lazy computation for next
         auto compute_next = [weak_build, build_ref, elem]() 
-            -> std::shared_ptr<RankingElement<T>>
+            -> std::shared_ptr<RankingElement<T, Policy>>
         {
             auto next_elem = elem->next();
 
@@ -279,19 +454,59 @@ template<typename T>
         };
         
         // Create new element with same value/rank, filtered next
-        return std::make_shared<RankingElement<T>>(
+        return allocate_pooled<RankingElement<T, Policy>>(
+            pool,
             elem->value(),
             elem->rank(),
-            make_promise(std::move(compute_next))
+            make_promise<Policy>(std::move(compute_next))
         );
     };
     
     // Build the head of the rank-filtered sequence
-    auto filtered_head = (*build_filtered)(rf.head());
+    auto filtered_head = (*build_filtered)(rf.raw_head());
     
-    return RankingFunction<T>(filtered_head, deduplicate);
+    return RankingFunction<T, Policy>(filtered_head, deduplicate)
+        .with_rank_offset(rf.rank_offset(), rf.rank_overflow());
+}
+
+/**
+ * @brief Build a ranking that only needs to be correct up to @p horizon.
+ *
+ * Runs @p build inside a RankHorizonScope, so merge_apply(),
+ * normal_exceptional() and filter() called while building (or while later
+ * forcing the result) skip branches that can only produce ranks above
+ * @p horizon, without invoking their callbacks. The result is then truncated
+ * with take_while_rank(), so it holds exactly the elements of the unbounded
+ * ranking with rank <= @p horizon.
+ *
+ * Do not call observe() inside @p build: normalization lowers ranks, so a
+ * pruned input would normalize differently (see rank_horizon.hpp).
+ *
+ * @tparam Builder Callable returning a RankingFunction.
+ * @param horizon The largest rank the caller will look at.
+ * @param build Builds the ranking.
+ * @param deduplicate Whether the truncated result deduplicates consecutive equal values.
+ * @return The elements of build()'s ranking with rank <= @p horizon.
+ *
+ * @par Example
+ * @code
+ * auto likely = with_rank_horizon(Rank::from_value(2), [&] {
+ *     return merge_apply(inputs, expensive_model);
+ * });
+ * @endcode
+ */
+template<typename Builder>
+requires std::invocable<Builder&>
+[[nodiscard]] auto with_rank_horizon(
+    Rank horizon,
+    Builder&& build,
+    Deduplication deduplicate = Deduplication::Enabled)
+{
+    RankHorizonScope scope(horizon);
+    auto result = std::invoke(build);
+    return take_while_rank(result, horizon, deduplicate);
 }
 
-}  // namespace ranked_belief
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI
 
 #endif  // RANKED_BELIEF_OPERATIONS_FILTER_HPP
@@ -19,11 +19,101 @@
 #include "ranked_belief/ranking_function.hpp"
 
 #include <concepts>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
-namespace ranked_belief {
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
+
+namespace detail {
+
+/// Shared state of a chunked map: the function, chunk size and node pool.
+template<typename F>
+struct ChunkedMapState {
+    F func;
+    std::size_t chunk_size;
+    std::shared_ptr<NodePool> pool;
+};
+
+/**
+ * @brief Map up to @p count input elements starting at @p elem.
+ *
+ * Values of the chunk are computed eagerly and linked with link_chunk(); the
+ * rest of the input is mapped, one full chunk at a time, when the chunk's
+ * lazy tail is forced.
+ */
+template<typename R, typename T, typename Policy, typename F>
+[[nodiscard]] std::shared_ptr<RankingElement<R, Policy>> map_chunk(
+    std::shared_ptr<RankingElement<T, Policy>> elem,
+    std::shared_ptr<const ChunkedMapState<F>> state,
+    std::size_t count)
+{
+    if (!elem) {
+        return nullptr;
+    }
+
+    std::vector<std::pair<R, Rank>> items;
+    items.reserve(count);
+    while (true) {
+        items.emplace_back(state->func(elem->value()), elem->rank());
+        if (items.size() == count) {
+            break;
+        }
+        auto next = elem->next();
+        if (!next) {
+            return link_chunk<R>(
+                std::move(items),
+                make_promise_value<Policy>(std::shared_ptr<RankingElement<R, Policy>>(nullptr)),
+                state->pool);
+        }
+        elem = std::move(next);
+    }
+
+    const auto pool = state->pool;
+    return link_chunk<R>(
+        std::move(items),
+        make_promise<Policy>([elem, state]() {
+            return map_chunk<R>(elem->next(), state, state->chunk_size);
+        }),
+        pool);
+}
+
+/**
+ * @brief Build the head of a chunked map without applying the function.
+ *
+ * The head takes its rank from @p head. Its value and its tail share one
+ * promise that maps the whole first chunk, so the function first runs when
+ * either is needed, as it does for every later chunk.
+ */
+template<typename R, typename T, typename Policy, typename F>
+[[nodiscard]] std::shared_ptr<RankingElement<R, Policy>> map_first_chunk(
+    std::shared_ptr<RankingElement<T, Policy>> head,
+    std::shared_ptr<const ChunkedMapState<F>> state)
+{
+    if (!head) {
+        return nullptr;
+    }
+
+    using FirstChunk = std::pair<R, std::shared_ptr<RankingElement<R, Policy>>>;
+    auto chunk = std::make_shared<Promise<FirstChunk, Policy>>(make_promise<Policy>([head, state]() {
+        R value = state->func(head->value());
+        return FirstChunk(std::move(value), map_chunk<R>(head->next(), state, state->chunk_size - 1));
+    }));
+
+    const Rank rank = head->rank();
+    const auto pool = state->pool;
+    return allocate_pooled<RankingElement<R, Policy>>(
+        pool,
+        // Only the head's value promise reads the value, and at most once.
+        make_promise<Policy>([chunk]() -> R { return std::move(chunk->force().first); }),
+        rank,
+        make_promise<Policy>([chunk]() { return chunk->force().second; }));
+}
+
+}  // namespace detail
 
 /**
  * @brief Transform each value in a ranking function while preserving ranks.
@@ -39,6 +129,12 @@ namespace ranked_belief {
  * - Traversing to subsequent elements happens lazily
  * - All computations are memoized for efficiency
  *
+ * If @p rf is chunked (rf.chunk_size() > 1), the result is chunked too: the
+ * function is applied to a whole chunk of inputs when the first element of
+ * that chunk is needed (for the first chunk, its value or its successor), and
+ * only one lazy step is taken per chunk. The
+ * result carries the rank offset of @p rf.
+ *
  * @tparam T The input value type.
  * @tparam F The function type (must be invocable with const T&).
  * @param rf The source ranking function.
@@ -58,24 +154,33 @@ namespace ranked_belief {
  * // Values are only computed when accessed via iteration or first()
  * @endcode
  */
-template<typename T, typename F>
+template<typename T, typename F, typename Policy>
 requires std::invocable<F, const T&>
 [[nodiscard]] auto map(
-    const RankingFunction<T>& rf,
+    const RankingFunction<T, Policy>& rf,
     F func,
     Deduplication deduplicate = Deduplication::Enabled)
-    -> RankingFunction<std::invoke_result_t<F, const T&>>
+    -> RankingFunction<std::invoke_result_t<F, const T&>, Policy>
 {
     using R = std::invoke_result_t<F, const T&>;
+
+    if (rf.chunk_size() > 1) {
+        auto state = std::make_shared<const detail::ChunkedMapState<F>>(
+            detail::ChunkedMapState<F>{std::move(func), rf.chunk_size(), current_node_pool()});
+        return RankingFunction<R, Policy>(
+            detail::map_first_chunk<R>(rf.raw_head(), std::move(state)), deduplicate, rf.chunk_size())
+            .with_rank_offset(rf.rank_offset(), rf.rank_overflow());
+    }
     
     // Helper function to recursively build the mapped sequence
     // Use shared_ptr to allow safe capture in lazy computations
-    using BuildFunc = std::function<std::shared_ptr<RankingElement<R>>(std::shared_ptr<RankingElement<T>>)>;
+    using BuildFunc = std::function<std::shared_ptr<RankingElement<R, Policy>>(std::shared_ptr<RankingElement<T, Policy>>)>;
     auto build_mapped = std::make_shared<BuildFunc>();
     std::weak_ptr<BuildFunc> weak_build = build_mapped;
     
-    *build_mapped = [func, weak_build](std::shared_ptr<RankingElement<T>> elem)
-        -> std::shared_ptr<RankingElement<R>>
+    *build_mapped = [func, weak_build, pool = current_node_pool()](
+        std::shared_ptr<RankingElement<T, Policy>> elem)
+        -> std::shared_ptr<RankingElement<R, Policy>>
     {
         if (!elem) {
             return nullptr;
@@ -88,7 +193,7 @@ requires std::invocable<F, const T&>
         
         // Create a lazy computation for the next element
         auto build_ref = weak_build.lock();
-        auto compute_next = [weak_build, build_ref, elem]() -> std::shared_ptr<RankingElement<R>> {
+        auto compute_next = [weak_build, build_ref, elem]() -> std::shared_ptr<RankingElement<R, Policy>> {
             if (auto locked = weak_build.lock()) {
                 return (*locked)(elem->next());
             }
@@ -99,17 +204,19 @@ requires std::invocable<F, const T&>
         };
         
         // Build the mapped element with lazy value and next
-        return std::make_shared<RankingElement<R>>(
-            make_promise(std::move(compute_value)),  // Lazy value transformation
+        return allocate_pooled<RankingElement<R, Policy>>(
+            pool,
+            make_promise<Policy>(std::move(compute_value)),  // Lazy value transformation
             elem->rank(),                             // Preserve rank
-            make_promise(std::move(compute_next))     // Lazy next
+            make_promise<Policy>(std::move(compute_next))     // Lazy next
         );
     };
     
     // Build the head of the mapped sequence
-    auto mapped_head = (*build_mapped)(rf.head());
+    auto mapped_head = (*build_mapped)(rf.raw_head());
     
-    return RankingFunction<R>(mapped_head, deduplicate);
+    return RankingFunction<R, Policy>(mapped_head, deduplicate)
+        .with_rank_offset(rf.rank_offset(), rf.rank_overflow());
 }
 
 /**
@@ -144,37 +251,39 @@ requires std::invocable<F, const T&>
  * // Result: 10@5, 20@6, 30@7
  * @endcode
  */
-template<typename T, typename F>
+template<typename T, typename F, typename Policy>
 requires std::invocable<F, const T&, Rank>
 [[nodiscard]] auto map_with_rank(
-    const RankingFunction<T>& rf,
+    const RankingFunction<T, Policy>& rf,
     F func,
     Deduplication deduplicate = Deduplication::Enabled)
-    -> RankingFunction<typename std::invoke_result_t<F, const T&, Rank>::first_type>
+    -> RankingFunction<typename std::invoke_result_t<F, const T&, Rank>::first_type, Policy>
 {
     using PairType = std::invoke_result_t<F, const T&, Rank>;
     using R = typename PairType::first_type;
     
     // Helper function to recursively build the mapped sequence
     // Use shared_ptr to allow safe capture in lazy computations
-    using BuildFunc = std::function<std::shared_ptr<RankingElement<R>>(std::shared_ptr<RankingElement<T>>)>;
+    using BuildFunc = std::function<std::shared_ptr<RankingElement<R, Policy>>(std::shared_ptr<RankingElement<T, Policy>>)>;
     auto build_mapped = std::make_shared<BuildFunc>();
     std::weak_ptr<BuildFunc> weak_build = build_mapped;
     
-    *build_mapped = [func, weak_build](std::shared_ptr<RankingElement<T>> elem)
-        -> std::shared_ptr<RankingElement<R>>
+    *build_mapped = [func, weak_build, pool = current_node_pool(),
+                     offset = rf.rank_offset(), overflow = rf.rank_overflow()](
+        std::shared_ptr<RankingElement<T, Policy>> elem)
+        -> std::shared_ptr<RankingElement<R, Policy>>
     {
         if (!elem) {
             return nullptr;
         }
         
         // Create a lazy computation that applies func to get value and rank
-        auto compute_pair = [func, elem]() -> PairType {
-            return func(elem->value(), elem->rank());
+        auto compute_pair = [func, elem, offset, overflow]() -> PairType {
+            return func(elem->value(), detail::offset_rank(elem->rank(), offset, overflow));
         };
         
         // Create promise for the pair, then extract value and rank lazily
-        auto pair_promise = std::make_shared<Promise<PairType>>(make_promise(std::move(compute_pair)));
+        auto pair_promise = std::make_shared<Promise<PairType, Policy>>(make_promise<Policy>(std::move(compute_pair)));
         
         auto compute_value = [pair_promise]() -> R {
             return pair_promise->force().first;
@@ -190,7 +299,7 @@ requires std::invocable<F, const T&, Rank>
         
         // Create a lazy computation for the next element
         auto build_ref = weak_build.lock();
-        auto compute_next = [weak_build, build_ref, elem]() -> std::shared_ptr<RankingElement<R>> {
+        auto compute_next = [weak_build, build_ref, elem]() -> std::shared_ptr<RankingElement<R, Policy>> {
             if (auto locked = weak_build.lock()) {
                 return (*locked)(elem->next());
             }
@@ -201,17 +310,18 @@ requires std::invocable<F, const T&, Rank>
         };
         
         // Build the mapped element with lazy value and lazy next
-        return std::make_shared<RankingElement<R>>(
-            make_promise(std::move(compute_value)),  // Lazy value transformation
+        return allocate_pooled<RankingElement<R, Policy>>(
+            pool,
+            make_promise<Policy>(std::move(compute_value)),  // Lazy value transformation
             mapped_rank,                              // Rank (forced once)
-            make_promise(std::move(compute_next))     // Lazy next
+            make_promise<Policy>(std::move(compute_next))     // Lazy next
         );
     };
     
     // Build the head of the mapped sequence
-    auto mapped_head = (*build_mapped)(rf.head());
+    auto mapped_head = (*build_mapped)(rf.raw_head());
     
-    return RankingFunction<R>(mapped_head, deduplicate);
+    return RankingFunction<R, Policy>(mapped_head, deduplicate);
 }
 
 /**
@@ -245,26 +355,26 @@ requires std::invocable<F, const T&, Rank>
  * // Result: (0, 10)@0, (1, 20)@0, (2, 30)@0
  * @endcode
  */
-template<typename T, typename F>
+template<typename T, typename F, typename Policy>
 requires std::invocable<F, const T&, size_t>
 [[nodiscard]] auto map_with_index(
-    const RankingFunction<T>& rf,
+    const RankingFunction<T, Policy>& rf,
     F func,
     Deduplication deduplicate = Deduplication::Enabled)
-    -> RankingFunction<std::invoke_result_t<F, const T&, size_t>>
+    -> RankingFunction<std::invoke_result_t<F, const T&, size_t>, Policy>
 {
     using R = std::invoke_result_t<F, const T&, size_t>;
     
     // Helper function to recursively build the mapped sequence with index
     // Use shared_ptr to allow safe capture in lazy computations
-    using BuildFunc = std::function<std::shared_ptr<RankingElement<R>>(
-        std::shared_ptr<RankingElement<T>>, size_t)>;
+    using BuildFunc = std::function<std::shared_ptr<RankingElement<R, Policy>>(
+        std::shared_ptr<RankingElement<T, Policy>>, size_t)>;
     auto build_mapped = std::make_shared<BuildFunc>();
     std::weak_ptr<BuildFunc> weak_build = build_mapped;
     
-    *build_mapped = [func, weak_build](
-        std::shared_ptr<RankingElement<T>> elem,
-        size_t index) -> std::shared_ptr<RankingElement<R>>
+    *build_mapped = [func, weak_build, pool = current_node_pool()](
+        std::shared_ptr<RankingElement<T, Policy>> elem,
+        size_t index) -> std::shared_ptr<RankingElement<R, Policy>>
     {
         if (!elem) {
             return nullptr;
@@ -278,7 +388,7 @@ requires std::invocable<F, const T&, size_t>
         // Create a lazy computation for the next element
         auto build_ref = weak_build.lock();
         auto compute_next = [weak_build, build_ref, elem, index]()
-            -> std::shared_ptr<RankingElement<R>>
+            -> std::shared_ptr<RankingElement<R, Policy>>
         {
             if (auto locked = weak_build.lock()) {
                 return (*locked)(elem->next(), index + 1);
@@ -290,19 +400,21 @@ requires std::invocable<F, const T&, size_t>
         };
         
         // Build the mapped element with lazy value and next
-        return std::make_shared<RankingElement<R>>(
-            make_promise(std::move(compute_value)),  // Lazy value transformation
+        return allocate_pooled<RankingElement<R, Policy>>(
+            pool,
+            make_promise<Policy>(std::move(compute_value)),  // Lazy value transformation
             elem->rank(),                             // Preserve rank
-            make_promise(std::move(compute_next))     // Lazy next
+            make_promise<Policy>(std::move(compute_next))     // Lazy next
         );
     };
     
     // Build the head of the mapped sequence starting at index 0
-    auto mapped_head = (*build_mapped)(rf.head(), 0);
+    auto mapped_head = (*build_mapped)(rf.raw_head(), 0);
     
-    return RankingFunction<R>(mapped_head, deduplicate);
+    return RankingFunction<R, Policy>(mapped_head, deduplicate)
+        .with_rank_offset(rf.rank_offset(), rf.rank_overflow());
 }
 
-}  // namespace ranked_belief
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI
 
 #endif  // RANKED_BELIEF_OPERATIONS_MAP_HPP
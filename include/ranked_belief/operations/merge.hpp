@@ -16,11 +16,22 @@
 #include "ranked_belief/rank.hpp"
 #include "ranked_belief/ranking_element.hpp"
 #include "ranked_belief/ranking_function.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
-namespace ranked_belief {
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
+
+// Defined below; merge() defers to it for inputs with different rank offsets.
+template<typename T, typename Policy = DefaultPromisePolicy>
+[[nodiscard]] RankingFunction<T, Policy> merge_all(
+    const std::vector<RankingFunction<T, Policy>>& rankings,
+    Deduplication deduplicate = Deduplication::Enabled);
 
 /**
  * @brief Merge two ranking functions in rank order.
@@ -38,6 +49,10 @@ namespace ranked_belief {
  * - Lazy evaluation throughout
  * - Memoization after first access
  *
+ * If both inputs carry the same rank offset the stored sequences are merged
+ * and the result carries that offset; otherwise the inputs are merged by
+ * merge_all(), which reads each input's ranks through its own offset.
+ *
  * @tparam T The value type in the ranking functions.
  * @param rf1 The first ranking function.
  * @param rf2 The second ranking function.
@@ -57,25 +72,37 @@ namespace ranked_belief {
  * // merged contains: 1@0, 2@1, 3@2, 4@3
  * @endcode
  */
-template<typename T>
-[[nodiscard]] RankingFunction<T> merge(
-    const RankingFunction<T>& rf1,
-    const RankingFunction<T>& rf2,
+template<typename T, typename Policy>
+[[nodiscard]] RankingFunction<T, Policy> merge(
+    const RankingFunction<T, Policy>& rf1,
+    const RankingFunction<T, Policy>& rf2,
     Deduplication deduplicate = Deduplication::Enabled)
 {
+    if (rf1.rank_offset() != rf2.rank_offset() || rf1.rank_overflow() != rf2.rank_overflow()) {
+        return merge_all<T, Policy>({rf1, rf2}, deduplicate);
+    }
+    // Merging commutes with a common shift, so merge the stored sequences and
+    // shift the result.
+    const std::int64_t rank_offset = rf1.rank_offset();
+    const RankOverflow overflow = rf1.rank_overflow();
+
+    // Nodes built now or when the merged tail is forced come from the pool
+    // that is current at construction time.
+    const auto pool = current_node_pool();
+
     // Special case: if both ranking functions have the same head, return one of them
     // This handles merging a sequence with itself, which should produce the same sequence
-    if (rf1.head() == rf2.head()) {
+    if (rf1.raw_head() == rf2.raw_head()) {
         if (deduplicate == Deduplication::Disabled) {
             // If deduplication is off, make a lazy deep copy of rf2 and merge rf1 with the copy directly
-            auto rf2_copy_head = lazy_deepcopy_ranking_sequence<T>(rf2.head());
+            auto rf2_copy_head = lazy_deepcopy_ranking_sequence<T>(rf2.raw_head(), pool);
             // Do NOT call merge recursively with rf1 and rf2_copy, as that can reintroduce shared structure
             // Instead, merge rf1 and rf2_copy using a local merge implementation that never compares pointer-equal nodes
-            auto build_merged_impl = [](
+            auto build_merged_impl = [pool](
                 auto&& self,
-                std::shared_ptr<RankingElement<T>> elem1,
-                std::shared_ptr<RankingElement<T>> elem2,
-                Rank seen_rank) -> std::shared_ptr<RankingElement<T>>
+                std::shared_ptr<RankingElement<T, Policy>> elem1,
+                std::shared_ptr<RankingElement<T, Policy>> elem2,
+                Rank seen_rank) -> std::shared_ptr<RankingElement<T, Policy>>
             {
                 if (!elem1) return elem2;
                 if (!elem2) return elem1;
@@ -83,7 +110,7 @@ template<typename T>
                 if (elem1->rank() == seen_rank) {
                     auto elem1_rank = elem1->rank();
                     // Create a promise wrapper to avoid moving from elem1
-                    auto value_wrapper = make_promise([elem1]() { return elem1->value(); });
+                    auto value_wrapper = make_promise<Policy>([elem1]() { return elem1->value(); });
                     auto compute_next = [self, elem1, elem2, seen_rank]() {
                         auto next_elem1 = elem1->next();
                         return self(self, next_elem1, elem2, seen_rank);
@@ -91,13 +118,14 @@ template<typename T>
                     return make_lazy_node(
                         std::move(value_wrapper),
                         elem1_rank,
-                        make_promise(std::move(compute_next))
+                        make_promise<Policy>(std::move(compute_next)),
+                        pool
                     );
                 }
                 if (elem1->rank() <= elem2->rank()) {
                     auto elem1_rank = elem1->rank();
                     // Create a promise wrapper to avoid moving from elem1
-                    auto value_wrapper = make_promise([elem1]() { return elem1->value(); });
+                    auto value_wrapper = make_promise<Policy>([elem1]() { return elem1->value(); });
                     auto compute_next = [self, elem1, elem2, elem1_rank]() {
                         auto next_elem1 = elem1->next();
                         return self(self, next_elem1, elem2, elem1_rank);
@@ -105,12 +133,13 @@ template<typename T>
                     return make_lazy_node(
                         std::move(value_wrapper),
                         elem1_rank,
-                        make_promise(std::move(compute_next))
+                        make_promise<Policy>(std::move(compute_next)),
+                        pool
                     );
                 } else {
                     auto elem2_rank = elem2->rank();
                     // Create a promise wrapper to avoid moving from elem2
-                    auto value_wrapper = make_promise([elem2]() { return elem2->value(); });
+                    auto value_wrapper = make_promise<Policy>([elem2]() { return elem2->value(); });
                     auto compute_next = [self, elem1, elem2, elem2_rank]() {
                         auto next_elem2 = elem2->next();
                         return self(self, elem1, next_elem2, elem2_rank);
@@ -118,23 +147,25 @@ template<typename T>
                     return make_lazy_node(
                         std::move(value_wrapper),
                         elem2_rank,
-                        make_promise(std::move(compute_next))
+                        make_promise<Policy>(std::move(compute_next)),
+                        pool
                     );
                 }
             };
-            auto merged_head = build_merged_impl(build_merged_impl, rf1.head(), rf2_copy_head, Rank::zero());
-            return RankingFunction<T>(merged_head, Deduplication::Disabled);
+            auto merged_head = build_merged_impl(build_merged_impl, rf1.raw_head(), rf2_copy_head, Rank::zero());
+            return RankingFunction<T, Policy>(merged_head, Deduplication::Disabled)
+                .with_rank_offset(rank_offset, overflow);
         }
         return rf1;
     }
     
     // Helper function to recursively merge sequences
-    auto build_merged_impl = [](
+    auto build_merged_impl = [pool](
         auto&& self,
-        std::shared_ptr<RankingElement<T>> elem1,
-        std::shared_ptr<RankingElement<T>> elem2,
+        std::shared_ptr<RankingElement<T, Policy>> elem1,
+        std::shared_ptr<RankingElement<T, Policy>> elem2,
         Rank seen_rank)
-        -> std::shared_ptr<RankingElement<T>>
+        -> std::shared_ptr<RankingElement<T, Policy>>
     {
         // If both pointers are the same, just return one (avoid double-move)
         if (elem1 == elem2) {
@@ -152,64 +183,195 @@ template<typename T>
         if (elem1->rank() == seen_rank) {
             auto elem1_rank = elem1->rank();
             // Create a promise wrapper to avoid moving from elem1
-            auto value_wrapper = make_promise([elem1]() { return elem1->value(); });
-            auto compute_next = [self](std::shared_ptr<RankingElement<T>> n1, std::shared_ptr<RankingElement<T>> n2, Rank r) -> std::shared_ptr<RankingElement<T>> {
+            auto value_wrapper = make_promise<Policy>([elem1]() { return elem1->value(); });
+            auto compute_next = [self](std::shared_ptr<RankingElement<T, Policy>> n1, std::shared_ptr<RankingElement<T, Policy>> n2, Rank r) -> std::shared_ptr<RankingElement<T, Policy>> {
                 if (n1 == n2) return n1;
                 return self(self, n1, n2, r);
             };
             return make_lazy_node(
                 std::move(value_wrapper),
                 elem1_rank,
-                make_promise([elem1, elem2, seen_rank, compute_next]() {
+                make_promise<Policy>([elem1, elem2, seen_rank, compute_next]() {
                     auto next_elem1 = elem1->next();
                     if (next_elem1 == elem2) return next_elem1;
                     return compute_next(next_elem1, elem2, seen_rank);
-                })
+                }),
+                pool
             );
         }
         // Compare ranks to decide which element comes next
         if (elem1->rank() <= elem2->rank()) {
             auto elem1_rank = elem1->rank();
             // Create a promise wrapper to avoid moving from elem1
-            auto value_wrapper = make_promise([elem1]() { return elem1->value(); });
-            auto compute_next = [self](std::shared_ptr<RankingElement<T>> n1, std::shared_ptr<RankingElement<T>> n2, Rank r) -> std::shared_ptr<RankingElement<T>> {
+            auto value_wrapper = make_promise<Policy>([elem1]() { return elem1->value(); });
+            auto compute_next = [self](std::shared_ptr<RankingElement<T, Policy>> n1, std::shared_ptr<RankingElement<T, Policy>> n2, Rank r) -> std::shared_ptr<RankingElement<T, Policy>> {
                 if (n1 == n2) return n1;
                 return self(self, n1, n2, r);
             };
             return make_lazy_node(
                 std::move(value_wrapper),
                 elem1_rank,
-                make_promise([elem1, elem2, elem1_rank, compute_next]() {
+                make_promise<Policy>([elem1, elem2, elem1_rank, compute_next]() {
                     auto next_elem1 = elem1->next();
                     if (next_elem1 == elem2) return next_elem1;
                     return compute_next(next_elem1, elem2, elem1_rank);
-                })
+                }),
+                pool
             );
         } else {
             auto elem2_rank = elem2->rank();
             // Create a promise wrapper to avoid moving from elem2
-            auto value_wrapper = make_promise([elem2]() { return elem2->value(); });
-            auto compute_next = [self](std::shared_ptr<RankingElement<T>> n1, std::shared_ptr<RankingElement<T>> n2, Rank r) -> std::shared_ptr<RankingElement<T>> {
+            auto value_wrapper = make_promise<Policy>([elem2]() { return elem2->value(); });
+            auto compute_next = [self](std::shared_ptr<RankingElement<T, Policy>> n1, std::shared_ptr<RankingElement<T, Policy>> n2, Rank r) -> std::shared_ptr<RankingElement<T, Policy>> {
                 if (n1 == n2) return n1;
                 return self(self, n1, n2, r);
             };
             return make_lazy_node(
                 std::move(value_wrapper),
                 elem2_rank,
-                make_promise([elem1, elem2, elem2_rank, compute_next]() {
+                make_promise<Policy>([elem1, elem2, elem2_rank, compute_next]() {
                     auto next_elem2 = elem2->next();
                     if (elem1 == next_elem2) return elem1;
                     return compute_next(elem1, next_elem2, elem2_rank);
-                })
+                }),
+                pool
             );
         }
     };
     // Start merge with both heads and rank 0
-    auto merged_head = build_merged_impl(build_merged_impl, rf1.head(), rf2.head(), Rank::zero());
+    auto merged_head = build_merged_impl(build_merged_impl, rf1.raw_head(), rf2.raw_head(), Rank::zero());
     
-    return RankingFunction<T>(merged_head, deduplicate);
+    return RankingFunction<T, Policy>(merged_head, deduplicate).with_rank_offset(rank_offset, overflow);
+}
+
+namespace detail {
+
+/**
+ * @brief Position in one input of merge_all.
+ *
+ * Holds the next unconsumed (stored) element, its rank with the input's rank
+ * offset applied, the input index, the offset itself and which copy of a
+ * repeated input it walks.
+ */
+template<typename T, typename Policy>
+struct MergeCursor {
+    std::shared_ptr<RankingElement<T, Policy>> elem;
+    Rank rank;
+    std::size_t source;
+    std::int64_t rank_offset;
+    RankOverflow overflow;
+    std::size_t copy;  ///< Earlier inputs with the same head (kept without deduplication)
+};
+
+/// Heap order for merge_all: lowest rank first, ties broken by input index.
+template<typename T, typename Policy>
+[[nodiscard]] bool merge_cursor_after(const MergeCursor<T, Policy>& lhs, const MergeCursor<T, Policy>& rhs) {
+    if (lhs.rank != rhs.rank) {
+        return lhs.rank > rhs.rank;
+    }
+    return lhs.source > rhs.source;
+}
+
+/// Identifies the sequence a merge_all cursor walks: stored node, rank offset, overflow mode and copy.
+template<typename T, typename Policy>
+struct MergeCursorKey {
+    const RankingElement<T, Policy>* elem;
+    std::int64_t rank_offset;
+    RankOverflow overflow;
+    std::size_t copy = 0;
+
+    [[nodiscard]] bool operator==(const MergeCursorKey&) const = default;
+};
+
+template<typename T, typename Policy>
+struct MergeCursorKeyHash {
+    [[nodiscard]] std::size_t operator()(const MergeCursorKey<T, Policy>& key) const noexcept {
+        std::size_t seed = std::hash<const RankingElement<T, Policy>*>{}(key.elem);
+        seed ^= std::hash<std::int64_t>{}(key.rank_offset) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+        return seed ^ static_cast<std::size_t>(key.overflow) ^ (key.copy << 1);
+    }
+};
+
+/**
+ * @brief Mutable state shared by the nodes of one merge_all result.
+ *
+ * Only the newest node of the result holds an unforced next promise, and it
+ * is the only code that touches the heap, so the state needs no lock of its
+ * own: Promise already runs each thunk at most once.
+ */
+template<typename T, typename Policy>
+struct MergeAllState {
+    std::vector<MergeCursor<T, Policy>> heap;  ///< Min-heap of input heads (see merge_cursor_after)
+    /// Number of heap cursors standing on each (node, offset, overflow).
+    std::unordered_map<MergeCursorKey<T, Policy>, std::size_t, MergeCursorKeyHash<T, Policy>> live;
+    std::shared_ptr<NodePool> pool;
+
+    [[nodiscard]] static MergeCursorKey<T, Policy> key_of(const MergeCursor<T, Policy>& cursor) noexcept {
+        return {cursor.elem.get(), cursor.rank_offset, cursor.overflow, cursor.copy};
+    }
+
+    /// Whether a live cursor already walks the sequence starting at @p key.
+    [[nodiscard]] bool shared(const MergeCursorKey<T, Policy>& key) const {
+        return live.contains(key);
+    }
+
+    void push(MergeCursor<T, Policy> cursor) {
+        ++live[key_of(cursor)];
+        heap.push_back(std::move(cursor));
+        std::push_heap(heap.begin(), heap.end(), merge_cursor_after<T, Policy>);
+    }
+
+    [[nodiscard]] MergeCursor<T, Policy> pop() {
+        std::pop_heap(heap.begin(), heap.end(), merge_cursor_after<T, Policy>);
+        MergeCursor<T, Policy> top = std::move(heap.back());
+        heap.pop_back();
+        if (const auto it = live.find(key_of(top)); --it->second == 0) {
+            live.erase(it);
+        }
+        return top;
+    }
+};
+
+/**
+ * @brief Emit the minimum input head and defer the rest of the merge.
+ *
+ * The successor of the emitted element is forced only when the emitted node's
+ * own next is forced. Once a single unshifted input remains its tail is
+ * returned as is.
+ */
+template<typename T, typename Policy>
+[[nodiscard]] std::shared_ptr<RankingElement<T, Policy>> merge_all_next(
+    const std::shared_ptr<MergeAllState<T, Policy>>& state)
+{
+    auto& heap = state->heap;
+    if (heap.empty()) {
+        return nullptr;
+    }
+    if (heap.size() == 1 && heap.front().rank_offset == 0) {
+        return heap.front().elem;
+    }
+
+    MergeCursor<T, Policy> top = state->pop();
+
+    auto elem = top.elem;
+    const Rank rank = top.rank;
+    return allocate_pooled<RankingElement<T, Policy>>(
+        state->pool,
+        make_promise<Policy>([elem]() { return elem->value(); }),
+        rank,
+        make_promise<Policy>([state, top = std::move(top)]() {
+            auto next = top.elem->next();
+            if (next && !state->shared({next.get(), top.rank_offset, top.overflow, top.copy})) {
+                const Rank next_rank = offset_rank(next->rank(), top.rank_offset, top.overflow);
+                state->push(
+                    {std::move(next), next_rank, top.source, top.rank_offset, top.overflow, top.copy});
+            }
+            return merge_all_next<T, Policy>(state);
+        }));
 }
 
+}  // namespace detail
+
 /**
  * @brief Merge multiple ranking functions in rank order.
  *
@@ -217,7 +379,17 @@ template<typename T>
  * elements ordered by rank. Elements at the same rank are ordered by their
  * position in the input vector (earlier functions take precedence).
  *
- * The merge is **fully lazy** - elements are only computed as needed.
+ * The inputs are merged by one k-way merge: a min-heap holds the current head
+ * of every input, keyed by (rank, input index). The merge is **fully lazy** -
+ * an input's successor is forced only after its current head has been
+ * emitted and the next output element is requested. Inputs whose tails
+ * reach the same stored element under the same rank offset and overflow
+ * mode share the rest of their sequence, which is merged only once, as in
+ * merge(). When deduplication is enabled, inputs that start at the same
+ * element are merged only once as well; without it they are kept twice,
+ * again as in merge(). Each input's rank offset is applied as its ranks are
+ * read, so shifted inputs are not copied. A single input is returned with
+ * @p deduplicate applied.
  *
  * This matches the Racket ranked-programming library's merge-list semantics.
  *
@@ -229,7 +401,7 @@ template<typename T>
  *
  * @par Complexity
  * Time: O(k) to create the merge where k is the number of ranking functions,
- *       O(n1+n2+...+nk) to traverse all elements.
+ *       O(log k) per element traversed.
  * Space: O(k) for the merge structure.
  *
  * @par Example
@@ -241,29 +413,47 @@ template<typename T>
  * // merged contains: 1@0, 2@1, 3@2, 4@3
  * @endcode
  */
-template<typename T>
-[[nodiscard]] RankingFunction<T> merge_all(
-    const std::vector<RankingFunction<T>>& rankings,
-    Deduplication deduplicate = Deduplication::Enabled)
+template<typename T, typename Policy>
+[[nodiscard]] RankingFunction<T, Policy> merge_all(
+    const std::vector<RankingFunction<T, Policy>>& rankings,
+    Deduplication deduplicate)  // defaults to Enabled (see the declaration above)
 {
     if (rankings.empty()) {
-        return RankingFunction<T>();
+        return RankingFunction<T, Policy>();
     }
     
     if (rankings.size() == 1) {
-        return rankings[0];
+        const auto& only = rankings[0];
+        return RankingFunction<T, Policy>(only.raw_head(), deduplicate, only.chunk_size())
+            .with_rank_offset(only.rank_offset(), only.rank_overflow());
     }
-    
-    // Iteratively merge all ranking functions
-    // Start with first, then merge each subsequent one
-    RankingFunction<T> result = rankings[0];
-    for (std::size_t i = 1; i < rankings.size(); ++i) {
-        result = merge(result, rankings[i], deduplicate);
+
+    auto state = std::make_shared<detail::MergeAllState<T, Policy>>();
+    state->pool = current_node_pool();
+    state->heap.reserve(rankings.size());
+    for (std::size_t i = 0; i < rankings.size(); ++i) {
+        const auto& rf = rankings[i];
+        const auto& head = rf.raw_head();
+        if (!head) {
+            continue;
+        }
+        detail::MergeCursorKey<T, Policy> key{head.get(), rf.rank_offset(), rf.rank_overflow()};
+        if (state->shared(key)) {
+            if (deduplicate == Deduplication::Enabled) {
+                continue;
+            }
+            // Without deduplication a repeated input is kept as a separate
+            // copy, like the copy merge() makes of an input merged with itself.
+            while (state->shared(key)) {
+                ++key.copy;
+            }
+        }
+        state->push({head, rf.rank_of(*head), i, rf.rank_offset(), rf.rank_overflow(), key.copy});
     }
-    
-    return result;
+
+    return RankingFunction<T, Policy>(detail::merge_all_next<T, Policy>(state), deduplicate);
 }
 
-}  // namespace ranked_belief
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI
 
 #endif  // RANKED_BELIEF_OPERATIONS_MERGE_HPP
@@ -13,57 +13,66 @@
 #ifndef RANKED_BELIEF_OPERATIONS_MERGE_APPLY_HPP
 #define RANKED_BELIEF_OPERATIONS_MERGE_APPLY_HPP
 
+#include "ranked_belief/intern.hpp"
 #include "ranked_belief/promise.hpp"
 #include "ranked_belief/rank.hpp"
+#include "ranked_belief/rank_horizon.hpp"
 #include "ranked_belief/ranking_element.hpp"
 #include "ranked_belief/ranking_function.hpp"
+#include "ranked_belief/types.hpp"
 #include "ranked_belief/operations/merge.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
-namespace ranked_belief {
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
 
-// Helper trait to extract element type from RankingFunction<T>
+// Helper trait to extract element type from RankingFunction<T, Policy>
 template<typename RF>
 struct ranking_function_element_type;
 
-template<typename T>
-struct ranking_function_element_type<RankingFunction<T>> {
+template<typename T, typename Policy>
+struct ranking_function_element_type<RankingFunction<T, Policy>> {
     using type = T;
 };
 
 template<typename RF>
 using ranking_function_element_type_t = typename ranking_function_element_type<RF>::type;
 
-// Forward declaration for merge_with_ranks helper
 namespace detail {
-    template<typename T>
-    using ElementPromisePtr = std::shared_ptr<Promise<std::shared_ptr<RankingElement<T>>>>;
-
-    template<typename T>
-    std::shared_ptr<RankingElement<T>> merge_with_ranks(
-        std::shared_ptr<RankingElement<T>> first,
-        Rank first_rank,
-        ElementPromisePtr<T> second_promise,
-        Rank second_min_rank);
+    /**
+     * @brief Add two ranks using the requested overflow behaviour.
+     */
+    [[nodiscard]] inline Rank add_ranks(Rank lhs, Rank rhs, RankOverflow overflow) {
+        return overflow == RankOverflow::Saturate ? lhs.saturating_add(rhs) : lhs + rhs;
+    }
 }
 
 /**
  * @brief Shift all ranks in a ranking function by a constant amount.
  *
  * Creates a new ranking function where every element's rank is increased by
- * the specified shift amount. This is fully lazy - ranks are computed on
- * demand during traversal.
+ * the specified shift amount. The shift is recorded as the result's rank
+ * offset (see RankingFunction::shifted()), so no nodes are built and shifting
+ * an already shifted ranking adds to its offset. Amounts too large to carry
+ * as an offset (including infinity) fall back to a lazily shifted copy.
  *
  * @tparam T The value type in the ranking function.
  * @param rf The ranking function to shift.
  * @param shift_amount The amount to add to each rank.
+ * @param overflow Whether overflowing ranks throw (default) or saturate.
  * @return A new ranking function with shifted ranks.
+ * @throws std::overflow_error while reading, if a shifted rank overflows and
+ *         @p overflow is RankOverflow::Throw.
  *
  * @par Complexity
- * Time: O(1) to create, O(n) to traverse all elements.
- * Space: O(1) for the initial call, O(depth) for recursive structure.
+ * Time: O(1) to create; reading a rank costs one addition.
+ * Space: O(1).
  *
  * @par Example
  * @code
@@ -71,63 +80,191 @@ namespace detail {
  * auto shifted = shift_ranks(rf, Rank::from_value(10));  // ranks: 10, 11, 12
  * @endcode
  */
-template<typename T>
-[[nodiscard]] RankingFunction<T> shift_ranks(
-    const RankingFunction<T>& rf,
-    Rank shift_amount)
+template<typename T, typename Policy>
+[[nodiscard]] RankingFunction<T, Policy> shift_ranks(
+    const RankingFunction<T, Policy>& rf,
+    Rank shift_amount,
+    RankOverflow overflow = RankOverflow::Throw)
 {
     if (shift_amount == Rank::zero()) {
         return rf;
     }
-    
-    // Use shared_ptr to allow capture in lazy computations
-    using BuildFunc = std::function<std::shared_ptr<RankingElement<T>>(
-        std::shared_ptr<RankingElement<T>>)>;
-    auto build_shifted = std::make_shared<BuildFunc>();
-    std::weak_ptr<BuildFunc> weak_build = build_shifted;
-    
-    *build_shifted = [weak_build, shift_amount](
-        std::shared_ptr<RankingElement<T>> elem)
-        -> std::shared_ptr<RankingElement<T>>
-    {
-        if (!elem) {
-            return nullptr;
-        }
+    if (!shift_amount.is_infinity() &&
+        shift_amount.value() <= static_cast<std::uint64_t>(detail::kMaxRankOffset)) {
+        return rf.shifted(static_cast<std::int64_t>(shift_amount.value()), overflow);
+    }
+
+    return RankingFunction<T, Policy>(
+        detail::remap_ranks<T>(
+            rf.raw_head(),
+            [shift_amount, overflow, offset = rf.rank_offset(), offset_overflow = rf.rank_overflow()](
+                Rank rank) {
+                return detail::add_ranks(
+                    detail::offset_rank(rank, offset, offset_overflow), shift_amount, overflow);
+            }),
+        from_bool(rf.is_deduplicating())
+    );
+}
 
-        Rank new_rank = elem->rank() + shift_amount;
+namespace detail {
+    /**
+     * @brief Position in one continuation result of merge_apply.
+     *
+     * The continuation's own nodes are walked directly; the input element's rank
+     * is kept as an offset and added when the cursor moves, instead of building
+     * a shifted copy of the continuation. The continuation's own rank offset
+     * (RankingFunction::rank_offset()) is applied first.
+     */
+    template<typename U, typename Policy>
+    struct ApplyCursor {
+        std::shared_ptr<RankingElement<U, Policy>> elem;  ///< Next unconsumed continuation element
+        Rank offset;                                      ///< Rank of the input element it came from
+        Rank rank;                                        ///< elem's reported rank shifted by offset
+        std::size_t source;                               ///< Index of that input element
+        std::int64_t inner_offset;                        ///< Rank offset of the continuation
+        RankOverflow inner_overflow;                      ///< Overflow mode of inner_offset
+    };
 
-        auto build_ref = weak_build.lock();
+    /// Heap order for merge_apply: lowest shifted rank first, ties by input index.
+    template<typename U, typename Policy>
+    [[nodiscard]] bool apply_cursor_after(const ApplyCursor<U, Policy>& lhs,
+                                          const ApplyCursor<U, Policy>& rhs) {
+        if (lhs.rank != rhs.rank) {
+            return lhs.rank > rhs.rank;
+        }
+        return lhs.source > rhs.source;
+    }
 
-        auto compute_value = [elem]() -> T {
-            return elem->value();
-        };
+    /**
+     * @brief Frontier of one merge_apply result.
+     *
+     * The frontier is a min-heap of cursors into the continuations expanded so
+     * far plus the first input element that has not been expanded yet. That
+     * element's rank is a lower bound for every result still to come from the
+     * input, so it is expanded only once no cursor can beat it.
+     *
+     * Under a rank horizon (see rank_horizon.hpp) the same bound prunes: input
+     * ranked above the horizon is never expanded and cursors above it are
+     * dropped.
+     *
+     * Only the newest node of the result holds an unforced next promise and
+     * only that thunk touches the frontier, so it needs no lock of its own.
+     *
+     * The input and the continuations' results each keep their own promise
+     * policy (InputPolicy and Policy); the result is built with Policy.
+     */
+    template<typename T, typename InputPolicy, typename U, typename Policy, typename Func>
+    struct ApplyFrontier {
+        using result_type = U;
+        using policy_type = Policy;
+
+        Func func;
+        RankOverflow overflow;
+        std::shared_ptr<NodePool> pool;
+        InternTables intern_tables;                               ///< Installed while continuations run
+        std::vector<ApplyCursor<U, Policy>> heap;
+        std::shared_ptr<RankingElement<T, InputPolicy>> pending;  ///< First unexpanded (raw) input element
+        std::int64_t input_offset = 0;                            ///< Rank offset of the input ranking
+        RankOverflow input_overflow = RankOverflow::Throw;
+        Rank horizon = Rank::infinity();                          ///< Results above this rank are pruned
+        std::size_t pending_index = 0;
+
+        /// Rank of the pending input element as the input ranking reports it.
+        [[nodiscard]] Rank pending_rank() const {
+            return offset_rank(pending->rank(), input_offset, input_overflow);
+        }
 
-        auto compute_next = [weak_build, build_ref, elem]()
-            -> std::shared_ptr<RankingElement<T>>
+        /// Start a cursor at @p elem if it exists.
+        void push(std::shared_ptr<RankingElement<U, Policy>> elem,
+                  Rank offset,
+                  std::size_t source,
+                  std::int64_t inner_offset,
+                  RankOverflow inner_overflow)
         {
-            auto next_elem = elem->next();
+            if (!elem) {
+                return;
+            }
+            const Rank rank = add_ranks(
+                offset_rank(elem->rank(), inner_offset, inner_overflow), offset, overflow);
+            if (rank > horizon) {
+                return;
+            }
+            heap.push_back({std::move(elem), offset, rank, source, inner_offset, inner_overflow});
+            std::push_heap(heap.begin(), heap.end(), apply_cursor_after<U, Policy>);
+        }
 
-            if (auto locked = weak_build.lock()) {
-                return (*locked)(next_elem);
+        /// Apply the continuation to the pending input element.
+        void expand() {
+            const Rank offset = pending_rank();
+            auto elem = std::move(pending);
+            const std::size_t source = pending_index;
+            {
+                NodePoolScope pool_scope(pool);
+                InternTablesScope intern_scope(intern_tables);
+                RankHorizonScope horizon_scope(horizon_below(horizon, offset));
+                RankingFunction<U, Policy> result_rf = func(elem->value());
+                push(result_rf.raw_head(), offset, source,
+                     result_rf.rank_offset(), result_rf.rank_overflow());
             }
+            pending = elem->next();
+            ++pending_index;
+        }
+    };
 
-            if (build_ref) {
-                return (*build_ref)(next_elem);
+    /**
+     * @brief Emit the next element of a merge_apply result.
+     *
+     * Expands input elements until the best cursor ranks no higher than the
+     * pending input's rank, then emits that cursor's element. The cursor is
+     * advanced only when the emitted node's next is forced.
+     *
+     * @tparam Frontier ApplyFrontier, or a frontier derived from it that
+     *         provides its own expand() (see parallel_merge_apply()).
+     */
+    template<typename Frontier>
+    [[nodiscard]] auto apply_frontier_next(const std::shared_ptr<Frontier>& frontier)
+        -> std::shared_ptr<RankingElement<typename Frontier::result_type, typename Frontier::policy_type>>
+    {
+        using U = typename Frontier::result_type;
+        using Policy = typename Frontier::policy_type;
+        auto& heap = frontier->heap;
+        while (frontier->pending) {
+            const Rank pending_rank = frontier->pending_rank();
+            if (pending_rank > frontier->horizon) {
+                frontier->pending = nullptr;
+                break;
+            }
+            if (!heap.empty() && heap.front().rank <= pending_rank) {
+                break;
             }
+            frontier->expand();
+        }
+        if (heap.empty()) {
             return nullptr;
-        };
+        }
 
-        return std::make_shared<RankingElement<T>>(
-            make_promise(std::move(compute_value)),
-            new_rank,
-            make_promise(std::move(compute_next))
-        );
-    };
-    
-    return RankingFunction<T>(
-        (*build_shifted)(rf.head()),
-        from_bool(rf.is_deduplicating())
-    );
+        // The last continuation left with no input to come passes through
+        // unshifted, unless a horizon still has to cut its tail.
+        if (!frontier->pending && heap.size() == 1 && heap.front().offset == Rank::zero() &&
+            heap.front().inner_offset == 0 && frontier->horizon.is_infinity()) {
+            return heap.front().elem;
+        }
+
+        std::pop_heap(heap.begin(), heap.end(), apply_cursor_after<U, Policy>);
+        ApplyCursor<U, Policy> top = std::move(heap.back());
+        heap.pop_back();
+
+        auto elem = top.elem;
+        return allocate_pooled<RankingElement<U, Policy>>(
+            frontier->pool,
+            elem->value(),
+            top.rank,
+            make_promise<Policy>([frontier, top = std::move(top)]() {
+                frontier->push(
+                    top.elem->next(), top.offset, top.source, top.inner_offset, top.inner_overflow);
+                return apply_frontier_next(frontier);
+            }));
+    }
 }
 
 /**
@@ -141,7 +278,18 @@ template<typename T>
  * similar to flatMap or bind in functional programming.
  *
  * The operation is **fully lazy** - functions are only applied and results merged
- * as elements are accessed during traversal.
+ * as elements are accessed during traversal. Results are produced best-first
+ * from a frontier: a min-heap of cursors into the continuations applied so far,
+ * plus the next input element, whose rank bounds everything the remaining
+ * input can still produce. `func` is applied to that element only when no
+ * cursor ranks at or below it. Each output element costs O(log k) for k
+ * expanded continuations, independent of how deep in the input it came from.
+ * Elements of equal rank are ordered by input position.
+ *
+ * Under a rank horizon K (see rank_horizon.hpp, with_rank_horizon()) `func`
+ * is never applied to input ranked above K, results above K are dropped, and
+ * `func` runs with the horizon lowered by its input's rank, so nested
+ * merge_apply calls prune their own branches.
  *
  * This matches the Racket ranked-programming library's merge-apply semantics:
  * - Apply function to each value in input ranking
@@ -155,13 +303,15 @@ template<typename T>
  * @tparam U The output value type (deduced from Func return type).
  * @param rf The input ranking function.
  * @param func A function taking const T& and returning RankingFunction\<U\>.
+ *        The result has the promise policy of the rankings @p func returns.
  * @param deduplicate Whether to deduplicate the result (default: true).
+ * @param overflow Whether overflowing shifted ranks throw (default) or saturate.
  * @return A new ranking function containing all merged results.
  *
  * @par Complexity
- * Time: O(1) to create the merge_apply, O(n*m) to traverse all elements where
- *       n is input size and m is average result size.
- * Space: O(1) for the initial call, O(depth) for recursive structure.
+ * Time: O(1) amortized to create the merge_apply, O(log k) per element
+ *       traversed, where k is the number of continuations expanded so far.
+ * Space: O(k) for the frontier.
  *
  * @par Example
  * @code
@@ -176,164 +326,29 @@ template<typename T>
  * //         3@2 (from 3), 30@3 (from 3)
  * @endcode
  */
-template<typename T, typename Func>
+template<typename T, typename Func, typename InputPolicy>
 [[nodiscard]] auto merge_apply(
-    const RankingFunction<T>& rf,
+    const RankingFunction<T, InputPolicy>& rf,
     Func&& func,
-    Deduplication deduplicate = Deduplication::Enabled)
+    Deduplication deduplicate = Deduplication::Enabled,
+    RankOverflow overflow = RankOverflow::Throw)
     -> std::invoke_result_t<Func, const T&>
 {
     using ResultRF = std::invoke_result_t<Func, const T&>;
     using U = ranking_function_element_type_t<ResultRF>;
-    
-    // Recursive builder function
-    using BuildFunc = std::function<std::shared_ptr<RankingElement<U>>(
-        std::shared_ptr<RankingElement<T>>)>;
-    auto build_merge_apply = std::make_shared<BuildFunc>();
-    std::weak_ptr<BuildFunc> weak_build = build_merge_apply;
-    
-    *build_merge_apply = [weak_build, func](
-        std::shared_ptr<RankingElement<T>> elem)
-        -> std::shared_ptr<RankingElement<U>>
-    {
-        if (!elem) {
-            return nullptr;
-        }
+    using Policy = typename ResultRF::policy_type;
+    using Frontier = detail::ApplyFrontier<T, InputPolicy, U, Policy, std::decay_t<Func>>;
 
-    auto build_ref = weak_build.lock();
-        
-    // Get current element's rank and value
-        Rank current_rank = elem->rank();
-        T current_value = elem->value();
-        
-        // Apply function to get result ranking
-        RankingFunction<U> result_rf = func(current_value);
-        
-        // Shift result ranks by current element's rank
-        RankingFunction<U> shifted_rf = shift_ranks(result_rf, current_rank);
-        
-        // Head of shifted result (may be null if function returns empty ranking)
-        auto shifted_head = shifted_rf.head();
+    auto frontier = std::make_shared<Frontier>(Frontier{
+        std::forward<Func>(func), overflow, current_node_pool(), current_intern_tables(), {},
+        rf.raw_head(), rf.rank_offset(), rf.rank_overflow(), current_rank_horizon()});
 
-        // Prepare lazy computation for the rest of the input sequence
-        auto next_input = elem->next();
-        Rank rest_min_rank = next_input ? next_input->rank() : Rank::infinity();
-
-        detail::ElementPromisePtr<U> rest_promise;
-        if (next_input) {
-            rest_promise = std::make_shared<Promise<std::shared_ptr<RankingElement<U>>>>(
-                make_promise([weak_build, build_ref, next_input]() -> std::shared_ptr<RankingElement<U>> {
-                    if (auto locked = weak_build.lock()) {
-                        return (*locked)(next_input);
-                    }
-
-                    if (build_ref) {
-                        return (*build_ref)(next_input);
-                    }
-                    return nullptr;
-                })
-            );
-        }
-
-        // Merge shifted results with the recursively computed rest using lazy ranks
-        return detail::merge_with_ranks(
-            shifted_head,
-            shifted_head ? shifted_head->rank() : Rank::infinity(),
-            rest_promise,
-            rest_min_rank
-        );
-    };
-    
-    return RankingFunction<U>(
-        (*build_merge_apply)(rf.head()),
+    return RankingFunction<U, Policy>(
+        detail::apply_frontier_next(frontier),
         deduplicate
     );
 }
 
-namespace detail {
-    /**
-     * @brief Merge two element sequences when their first elements' ranks are known.
-     *
-     * This is a lazy merge operation used by merge_apply. It takes the first
-     * element from each sequence (which may be null) and their ranks, and returns
-     * a merged sequence. The recursive calls are wrapped in Promises to maintain
-     * lazy evaluation.
-     *
-     * @tparam T The value type.
-    * @param first First element of the primary sequence (may be null).
-    * @param first_rank Rank of the primary element (infinity if @p first is null).
-    * @param second_promise Lazy thunk that can produce the head of the secondary sequence.
-    * @param second_min_rank Lowest possible rank available from the secondary sequence.
-     * @return Lazily merged sequence head.
-     */
-    template<typename T>
-    std::shared_ptr<RankingElement<T>> merge_with_ranks(
-        std::shared_ptr<RankingElement<T>> first,
-        Rank first_rank,
-        ElementPromisePtr<T> second_promise,
-        Rank second_min_rank)
-    {
-        // If the first sequence is empty, defer to the second sequence
-        if (!first) {
-            return second_promise ? second_promise->force() : nullptr;
-        }
-
-        // If the second sequence cannot produce any elements (infinite rank), take from first
-        if (second_min_rank == Rank::infinity() || !second_promise) {
-            return first;
-        }
-
-        // If the first element's rank is lower or equal to the minimum possible
-        // rank of the second sequence, take from the first sequence without
-        // forcing the second sequence yet.
-        if (first_rank <= second_min_rank) {
-            auto compute_next = [first, second_promise, second_min_rank]()
-                -> std::shared_ptr<RankingElement<T>>
-            {
-                auto first_next = first->next();
-                Rank next_rank = first_next ? first_next->rank() : Rank::infinity();
-                return merge_with_ranks(first_next, next_rank, second_promise, second_min_rank);
-            };
-
-            return std::make_shared<RankingElement<T>>(
-                first->value(),
-                first_rank,
-                make_promise(std::move(compute_next))
-            );
-        }
-
-        // Otherwise, force the second sequence to obtain its head (needed now)
-        auto second = second_promise->force();
-        if (!second) {
-            return first;
-        }
-
-        auto second_next = second->next();
-        Rank second_next_min_rank = second_next ? second_next->rank() : Rank::infinity();
-
-        ElementPromisePtr<T> next_second_promise;
-        if (second_next) {
-            next_second_promise = std::make_shared<Promise<std::shared_ptr<RankingElement<T>>>>(
-                make_promise([second_next]() -> std::shared_ptr<RankingElement<T>> {
-                    return second_next;
-                })
-            );
-        }
-
-        auto compute_next = [first, first_rank, next_second_promise, second_next_min_rank]()
-            -> std::shared_ptr<RankingElement<T>>
-        {
-            return merge_with_ranks(first, first_rank, next_second_promise, second_next_min_rank);
-        };
-
-        return std::make_shared<RankingElement<T>>(
-            second->value(),
-            second->rank(),
-            make_promise(std::move(compute_next))
-        );
-    }
-}
-
-} // namespace ranked_belief
+} // namespace ranked_belief::inline RANKED_BELIEF_ABI
 
 #endif // RANKED_BELIEF_OPERATIONS_MERGE_APPLY_HPP
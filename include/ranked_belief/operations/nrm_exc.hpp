@@ -1,19 +1,24 @@
 #pragma once
 
+#include "ranked_belief/intern.hpp"
+#include "ranked_belief/materialized_ranking.hpp"
 #include "ranked_belief/operations/merge.hpp"
 #include "ranked_belief/operations/merge_apply.hpp"
 #include "ranked_belief/promise.hpp"
+#include "ranked_belief/rank_horizon.hpp"
 #include "ranked_belief/ranking_element.hpp"
 #include "ranked_belief/ranking_function.hpp"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <mutex>
 #include <optional>
 #include <utility>
 #include <vector>
 
-namespace ranked_belief {
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
 
 /**
  * @brief Retrieve the most normal value from a ranking function.
@@ -27,8 +32,8 @@ namespace ranked_belief {
  * @return std::nullopt when the ranking is empty, otherwise the most normal
  *         value (i.e., the one with minimum rank).
  */
-template<typename T>
-[[nodiscard]] std::optional<T> most_normal(const RankingFunction<T>& rf)
+template<typename T, typename Policy>
+[[nodiscard]] std::optional<T> most_normal(const RankingFunction<T, Policy>& rf)
 {
     auto first = rf.first();
     if (!first) {
@@ -44,14 +49,17 @@ template<typename T>
  * value/rank pairs into a std::vector. Only the inspected prefix is forced;
  * the remainder of the ranking stays unevaluated.
  *
+ * To read a ranking page by page, use a TopKCursor (top_k.hpp) rather than
+ * calling take_n() with a growing count.
+ *
  * @tparam T Value type stored in the ranking function.
  * @param rf Source ranking function.
  * @param count Maximum number of entries to retrieve.
  * @return Vector containing up to @p count pairs in increasing rank order.
  */
-template<typename T>
+template<typename T, typename Policy>
 [[nodiscard]] std::vector<std::pair<T, Rank>> take_n(
-    const RankingFunction<T>& rf,
+    const RankingFunction<T, Policy>& rf,
     std::size_t count)
 {
     std::vector<std::pair<T, Rank>> result;
@@ -74,16 +82,84 @@ template<typename T>
     return result;
 }
 
-template<typename T, typename ExceptionalThunk>
+/**
+ * @brief Retrieve the most normal value from a materialized ranking.
+ *
+ * @return std::nullopt when the ranking is empty, otherwise its first value.
+ */
+template<typename T>
+[[nodiscard]] std::optional<T> most_normal(const MaterializedRanking<T>& rf)
+{
+    if (rf.is_empty()) {
+        return std::nullopt;
+    }
+    return std::make_optional(rf.value(0));
+}
+
+/**
+ * @brief Copy the first @p count entries of a materialized ranking.
+ *
+ * Equivalent to take_n() on the corresponding RankingFunction, but reads the
+ * contiguous storage directly and sizes the result exactly.
+ */
+template<typename T>
+[[nodiscard]] std::vector<std::pair<T, Rank>> take_n(
+    const MaterializedRanking<T>& rf,
+    std::size_t count)
+{
+    const std::size_t n = std::min(count, rf.size());
+    std::vector<std::pair<T, Rank>> result;
+    result.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        result.emplace_back(rf.value(i), rf.rank(i));
+    }
+    return result;
+}
+
+namespace detail {
+
+/**
+ * @brief Head of merge(@p first, @p second) with every rank offset applied.
+ *
+ * merge() of two inputs shifted by the same offset returns a shifted
+ * ranking, and head() of that would add a remapping layer per element.
+ * merge_all() applies each input's offset as it reads ranks, so its nodes
+ * already hold final ranks.
+ */
+template<typename T, typename Policy>
+[[nodiscard]] std::shared_ptr<RankingElement<T, Policy>> merged_head(
+    const RankingFunction<T, Policy>& first,
+    const RankingFunction<T, Policy>& second,
+    Deduplication deduplicate)
+{
+    if (first.rank_offset() == 0 && second.rank_offset() == 0) {
+        return merge(first, second, deduplicate).raw_head();
+    }
+    return merge_all<T, Policy>({first, second}, deduplicate).raw_head();
+}
+
+}  // namespace detail
+
+template<typename T, typename ExceptionalThunk, typename Policy>
 requires std::invocable<ExceptionalThunk>
-[[nodiscard]] RankingFunction<T> normal_exceptional(
-    const RankingFunction<T>& normal,
+[[nodiscard]] RankingFunction<T, Policy> normal_exceptional(
+    const RankingFunction<T, Policy>& normal,
     ExceptionalThunk exceptional,
     Rank exceptional_rank = Rank::from_value(1),
     Deduplication deduplicate = Deduplication::Disabled)
 {
-    auto normal_head = normal.head();
+    // The exceptional branch is pruned, without running its thunk, when it
+    // starts above the current rank horizon (see rank_horizon.hpp).
+    const Rank horizon = current_rank_horizon();
+    const bool exceptional_pruned = exceptional_rank > horizon;
+
+    // Heads are read raw; tails rebuilt from them carry their ranking's rank offset.
+    const auto& normal_head = normal.raw_head();
     if (!normal_head) {
+        if (exceptional_pruned) {
+            return RankingFunction<T, Policy>(nullptr, deduplicate);
+        }
+        RankHorizonScope horizon_scope(detail::horizon_below(horizon, exceptional_rank));
         auto exceptional_rf = std::invoke(std::forward<ExceptionalThunk>(exceptional));
         if (exceptional_rank != Rank::zero()) {
             exceptional_rf = shift_ranks(exceptional_rf, exceptional_rank);
@@ -91,7 +167,10 @@ requires std::invocable<ExceptionalThunk>
         return exceptional_rf;
     }
 
+    const auto pool = current_node_pool();
     const bool normal_dedup = normal.is_deduplicating();
+    const std::int64_t normal_offset = normal.rank_offset();
+    const RankOverflow normal_overflow = normal.rank_overflow();
     auto dedup_from_bool = [](bool flag) {
         return flag ? Deduplication::Enabled : Deduplication::Disabled;
     };
@@ -100,16 +179,20 @@ requires std::invocable<ExceptionalThunk>
 
     struct ExceptionalState {
         std::once_flag flag;
-        RankingFunction<T> ranking;
+        RankingFunction<T, Policy> ranking;
     };
 
     auto state = std::make_shared<ExceptionalState>();
     auto thunk_storage = std::make_shared<std::optional<ExceptionalThunkType>>(std::in_place, std::forward<ExceptionalThunk>(exceptional));
 
-    auto ensure_exceptional = [state, thunk_storage, exceptional_rank]() -> RankingFunction<T>& {
+    auto ensure_exceptional = [state, thunk_storage, exceptional_rank, exceptional_pruned, horizon, pool,
+                               intern_tables = current_intern_tables()]() -> RankingFunction<T, Policy>& {
         std::call_once(state->flag, [&]() {
-            RankingFunction<T> realised;
-            if (auto& stored = *thunk_storage; stored) {
+            NodePoolScope pool_scope(pool);
+            InternTablesScope intern_scope(intern_tables);
+            RankingFunction<T, Policy> realised;
+            if (auto& stored = *thunk_storage; stored && !exceptional_pruned) {
+                RankHorizonScope horizon_scope(detail::horizon_below(horizon, exceptional_rank));
                 auto rf = std::invoke(std::move(*stored));
                 stored.reset();
                 if (exceptional_rank != Rank::zero()) {
@@ -122,92 +205,94 @@ requires std::invocable<ExceptionalThunk>
         return state->ranking;
     };
 
-    const Rank normal_rank = normal_head->rank();
+    const Rank normal_rank = normal.rank_of(*normal_head);
     bool use_normal_head = true;
-    std::shared_ptr<RankingElement<T>> exceptional_head;
+    std::shared_ptr<RankingElement<T, Policy>> exceptional_head;
 
     if (exceptional_rank <= normal_rank) {
         auto& exceptional_rf = ensure_exceptional();
-        exceptional_head = exceptional_rf.head();
-        if (exceptional_head && exceptional_head->rank() < normal_rank) {
+        exceptional_head = exceptional_rf.raw_head();
+        if (exceptional_head && exceptional_rf.rank_of(*exceptional_head) < normal_rank) {
             use_normal_head = false;
         }
     }
 
     if (use_normal_head) {
-        auto value_promise = make_promise([normal_head]() -> T {
+        auto value_promise = make_promise<Policy>([normal_head]() -> T {
             return normal_head->value();
         });
 
-        auto next_promise = make_promise([normal_head, normal_dedup, deduplicate, ensure_exceptional, dedup_from_bool]() {
+        auto next_promise = make_promise<Policy>([normal_head, normal_dedup, normal_offset, normal_overflow, deduplicate, ensure_exceptional, dedup_from_bool, pool]() {
+            NodePoolScope pool_scope(pool);
             auto next_head = normal_head->next();
-            RankingFunction<T> normal_tail(
+            auto normal_tail = RankingFunction<T, Policy>(
                 std::move(next_head),
-                dedup_from_bool(normal_dedup));
+                dedup_from_bool(normal_dedup)).with_rank_offset(normal_offset, normal_overflow);
 
-            auto& exceptional_rf = ensure_exceptional();
-            auto merged = merge(normal_tail, exceptional_rf, deduplicate);
-            return merged.head();
+            return detail::merged_head(normal_tail, ensure_exceptional(), deduplicate);
         });
 
-        auto combined_head = std::make_shared<RankingElement<T>>(
+        auto combined_head = allocate_pooled<RankingElement<T, Policy>>(
+            pool,
             std::move(value_promise),
             normal_rank,
             std::move(next_promise));
 
-        return RankingFunction<T>(std::move(combined_head), deduplicate);
+        return RankingFunction<T, Policy>(std::move(combined_head), deduplicate);
     }
 
     // Exceptional head outranks the normal head.
     auto& exceptional_rf = ensure_exceptional();
-    exceptional_head = exceptional_rf.head();
+    exceptional_head = exceptional_rf.raw_head();
 
     if (!exceptional_head) {
         // Exceptional branch ended up empty; fall back to the normal branch.
-        auto value_promise = make_promise([normal_head]() -> T {
+        auto value_promise = make_promise<Policy>([normal_head]() -> T {
             return normal_head->value();
         });
 
-        auto next_promise = make_promise([normal_head, normal_dedup, deduplicate, ensure_exceptional, dedup_from_bool]() {
+        auto next_promise = make_promise<Policy>([normal_head, normal_dedup, normal_offset, normal_overflow, deduplicate, ensure_exceptional, dedup_from_bool, pool]() {
+            NodePoolScope pool_scope(pool);
             auto next_head = normal_head->next();
-            RankingFunction<T> normal_tail(
+            auto normal_tail = RankingFunction<T, Policy>(
                 std::move(next_head),
-                dedup_from_bool(normal_dedup));
+                dedup_from_bool(normal_dedup)).with_rank_offset(normal_offset, normal_overflow);
 
-            auto& exceptional_rf_inner = ensure_exceptional();
-            auto merged = merge(normal_tail, exceptional_rf_inner, deduplicate);
-            return merged.head();
+            return detail::merged_head(normal_tail, ensure_exceptional(), deduplicate);
         });
 
-        auto combined_head = std::make_shared<RankingElement<T>>(
+        auto combined_head = allocate_pooled<RankingElement<T, Policy>>(
+            pool,
             std::move(value_promise),
             normal_rank,
             std::move(next_promise));
 
-        return RankingFunction<T>(std::move(combined_head), deduplicate);
+        return RankingFunction<T, Policy>(std::move(combined_head), deduplicate);
     }
 
-    auto exceptional_value_promise = make_promise([exceptional_head]() -> T {
+    auto exceptional_value_promise = make_promise<Policy>([exceptional_head]() -> T {
         return exceptional_head->value();
     });
 
-    auto next_promise = make_promise([normal, deduplicate, ensure_exceptional, exceptional_head, dedup_from_bool]() {
+    auto next_promise = make_promise<Policy>([normal, deduplicate, ensure_exceptional, exceptional_head, dedup_from_bool, pool]() {
+        NodePoolScope pool_scope(pool);
         auto& realised = ensure_exceptional();
         auto tail_head = exceptional_head->next();
-        RankingFunction<T> exceptional_tail(
+        auto exceptional_tail = RankingFunction<T, Policy>(
             std::move(tail_head),
-            dedup_from_bool(realised.is_deduplicating()));
+            dedup_from_bool(realised.is_deduplicating()))
+            .with_rank_offset(realised.rank_offset(), realised.rank_overflow());
 
-        auto merged = merge(normal, exceptional_tail, deduplicate);
-        return merged.head();
+        return detail::merged_head(normal, exceptional_tail, deduplicate);
     });
 
-    auto combined_head = std::make_shared<RankingElement<T>>(
+    auto combined_head = allocate_pooled<RankingElement<T, Policy>>(
+        pool,
         std::move(exceptional_value_promise),
-        exceptional_head->rank(),
+        exceptional_rf.rank_of(*exceptional_head),
         std::move(next_promise));
 
-    return RankingFunction<T>(std::move(combined_head), deduplicate);
+    return RankingFunction<T, Policy>(std::move(combined_head), deduplicate);
 }
 
-} // namespace ranked_belief
+} // namespace ranked_belief::inline RANKED_BELIEF_ABI
@@ -1,15 +1,19 @@
 #pragma once
 
+#include "ranked_belief/materialized_ranking.hpp"
 #include "ranked_belief/ranking_element.hpp"
 #include "ranked_belief/ranking_function.hpp"
+#include "ranked_belief/rank_horizon.hpp"
 #include "ranked_belief/operations/filter.hpp"
 
 #include <concepts>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <utility>
+#include <vector>
 
-namespace ranked_belief {
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
 
 namespace detail {
 
@@ -17,32 +21,36 @@ namespace detail {
  * @brief Lazily subtract a constant rank from every element in a sequence.
  *
  * Builds a new ranking sequence that mirrors the input but with each element's
- * rank decreased by `shift_amount`. The computation is fully lazy: the tail is
- * only normalized when forced.
+ * rank decreased by `shift_amount`. Stored ranks are read with `rank_offset`
+ * applied first. The computation is fully lazy: the tail is only normalized
+ * when forced.
  */
-template<typename T>
-[[nodiscard]] std::shared_ptr<RankingElement<T>> normalize_with_shift(
-    const std::shared_ptr<RankingElement<T>>& elem,
-    Rank shift_amount)
+template<typename T, typename Policy>
+[[nodiscard]] std::shared_ptr<RankingElement<T, Policy>> normalize_with_shift(
+    const std::shared_ptr<RankingElement<T, Policy>>& elem,
+    Rank shift_amount,
+    std::int64_t rank_offset = 0,
+    RankOverflow overflow = RankOverflow::Throw)
 {
-    using BuildFunc = std::function<std::shared_ptr<RankingElement<T>>(
-        std::shared_ptr<RankingElement<T>>) >;
+    using BuildFunc = std::function<std::shared_ptr<RankingElement<T, Policy>>(
+        std::shared_ptr<RankingElement<T, Policy>>) >;
     auto build_normalized = std::make_shared<BuildFunc>();
     std::weak_ptr<BuildFunc> weak_build = build_normalized;
 
-    *build_normalized = [weak_build, shift_amount](
-        std::shared_ptr<RankingElement<T>> current) -> std::shared_ptr<RankingElement<T>> {
+    *build_normalized = [weak_build, shift_amount, rank_offset, overflow, pool = current_node_pool()](
+        std::shared_ptr<RankingElement<T, Policy>> current) -> std::shared_ptr<RankingElement<T, Policy>> {
         if (!current) {
             return nullptr;
         }
 
-        if (current->rank().is_infinity()) {
+        const Rank rank = offset_rank(current->rank(), rank_offset, overflow);
+        if (rank.is_infinity()) {
             return nullptr;
         }
 
         auto build_ref = weak_build.lock();
 
-        auto compute_next = [weak_build, build_ref, current]() -> std::shared_ptr<RankingElement<T>> {
+        auto compute_next = [weak_build, build_ref, current]() -> std::shared_ptr<RankingElement<T, Policy>> {
             auto next_elem = current->next();
 
             if (auto locked = weak_build.lock()) {
@@ -55,12 +63,13 @@ template<typename T>
             return nullptr;
         };
 
-        Rank adjusted_rank = current->rank() - shift_amount;
+        Rank adjusted_rank = rank - shift_amount;
 
-        return std::make_shared<RankingElement<T>>(
+        return allocate_pooled<RankingElement<T, Policy>>(
+            pool,
             current->value(),
             adjusted_rank,
-            make_promise(std::move(compute_next))
+            make_promise<Policy>(std::move(compute_next))
         );
     };
 
@@ -75,56 +84,130 @@ template<typename T>
  * Matches the Racket `observe` semantics: the ranking is filtered by the
  * predicate and then normalized so that the lowest-rank satisfying element
  * becomes rank 0. All remaining elements retain their relative differences by
- * subtracting the same offset.
+ * subtracting the same offset. Elements of infinite rank are impossible and
+ * end the result.
+ *
+ * Normalization is recorded as a negative rank offset on the filtered ranking
+ * (see RankingFunction::shifted()) rather than by rebuilding its nodes.
  *
  * @tparam T Value type of the ranking function.
  * @tparam Pred Predicate type; must return bool when invoked with `const T&`.
  * @param rf Source ranking function.
  * @param predicate Condition describing the observed evidence.
  * @param deduplicate Whether the resulting ranking should deduplicate values.
+ * @param limits Scan budget and horizon for the underlying filter(); the
+ *        horizon applies to the ranks of @p rf, before normalization.
  * @return Ranking function conditioned on the observation.
+ * @throws std::length_error when the scan budget is exhausted (see filter()).
  */
-template<typename T, typename Pred>
+template<typename T, typename Pred, typename Policy>
 requires std::invocable<Pred, const T&> &&
          std::same_as<std::invoke_result_t<Pred, const T&>, bool>
-[[nodiscard]] RankingFunction<T> observe(
-    const RankingFunction<T>& rf,
+[[nodiscard]] RankingFunction<T, Policy> observe(
+    const RankingFunction<T, Policy>& rf,
     Pred predicate,
-    Deduplication deduplicate = Deduplication::Enabled)
+    Deduplication deduplicate = Deduplication::Enabled,
+    FilterLimits limits = {})
 {
-    auto filtered = filter(rf, std::move(predicate), deduplicate);
-    auto head = filtered.head();
+    if (limits.horizon.is_infinity()) {
+        limits.horizon = Rank::max_finite();
+    }
+    // Normalization lowers ranks, so the filter must not prune at an
+    // enclosing rank horizon.
+    RankHorizonScope unbounded(Rank::infinity());
+    auto filtered = filter(rf, std::move(predicate), deduplicate, limits);
+    const auto& head = filtered.raw_head();
 
     if (!head) {
         return filtered;
     }
 
-    const Rank shift_amount = head->rank();
-    if (shift_amount.is_infinity()) {
-        return RankingFunction<T>(nullptr, from_bool(filtered.is_deduplicating()));
-    }
+    const Rank shift_amount = filtered.rank_of(*head);
     if (shift_amount == Rank::zero()) {
         return filtered;
     }
+    if (shift_amount.value() <= static_cast<std::uint64_t>(detail::kMaxRankOffset)) {
+        return filtered.shifted(-static_cast<std::int64_t>(shift_amount.value()));
+    }
 
-    auto normalized_head = detail::normalize_with_shift(head, shift_amount);
-    return RankingFunction<T>(normalized_head, from_bool(filtered.is_deduplicating()));
+    // A head rank too large to carry as an offset: subtract it node by node.
+    auto normalized_head = detail::normalize_with_shift(
+        filtered.raw_head(), shift_amount, filtered.rank_offset(), filtered.rank_overflow());
+    return RankingFunction<T, Policy>(normalized_head, from_bool(filtered.is_deduplicating()));
 }
 
 /**
  * @brief Convenience overload that conditions on equality with a specific value.
  */
+template<typename T, typename Policy>
+[[nodiscard]] RankingFunction<T, Policy> observe(
+    const RankingFunction<T, Policy>& rf,
+    const T& observed_value,
+    Deduplication deduplicate = Deduplication::Enabled,
+    FilterLimits limits = {})
+{
+    return observe(
+        rf,
+        [observed_value](const T& value) { return value == observed_value; },
+        deduplicate,
+        limits
+    );
+}
+
+/**
+ * @brief Condition a materialized ranking on a predicate.
+ *
+ * Same semantics as observe() on a RankingFunction, computed eagerly in one
+ * pass over the contiguous storage: satisfying elements are kept (elements of
+ * infinite rank are dropped) and their ranks are shifted so that the first one
+ * has rank 0.
+ *
+ * @return Materialized ranking conditioned on the observation.
+ */
+template<typename T, typename Pred>
+requires std::invocable<Pred, const T&> &&
+         std::same_as<std::invoke_result_t<Pred, const T&>, bool>
+[[nodiscard]] MaterializedRanking<T> observe(
+    const MaterializedRanking<T>& rf,
+    Pred predicate,
+    Deduplication deduplicate = Deduplication::Enabled)
+{
+    std::vector<T> values;
+    std::vector<Rank> ranks;
+    for (std::size_t i = 0; i < rf.size(); ++i) {
+        const Rank rank = rf.rank(i);
+        if (rank.is_infinity()) {
+            break;
+        }
+        if (std::invoke(predicate, rf.value(i))) {
+            values.push_back(rf.value(i));
+            ranks.push_back(rank);
+        }
+    }
+
+    if (!ranks.empty()) {
+        const Rank shift_amount = ranks.front();
+        for (auto& rank : ranks) {
+            rank = rank - shift_amount;
+        }
+    }
+    return MaterializedRanking<T>(std::move(values), std::move(ranks), deduplicate);
+}
+
+/**
+ * @brief Convenience overload that conditions a materialized ranking on a value.
+ */
 template<typename T>
-[[nodiscard]] RankingFunction<T> observe(
-    const RankingFunction<T>& rf,
+[[nodiscard]] MaterializedRanking<T> observe(
+    const MaterializedRanking<T>& rf,
     const T& observed_value,
     Deduplication deduplicate = Deduplication::Enabled)
 {
     return observe(
         rf,
-        [observed_value](const T& value) { return value == observed_value; },
+        [&observed_value](const T& value) { return value == observed_value; },
         deduplicate
     );
 }
 
-} // namespace ranked_belief
+} // namespace ranked_belief::inline RANKED_BELIEF_ABI
@@ -0,0 +1,224 @@
+/**
+ * @file parallel_merge_apply.hpp
+ * @brief merge_apply with continuations evaluated concurrently on an Executor.
+ *
+ * The continuations merge_apply() applies to different input elements are
+ * independent, but it runs them one at a time, when the merge first needs
+ * each. parallel_merge_apply() starts the continuations of the next few input
+ * elements on an Executor ahead of that point and merges their results exactly
+ * as merge_apply() would.
+ */
+
+#ifndef RANKED_BELIEF_OPERATIONS_PARALLEL_MERGE_APPLY_HPP
+#define RANKED_BELIEF_OPERATIONS_PARALLEL_MERGE_APPLY_HPP
+
+#include "ranked_belief/executor.hpp"
+#include "ranked_belief/node_pool.hpp"
+#include "ranked_belief/promise.hpp"
+#include "ranked_belief/rank.hpp"
+#include "ranked_belief/rank_horizon.hpp"
+#include "ranked_belief/ranking_element.hpp"
+#include "ranked_belief/ranking_function.hpp"
+#include "ranked_belief/types.hpp"
+#include "ranked_belief/operations/merge_apply.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
+
+namespace detail {
+
+/**
+ * @brief Continuation shared between a parallel frontier and speculative tasks.
+ *
+ * Tasks hold the function through this handle rather than through the
+ * frontier, so an abandoned result does not keep itself alive.
+ */
+template<typename Func>
+struct SharedContinuation {
+    std::shared_ptr<Func> func;
+
+    template<typename T>
+    decltype(auto) operator()(const T& value) const {
+        return std::invoke(*func, value);
+    }
+};
+
+/**
+ * @brief One input element whose continuation may already be running.
+ */
+template<typename T, typename U>
+struct Speculation {
+    std::shared_ptr<RankingElement<T, ThreadSafePolicy>> input;
+    Promise<RankingFunction<U, ThreadSafePolicy>, ThreadSafePolicy> result;  ///< Forced by a task or by the frontier, once
+};
+
+/**
+ * @brief merge_apply frontier that evaluates continuations ahead of the merge.
+ *
+ * Keeps a window of speculations for up to @c width input elements starting
+ * at the pending one. expand() takes the pending element's result from the
+ * window (waiting if its task is still running) instead of calling the
+ * function, then tops the window up. Input ranked above @c speculation_limit
+ * is not speculated on and is expanded lazily on the consumer's thread, as in
+ * merge_apply(). Input and results are forced from several threads, so both
+ * use ThreadSafePolicy.
+ */
+template<typename T, typename U, typename Func>
+struct ParallelApplyFrontier
+    : ApplyFrontier<T, ThreadSafePolicy, U, ThreadSafePolicy, SharedContinuation<Func>> {
+    using Base = ApplyFrontier<T, ThreadSafePolicy, U, ThreadSafePolicy, SharedContinuation<Func>>;
+
+    std::shared_ptr<Executor> executor;
+    std::size_t width = 1;
+    Rank speculation_limit = Rank::infinity();
+    std::deque<std::shared_ptr<Speculation<T, U>>> window;         ///< Front is the pending element, if speculated
+    std::shared_ptr<RankingElement<T, ThreadSafePolicy>> window_end;  ///< Input element after the window's last
+
+    [[nodiscard]] Rank input_rank(const RankingElement<T, ThreadSafePolicy>& elem) const {
+        return offset_rank(elem.rank(), this->input_offset, this->input_overflow);
+    }
+
+    /// Start continuations until the window holds @c width elements.
+    void refill() {
+        if (window.empty()) {
+            window_end = this->pending;
+        }
+        while (window.size() < width && window_end) {
+            const Rank offset = input_rank(*window_end);
+            if (offset > speculation_limit) {
+                break;
+            }
+            auto speculation = std::make_shared<Speculation<T, U>>(Speculation<T, U>{
+                window_end,
+                make_promise<ThreadSafePolicy>([func = this->func, input = window_end, offset,
+                              horizon = horizon_below(this->horizon, offset), pool = this->pool,
+                              intern_tables = this->intern_tables]() {
+                    NodePoolScope pool_scope(pool);
+                    InternTablesScope intern_scope(intern_tables);
+                    RankHorizonScope horizon_scope(horizon);
+                    return RankingFunction<U, ThreadSafePolicy>(func(input->value()));
+                })});
+            executor->submit(Executor::Task([speculation]() {
+                try {
+                    (void)speculation->result.force();
+                } catch (...) {
+                    // Memoized by the promise; rethrown when the merge needs this result.
+                }
+            }));
+            window_end = window_end->next();
+            window.push_back(std::move(speculation));
+        }
+    }
+
+    void expand() {
+        if (window.empty() || window.front()->input != this->pending) {
+            Base::expand();
+        } else {
+            auto speculation = std::move(window.front());
+            window.pop_front();
+            const Rank offset = this->pending_rank();
+            const RankingFunction<U, ThreadSafePolicy>& result_rf = speculation->result.force();
+            this->push(result_rf.raw_head(), offset, this->pending_index,
+                       result_rf.rank_offset(), result_rf.rank_overflow());
+            this->pending = speculation->input->next();
+            ++this->pending_index;
+        }
+        refill();
+    }
+};
+
+}  // namespace detail
+
+/**
+ * @brief merge_apply() that evaluates continuations concurrently.
+ *
+ * Produces the same elements in the same order as
+ * merge_apply(rf, func, deduplicate, overflow). In addition, whenever the
+ * merge expands an input element, continuations for up to @p width following
+ * input elements are started on @p executor, so by the time the merge needs
+ * them they are usually ready. Input ranked above @p speculation_horizon (or
+ * above the current rank horizon, see rank_horizon.hpp) is never speculated
+ * on and is evaluated lazily on the consumer's thread.
+ *
+ * Speculation trades work for latency: continuations may run for input the
+ * consumer never reaches. @p func must be safe to call concurrently. When the
+ * input or the rankings @p func returns use SingleThreadedPolicy (the default
+ * under RANKED_BELIEF_SINGLE_THREADED), or while an Unsynchronized NodePool is
+ * current (the input's operations allocate from it as their tails are
+ * forced), this is merge_apply(). Otherwise continuations draw their nodes
+ * from the current NodePool.
+ *
+ * @tparam T The input value type.
+ * @tparam Func The function type (must return RankingFunction\<U\>).
+ * @param rf The input ranking function.
+ * @param func A function taking const T& and returning RankingFunction\<U\>.
+ * @param executor Where continuations run (default, or nullptr: default_executor()).
+ * @param width How many input elements to evaluate ahead (0 behaves like merge_apply()).
+ * @param speculation_horizon Input ranked above this is not evaluated ahead.
+ * @param deduplicate Whether to deduplicate the result (default: true).
+ * @param overflow Whether overflowing shifted ranks throw (default) or saturate.
+ * @return A new ranking function containing all merged results.
+ * @throws Whatever @p func throws, from the force that needs that continuation.
+ *
+ * @par Example
+ * @code
+ * auto outputs = parallel_merge_apply(inputs, [&](const Inputs& in) {
+ *     return evaluate_circuit(in);  // expensive and independent per input
+ * }, nullptr, 8);
+ * @endcode
+ */
+template<typename T, typename Func, typename InputPolicy>
+[[nodiscard]] auto parallel_merge_apply(
+    const RankingFunction<T, InputPolicy>& rf,
+    Func&& func,
+    std::shared_ptr<Executor> executor = nullptr,
+    std::size_t width = 8,
+    Rank speculation_horizon = Rank::infinity(),
+    Deduplication deduplicate = Deduplication::Enabled,
+    RankOverflow overflow = RankOverflow::Throw)
+    -> std::invoke_result_t<Func, const T&>
+{
+    using ResultRF = std::invoke_result_t<Func, const T&>;
+    if constexpr (!std::is_same_v<InputPolicy, ThreadSafePolicy> ||
+                  !std::is_same_v<typename ResultRF::policy_type, ThreadSafePolicy>) {
+        (void)executor;
+        (void)width;
+        (void)speculation_horizon;
+        return merge_apply(rf, std::forward<Func>(func), deduplicate, overflow);
+    } else {
+        if (width == 0 || !current_node_pool_is_shareable()) {
+            return merge_apply(rf, std::forward<Func>(func), deduplicate, overflow);
+        }
+        if (!executor) {
+            executor = default_executor();
+        }
+
+        using U = ranking_function_element_type_t<ResultRF>;
+        using F = std::decay_t<Func>;
+        using Frontier = detail::ParallelApplyFrontier<T, U, F>;
+
+        const Rank horizon = current_rank_horizon();
+        auto frontier = std::make_shared<Frontier>(Frontier{
+            {detail::SharedContinuation<F>{std::make_shared<F>(std::forward<Func>(func))},
+             overflow, current_shared_node_pool(), current_intern_tables(), {},
+             rf.raw_head(), rf.rank_offset(), rf.rank_overflow(), horizon},
+            std::move(executor), width, std::min(speculation_horizon, horizon), {}, nullptr});
+        frontier->refill();
+
+        return RankingFunction<U, ThreadSafePolicy>(
+            detail::apply_frontier_next(frontier),
+            deduplicate
+        );
+    }
+}
+
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI
+
+#endif  // RANKED_BELIEF_OPERATIONS_PARALLEL_MERGE_APPLY_HPP
@@ -0,0 +1,215 @@
+/**
+ * @file prefetch.hpp
+ * @brief Read-ahead of lazy tails and values on an Executor.
+ *
+ * Iterating a ranking forces each next() promise (and each value) on the
+ * consumer's thread, so expensive callbacks in map() or merge_apply() run
+ * serially with the consumer's own work. prefetch() returns a ranking with the
+ * same elements that, while the consumer handles one element, forces the next
+ * few on an Executor.
+ *
+ * Forcing a promise is exactly-once whichever thread gets there first: when
+ * the consumer reaches an element the executor is still computing, it waits
+ * for that result instead of computing it again, and an exception thrown by a
+ * callback is re-thrown to the consumer from the element that threw.
+ */
+
+#ifndef RANKED_BELIEF_OPERATIONS_PREFETCH_HPP
+#define RANKED_BELIEF_OPERATIONS_PREFETCH_HPP
+
+#include "ranked_belief/executor.hpp"
+#include "ranked_belief/node_pool.hpp"
+#include "ranked_belief/promise.hpp"
+#include "ranked_belief/ranking_element.hpp"
+#include "ranked_belief/ranking_function.hpp"
+#include "ranked_belief/types.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
+
+namespace detail {
+
+/**
+ * @brief Shared state of one prefetch() result.
+ *
+ * The consumer publishes the index of the newest element it has reached; a
+ * single read-ahead task at a time (claimed through @c scheduled) walks the
+ * input until it is @c depth elements ahead of that index. Only the running
+ * task touches @c ahead and @c ahead_index. The input is forced from several
+ * threads, so it and the result use ThreadSafePolicy.
+ */
+template<typename T>
+struct PrefetchState {
+    std::shared_ptr<Executor> executor;
+    std::size_t depth;
+    PrefetchValues values;
+    std::shared_ptr<NodePool> pool;
+    std::atomic<std::size_t> reached{0};  ///< Index of the newest element built for the consumer
+    std::atomic<bool> scheduled{false};   ///< A read-ahead task is queued or running
+    std::shared_ptr<RankingElement<T, ThreadSafePolicy>> ahead;  ///< Furthest input element forced so far
+    std::size_t ahead_index = 0;
+};
+
+template<typename T>
+void schedule_prefetch(const std::shared_ptr<PrefetchState<T>>& state);
+
+/**
+ * @brief Force the value of @p elem on the executor.
+ */
+template<typename T>
+void prefetch_value(const std::shared_ptr<PrefetchState<T>>& state,
+                    std::shared_ptr<RankingElement<T, ThreadSafePolicy>> elem)
+{
+    state->executor->submit(Executor::Task([elem = std::move(elem)]() {
+        try {
+            (void)elem->value();
+        } catch (...) {
+            // Memoized by the promise; the consumer sees it when it reads the value.
+        }
+    }));
+}
+
+/**
+ * @brief Body of the read-ahead task.
+ */
+template<typename T>
+void run_prefetch(const std::shared_ptr<PrefetchState<T>>& state) {
+    for (;;) {
+        try {
+            while (state->ahead &&
+                   state->ahead_index < state->reached.load(std::memory_order_acquire) + state->depth) {
+                auto next = state->ahead->next();
+                if (next && state->values == PrefetchValues::Enabled) {
+                    prefetch_value(state, next);
+                }
+                state->ahead = std::move(next);
+                ++state->ahead_index;
+            }
+        } catch (...) {
+            // Memoized by the promise; the consumer sees it when it forces that tail.
+            state->ahead = nullptr;
+        }
+        // Once scheduled is cleared another task may start and take over
+        // ahead and ahead_index, so the re-check only reads these copies.
+        const bool exhausted = !state->ahead;
+        const std::size_t ahead_index = state->ahead_index;
+        state->scheduled.store(false, std::memory_order_release);
+
+        // The consumer may have moved on after the loop's last check.
+        if (exhausted ||
+            ahead_index >= state->reached.load(std::memory_order_acquire) + state->depth ||
+            state->scheduled.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+}
+
+template<typename T>
+void schedule_prefetch(const std::shared_ptr<PrefetchState<T>>& state) {
+    if (state->scheduled.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+    state->executor->submit(Executor::Task([state]() { run_prefetch(state); }));
+}
+
+/**
+ * @brief Build the consumer's node for input element @p elem at position @p index.
+ */
+template<typename T>
+[[nodiscard]] std::shared_ptr<RankingElement<T, ThreadSafePolicy>> prefetch_node(
+    std::shared_ptr<RankingElement<T, ThreadSafePolicy>> elem,
+    std::size_t index,
+    const std::shared_ptr<PrefetchState<T>>& state)
+{
+    if (!elem) {
+        return nullptr;
+    }
+    // Only the newest node's next promise builds nodes, so indices only grow.
+    state->reached.store(index, std::memory_order_release);
+    schedule_prefetch(state);
+
+    const Rank rank = elem->rank();
+    auto value_promise = make_promise<ThreadSafePolicy>([elem]() -> T { return elem->value(); });
+    auto next_promise = make_promise<ThreadSafePolicy>([elem, index, state]() {
+        return prefetch_node(elem->next(), index + 1, state);
+    });
+    return allocate_pooled<RankingElement<T, ThreadSafePolicy>>(
+        state->pool, std::move(value_promise), rank, std::move(next_promise));
+}
+
+}  // namespace detail
+
+/**
+ * @brief Read @p depth elements of @p rf ahead on @p executor.
+ *
+ * The result has the same elements, ranks, rank offset and deduplication as
+ * @p rf. Whenever the consumer reaches element i of the result, a background
+ * task forces the input's tails up to element i + @p depth and, with
+ * PrefetchValues::Enabled, submits one task per element forcing its value, so
+ * the values of several elements are computed concurrently.
+ *
+ * Read-ahead is speculative: elements the consumer never reaches may still be
+ * computed. The input must be safe to force from the executor's threads, so
+ * when it uses SingleThreadedPolicy (unsynchronised promises, the default
+ * under RANKED_BELIEF_SINGLE_THREADED), or while an Unsynchronized NodePool is
+ * current (the input's operations allocate from it as their tails are
+ * forced), prefetch() returns @p rf unchanged. Otherwise nodes are drawn from
+ * the current NodePool.
+ *
+ * @tparam T The value type in the ranking function.
+ * @param rf The ranking to read ahead.
+ * @param depth How many elements to keep forced ahead of the consumer (0 disables read-ahead).
+ * @param executor Where read-ahead runs (default, or nullptr: default_executor()).
+ * @param values Whether values are forced as well as tails.
+ * @return A ranking function with the elements of @p rf.
+ *
+ * @par Example
+ * @code
+ * auto scored = map(candidates, expensive_score);
+ * for (auto [score, rank] : prefetch(scored, 8)) {
+ *     consume(score);  // the next 8 scores are computed meanwhile
+ * }
+ * @endcode
+ */
+template<typename T, typename Policy>
+[[nodiscard]] RankingFunction<T, Policy> prefetch(
+    const RankingFunction<T, Policy>& rf,
+    std::size_t depth,
+    std::shared_ptr<Executor> executor = nullptr,
+    PrefetchValues values = PrefetchValues::Enabled)
+{
+    if constexpr (!std::is_same_v<Policy, ThreadSafePolicy>) {
+        (void)depth;
+        (void)executor;
+        (void)values;
+        return rf;
+    } else {
+        const auto& head = rf.raw_head();
+        if (depth == 0 || !head || !current_node_pool_is_shareable()) {
+            return rf;
+        }
+        if (!executor) {
+            executor = default_executor();
+        }
+        auto state = std::make_shared<detail::PrefetchState<T>>();
+        state->executor = std::move(executor);
+        state->depth = depth;
+        state->values = values;
+        state->pool = current_shared_node_pool();
+        state->ahead = head;
+        if (values == PrefetchValues::Enabled) {
+            detail::prefetch_value(state, head);
+        }
+        return RankingFunction<T, Policy>(detail::prefetch_node(head, 0, state), from_bool(rf.is_deduplicating()))
+            .with_rank_offset(rf.rank_offset(), rf.rank_overflow());
+    }
+}
+
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI
+
+#endif  // RANKED_BELIEF_OPERATIONS_PREFETCH_HPP
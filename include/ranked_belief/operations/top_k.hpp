@@ -0,0 +1,320 @@
+/**
+ * @file top_k.hpp
+ * @brief Top-k queries with resumable cursors.
+ *
+ * top_k() and top_k_distinct() return the k lowest-ranked entries of a
+ * ranking. Unlike take_n() they can fill a caller-provided buffer, return all
+ * entries tied at the k-th rank (TopKTies::Include), and continue through a
+ * TopKCursor: a paginated query asks the same cursor for the next page instead
+ * of re-walking the prefix with a larger k.
+ *
+ * @code
+ * TopKCursor<int> cursor(rf);
+ * auto page1 = cursor.next(20);
+ * auto page2 = cursor.next(20);  // entries 20..39, prefix not revisited
+ * @endcode
+ */
+
+#ifndef RANKED_BELIEF_OPERATIONS_TOP_K_HPP
+#define RANKED_BELIEF_OPERATIONS_TOP_K_HPP
+
+#include "ranked_belief/rank.hpp"
+#include "ranked_belief/ranking_element.hpp"
+#include "ranked_belief/ranking_function.hpp"
+#include "ranked_belief/ranking_iterator.hpp"
+#include "ranked_belief/types.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
+
+namespace detail {
+
+template<typename T>
+concept std_hashable = requires(const T& value) {
+    { std::hash<T>{}(value) } -> std::convertible_to<std::size_t>;
+};
+
+/// Hash of the value behind a pointer.
+template<typename T>
+struct PointeeHash {
+    [[nodiscard]] std::size_t operator()(const T* value) const { return std::hash<T>{}(*value); }
+};
+
+/// Equality of the values behind two pointers.
+template<typename T>
+struct PointeeEqual {
+    [[nodiscard]] bool operator()(const T* lhs, const T* rhs) const { return *lhs == *rhs; }
+};
+
+/**
+ * @brief Values already returned by a distinct top-k cursor.
+ *
+ * Holds pointers into the ranking's nodes rather than copies of the values;
+ * @c anchor keeps those nodes alive. Hashable types use a hash set, others a
+ * linear scan.
+ */
+template<typename T, typename Policy>
+struct SeenValues {
+    using Set = std::conditional_t<std_hashable<T>,
+                                   std::unordered_set<const T*, PointeeHash<T>, PointeeEqual<T>>,
+                                   std::vector<const T*>>;
+
+    std::shared_ptr<RankingElement<T, Policy>> anchor;  ///< Head of the ranking being walked
+    Set values;
+
+    [[nodiscard]] bool contains(const T& value) const {
+        if constexpr (std_hashable<T>) {
+            return values.contains(&value);
+        } else {
+            return std::any_of(values.begin(), values.end(),
+                               [&value](const T* seen) { return *seen == value; });
+        }
+    }
+
+    void insert(const T& value) {
+        if constexpr (std_hashable<T>) {
+            values.insert(&value);
+        } else {
+            values.push_back(&value);
+        }
+    }
+};
+
+}  // namespace detail
+
+/**
+ * @class TopKCursor
+ * @brief Resumable position in a top-k query over a RankingFunction.
+ *
+ * Each call returns the next entries in rank order, starting where the last
+ * call stopped, so paging through n entries costs O(n) in total. Values are
+ * copied once, straight from the ranking's nodes into the caller's buffer.
+ * Entries are deduplicated like iteration over the ranking (consecutive equal
+ * values when the ranking deduplicates); a cursor made with distinct() skips
+ * every value it has already returned.
+ *
+ * Nothing beyond the entries returned is forced, except that
+ * TopKTies::Include must look at the entry after the k-th to find the end of
+ * the tie. A distinct cursor keeps the walked prefix of the ranking alive.
+ *
+ * @tparam T The value type of the ranking.
+ * @tparam Policy Promise policy of the ranking.
+ */
+template<typename T, typename Policy = DefaultPromisePolicy>
+class TopKCursor {
+public:
+    using entry_type = std::pair<T, Rank>;
+
+    /**
+     * @brief Start a query at the head of @p rf.
+     */
+    explicit TopKCursor(const RankingFunction<T, Policy>& rf)
+        : next_(rf.raw_head())
+        , deduplicate_(rf.is_deduplicating())
+        , rank_offset_(rf.rank_offset())
+        , overflow_(rf.rank_overflow())
+    {}
+
+    /**
+     * @brief Start a query at the head of @p rf that returns each value at most once.
+     *
+     * Each value is returned with the rank of its first (lowest-ranked) occurrence.
+     */
+    [[nodiscard]] static TopKCursor distinct(const RankingFunction<T, Policy>& rf)
+        requires std::equality_comparable<T>
+    {
+        TopKCursor cursor(rf);
+        cursor.seen_.emplace();
+        cursor.seen_->anchor = rf.raw_head();
+        return cursor;
+    }
+
+    /**
+     * @brief Assign the next entries to @p out.
+     *
+     * @return Number of entries written (less than out.size() once the
+     *         ranking is exhausted).
+     */
+    std::size_t fill(std::span<entry_type> out) {
+        std::size_t written = 0;
+        while (written < out.size()) {
+            const RankingElement<T, Policy>* elem = peek();
+            if (!elem) {
+                break;
+            }
+            out[written].first = elem->value();
+            out[written].second = rank_of(*elem);
+            consume();
+            ++written;
+        }
+        return written;
+    }
+
+    /**
+     * @brief Append the next @p k entries to @p out.
+     *
+     * @param ties With TopKTies::Include, also append the following entries
+     *        that share the rank of the k-th one.
+     * @return Number of entries appended.
+     */
+    std::size_t append(std::vector<entry_type>& out, std::size_t k,
+                       TopKTies ties = TopKTies::Exclude)
+    {
+        std::size_t appended = 0;
+        std::optional<Rank> last_rank;
+        while (const RankingElement<T, Policy>* elem = peek()) {
+            const Rank rank = rank_of(*elem);
+            if (appended >= k && (ties == TopKTies::Exclude || rank != last_rank)) {
+                break;
+            }
+            out.emplace_back(elem->value(), rank);
+            consume();
+            ++appended;
+            last_rank = rank;
+        }
+        return appended;
+    }
+
+    /**
+     * @brief Return the next @p k entries (see append()).
+     */
+    [[nodiscard]] std::vector<entry_type> next(std::size_t k, TopKTies ties = TopKTies::Exclude) {
+        std::vector<entry_type> out;
+        out.reserve(k);
+        append(out, k, ties);
+        return out;
+    }
+
+    /**
+     * @brief Whether every entry has been returned.
+     *
+     * May force the ranking up to the next entry.
+     */
+    [[nodiscard]] bool exhausted() { return peek() == nullptr; }
+
+    /**
+     * @brief Number of entries returned so far.
+     */
+    [[nodiscard]] std::size_t returned() const noexcept { return returned_; }
+
+private:
+    /// The next entry to return, or null when the ranking is exhausted.
+    const RankingElement<T, Policy>* peek() {
+        if (advance_) {
+            advance_ = false;
+            step();
+        }
+        while (next_ && skipped(*next_)) {
+            step();
+        }
+        return next_.get();
+    }
+
+    /// Mark the entry returned by peek() as returned.
+    void consume() {
+        if (seen_) {
+            seen_->insert(next_->value());
+        }
+        ++returned_;
+        advance_ = true;
+    }
+
+    void step() {
+        previous_ = std::move(next_);
+        next_ = previous_->next();
+    }
+
+    [[nodiscard]] bool skipped(const RankingElement<T, Policy>& elem) const {
+        if (deduplicate_ && previous_ && detail::duplicate_values(elem.value(), previous_->value())) {
+            return true;
+        }
+        if constexpr (std::equality_comparable<T>) {
+            return seen_ && seen_->contains(elem.value());
+        } else {
+            return false;
+        }
+    }
+
+    [[nodiscard]] Rank rank_of(const RankingElement<T, Policy>& elem) const {
+        return detail::offset_rank(elem.rank(), rank_offset_, overflow_);
+    }
+
+    std::shared_ptr<RankingElement<T, Policy>> next_;      ///< Next element to examine
+    std::shared_ptr<RankingElement<T, Policy>> previous_;  ///< Last element examined
+    bool deduplicate_;
+    bool advance_ = false;                                 ///< next_ was returned; step before peeking
+    std::int64_t rank_offset_;
+    RankOverflow overflow_;
+    std::size_t returned_ = 0;
+    std::optional<detail::SeenValues<T, Policy>> seen_;    ///< Set only for distinct cursors
+};
+
+/**
+ * @brief The @p k lowest-ranked entries of @p rf.
+ *
+ * Equivalent to take_n(rf, k) with TopKTies::Exclude, but copies each value
+ * once. With TopKTies::Include the result also holds every further entry tied
+ * at the k-th rank.
+ */
+template<typename T, typename Policy>
+[[nodiscard]] std::vector<std::pair<T, Rank>> top_k(
+    const RankingFunction<T, Policy>& rf,
+    std::size_t k,
+    TopKTies ties = TopKTies::Exclude)
+{
+    return TopKCursor<T, Policy>(rf).next(k, ties);
+}
+
+/**
+ * @brief Write the out.size() lowest-ranked entries of @p rf into @p out.
+ *
+ * @return Number of entries written.
+ */
+template<typename T, typename Policy>
+std::size_t top_k(const RankingFunction<T, Policy>& rf,
+                  std::type_identity_t<std::span<std::pair<T, Rank>>> out)
+{
+    return TopKCursor<T, Policy>(rf).fill(out);
+}
+
+/**
+ * @brief The @p k lowest-ranked distinct values of @p rf, each with its lowest rank.
+ */
+template<typename T, typename Policy>
+requires std::equality_comparable<T>
+[[nodiscard]] std::vector<std::pair<T, Rank>> top_k_distinct(
+    const RankingFunction<T, Policy>& rf,
+    std::size_t k,
+    TopKTies ties = TopKTies::Exclude)
+{
+    return TopKCursor<T, Policy>::distinct(rf).next(k, ties);
+}
+
+/**
+ * @brief Write the out.size() lowest-ranked distinct values of @p rf into @p out.
+ *
+ * @return Number of entries written.
+ */
+template<typename T, typename Policy>
+requires std::equality_comparable<T>
+std::size_t top_k_distinct(const RankingFunction<T, Policy>& rf,
+                           std::type_identity_t<std::span<std::pair<T, Rank>>> out)
+{
+    return TopKCursor<T, Policy>::distinct(rf).fill(out);
+}
+
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI
+
+#endif  // RANKED_BELIEF_OPERATIONS_TOP_K_HPP
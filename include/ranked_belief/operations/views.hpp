@@ -0,0 +1,373 @@
+/**
+ * @file views.hpp
+ * @brief Fused pipelines of rank-preserving operations.
+ *
+ * Chaining map(), filter(), take() and friends builds one lazy node layer per
+ * operation, each with its own builder and per-node promises. The adaptors in
+ * ranked_belief::views instead compose into a single pipeline whose stages are
+ * statically typed and inlined into one builder, so forcing an element of the
+ * result allocates one node however many stages there are:
+ *
+ * @code
+ * namespace views = ranked_belief::views;
+ * RankingFunction<int> out = rf | views::map(f) | views::filter(p) | views::take(10);
+ * // or: auto out = (rf | views::map(f) | views::filter(p)).ranking();
+ * @endcode
+ *
+ * Stages run in order on each input element when the node that needs it is
+ * built. Unlike the standalone map(), a map stage therefore computes its value
+ * as soon as the element reaches it rather than on first access.
+ */
+
+#ifndef RANKED_BELIEF_OPERATIONS_VIEWS_HPP
+#define RANKED_BELIEF_OPERATIONS_VIEWS_HPP
+
+#include "ranked_belief/node_pool.hpp"
+#include "ranked_belief/promise.hpp"
+#include "ranked_belief/rank.hpp"
+#include "ranked_belief/ranking_element.hpp"
+#include "ranked_belief/ranking_function.hpp"
+#include "ranked_belief/types.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ranked_belief::inline RANKED_BELIEF_ABI::views {
+
+/**
+ * @brief What a pipeline did with one input element.
+ */
+enum class Step {
+    Skip,          ///< Element dropped; continue with the next input element
+    Emit,          ///< Element produced an output element
+    EmitThenStop,  ///< Element produced the last output element
+    Stop           ///< Element dropped and no further output is possible
+};
+
+/// Stage that transforms values (see map()).
+template<typename F>
+struct MapStage {
+    template<typename V>
+    using output_t = std::invoke_result_t<const F&, const V&>;
+
+    F func;
+
+    template<typename V, typename Next>
+    Step operator()(V&& value, Rank rank, Next&& next) {
+        return next(std::invoke(func, std::as_const(value)), rank);
+    }
+};
+
+/// Stage that keeps values satisfying a predicate (see filter()).
+template<typename Pred>
+struct FilterStage {
+    template<typename V>
+    using output_t = std::remove_cvref_t<V>;
+
+    Pred predicate;
+
+    template<typename V, typename Next>
+    Step operator()(V&& value, Rank rank, Next&& next) {
+        if (!std::invoke(predicate, std::as_const(value))) {
+            return Step::Skip;
+        }
+        return next(std::forward<V>(value), rank);
+    }
+};
+
+/// Stage that passes at most a fixed number of elements (see take()).
+struct TakeStage {
+    template<typename V>
+    using output_t = std::remove_cvref_t<V>;
+
+    std::size_t remaining;
+
+    template<typename V, typename Next>
+    Step operator()(V&& value, Rank rank, Next&& next) {
+        if (remaining == 0) {
+            return Step::Stop;
+        }
+        --remaining;
+        const Step step = next(std::forward<V>(value), rank);
+        if (remaining != 0) {
+            return step;
+        }
+        return step == Step::Emit ? Step::EmitThenStop
+             : step == Step::Skip ? Step::Stop
+             : step;
+    }
+};
+
+/// Stage that ends the sequence at the first rank above a bound (see take_while_rank()).
+struct TakeWhileRankStage {
+    template<typename V>
+    using output_t = std::remove_cvref_t<V>;
+
+    Rank max_rank;
+
+    template<typename V, typename Next>
+    Step operator()(V&& value, Rank rank, Next&& next) {
+        if (rank > max_rank) {
+            return Step::Stop;
+        }
+        return next(std::forward<V>(value), rank);
+    }
+};
+
+/// Stage that shifts ranks so the first element reaching it has rank 0 (see normalize()).
+struct NormalizeStage {
+    template<typename V>
+    using output_t = std::remove_cvref_t<V>;
+
+    std::optional<Rank> shift;
+
+    template<typename V, typename Next>
+    Step operator()(V&& value, Rank rank, Next&& next) {
+        if (rank.is_infinity()) {
+            return Step::Stop;
+        }
+        if (!shift) {
+            shift = rank;
+        }
+        return next(std::forward<V>(value), rank - *shift);
+    }
+};
+
+namespace detail {
+
+template<typename V, typename... Stages>
+struct pipeline_output;
+
+template<typename V>
+struct pipeline_output<V> {
+    using type = std::remove_cvref_t<V>;
+};
+
+template<typename V, typename Stage, typename... Rest>
+struct pipeline_output<V, Stage, Rest...> {
+    using type = typename pipeline_output<typename Stage::template output_t<V>, Rest...>::type;
+};
+
+/**
+ * @brief Run stages I.. of @p stages on one element, then @p emit.
+ */
+template<std::size_t I, typename Tuple, typename V, typename Emit>
+Step run_stages(Tuple& stages, V&& value, Rank rank, Emit& emit) {
+    if constexpr (I == std::tuple_size_v<Tuple>) {
+        return emit(std::forward<V>(value), rank);
+    } else {
+        return std::get<I>(stages)(
+            std::forward<V>(value),
+            rank,
+            [&stages, &emit](auto&& next_value, Rank next_rank) {
+                return run_stages<I + 1>(
+                    stages, std::forward<decltype(next_value)>(next_value), next_rank, emit);
+            });
+    }
+}
+
+/**
+ * @brief Per-result state of a fused pipeline.
+ *
+ * Stages such as take() and normalize() keep counters, so each result gets its
+ * own copy. Only the newest node of the result holds an unforced next promise
+ * and only that thunk runs the stages, so the state needs no lock of its own.
+ */
+template<typename... Stages>
+struct FusedState {
+    std::tuple<Stages...> stages;
+    std::shared_ptr<NodePool> pool;
+    std::int64_t rank_offset;  ///< The source's rank offset, applied as ranks are read
+    RankOverflow overflow;
+};
+
+/**
+ * @brief Build the next output node, starting the scan at @p elem.
+ *
+ * Input elements rejected by the stages are skipped in a loop.
+ */
+template<typename R, typename T, typename Policy, typename... Stages>
+[[nodiscard]] std::shared_ptr<RankingElement<R, Policy>> build_fused(
+    std::shared_ptr<RankingElement<T, Policy>> elem,
+    const std::shared_ptr<FusedState<Stages...>>& state)
+{
+    std::optional<std::pair<R, Rank>> out;
+    auto emit = [&out](auto&& value, Rank rank) {
+        out.emplace(std::forward<decltype(value)>(value), rank);
+        return Step::Emit;
+    };
+
+    while (elem) {
+        const Step step = run_stages<0>(
+            state->stages, elem->value(),
+            ranked_belief::detail::offset_rank(elem->rank(), state->rank_offset, state->overflow), emit);
+        switch (step) {
+        case Step::Skip:
+            elem = elem->next();
+            continue;
+        case Step::Stop:
+            return nullptr;
+        case Step::EmitThenStop:
+            return allocate_pooled<RankingElement<R, Policy>>(
+                state->pool, std::move(out->first), out->second);
+        case Step::Emit:
+            break;
+        }
+        return allocate_pooled<RankingElement<R, Policy>>(
+            state->pool,
+            std::move(out->first),
+            out->second,
+            make_promise<Policy>([elem = std::move(elem), state]() {
+                return build_fused<R>(elem->next(), state);
+            }));
+    }
+    return nullptr;
+}
+
+}  // namespace detail
+
+/**
+ * @class Pipeline
+ * @brief An unbound sequence of fused stages.
+ *
+ * Pipelines compose with `|` and apply to a RankingFunction with `|`.
+ */
+template<typename... Stages>
+struct Pipeline {
+    std::tuple<Stages...> stages;
+
+    /// Value type produced from input values of type @p T.
+    template<typename T>
+    using output_t = typename detail::pipeline_output<T, Stages...>::type;
+};
+
+/**
+ * @class BoundPipeline
+ * @brief A pipeline applied to a source ranking, not yet built.
+ *
+ * Further stages can be appended with `|`. Converting to RankingFunction (or
+ * calling ranking()) builds the single fused node layer, with the promise
+ * policy of the source.
+ */
+template<typename T, typename Policy, typename... Stages>
+class BoundPipeline {
+public:
+    /// Value type of the resulting ranking
+    using value_type = typename Pipeline<Stages...>::template output_t<T>;
+
+    BoundPipeline(RankingFunction<T, Policy> source, Pipeline<Stages...> pipeline)
+        : source_(std::move(source)), pipeline_(std::move(pipeline)) {}
+
+    /**
+     * @brief Build the fused ranking.
+     *
+     * Nodes come from the NodePool current at this call.
+     *
+     * @param deduplicate Whether the result deduplicates consecutive equal values.
+     */
+    [[nodiscard]] RankingFunction<value_type, Policy> ranking(
+        Deduplication deduplicate = Deduplication::Enabled) const
+    {
+        auto state = std::make_shared<detail::FusedState<Stages...>>(
+            detail::FusedState<Stages...>{pipeline_.stages, current_node_pool(),
+                                          source_.rank_offset(), source_.rank_overflow()});
+        return RankingFunction<value_type, Policy>(
+            detail::build_fused<value_type>(source_.raw_head(), state), deduplicate);
+    }
+
+    /// Build the fused ranking with deduplication enabled.
+    operator RankingFunction<value_type, Policy>() const { return ranking(); }
+
+    /// Append more stages.
+    template<typename... More>
+    [[nodiscard]] friend BoundPipeline<T, Policy, Stages..., More...> operator|(
+        BoundPipeline bound, Pipeline<More...> more)
+    {
+        return BoundPipeline<T, Policy, Stages..., More...>(
+            std::move(bound.source_),
+            Pipeline<Stages..., More...>{
+                std::tuple_cat(std::move(bound.pipeline_.stages), std::move(more.stages))});
+    }
+
+private:
+    template<typename, typename, typename...>
+    friend class BoundPipeline;
+
+    RankingFunction<T, Policy> source_;
+    Pipeline<Stages...> pipeline_;
+};
+
+/// Compose two pipelines.
+template<typename... Lhs, typename... Rhs>
+[[nodiscard]] Pipeline<Lhs..., Rhs...> operator|(Pipeline<Lhs...> lhs, Pipeline<Rhs...> rhs) {
+    return {std::tuple_cat(std::move(lhs.stages), std::move(rhs.stages))};
+}
+
+/// Apply a pipeline to a ranking function.
+template<typename T, typename Policy, typename... Stages>
+[[nodiscard]] BoundPipeline<T, Policy, Stages...> operator|(
+    const RankingFunction<T, Policy>& rf, Pipeline<Stages...> pipeline)
+{
+    return BoundPipeline<T, Policy, Stages...>(rf, std::move(pipeline));
+}
+
+/**
+ * @brief Transform each value, preserving ranks (fused counterpart of ranked_belief::map).
+ */
+template<typename F>
+[[nodiscard]] Pipeline<MapStage<std::decay_t<F>>> map(F&& func) {
+    return {{MapStage<std::decay_t<F>>{std::forward<F>(func)}}};
+}
+
+/**
+ * @brief Keep values satisfying @p predicate (fused counterpart of ranked_belief::filter).
+ */
+template<typename Pred>
+[[nodiscard]] Pipeline<FilterStage<std::decay_t<Pred>>> filter(Pred&& predicate) {
+    return {{FilterStage<std::decay_t<Pred>>{std::forward<Pred>(predicate)}}};
+}
+
+/**
+ * @brief Pass at most @p n elements (fused counterpart of ranked_belief::take).
+ *
+ * Once @p n elements have reached this stage no further input is forced.
+ */
+[[nodiscard]] inline Pipeline<TakeStage> take(std::size_t n) {
+    return {{TakeStage{n}}};
+}
+
+/**
+ * @brief End at the first rank above @p max_rank (fused counterpart of take_while_rank).
+ */
+[[nodiscard]] inline Pipeline<TakeWhileRankStage> take_while_rank(Rank max_rank) {
+    return {{TakeWhileRankStage{max_rank}}};
+}
+
+/**
+ * @brief Shift ranks so the first element reaching this stage has rank 0.
+ *
+ * This is the normalization step of observe(); elements of infinite rank end
+ * the sequence.
+ */
+[[nodiscard]] inline Pipeline<NormalizeStage> normalize() {
+    return {{NormalizeStage{std::nullopt}}};
+}
+
+/**
+ * @brief Condition on @p predicate: filter, then normalize (fused counterpart of observe).
+ */
+template<typename Pred>
+[[nodiscard]] auto observe(Pred&& predicate) {
+    return filter(std::forward<Pred>(predicate)) | normalize();
+}
+
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI::views
+
+#endif  // RANKED_BELIEF_OPERATIONS_VIEWS_HPP
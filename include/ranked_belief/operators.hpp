@@ -22,15 +22,15 @@
 #include <functional>
 #include <type_traits>
 
-namespace ranked_belief {
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
 
 namespace detail {
 
 template<typename T>
 struct ranking_value_type;
 
-template<typename T>
-struct ranking_value_type<RankingFunction<T>> {
+template<typename T, typename Policy>
+struct ranking_value_type<RankingFunction<T, Policy>> {
     using type = T;
 };
 
@@ -41,11 +41,18 @@ template<typename L, typename R>
 concept RankingOperand = IsRankingFunction<std::remove_cvref_t<L>> ||
                          IsRankingFunction<std::remove_cvref_t<R>>;
 
+/// Promise policy of the ranked operand (the left one if both are ranked).
+template<typename L, typename R>
+using operand_policy_t = typename std::remove_cvref_t<
+    std::conditional_t<IsRankingFunction<L>, L, R>>::policy_type;
+
 template<typename L, typename R, typename Op>
 [[nodiscard]] auto combine_binary(L&& lhs, R&& rhs, Op op)
 {
-    auto lhs_rf = autocast(std::forward<L>(lhs));
-    auto rhs_rf = autocast(std::forward<R>(rhs));
+    // Scalars are lifted with the policy of the ranked operand.
+    using Policy = operand_policy_t<L, R>;
+    auto lhs_rf = autocast<Policy>(std::forward<L>(lhs));
+    auto rhs_rf = autocast<Policy>(std::forward<R>(rhs));
 
     using LValue = ranking_value_type_t<decltype(lhs_rf)>;
     using RValue = ranking_value_type_t<decltype(rhs_rf)>;
@@ -175,4 +182,4 @@ requires detail::RankingOperand<L, R>
     return detail::combine_binary(std::forward<L>(lhs), std::forward<R>(rhs), std::greater_equal<>{});
 }
 
-} // namespace ranked_belief
+} // namespace ranked_belief::inline RANKED_BELIEF_ABI
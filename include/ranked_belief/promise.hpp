@@ -6,12 +6,29 @@
  * representing infinite ranking sequences efficiently. Once forced, the computation
  * result is cached for subsequent accesses.
  *
- * This implementation is thread-safe, ensuring that the computation function is
- * executed exactly once even under concurrent access.
+ * Promise<T, Policy> is parameterised by a threading policy:
+ * - ThreadSafePolicy: the computation is executed exactly once even under
+ *   concurrent access (the default). State is published through one atomic,
+ *   so forced promises are read without locks.
+ * - SingleThreadedPolicy: no synchronisation at all. The state is a single
+ *   inline variant of thunk, value or error, and the thunk lives in
+ *   small-buffer storage, so an unforced promise usually owns no heap memory.
+ *
+ * RankingElement, RankingFunction and the operations carry the policy as a
+ * template parameter defaulting to DefaultPromisePolicy, which is
+ * SingleThreadedPolicy when the library is built with
+ * RANKED_BELIEF_SINGLE_THREADED (CMake option of the same name) and
+ * ThreadSafePolicy otherwise. A ranking can name either policy explicitly;
+ * operations build their results with the policy of their inputs. The setting
+ * also selects the inline namespace of every library symbol (see abi.hpp), so
+ * translation units that disagree on it cannot share rankings through a linked
+ * function.
  *
  * Design decisions:
  * - Move-only semantics (no copying) to avoid expensive computation duplication
- * - Thread-safe memoization using std::call_once
+ * - Thread-safe memoization through an atomic state with acquire/release
+ *   publication and C++20 atomic wait (ThreadSafePolicy)
+ * - Forced values are stored inline (no separate heap allocation per value)
  * - Exception safety: exceptions from computations are propagated and re-thrown
  * - Const-correct: force() is logically const (memoization is implementation detail)
  */
@@ -19,15 +36,100 @@
 #ifndef RANKED_BELIEF_PROMISE_HPP
 #define RANKED_BELIEF_PROMISE_HPP
 
+#include "abi.hpp"
 #include "concepts.hpp"
+#include "detail/inline_function.hpp"
+
+#include <atomic>
+#include <exception>
 #include <functional>
 #include <memory>
-#include <mutex>
 #include <optional>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
+#include <variant>
+
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
+
+/**
+ * @brief Promise policy: memoization is safe under concurrent force().
+ */
+struct ThreadSafePolicy {};
+
+/**
+ * @brief Promise policy: no synchronisation; a promise must only be forced
+ * from one thread at a time.
+ */
+struct SingleThreadedPolicy {};
+
+#ifdef RANKED_BELIEF_SINGLE_THREADED
+using DefaultPromisePolicy = SingleThreadedPolicy;
+#else
+using DefaultPromisePolicy = ThreadSafePolicy;
+#endif
 
-namespace ranked_belief {
+template<typename T, typename Policy = DefaultPromisePolicy>
+class Promise;
+
+namespace detail {
+
+template<typename T>
+struct is_promise : std::false_type {};
+
+template<typename T, typename Policy>
+struct is_promise<Promise<T, Policy>> : std::true_type {};
+
+/**
+ * @brief A callable that can be deferred inside a Promise<T>.
+ *
+ * Excludes T itself (and promises) so the value constructor is chosen when a
+ * callable type is also the promised type.
+ */
+template<typename F, typename T>
+concept PromiseComputation =
+    !std::same_as<std::remove_cvref_t<F>, T> &&
+    !is_promise<std::remove_cvref_t<F>>::value &&
+    std::invocable<std::decay_t<F>&> &&
+    std::convertible_to<std::invoke_result_t<std::decay_t<F>&>, T>;
+
+/// Alternatives of PromiseStorage, addressed by index so T may coincide with any of them.
+inline constexpr std::size_t kPromiseEmpty = 0;    ///< Moved from, or currently running
+inline constexpr std::size_t kPromisePending = 1;  ///< Holds the deferred computation
+inline constexpr std::size_t kPromiseValue = 2;    ///< Holds the result
+inline constexpr std::size_t kPromiseFailed = 3;   ///< Holds the captured exception
+
+/**
+ * @brief Inline storage shared by both promise policies.
+ *
+ * The computation, the value and the captured exception are never alive at the
+ * same time, so they share one variant instead of three separate members.
+ */
+template<typename T>
+using PromiseStorage = std::variant<std::monostate, InlineFunction<T>, T, std::exception_ptr>;
+
+/**
+ * @brief Pass @p computation through, rejecting null function pointers and
+ * empty std::function objects.
+ *
+ * @throws std::invalid_argument if computation is null.
+ */
+template<typename F>
+[[nodiscard]] F&& require_computation(F&& computation) {
+    using Callable = std::decay_t<F>;
+    bool is_null = false;
+    if constexpr (std::is_pointer_v<Callable> || std::is_member_pointer_v<Callable>) {
+        is_null = computation == nullptr;
+    } else if constexpr (requires { typename Callable::result_type; &Callable::target_type; }) {
+        is_null = !static_cast<bool>(computation);  // std::function
+    }
+    if (is_null) {
+        throw std::invalid_argument("Promise computation function cannot be null");
+    }
+    return std::forward<F>(computation);
+}
+
+}  // namespace detail
 
 /**
  * @class Promise
@@ -37,14 +139,25 @@ namespace ranked_belief {
  * with the result cached for subsequent accesses. This is essential for lazy
  * evaluation in ranking functions, particularly for infinite sequences.
  *
- * Thread Safety: Multiple threads can safely call force() concurrently. The
- * computation will be executed exactly once, and all threads will receive the
- * same result.
+ * Thread Safety: Multiple threads can safely call force() and the state
+ * queries concurrently. The computation will be executed exactly once, and all
+ * threads will receive the same result. The promise's state is a single atomic
+ * word: the thread that wins the Pending -> Running transition runs the
+ * computation and publishes the result with a release store; every other
+ * thread blocks on the atomic until the result is published. Once forced,
+ * force() is one acquire load and never takes a lock, so any number of readers
+ * can share an already-forced ranking prefix without contention.
  *
  * Exception Safety: If the computation throws an exception during the first
  * force(), that exception is captured and will be re-thrown on all subsequent
  * force() calls. This ensures consistent behavior across all accessors.
  *
+ * Forcing a promise re-entrantly from its own computation deadlocks, as with
+ * std::call_once. Moving a promise while another thread forces it is not
+ * supported.
+ *
+ * This is the ThreadSafePolicy specialisation.
+ *
  * @tparam T The type of value produced by the promise.
  *
  * Example:
@@ -54,12 +167,12 @@ namespace ranked_belief {
  * int cached = p.force();  // Returns cached result
  * @endcode
  *
- * @invariant After a successful force(), value_ contains the result.
- * @invariant After a failed force(), exception_ contains the exception.
- * @invariant computation_ is cleared after the first force() attempt.
+ * @invariant storage_ holds the value exactly when state_ is Ready.
+ * @invariant storage_ holds the exception exactly when state_ is Failed.
+ * @invariant storage_ is only written by the thread that owns the Running state.
  */
 template<typename T>
-class Promise {
+class Promise<T, ThreadSafePolicy> {
 public:
     /**
      * @brief Construct a promise from a computation function.
@@ -69,11 +182,20 @@ public:
      * @param computation A callable that produces a value of type T.
      * @throws std::invalid_argument if computation is null/empty.
      */
-    explicit Promise(std::function<T()> computation) : computation_(std::move(computation)) {
-        if (!computation_) {
-            throw std::invalid_argument("Promise computation function cannot be null");
-        }
-    }
+    explicit Promise(std::function<T()> computation)
+        : Promise(std::in_place, std::move(computation)) {}
+
+    /**
+     * @brief Construct a promise from any callable returning T.
+     *
+     * The callable is stored in small-buffer storage and may be move-only.
+     *
+     * @param computation A callable that produces a value of type T.
+     * @throws std::invalid_argument if computation is a null function.
+     */
+    template<typename F>
+    requires detail::PromiseComputation<F, T>
+    explicit Promise(F&& computation) : Promise(std::in_place, std::forward<F>(computation)) {}
 
     /**
      * @brief Construct a promise from an already-computed value.
@@ -84,44 +206,34 @@ public:
      * @param value The pre-computed value to wrap.
      */
     explicit Promise(T value)
-        : computation_(nullptr), value_(std::make_unique<T>(std::move(value))) {
-        // Mark as already forced by setting flag
-        std::call_once(force_flag_, []() {});
-    }
+        : storage_(std::in_place_index<detail::kPromiseValue>, std::move(value)),
+          state_(State::Ready) {}
 
     /**
      * @brief Move constructor.
      *
-     * Note: std::once_flag is not movable, so we cannot properly move promises
-     * after they've been forced. The moved-from promise will be in a valid but
-     * potentially unusable state.
+     * The new promise takes over the computation, value or exception together
+     * with the forced state. The moved-from promise is left invalid: forcing it
+     * throws std::logic_error.
      *
      * @param other The promise to move from.
      */
-    Promise(Promise&& other) noexcept
-        : computation_(std::move(other.computation_)),
-          value_(std::move(other.value_)),
-          exception_(std::move(other.exception_)) {
-        // Note: force_flag_ cannot be moved (std::once_flag is not movable)
-        // This means a moved-from promise that was already forced will have
-        // issues if force() is called on it again
+    Promise(Promise&& other) noexcept : state_(other.state_.load(std::memory_order_acquire)) {
+        storage_.swap(other.storage_);  // leaves other holding the empty alternative
+        other.state_.store(State::Empty, std::memory_order_release);
     }
 
     /**
      * @brief Move assignment operator.
      *
-     * Note: std::once_flag is not movable, so this assignment only moves the
-     * computation, value, and exception. The force state is not transferred.
-     *
      * @param other The promise to move from.
      * @return Reference to this promise.
      */
     Promise& operator=(Promise&& other) noexcept {
         if (this != &other) {
-            computation_ = std::move(other.computation_);
-            value_ = std::move(other.value_);
-            exception_ = std::move(other.exception_);
-            // Note: force_flag_ cannot be moved/assigned
+            storage_ = std::move(other.storage_);
+            state_.store(other.state_.load(std::memory_order_acquire), std::memory_order_release);
+            other.release_state();
         }
         return *this;
     }
@@ -137,24 +249,17 @@ public:
      * Subsequent calls return the cached result without re-executing the computation.
      *
      * Thread Safety: Safe to call from multiple threads concurrently. The computation
-     * will be executed exactly once.
+     * will be executed exactly once. After publication this is wait-free.
      *
      * @return Reference to the computed value.
      * @throws Any exception thrown by the computation function (re-thrown on all calls).
      * @throws std::logic_error if the promise was moved from.
      */
     T& force() {
-        std::call_once(force_flag_, [this]() { execute_computation(); });
-
-        if (exception_) {
-            std::rethrow_exception(exception_);
-        }
-
-        if (!value_) {
-            throw std::logic_error("Promise is in invalid state (possibly moved from)");
+        if (state_.load(std::memory_order_acquire) == State::Ready) {
+            return *std::get_if<detail::kPromiseValue>(&storage_);
         }
-
-        return *value_;
+        return force_slow();
     }
 
     /**
@@ -167,29 +272,16 @@ public:
      * @throws Any exception thrown by the computation function.
      * @throws std::logic_error if the promise was moved from.
      */
-    const T& force() const {
-        std::call_once(force_flag_, [this]() { execute_computation(); });
-
-        if (exception_) {
-            std::rethrow_exception(exception_);
-        }
-
-        if (!value_) {
-            throw std::logic_error("Promise is in invalid state (possibly moved from)");
-        }
-
-        return *value_;
-    }
+    const T& force() const { return const_cast<Promise*>(this)->force(); }
 
     /**
      * @brief Check if the promise has been forced.
      *
-     * @return true if force() has been called (successfully or not), false otherwise.
+     * @return true if force() has completed (successfully or not), false otherwise.
      */
     [[nodiscard]] bool is_forced() const noexcept {
-        // Check if the once_flag has been invoked by attempting to call with empty lambda
-        // Since we can't directly query once_flag, we check if value or exception is set
-        return value_ != nullptr || exception_ != nullptr;
+        const State state = state_.load(std::memory_order_acquire);
+        return state == State::Ready || state == State::Failed;
     }
 
     /**
@@ -197,53 +289,252 @@ public:
      *
      * @return true if the promise has been forced and has a value, false otherwise.
      */
-    [[nodiscard]] bool has_value() const noexcept { return value_ != nullptr; }
+    [[nodiscard]] bool has_value() const noexcept {
+        return state_.load(std::memory_order_acquire) == State::Ready;
+    }
 
     /**
      * @brief Check if the promise has an exception (forced with failure).
      *
      * @return true if the promise was forced and threw an exception, false otherwise.
      */
-    [[nodiscard]] bool has_exception() const noexcept { return exception_ != nullptr; }
+    [[nodiscard]] bool has_exception() const noexcept {
+        return state_.load(std::memory_order_acquire) == State::Failed;
+    }
+
+    /**
+     * @brief Move the forced value out, leaving the promise moved-from.
+     *
+     * Intended for tearing down promises that are owned exclusively (see
+     * RankingElement's destructor); it must not race with force().
+     *
+     * @return The value if the promise was forced successfully, otherwise empty.
+     */
+    [[nodiscard]] std::optional<T> take_value() noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (state_.load(std::memory_order_acquire) != State::Ready) {
+            return std::nullopt;
+        }
+        std::optional<T> value(std::move(*std::get_if<detail::kPromiseValue>(&storage_)));
+        release_state();
+        return value;
+    }
 
 private:
+    enum class State : unsigned char {
+        Pending,  ///< Computation not yet started
+        Running,  ///< One thread is executing the computation
+        Ready,    ///< The value in storage_ is published
+        Failed,   ///< The exception in storage_ is published
+        Empty     ///< Moved from
+    };
+
+    template<typename F>
+    Promise(std::in_place_t, F&& computation)
+        : storage_(std::in_place_index<detail::kPromisePending>,
+                   detail::require_computation(std::forward<F>(computation))),
+          state_(State::Pending) {}
+
+    void release_state() noexcept {
+        storage_.template emplace<detail::kPromiseEmpty>();
+        state_.store(State::Empty, std::memory_order_release);
+    }
+
     /**
-     * @brief Execute the computation and store result or exception.
+     * @brief Claim and run the computation, or wait for the thread that did.
+     */
+    T& force_slow() {
+        State state = state_.load(std::memory_order_acquire);
+        for (;;) {
+            switch (state) {
+            case State::Ready:
+                return *std::get_if<detail::kPromiseValue>(&storage_);
+            case State::Failed:
+                std::rethrow_exception(*std::get_if<detail::kPromiseFailed>(&storage_));
+            case State::Empty:
+                throw std::logic_error("Promise is in invalid state (possibly moved from)");
+            case State::Pending:
+                if (state_.compare_exchange_strong(state, State::Running,
+                                                   std::memory_order_acquire,
+                                                   std::memory_order_acquire)) {
+                    state = execute_computation();
+                }
+                break;
+            case State::Running:
+                state_.wait(State::Running, std::memory_order_acquire);
+                state = state_.load(std::memory_order_acquire);
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Execute the computation and publish its result or exception.
      *
-     * This method is called exactly once by std::call_once. It captures either
-     * the successful result or any thrown exception for future access.
+     * Only the thread that moved the state to Running calls this, so the
+     * non-atomic members are written without further synchronisation; the
+     * release store on state_ publishes them to every reader.
      *
-     * Special case: If the promise was moved from an already-forced promise,
-     * value_ will already be set and computation_ will be null. In this case,
-     * we do nothing (the value is already available).
+     * @return The published state.
      */
-    void execute_computation() const {
-        // If value is already set (from move of forced promise), don't execute
-        if (const_cast<const Promise*>(this)->value_) {
-            return;
+    State execute_computation() {
+        State published;
+        {
+            detail::InlineFunction<T> computation =
+                std::move(*std::get_if<detail::kPromisePending>(&storage_));
+            storage_.template emplace<detail::kPromiseEmpty>();
+            try {
+                storage_.template emplace<detail::kPromiseValue>(computation());
+                published = State::Ready;
+            } catch (...) {
+                storage_.template emplace<detail::kPromiseFailed>(std::current_exception());
+                published = State::Failed;
+            }
         }
+        state_.store(published, std::memory_order_release);
+        state_.notify_all();
+        return published;
+    }
+
+    detail::PromiseStorage<T> storage_;  ///< Computation, value or exception
+    std::atomic<State> state_;           ///< Publication state
+};
 
+/**
+ * @class Promise<T, SingleThreadedPolicy>
+ * @brief Unsynchronised lazy computation for single-threaded queries.
+ *
+ * Same interface and exception semantics as the thread-safe promise, without
+ * any atomic operations. The thunk, value and captured exception share one
+ * inline std::variant, and the thunk is held in an InlineFunction so typical
+ * closures need no separate allocation. Move-only callables are accepted.
+ *
+ * Thread Safety: None. A promise must not be forced concurrently. Forcing a
+ * promise re-entrantly from its own computation throws std::logic_error.
+ *
+ * @tparam T The type of value produced by the promise.
+ */
+template<typename T>
+class Promise<T, SingleThreadedPolicy> {
+public:
+    /**
+     * @brief Construct a promise from a computation function.
+     *
+     * @param computation A callable that produces a value of type T.
+     * @throws std::invalid_argument if computation is null/empty.
+     */
+    template<typename F>
+    requires detail::PromiseComputation<F, T>
+    explicit Promise(F&& computation)
+        : state_(std::in_place_index<kPending>,
+                 detail::require_computation(std::forward<F>(computation))) {}
+
+    /**
+     * @brief Construct a promise from an already-computed value.
+     *
+     * @param value The pre-computed value to wrap.
+     */
+    explicit Promise(T value) : state_(std::in_place_index<kValue>, std::move(value)) {}
+
+    /**
+     * @brief Move constructor. The moved-from promise is left invalid.
+     */
+    Promise(Promise&& other) noexcept : state_(std::move(other.state_)) {
+        other.state_.template emplace<kEmpty>();
+    }
+
+    /**
+     * @brief Move assignment operator. The moved-from promise is left invalid.
+     */
+    Promise& operator=(Promise&& other) noexcept {
+        if (this != &other) {
+            state_ = std::move(other.state_);
+            other.state_.template emplace<kEmpty>();
+        }
+        return *this;
+    }
+
+    Promise(const Promise&) = delete;
+    Promise& operator=(const Promise&) = delete;
+
+    /**
+     * @brief Force evaluation of the promise and return the result.
+     *
+     * @return Reference to the computed value.
+     * @throws Any exception thrown by the computation function (re-thrown on all calls).
+     * @throws std::logic_error if the promise was moved from or is forced re-entrantly.
+     */
+    T& force() {
+        if (auto* value = std::get_if<kValue>(&state_)) {
+            return *value;
+        }
+        return force_slow();
+    }
+
+    /**
+     * @brief Force evaluation and return const reference to the result.
+     */
+    const T& force() const { return const_cast<Promise*>(this)->force(); }
+
+    /**
+     * @brief Check if the promise has been forced (successfully or not).
+     */
+    [[nodiscard]] bool is_forced() const noexcept {
+        return state_.index() == kValue || state_.index() == kFailed;
+    }
+
+    /**
+     * @brief Check if the promise has a value (forced successfully).
+     */
+    [[nodiscard]] bool has_value() const noexcept { return state_.index() == kValue; }
+
+    /**
+     * @brief Check if the promise has an exception (forced with failure).
+     */
+    [[nodiscard]] bool has_exception() const noexcept { return state_.index() == kFailed; }
+
+    /**
+     * @brief Move the forced value out, leaving the promise moved-from.
+     *
+     * @return The value if the promise was forced successfully, otherwise empty.
+     */
+    [[nodiscard]] std::optional<T> take_value() noexcept(std::is_nothrow_move_constructible_v<T>) {
+        auto* value = std::get_if<kValue>(&state_);
+        if (!value) {
+            return std::nullopt;
+        }
+        std::optional<T> result(std::move(*value));
+        state_.template emplace<kEmpty>();
+        return result;
+    }
+
+private:
+    static constexpr std::size_t kEmpty = detail::kPromiseEmpty;
+    static constexpr std::size_t kPending = detail::kPromisePending;
+    static constexpr std::size_t kValue = detail::kPromiseValue;
+    static constexpr std::size_t kFailed = detail::kPromiseFailed;
+
+    T& force_slow() {
+        if (auto* error = std::get_if<kFailed>(&state_)) {
+            std::rethrow_exception(*error);
+        }
+        auto* pending = std::get_if<kPending>(&state_);
+        if (!pending) {
+            throw std::logic_error("Promise is in invalid state (moved from or forced re-entrantly)");
+        }
+
+        // Release the thunk before running it so its captures are freed with it
+        // and a re-entrant force() is detected instead of recursing.
+        detail::InlineFunction<T> computation = std::move(*pending);
+        state_.template emplace<kEmpty>();
         try {
-            if (!computation_) {
-                throw std::logic_error("Cannot force a promise without a computation function");
-            }
-            // Execute computation and store result
-            // Use const_cast since this is memoization (implementation detail)
-            const_cast<Promise*>(this)->value_ = std::make_unique<T>(computation_());
-            // Clear computation to free resources
-            const_cast<Promise*>(this)->computation_ = nullptr;
+            return state_.template emplace<kValue>(computation());
         } catch (...) {
-            // Capture exception for re-throwing
-            const_cast<Promise*>(this)->exception_ = std::current_exception();
-            // Clear computation even on failure
-            const_cast<Promise*>(this)->computation_ = nullptr;
+            state_.template emplace<kFailed>(std::current_exception());
+            throw;
         }
     }
 
-    std::function<T()> computation_;           ///< The deferred computation
-    mutable std::unique_ptr<T> value_;         ///< Cached result (nullptr until forced)
-    mutable std::exception_ptr exception_;     ///< Cached exception if computation failed
-    mutable std::once_flag force_flag_;        ///< Ensures single execution
+    detail::PromiseStorage<T> state_;  ///< Computation, value or exception
 };
 
 /**
@@ -251,6 +542,7 @@ private:
  *
  * Provides type deduction for convenient promise creation.
  *
+ * @tparam Policy Threading policy of the promise (default: DefaultPromisePolicy).
  * @tparam F The type of the computation function.
  * @param computation The computation to defer.
  * @return A promise that will execute the computation when forced.
@@ -260,12 +552,12 @@ private:
  * auto p = make_promise([]() { return 42; });
  * @endcode
  */
-template<Invocable F>
+template<typename Policy = DefaultPromisePolicy, Invocable F>
 requires ValueType<std::invoke_result_t<std::decay_t<F>>>
 [[nodiscard]] auto make_promise(F&& computation)
-    -> Promise<std::invoke_result_t<std::decay_t<F>>> {
+    -> Promise<std::invoke_result_t<std::decay_t<F>>, Policy> {
     using T = std::invoke_result_t<std::decay_t<F>>;
-    return Promise<T>(std::function<T()>(std::forward<F>(computation)));
+    return Promise<T, Policy>(std::forward<F>(computation));
 }
 
 /**
@@ -273,6 +565,7 @@ requires ValueType<std::invoke_result_t<std::decay_t<F>>>
  *
  * Provides type deduction for convenient promise creation from values.
  *
+ * @tparam Policy Threading policy of the promise (default: DefaultPromisePolicy).
  * @tparam T The type of the value (deduced).
  * @param value The value to wrap in a promise.
  * @return A promise that is already forced with the given value.
@@ -282,12 +575,12 @@ requires ValueType<std::invoke_result_t<std::decay_t<F>>>
  * auto p = make_promise_value(42);
  * @endcode
  */
-template<typename T>
+template<typename Policy = DefaultPromisePolicy, typename T>
 requires ValueType<std::decay_t<T>>
-[[nodiscard]] Promise<std::decay_t<T>> make_promise_value(T&& value) {
-    return Promise<std::decay_t<T>>(std::forward<T>(value));
+[[nodiscard]] Promise<std::decay_t<T>, Policy> make_promise_value(T&& value) {
+    return Promise<std::decay_t<T>, Policy>(std::forward<T>(value));
 }
 
-}  // namespace ranked_belief
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI
 
 #endif  // RANKED_BELIEF_PROMISE_HPP
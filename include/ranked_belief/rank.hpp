@@ -7,19 +7,24 @@
  * exceptionality. Infinity represents impossibility.
  *
  * This implementation provides a type-safe wrapper around uint64_t with special handling
- * for infinity and arithmetic operations that respect rank semantics.
+ * for infinity and arithmetic operations that respect rank semantics. Infinity is
+ * encoded as a sentinel bit pattern, so a Rank is exactly one uint64_t and
+ * compares as a plain integer.
  */
 
 #ifndef RANKED_BELIEF_RANK_HPP
 #define RANKED_BELIEF_RANK_HPP
 
+#include "abi.hpp"
+
 #include <compare>
 #include <cstdint>
 #include <limits>
 #include <ostream>
 #include <stdexcept>
+#include <type_traits>
 
-namespace ranked_belief {
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
 
 /**
  * @class Rank
@@ -35,7 +40,12 @@ namespace ranked_belief {
  * - Minimum: Used for merging alternative ranking functions (merge)
  * - Infinity is an absorbing element for addition
  *
- * @invariant The internal value is either a valid uint64_t or the infinity flag is set.
+ * Representation: finite ranks never exceed max_finite_value() (2^63 - 1), so
+ * the top bit is free. Infinity is stored as UINT64_MAX, which orders above
+ * every finite value; comparisons are therefore plain integer comparisons and
+ * the sum of two finite ranks never wraps.
+ *
+ * @invariant value_ <= max_finite_value() or value_ == infinity sentinel.
  */
 class Rank {
 public:
@@ -43,13 +53,21 @@ public:
      * @brief Construct a rank with value zero (most normal).
      * @return A rank representing the most normal outcome.
      */
-    [[nodiscard]] static constexpr Rank zero() noexcept { return Rank(0, false); }
+    [[nodiscard]] static constexpr Rank zero() noexcept { return Rank(0); }
 
     /**
      * @brief Construct a rank representing infinity (impossibility).
      * @return A rank representing an impossible outcome.
      */
-    [[nodiscard]] static constexpr Rank infinity() noexcept { return Rank(0, true); }
+    [[nodiscard]] static constexpr Rank infinity() noexcept { return Rank(kInfinity); }
+
+    /**
+     * @brief Construct the largest finite rank, max_finite_value().
+     *
+     * Not reachable through from_value(); saturating arithmetic clamps to it.
+     * @return The largest finite rank.
+     */
+    [[nodiscard]] static constexpr Rank max_finite() noexcept { return Rank(max_finite_value()); }
 
     /**
      * @brief Construct a rank from a finite non-negative integer value.
@@ -63,7 +81,7 @@ public:
                 "Rank value must be less than max_finite_value() (2^63). Use Rank::infinity() "
                 "for infinite ranks.");
         }
-        return Rank(value, false);
+        return Rank(value);
     }
 
     /**
@@ -81,19 +99,19 @@ public:
     /**
      * @brief Default constructor creates rank zero.
      */
-    constexpr Rank() noexcept : value_(0), is_infinity_(false) {}
+    constexpr Rank() noexcept : value_(0) {}
 
     /**
      * @brief Check if this rank represents infinity.
      * @return true if this rank is infinite, false otherwise.
      */
-    [[nodiscard]] constexpr bool is_infinity() const noexcept { return is_infinity_; }
+    [[nodiscard]] constexpr bool is_infinity() const noexcept { return value_ == kInfinity; }
 
     /**
      * @brief Check if this rank is finite.
      * @return true if this rank is not infinite, false otherwise.
      */
-    [[nodiscard]] constexpr bool is_finite() const noexcept { return !is_infinity_; }
+    [[nodiscard]] constexpr bool is_finite() const noexcept { return value_ != kInfinity; }
 
     /**
      * @brief Get the numeric value of this rank.
@@ -102,7 +120,7 @@ public:
      * @throws std::logic_error if this rank is infinite.
      */
     [[nodiscard]] uint64_t value() const {
-        if (is_infinity_) {
+        if (is_infinity()) {
             throw std::logic_error("Cannot get numeric value of infinite rank");
         }
         return value_;
@@ -114,7 +132,7 @@ public:
      * @return The rank value if finite, otherwise default_value.
      */
     [[nodiscard]] constexpr uint64_t value_or(uint64_t default_value) const noexcept {
-        return is_infinity_ ? default_value : value_;
+        return is_infinity() ? default_value : value_;
     }
 
     /**
@@ -128,18 +146,32 @@ public:
      * @param other The rank to add.
      * @return The sum of the two ranks.
      * @throws std::overflow_error if the sum would exceed max_finite_value().
+     * @see saturating_add() for a non-throwing variant.
      */
-    [[nodiscard]] Rank operator+(const Rank& other) const {
-        if (is_infinity_ || other.is_infinity_) {
-            return infinity();
-        }
-
-        // Check for overflow before performing addition
-        if (value_ > max_finite_value() - other.value_) {
+    [[nodiscard]] constexpr Rank operator+(const Rank& other) const {
+        const bool either_infinite = ((value_ | other.value_) & kInfinityBit) != 0;
+        const uint64_t sum = value_ + other.value_;  // cannot wrap for finite operands
+        if (!either_infinite && sum > max_finite_value()) [[unlikely]] {
             throw std::overflow_error("Rank addition would overflow max_finite_value()");
         }
+        return Rank(either_infinite ? kInfinity : sum);
+    }
 
-        return Rank(value_ + other.value_, false);
+    /**
+     * @brief Add two ranks, clamping instead of throwing on overflow.
+     *
+     * Same as operator+ except that a finite sum above max_finite_value() is
+     * clamped to max_finite_value(). Intended for hot paths (see RankOverflow)
+     * where ranks that large are already meaningless.
+     *
+     * @param other The rank to add.
+     * @return The saturated sum of the two ranks.
+     */
+    [[nodiscard]] constexpr Rank saturating_add(const Rank& other) const noexcept {
+        const bool either_infinite = ((value_ | other.value_) & kInfinityBit) != 0;
+        const uint64_t sum = value_ + other.value_;
+        const uint64_t clamped = sum > max_finite_value() ? max_finite_value() : sum;
+        return Rank(either_infinite ? kInfinity : clamped);
     }
 
     /**
@@ -154,12 +186,6 @@ public:
      * @return The smaller of the two ranks.
      */
     [[nodiscard]] constexpr Rank min(const Rank& other) const noexcept {
-        if (is_infinity_) {
-            return other;
-        }
-        if (other.is_infinity_) {
-            return *this;
-        }
         return value_ <= other.value_ ? *this : other;
     }
 
@@ -175,9 +201,6 @@ public:
      * @return The larger of the two ranks.
      */
     [[nodiscard]] constexpr Rank max(const Rank& other) const noexcept {
-        if (is_infinity_ || other.is_infinity_) {
-            return infinity();
-        }
         return value_ >= other.value_ ? *this : other;
     }
 
@@ -192,13 +215,13 @@ public:
      * @throws std::underflow_error if this < other.
      */
     [[nodiscard]] Rank operator-(const Rank& other) const {
-        if (is_infinity_ || other.is_infinity_) {
+        if (is_infinity() || other.is_infinity()) {
             throw std::logic_error("Cannot subtract infinite ranks");
         }
         if (value_ < other.value_) {
             throw std::underflow_error("Rank subtraction would result in negative value");
         }
-        return Rank(value_ - other.value_, false);
+        return Rank(value_ - other.value_);
     }
 
     /**
@@ -210,16 +233,7 @@ public:
      * @return std::strong_ordering indicating the relationship.
      */
     [[nodiscard]] constexpr std::strong_ordering operator<=>(const Rank& other) const noexcept {
-        // Infinity is greater than any finite value
-        if (is_infinity_ && other.is_infinity_) {
-            return std::strong_ordering::equal;
-        }
-        if (is_infinity_) {
-            return std::strong_ordering::greater;
-        }
-        if (other.is_infinity_) {
-            return std::strong_ordering::less;
-        }
+        // The infinity sentinel is greater than any finite value
         return value_ <=> other.value_;
     }
 
@@ -229,7 +243,7 @@ public:
      * @return true if the ranks are equal, false otherwise.
      */
     [[nodiscard]] constexpr bool operator==(const Rank& other) const noexcept {
-        return is_infinity_ == other.is_infinity_ && (is_infinity_ || value_ == other.value_);
+        return value_ == other.value_;
     }
 
     /**
@@ -240,7 +254,7 @@ public:
      * @throws std::logic_error if this rank is infinite.
      */
     Rank& operator++() {
-        if (is_infinity_) {
+        if (is_infinity()) {
             throw std::logic_error("Cannot increment infinite rank");
         }
         if (value_ >= max_finite_value() - 1) {
@@ -271,7 +285,7 @@ public:
      * @throws std::logic_error if this rank is infinite.
      */
     Rank& operator--() {
-        if (is_infinity_) {
+        if (is_infinity()) {
             throw std::logic_error("Cannot decrement infinite rank");
         }
         if (value_ == 0) {
@@ -304,7 +318,7 @@ public:
      * @return Reference to the output stream.
      */
     friend std::ostream& operator<<(std::ostream& os, const Rank& rank) {
-        if (rank.is_infinity_) {
+        if (rank.is_infinity()) {
             os << "∞";
         } else {
             os << rank.value_;
@@ -313,18 +327,23 @@ public:
     }
 
 private:
+    /// Bit pattern representing infinity (all bits set).
+    static constexpr uint64_t kInfinity = std::numeric_limits<uint64_t>::max();
+    /// Top bit: set only by the infinity sentinel, never by a finite rank.
+    static constexpr uint64_t kInfinityBit = uint64_t{1} << 63;
+
     /**
      * @brief Private constructor for internal use.
-     * @param value The numeric rank value.
-     * @param is_infinity Whether this rank represents infinity.
+     * @param value The numeric rank value or the infinity sentinel.
      */
-    constexpr Rank(uint64_t value, bool is_infinity) noexcept
-        : value_(value), is_infinity_(is_infinity) {}
+    constexpr explicit Rank(uint64_t value) noexcept : value_(value) {}
 
-    uint64_t value_;       ///< Numeric rank value (meaningful only if not infinite)
-    bool is_infinity_;     ///< Whether this rank represents infinity
+    uint64_t value_;  ///< Numeric rank value, or kInfinity
 };
 
-}  // namespace ranked_belief
+static_assert(sizeof(Rank) == sizeof(uint64_t), "Rank must stay a single machine word");
+static_assert(std::is_trivially_copyable_v<Rank>);
+
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI
 
 #endif  // RANKED_BELIEF_RANK_HPP
@@ -0,0 +1,94 @@
+/**
+ * @file rank_horizon.hpp
+ * @brief Thread-local rank horizon for bounded ("up to rank K") evaluation.
+ *
+ * Most queries only look at the elements up to some rank K. Operations that
+ * run user callbacks lazily (merge_apply, normal_exceptional, filter) still
+ * invoke them for branches that can only produce elements above K, because
+ * they cannot know the caller will stop there. A rank horizon tells them:
+ *
+ * - RankHorizonScope: RAII helper installing a horizon on the calling thread
+ * - current_rank_horizon(): the innermost installed horizon (infinity if none)
+ *
+ * Like the NodePool, the horizon is captured by each operation when it is
+ * constructed, and re-installed (lowered by the branch's rank offset) around
+ * the callbacks it runs later, so recursively built rankings inherit it
+ * whichever thread forces them. A ranking built under horizon K may omit any
+ * element ranked above K; with_rank_horizon() (filter.hpp) builds a ranking in
+ * such a scope and truncates it at K.
+ *
+ * Pruning is sound only if nothing downstream lowers ranks again. observe()
+ * normalizes its input by subtracting the minimum rank, so rankings that will
+ * be observed must be built outside any horizon.
+ */
+
+#ifndef RANKED_BELIEF_RANK_HORIZON_HPP
+#define RANKED_BELIEF_RANK_HORIZON_HPP
+
+#include "rank.hpp"
+
+#include <utility>
+
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
+
+namespace detail {
+
+/// Horizon installed on the calling thread by the innermost RankHorizonScope.
+inline thread_local Rank current_rank_horizon_slot = Rank::infinity();
+
+/**
+ * @brief The horizon seen by a branch whose ranks are shifted up by @p offset.
+ * @pre offset <= horizon
+ */
+[[nodiscard]] inline Rank horizon_below(Rank horizon, Rank offset) {
+    return horizon.is_infinity() ? horizon : horizon - offset;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Get the rank horizon installed on the calling thread.
+ *
+ * @return The innermost active horizon, or Rank::infinity() if none is installed.
+ */
+[[nodiscard]] inline Rank current_rank_horizon() noexcept {
+    return detail::current_rank_horizon_slot;
+}
+
+/**
+ * @class RankHorizonScope
+ * @brief RAII guard that installs a rank horizon on the calling thread.
+ *
+ * Scopes nest: the previous horizon is restored when the scope ends. An inner
+ * scope replaces the outer horizon rather than tightening it, so operations
+ * can re-install the horizon they captured. Passing Rank::infinity() disables
+ * pruning for the scope.
+ *
+ * Example:
+ * @code
+ * RankHorizonScope scope(Rank::from_value(3));
+ * auto rf = merge_apply(input, expensive);  // never expands inputs above rank 3
+ * @endcode
+ */
+class RankHorizonScope {
+public:
+    /**
+     * @brief Install @p horizon for the lifetime of this scope.
+     */
+    explicit RankHorizonScope(Rank horizon) noexcept
+        : previous_(std::exchange(detail::current_rank_horizon_slot, horizon)) {}
+
+    RankHorizonScope(const RankHorizonScope&) = delete;
+    RankHorizonScope& operator=(const RankHorizonScope&) = delete;
+    RankHorizonScope(RankHorizonScope&&) = delete;
+    RankHorizonScope& operator=(RankHorizonScope&&) = delete;
+
+    ~RankHorizonScope() { detail::current_rank_horizon_slot = previous_; }
+
+private:
+    Rank previous_;  ///< Horizon restored on destruction
+};
+
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI
+
+#endif  // RANKED_BELIEF_RANK_HORIZON_HPP
@@ -0,0 +1,182 @@
+/**
+ * @file ranked_generator.hpp
+ * @brief C++20 coroutine type for writing lazy rankings as producers.
+ *
+ * A function returning ranked_generator<T> produces its elements with
+ * `co_yield {value, rank}` and converts to a RankingFunction<T>:
+ *
+ * @code
+ * ranked_generator<int> doubling(int x) {
+ *     for (Rank rank = Rank::zero();; rank = rank + Rank::from_value(1), x *= 2) {
+ *         co_yield {x, rank};
+ *     }
+ * }
+ * RankingFunction<int> rf = doubling(1);  // 1@0, 2@1, 4@2, ...
+ * @endcode
+ *
+ * The coroutine is resumed only when the next tail promise of the ranking is
+ * forced, and never runs ahead: each resume produces exactly the element being
+ * forced. Its local variables carry the producer's state between elements,
+ * and each lazy tail captures just a pointer to the shared generator instead
+ * of a copy of a generator closure. The coroutine frame is allocated from the
+ * NodePool current when the coroutine is called, if any.
+ */
+
+#ifndef RANKED_BELIEF_RANKED_GENERATOR_HPP
+#define RANKED_BELIEF_RANKED_GENERATOR_HPP
+
+#include "node_pool.hpp"
+#include "promise.hpp"
+#include "rank.hpp"
+#include "ranking_element.hpp"
+#include "ranking_function.hpp"
+#include "types.hpp"
+#include "detail/coroutine_frame.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
+
+/**
+ * @class ranked_generator
+ * @brief Coroutine producing (value, rank) pairs in non-decreasing rank order.
+ *
+ * Move-only; owns the coroutine until it is converted to a RankingFunction,
+ * after which the ranking's nodes share ownership and the frame is destroyed
+ * with the last of them. Exceptions thrown by the coroutine body propagate
+ * from the force that resumed it.
+ *
+ * @tparam T The value type of the ranking.
+ */
+template<typename T>
+class ranked_generator {
+public:
+    struct promise_type : detail::PooledFrame {
+        std::optional<std::pair<T, Rank>> current;  ///< Element from the latest co_yield
+        std::exception_ptr error;
+
+        ranked_generator get_return_object() {
+            return ranked_generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        std::suspend_always yield_value(std::pair<T, Rank> item) {
+            current.emplace(std::move(item));
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+    };
+
+    ranked_generator(ranked_generator&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    ranked_generator& operator=(ranked_generator&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    ranked_generator(const ranked_generator&) = delete;
+    ranked_generator& operator=(const ranked_generator&) = delete;
+
+    ~ranked_generator() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    /**
+     * @brief Hand the coroutine over to a lazy ranking.
+     *
+     * Runs the coroutine up to its first co_yield to build the head. Nodes come
+     * from the NodePool current at this call, which is also installed while
+     * the coroutine runs.
+     *
+     * @param deduplicate Whether the ranking deduplicates consecutive equal values.
+     * @throws std::logic_error if the generator was moved from.
+     * @throws std::invalid_argument (from the force that produced it) if a
+     *         yielded rank is lower than the previous one.
+     */
+    [[nodiscard]] RankingFunction<T> ranking(Deduplication deduplicate = Deduplication::Enabled) && {
+        if (!handle_) {
+            throw std::logic_error("ranked_generator has been moved from");
+        }
+        auto state = std::make_shared<State>(std::exchange(handle_, nullptr), current_node_pool());
+        return RankingFunction<T>(next_node(state), deduplicate);
+    }
+
+    /// Convert to a ranking with deduplication enabled (see ranking()).
+    operator RankingFunction<T>() && { return std::move(*this).ranking(); }
+
+private:
+    using Handle = std::coroutine_handle<promise_type>;
+
+    /**
+     * @brief The coroutine shared by the nodes of one ranking.
+     *
+     * Only the newest node holds an unforced next promise and only that
+     * promise resumes the coroutine, so it is never resumed concurrently.
+     */
+    struct State {
+        State(Handle coroutine, std::shared_ptr<NodePool> node_pool)
+            : handle(coroutine), pool(std::move(node_pool)) {}
+
+        State(const State&) = delete;
+        State& operator=(const State&) = delete;
+
+        ~State() { handle.destroy(); }
+
+        Handle handle;
+        std::shared_ptr<NodePool> pool;
+        Rank last_rank = Rank::zero();
+    };
+
+    explicit ranked_generator(Handle handle) noexcept : handle_(handle) {}
+
+    /// Resume the coroutine and wrap the element it yields.
+    [[nodiscard]] static std::shared_ptr<RankingElement<T>> next_node(const std::shared_ptr<State>& state) {
+        auto& promise = state->handle.promise();
+        {
+            NodePoolScope pool_scope(state->pool);
+            promise.current.reset();
+            state->handle.resume();
+        }
+        if (promise.error) {
+            std::rethrow_exception(std::exchange(promise.error, nullptr));
+        }
+        if (!promise.current) {
+            return nullptr;
+        }
+        auto [value, rank] = std::move(*promise.current);
+        promise.current.reset();
+        if (rank < state->last_rank) {
+            throw std::invalid_argument("ranked_generator ranks must be non-decreasing");
+        }
+        state->last_rank = rank;
+        return allocate_pooled<RankingElement<T>>(
+            state->pool,
+            std::move(value),
+            rank,
+            make_promise([state]() { return next_node(state); }));
+    }
+
+    Handle handle_;
+};
+
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI
+
+#endif  // RANKED_BELIEF_RANKED_GENERATOR_HPP
@@ -0,0 +1,476 @@
+/**
+ * @file ranked_program.hpp
+ * @brief Coroutine notation for ranked programs (`co_await` binds a ranking).
+ *
+ * A ranked_program<T> coroutine binds values with `co_await` and finishes
+ * with `co_return`, the C++ counterpart of the Racket library's `rlet*`:
+ *
+ * @code
+ * ranked_program<Outcome> model(bool input) {
+ *     const bool n = co_await flip;          // flip: RankingFunction<bool>
+ *     const bool o = co_await flip;
+ *     co_return Outcome{n && o && input, n, o};
+ * }
+ * auto rf = from_program([] { return model(true); });
+ * @endcode
+ *
+ * from_program() is the same computation as the nested merge_apply() calls
+ * the program spells out, and produces the same elements in the same order,
+ * but it does not build them. A best-first search walks the tree of binds
+ * directly: its frontier holds positions in the awaited rankings ordered by
+ * accumulated rank, and each result is the co_return of one path. No shifted
+ * or merged intermediate rankings, and no continuation closures, are created.
+ *
+ * C++ coroutines cannot be resumed twice from the same point, so a path is
+ * explored by running the program again from the start and answering the
+ * binds it has already made from the recorded path (replay). The program is
+ * therefore created through a factory, and its body must be deterministic:
+ * given the same bound values it must perform the same binds in the same
+ * order. Side effects before a bind are repeated on each replay. Paths whose
+ * next bind ranks no higher than the current one are continued in the same
+ * run, so most results cost one run of the program.
+ */
+
+#ifndef RANKED_BELIEF_RANKED_PROGRAM_HPP
+#define RANKED_BELIEF_RANKED_PROGRAM_HPP
+
+#include "node_pool.hpp"
+#include "promise.hpp"
+#include "rank.hpp"
+#include "rank_horizon.hpp"
+#include "ranking_element.hpp"
+#include "ranking_function.hpp"
+#include "types.hpp"
+#include "detail/coroutine_frame.hpp"
+#include "operations/merge_apply.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
+
+template<typename T>
+class ranked_program;
+
+namespace detail {
+
+/**
+ * @brief Type-erased access to the RankingElement<U> nodes of an awaited ranking.
+ *
+ * One instance exists per U (bind_ops<U>), so the pointer also identifies U.
+ */
+struct BindOps {
+    Rank (*rank)(const void* node);
+    std::shared_ptr<void> (*next)(const void* node);
+};
+
+template<typename U>
+inline constexpr BindOps bind_ops{
+    [](const void* node) { return static_cast<const RankingElement<U>*>(node)->rank(); },
+    [](const void* node) -> std::shared_ptr<void> {
+        return static_cast<const RankingElement<U>*>(node)->next();
+    }};
+
+/**
+ * @brief One bind on an explored path: the awaited element the program received.
+ *
+ * Paths share their prefixes through @c parent.
+ */
+struct BindChoice {
+    std::shared_ptr<const BindChoice> parent;
+    std::shared_ptr<void> node;  ///< The RankingElement<U> bound
+    const BindOps* ops;
+    std::size_t index;           ///< Position of node in the awaited ranking
+    std::size_t depth;           ///< Binds on the path, this one included
+    Rank rank;                   ///< Accumulated rank of the path
+};
+
+/**
+ * @brief Frontier entry: a path extended by one element of an awaited ranking.
+ *
+ * A sibling entry stands for the element after @c node, which has not been
+ * forced yet; its rank is a lower bound (node's own) until it is.
+ */
+struct BindCandidate {
+    std::shared_ptr<const BindChoice> parent;
+    std::shared_ptr<void> node;
+    const BindOps* ops;
+    std::size_t index;
+    std::int64_t offset;             ///< Rank offset of the awaited ranking
+    RankOverflow offset_overflow;
+    Rank rank;
+    bool sibling;
+
+    [[nodiscard]] std::size_t position() const noexcept { return index + (sibling ? 1 : 0); }
+};
+
+/**
+ * @brief Lexicographic order of two paths, given as parent and last position.
+ *
+ * This is the order in which nested merge_apply() calls emit results of
+ * equal rank. Walks up to the paths' common prefix; O(depth).
+ *
+ * @return Negative, zero or positive as @p lhs precedes, equals or follows @p rhs.
+ */
+[[nodiscard]] inline int compare_bind_paths(const BindChoice* lhs,
+                                            std::size_t lhs_index,
+                                            const BindChoice* rhs,
+                                            std::size_t rhs_index) noexcept {
+    const auto depth = [](const BindChoice* choice) { return choice ? choice->depth : 0; };
+    const auto lift = [](const BindChoice*& choice, std::size_t& index) {
+        index = choice->index;
+        choice = choice->parent.get();
+    };
+    int longer = 0;
+    while (depth(lhs) > depth(rhs)) {
+        lift(lhs, lhs_index);
+        longer = 1;
+    }
+    while (depth(rhs) > depth(lhs)) {
+        lift(rhs, rhs_index);
+        longer = -1;
+    }
+    while (lhs != rhs) {
+        lift(lhs, lhs_index);
+        lift(rhs, rhs_index);
+    }
+    if (lhs_index != rhs_index) {
+        return lhs_index < rhs_index ? -1 : 1;
+    }
+    return longer;
+}
+
+/// Heap order for the search: lowest rank first, ties in path order.
+[[nodiscard]] inline bool bind_candidate_after(const BindCandidate& lhs, const BindCandidate& rhs) {
+    if (lhs.rank != rhs.rank) {
+        return lhs.rank > rhs.rank;
+    }
+    return compare_bind_paths(lhs.parent.get(), lhs.position(), rhs.parent.get(), rhs.position()) > 0;
+}
+
+/**
+ * @brief The awaited ranking at the first bind a run had no recorded answer for.
+ */
+struct BindBranch {
+    std::shared_ptr<void> head;
+    const BindOps* ops;
+    std::int64_t offset;
+    RankOverflow overflow;
+};
+
+/**
+ * @brief Replay state shared by the search and the running program's binds.
+ */
+struct ProgramReplay {
+    std::vector<const BindChoice*> path;  ///< Recorded answers, root first
+    std::size_t depth = 0;                ///< Binds answered so far in this run
+    std::optional<BindBranch> branch;
+};
+
+/**
+ * @brief Awaiter for `co_await ranking` inside a ranked_program.
+ *
+ * Completes immediately with the recorded value while replaying; otherwise
+ * reports the ranking to the search and suspends.
+ */
+template<typename U>
+struct BindAwaiter {
+    RankingFunction<U> ranking;
+    ProgramReplay& replay;
+
+    [[nodiscard]] bool await_ready() const noexcept { return replay.depth < replay.path.size(); }
+
+    void await_suspend(std::coroutine_handle<>) {
+        replay.branch.emplace(BindBranch{
+            ranking.raw_head(), &bind_ops<U>, ranking.rank_offset(), ranking.rank_overflow()});
+    }
+
+    [[nodiscard]] const U& await_resume() const {
+        const BindChoice* choice = replay.path[replay.depth++];
+        if (choice->ops != &bind_ops<U>) {
+            throw std::logic_error("ranked_program replay diverged; program bodies must be deterministic");
+        }
+        return static_cast<const RankingElement<U>*>(choice->node.get())->value();
+    }
+};
+
+template<typename T, typename Factory>
+struct ProgramSearch;
+
+}  // namespace detail
+
+/**
+ * @class ranked_program
+ * @brief Coroutine type for ranked programs; see the file documentation.
+ *
+ * The body may `co_await` any RankingFunction<U>, which evaluates to a
+ * `const U&` bound to one of its values, and must end with `co_return`.
+ * Instances are only useful to from_program(), which creates and runs them.
+ * The frame is allocated from the current NodePool, if any.
+ *
+ * @note GCC 12 miscompiles `co_await (c ? a() : b())` when both operands are
+ *       temporaries; bind such a ranking to a local before awaiting it.
+ *
+ * @tparam T The value type of the resulting ranking.
+ */
+template<typename T>
+class ranked_program {
+public:
+    using value_type = T;
+
+    struct promise_type : detail::PooledFrame {
+        std::optional<T> result;
+        std::exception_ptr error;
+        detail::ProgramReplay* replay = nullptr;
+
+        ranked_program get_return_object() {
+            return ranked_program(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        void return_value(T value) { result.emplace(std::move(value)); }
+
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+
+        template<typename U>
+        detail::BindAwaiter<U> await_transform(RankingFunction<U> ranking) {
+            return detail::BindAwaiter<U>{std::move(ranking), *replay};
+        }
+    };
+
+    ranked_program(ranked_program&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    ranked_program& operator=(ranked_program&&) = delete;
+    ranked_program(const ranked_program&) = delete;
+    ranked_program& operator=(const ranked_program&) = delete;
+
+    ~ranked_program() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+private:
+    template<typename, typename>
+    friend struct detail::ProgramSearch;
+
+    explicit ranked_program(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+
+/**
+ * @brief Best-first search over the binds of a ranked program.
+ *
+ * Only the newest node of the result holds an unforced next promise and only
+ * that thunk runs the search, so it needs no lock of its own.
+ */
+template<typename T, typename Factory>
+struct ProgramSearch {
+    Factory factory;
+    RankOverflow overflow;
+    std::shared_ptr<NodePool> pool;
+    Rank horizon;
+    std::vector<BindCandidate> heap;
+    ProgramReplay replay;
+    bool started = false;
+
+    void push(BindCandidate candidate) {
+        if (candidate.rank > horizon) {
+            return;
+        }
+        heap.push_back(std::move(candidate));
+        std::push_heap(heap.begin(), heap.end(), bind_candidate_after);
+    }
+
+    [[nodiscard]] Rank candidate_rank(const BindChoice* parent,
+                                      const BindOps& ops,
+                                      const void* node,
+                                      std::int64_t offset,
+                                      RankOverflow offset_overflow) const {
+        return add_ranks(parent ? parent->rank : Rank::zero(),
+                         offset_rank(ops.rank(node), offset, offset_overflow), overflow);
+    }
+
+    /// Bind @p candidate's element, leaving a placeholder for its successor.
+    [[nodiscard]] std::shared_ptr<const BindChoice> take(BindCandidate candidate) {
+        push({candidate.parent, candidate.node, candidate.ops, candidate.index,
+              candidate.offset, candidate.offset_overflow, candidate.rank, true});
+        const std::size_t depth = candidate.parent ? candidate.parent->depth + 1 : 1;
+        return allocate_pooled<BindChoice>(
+            pool,
+            BindChoice{std::move(candidate.parent), std::move(candidate.node), candidate.ops,
+                       candidate.index, depth, candidate.rank});
+    }
+
+    /**
+     * @brief Run the program along @p choice's path.
+     *
+     * @return The result, if the path (possibly continued at the same rank)
+     *         reaches a co_return; nothing if it stopped at a higher-ranked
+     *         bind, which was added to the frontier, or at an empty ranking.
+     */
+    [[nodiscard]] std::optional<std::pair<T, Rank>> run(std::shared_ptr<const BindChoice> choice) {
+        replay.path.clear();
+        for (const BindChoice* step = choice.get(); step; step = step->parent.get()) {
+            replay.path.push_back(step);
+        }
+        std::reverse(replay.path.begin(), replay.path.end());
+        replay.depth = 0;
+        replay.branch.reset();
+        const Rank rank = choice ? choice->rank : Rank::zero();
+
+        NodePoolScope pool_scope(pool);
+        RankHorizonScope horizon_scope(horizon_below(horizon, rank));
+        ranked_program<T> program = std::invoke(factory);
+        auto& promise = program.handle_.promise();
+        promise.replay = &replay;
+        for (;;) {
+            program.handle_.resume();
+            if (promise.error) {
+                std::rethrow_exception(promise.error);
+            }
+            if (promise.result) {
+                if (replay.depth != replay.path.size()) {
+                    throw std::logic_error("ranked_program replay diverged; program bodies must be deterministic");
+                }
+                return std::make_pair(std::move(*promise.result), rank);
+            }
+            if (!replay.branch) {
+                throw std::logic_error("ranked_program finished without co_return");
+            }
+            BindBranch branch = std::move(*replay.branch);
+            replay.branch.reset();
+            if (!branch.head) {
+                return std::nullopt;
+            }
+            const Rank head_rank = candidate_rank(
+                choice.get(), *branch.ops, branch.head.get(), branch.offset, branch.overflow);
+            BindCandidate head{choice, std::move(branch.head), branch.ops, 0,
+                               branch.offset, branch.overflow, head_rank, false};
+            if (head.rank != rank) {
+                push(std::move(head));
+                return std::nullopt;
+            }
+            // Nothing on the frontier precedes this extension; bind it in this run.
+            choice = take(std::move(head));
+            replay.path.push_back(choice.get());
+        }
+    }
+
+    [[nodiscard]] std::optional<std::pair<T, Rank>> next_result() {
+        if (!started) {
+            started = true;
+            if (auto result = run(nullptr)) {
+                return result;
+            }
+        }
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), bind_candidate_after);
+            BindCandidate top = std::move(heap.back());
+            heap.pop_back();
+            if (top.sibling) {
+                if (auto next = top.ops->next(top.node.get())) {
+                    const Rank rank = candidate_rank(
+                        top.parent.get(), *top.ops, next.get(), top.offset, top.offset_overflow);
+                    push({std::move(top.parent), std::move(next), top.ops, top.index + 1,
+                          top.offset, top.offset_overflow, rank, false});
+                }
+                continue;
+            }
+            if (auto result = run(take(std::move(top)))) {
+                return result;
+            }
+        }
+        return std::nullopt;
+    }
+};
+
+template<typename T, typename Factory>
+[[nodiscard]] std::shared_ptr<RankingElement<T>> program_next(
+    const std::shared_ptr<ProgramSearch<T, Factory>>& search)
+{
+    auto result = search->next_result();
+    if (!result) {
+        return nullptr;
+    }
+    return allocate_pooled<RankingElement<T>>(
+        search->pool,
+        std::move(result->first),
+        result->second,
+        make_promise([search]() { return program_next(search); }));
+}
+
+template<typename R>
+struct is_ranked_program : std::false_type {};
+
+template<typename T>
+struct is_ranked_program<ranked_program<T>> : std::true_type {};
+
+}  // namespace detail
+
+/**
+ * @brief Evaluate a ranked program lazily into a ranking.
+ *
+ * Runs the program up to its first result immediately; later results are
+ * searched for as the ranking is forced. Every awaited ranking is walked
+ * element by element as merge_apply() walks continuation results (its own
+ * deduplication setting does not apply). Under a rank horizon (see
+ * rank_horizon.hpp) paths ranked above it are abandoned and the program runs
+ * with the horizon lowered by the rank of its path.
+ *
+ * @tparam Factory Callable with no arguments returning ranked_program<T>; it
+ *         may itself be a coroutine lambda, whose captures then live as long
+ *         as the ranking.
+ * @param factory Creates one run of the program; called once per replay.
+ * @param deduplicate Whether to deduplicate the result (default: true).
+ * @param overflow Whether overflowing accumulated ranks throw (default) or saturate.
+ * @return The ranking of the program's co_return values.
+ * @throws Whatever the program throws, and std::logic_error if it binds
+ *         differently on replay, from the force that runs it.
+ *
+ * @par Example
+ * @code
+ * auto sums = from_program([&]() -> ranked_program<int> {
+ *     const int a = co_await dice;
+ *     const int b = co_await dice;
+ *     co_return a + b;
+ * });
+ * @endcode
+ */
+template<typename Factory>
+requires std::invocable<Factory&> &&
+         detail::is_ranked_program<std::invoke_result_t<Factory&>>::value
+[[nodiscard]] auto from_program(
+    Factory&& factory,
+    Deduplication deduplicate = Deduplication::Enabled,
+    RankOverflow overflow = RankOverflow::Throw)
+    -> RankingFunction<typename std::invoke_result_t<Factory&>::value_type>
+{
+    using T = typename std::invoke_result_t<Factory&>::value_type;
+    using Search = detail::ProgramSearch<T, std::decay_t<Factory>>;
+
+    auto search = std::make_shared<Search>(Search{
+        std::forward<Factory>(factory), overflow, current_node_pool(), current_rank_horizon(), {}, {}, false});
+    return RankingFunction<T>(detail::program_next(search), deduplicate);
+}
+
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI
+
+#endif  // RANKED_BELIEF_RANKED_PROGRAM_HPP
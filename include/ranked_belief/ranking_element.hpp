@@ -8,23 +8,35 @@
  *
  * This design allows for efficient representation of infinite ranking sequences, as
  * subsequent elements are only computed when accessed.
+ *
+ * All factory helpers accept an optional NodePool (see node_pool.hpp) and default
+ * to the pool installed on the calling thread, falling back to the heap.
+ *
+ * Every type and helper takes the promise policy of its nodes as a template
+ * parameter defaulting to DefaultPromisePolicy. Helpers that receive nodes or
+ * promises deduce it; the others take it as an explicit template argument.
  */
 
 #ifndef RANKED_BELIEF_RANKING_ELEMENT_HPP
 #define RANKED_BELIEF_RANKING_ELEMENT_HPP
 
 #include "concepts.hpp"
+#include "node_pool.hpp"
 #include "promise.hpp"
 #include "rank.hpp"
 
+#include <atomic>
+#include <cstddef>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <utility>
+#include <vector>
 
-namespace ranked_belief {
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
 
 // Forward declaration for the next element type
-template<typename T>
+template<typename T, typename Policy = DefaultPromisePolicy>
 class RankingElement;
 
 /**
@@ -33,8 +45,8 @@ class RankingElement;
  * The next element is wrapped in a Promise to enable lazy evaluation.
  * The shared_ptr allows multiple references to the same element in the sequence.
  */
-template<typename T>
-using LazyNext = Promise<std::shared_ptr<RankingElement<T>>>;
+template<typename T, typename Policy = DefaultPromisePolicy>
+using LazyNext = Promise<std::shared_ptr<RankingElement<T, Policy>>, Policy>;
 
 /**
  * @class RankingElement
@@ -50,9 +62,12 @@ using LazyNext = Promise<std::shared_ptr<RankingElement<T>>>;
  * until they are actually needed.
  *
  * Thread Safety: The lazy value and next pointer are thread-safe due to Promise's
- * guarantees. The rank is immutable after construction.
+ * guarantees when Policy is ThreadSafePolicy. With SingleThreadedPolicy (the
+ * default under RANKED_BELIEF_SINGLE_THREADED) a sequence must only be
+ * forced from one thread at a time. The rank is immutable after construction.
  *
  * @tparam T The type of values in the ranking sequence.
+ * @tparam Policy Promise policy of the value and next pointer.
  *
  * Example:
  * @code
@@ -68,7 +83,7 @@ using LazyNext = Promise<std::shared_ptr<RankingElement<T>>>;
  * @invariant rank_ is immutable after construction.
  * @invariant value_ and next_ are evaluated at most once (Promise guarantee).
  */
-template<typename T>
+template<typename T, typename Policy>
 class RankingElement {
 public:
     /**
@@ -81,7 +96,7 @@ public:
      * @param rank The rank of this value (0 = most normal, higher = more exceptional).
      * @param next A promise that produces the next element (or nullptr for end).
      */
-    RankingElement(Promise<T> value_promise, Rank rank, LazyNext<T> next)
+    RankingElement(Promise<T, Policy> value_promise, Rank rank, LazyNext<T, Policy> next)
         : value_(std::move(value_promise)), rank_(std::move(rank)), next_(std::move(next)) {}
     
     /**
@@ -94,8 +109,8 @@ public:
      * @param rank The rank of this value (0 = most normal, higher = more exceptional).
      * @param next A promise that produces the next element (or nullptr for end).
      */
-    RankingElement(T value, Rank rank, LazyNext<T> next)
-        : value_(make_promise_value(std::move(value))), rank_(std::move(rank)), next_(std::move(next)) {}
+    RankingElement(T value, Rank rank, LazyNext<T, Policy> next)
+        : value_(make_promise_value<Policy>(std::move(value))), rank_(std::move(rank)), next_(std::move(next)) {}
 
     /**
      * @brief Construct a ranking element with eager value and eager next pointer.
@@ -107,10 +122,10 @@ public:
      * @param rank The rank of this value.
      * @param next Pointer to the next element (or nullptr for end).
      */
-    RankingElement(T value, Rank rank, std::shared_ptr<RankingElement<T>> next)
-        : value_(make_promise_value(std::move(value))),
+    RankingElement(T value, Rank rank, std::shared_ptr<RankingElement> next)
+        : value_(make_promise_value<Policy>(std::move(value))),
           rank_(std::move(rank)),
-          next_(make_promise_value(std::move(next))) {}
+          next_(make_promise_value<Policy>(std::move(next))) {}
 
     /**
      * @brief Construct a terminal ranking element (last in sequence).
@@ -122,9 +137,9 @@ public:
      * @param rank The rank of this value.
      */
     RankingElement(T value, Rank rank)
-        : value_(make_promise_value(std::move(value))),
+        : value_(make_promise_value<Policy>(std::move(value))),
           rank_(std::move(rank)),
-          next_(make_promise_value(std::shared_ptr<RankingElement<T>>(nullptr))) {}
+          next_(make_promise_value<Policy>(std::shared_ptr<RankingElement>(nullptr))) {}
 
     // Ranking elements are immutable after construction, so disable copying and moving
     // to prevent accidental modifications and maintain clear ownership semantics.
@@ -133,6 +148,33 @@ public:
     RankingElement(RankingElement&&) = delete;
     RankingElement& operator=(RankingElement&&) = delete;
 
+    /**
+     * @brief Destroy the element without recursing down its forced successors.
+     *
+     * Releasing the last reference to a long forced chain would otherwise run
+     * each successor's destructor from inside its predecessor's, one group of
+     * stack frames per node. Instead, successors owned only by this chain are
+     * unlinked and released one at a time in a loop, so teardown uses constant
+     * stack regardless of chain length. The walk stops at the first successor
+     * that is still referenced elsewhere.
+     */
+    ~RankingElement() {
+        auto forced_next = next_.take_value();
+        if (!forced_next) {
+            return;
+        }
+        std::shared_ptr<RankingElement> current = std::move(*forced_next);
+        while (current && current.use_count() == 1) {
+            // use_count() is a relaxed load: pair it with the release other
+            // threads performed when dropping their references, so their
+            // earlier reads of this node happen before we modify it.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            auto successor = current->next_.take_value();
+            current.reset();  // its next_ is now empty, so this does not recurse
+            current = successor ? std::move(*successor) : nullptr;
+        }
+    }
+
     /**
      * @brief Get the value associated with this ranking element.
      *
@@ -164,7 +206,7 @@ public:
      *
      * @return Shared pointer to the next element, or nullptr if this is the last element.
      */
-    [[nodiscard]] std::shared_ptr<RankingElement<T>> next() const {
+    [[nodiscard]] std::shared_ptr<RankingElement> next() const {
         return next_.force();
     }
 
@@ -192,7 +234,7 @@ public:
      *
      * @return Const reference to the value promise.
      */
-    [[nodiscard]] Promise<T>& value_promise() noexcept {
+    [[nodiscard]] Promise<T, Policy>& value_promise() noexcept {
         return value_;
     }
 
@@ -205,14 +247,14 @@ public:
      *
      * @return The moved value promise.
      */
-    [[nodiscard]] Promise<T> extract_value_promise() && {
+    [[nodiscard]] Promise<T, Policy> extract_value_promise() && {
         return std::move(value_);
     }
 
 private:
-    mutable Promise<T> value_;  ///< Lazy value (mutable for lazy evaluation, memoized on first access)
-    Rank rank_;                  ///< The rank of this value
-    mutable LazyNext<T> next_;   ///< Lazy pointer to the next element (mutable for lazy evaluation)
+    mutable Promise<T, Policy> value_;  ///< Lazy value (mutable for lazy evaluation, memoized on first access)
+    Rank rank_;                          ///< The rank of this value
+    mutable LazyNext<T, Policy> next_;   ///< Lazy pointer to the next element (mutable for lazy evaluation)
 };
 
 /**
@@ -221,8 +263,10 @@ private:
  * Provides a convenient way to create the last element in a sequence.
  *
  * @tparam T The type of the value.
+ * @tparam Policy Promise policy of the element (default: DefaultPromisePolicy).
  * @param value The value for the terminal element.
  * @param rank The rank of the value.
+ * @param pool Pool to allocate the node from (default: the current thread's pool).
  * @return A shared pointer to the new terminal element.
  *
  * Example:
@@ -230,9 +274,12 @@ private:
  * auto last = make_terminal(42, Rank::from_value(5));
  * @endcode
  */
-template<typename T>
-[[nodiscard]] std::shared_ptr<RankingElement<T>> make_terminal(T value, Rank rank) {
-    return std::make_shared<RankingElement<T>>(std::move(value), std::move(rank));
+template<typename T, typename Policy = DefaultPromisePolicy>
+[[nodiscard]] std::shared_ptr<RankingElement<T, Policy>> make_terminal(
+    T value,
+    Rank rank,
+    const std::shared_ptr<NodePool>& pool = current_node_pool()) {
+    return allocate_pooled<RankingElement<T, Policy>>(pool, std::move(value), std::move(rank));
 }
 
 /**
@@ -244,6 +291,7 @@ template<typename T>
  * @param value The value for this element.
  * @param rank The rank of the value.
  * @param next Pointer to the next element.
+ * @param pool Pool to allocate the node from (default: the current thread's pool).
  * @return A shared pointer to the new element.
  *
  * Example:
@@ -252,12 +300,14 @@ template<typename T>
  * auto elem1 = make_element(1, Rank::zero(), elem2);
  * @endcode
  */
-template<typename T>
-[[nodiscard]] std::shared_ptr<RankingElement<T>> make_element(
+template<typename T, typename Policy>
+[[nodiscard]] std::shared_ptr<RankingElement<T, Policy>> make_element(
     T value,
     Rank rank,
-    std::shared_ptr<RankingElement<T>> next) {
-    return std::make_shared<RankingElement<T>>(
+    std::shared_ptr<RankingElement<T, Policy>> next,
+    const std::shared_ptr<NodePool>& pool = current_node_pool()) {
+    return allocate_pooled<RankingElement<T, Policy>>(
+        pool,
         std::move(value),
         std::move(rank),
         std::move(next));
@@ -269,9 +319,11 @@ template<typename T>
  * Provides a convenient way to build lazy sequences.
  *
  * @tparam T The type of the value.
+ * @tparam Policy Promise policy of the element (default: DefaultPromisePolicy).
  * @param value The value for this element.
  * @param rank The rank of the value.
  * @param next_computation Function that produces the next element when called.
+ * @param pool Pool to allocate the node from (default: the current thread's pool).
  * @return A shared pointer to the new element.
  *
  * Example:
@@ -281,28 +333,133 @@ template<typename T>
  * });
  * @endcode
  */
-template<typename T, Invocable F>
-requires std::same_as<std::invoke_result_t<F>, std::shared_ptr<RankingElement<T>>>
-[[nodiscard]] std::shared_ptr<RankingElement<T>> make_lazy_element(
+template<typename T, typename Policy = DefaultPromisePolicy, Invocable F>
+requires std::same_as<std::invoke_result_t<F>, std::shared_ptr<RankingElement<T, Policy>>>
+[[nodiscard]] std::shared_ptr<RankingElement<T, Policy>> make_lazy_element(
     T value,
     Rank rank,
-    F&& next_computation) {
-    return std::make_shared<RankingElement<T>>(
+    F&& next_computation,
+    const std::shared_ptr<NodePool>& pool = current_node_pool()) {
+    return allocate_pooled<RankingElement<T, Policy>>(
+        pool,
+        std::move(value),
+        std::move(rank),
+        make_promise<Policy>(std::forward<F>(next_computation)));
+}
+
+namespace detail {
+
+/**
+ * @brief Generator shared by every lazy tail of one generated sequence.
+ *
+ * Tails capture a pointer to this state and the next index instead of a copy
+ * of the generator, so a large or stateful generator is stored once per
+ * sequence. Only the newest node holds an unforced tail and only that tail
+ * calls the generator, so calls never overlap.
+ */
+template<typename T, typename Generator>
+struct SequenceState {
+    Generator generator;
+    std::size_t chunk_size;                 ///< Indices generated per lazy step
+    std::shared_ptr<NodePool> pool;
+    std::vector<std::pair<T, Rank>> items;  ///< Buffer reused by every chunk or batch
+};
+
+/**
+ * @brief Link a batch of (value, rank) pairs into one chunk of nodes.
+ *
+ * The nodes are linked eagerly (their next pointers are already forced) and
+ * only the last node carries @p tail, so walking the chunk runs no thunks.
+ * The pairs are moved out and @p items is left empty, keeping its capacity
+ * for the next batch.
+ *
+ * @pre @p items is non-empty.
+ * @return The first node of the chunk.
+ */
+template<typename T, typename Policy>
+[[nodiscard]] std::shared_ptr<RankingElement<T, Policy>> link_chunk(
+    std::vector<std::pair<T, Rank>>&& items,
+    LazyNext<T, Policy> tail,
+    const std::shared_ptr<NodePool>& pool) {
+    auto it = items.rbegin();
+    auto head = allocate_pooled<RankingElement<T, Policy>>(
+        pool, std::move(it->first), it->second, std::move(tail));
+    for (++it; it != items.rend(); ++it) {
+        head = allocate_pooled<RankingElement<T, Policy>>(
+            pool, std::move(it->first), it->second, std::move(head));
+    }
+    items.clear();
+    return head;
+}
+
+/// Node for @p index of a make_infinite_sequence() sequence.
+template<typename T, typename Policy, typename Generator>
+[[nodiscard]] std::shared_ptr<RankingElement<T, Policy>> sequence_node(
+    const std::shared_ptr<SequenceState<T, Generator>>& state,
+    std::size_t index) {
+    auto [value, rank] = std::invoke(state->generator, index);
+    return allocate_pooled<RankingElement<T, Policy>>(
+        state->pool,
         std::move(value),
         std::move(rank),
-        make_promise(std::forward<F>(next_computation)));
+        make_promise<Policy>([state, next = index + 1]() {
+            return sequence_node<T, Policy>(state, next);
+        }));
+}
+
+/// Chunk starting at @p index of a make_chunked_sequence() sequence.
+template<typename T, typename Policy, typename Generator>
+[[nodiscard]] std::shared_ptr<RankingElement<T, Policy>> sequence_chunk(
+    const std::shared_ptr<SequenceState<T, Generator>>& state,
+    std::size_t index) {
+    for (std::size_t i = 0; i < state->chunk_size; ++i) {
+        state->items.push_back(std::invoke(state->generator, index + i));
+    }
+    return link_chunk<T>(
+        std::move(state->items),
+        make_promise<Policy>([state, next = index + state->chunk_size]() {
+            return sequence_chunk<T, Policy>(state, next);
+        }),
+        state->pool);
+}
+
+/// Batch starting at @p index of a make_batched_sequence() sequence.
+template<typename T, typename Policy, typename Generator>
+[[nodiscard]] std::shared_ptr<RankingElement<T, Policy>> sequence_batch(
+    const std::shared_ptr<SequenceState<T, Generator>>& state,
+    std::size_t index) {
+    state->items.clear();
+    std::invoke(state->generator, index, state->items);
+    if (state->items.empty()) {
+        return nullptr;
+    }
+    const std::size_t next = index + state->items.size();
+    return link_chunk<T>(
+        std::move(state->items),
+        make_promise<Policy>([state, next]() {
+            return sequence_batch<T, Policy>(state, next);
+        }),
+        state->pool);
 }
 
+}  // namespace detail
+
 /**
  * @brief Helper function to create an infinite ranking sequence.
  *
  * Creates a lazy infinite sequence where each element is generated on demand.
- * Useful for representing unbounded ranking functions.
+ * Useful for representing unbounded ranking functions. The generator is
+ * stored once and shared by all lazy tails of the sequence, each of which
+ * captures only a pointer to it and an index, so forcing an element costs
+ * the same whatever the generator's size. It is called once per element, in
+ * index order, and may keep state between calls.
  *
  * @tparam T The type of values in the sequence.
+ * @tparam Policy Promise policy of the nodes (default: DefaultPromisePolicy).
  * @tparam Generator A callable that takes an index and returns std::pair<T, Rank>.
  * @param generator Function that generates the (value, rank) pair for index i.
  * @param start_index The starting index (default 0).
+ * @param pool Pool for every node of the sequence (default: the current thread's pool).
  * @return A shared pointer to the first element of the infinite sequence.
  *
  * Example:
@@ -313,19 +470,90 @@ requires std::same_as<std::invoke_result_t<F>, std::shared_ptr<RankingElement<T>
  * });
  * @endcode
  */
-template<typename T, Invocable<std::size_t> Generator>
-requires std::same_as<std::invoke_result_t<Generator, std::size_t>, std::pair<T, Rank>>
-[[nodiscard]] std::shared_ptr<RankingElement<T>> make_infinite_sequence(
+template<typename T, typename Policy = DefaultPromisePolicy, Invocable<std::size_t> Generator>
+requires std::same_as<std::invoke_result_t<Generator&, std::size_t>, std::pair<T, Rank>>
+[[nodiscard]] std::shared_ptr<RankingElement<T, Policy>> make_infinite_sequence(
     Generator generator,
-    size_t start_index = 0) {
-    auto [value, rank] = generator(start_index);
-    
-    return std::make_shared<RankingElement<T>>(
-        std::move(value),
-        std::move(rank),
-        make_promise([generator, index = start_index + 1]() mutable {
-            return make_infinite_sequence<T>(generator, index);
-        }));
+    size_t start_index = 0,
+    const std::shared_ptr<NodePool>& pool = current_node_pool()) {
+    using State = detail::SequenceState<T, Generator>;
+    auto state = std::make_shared<State>(State{std::move(generator), 1, pool, {}});
+    return detail::sequence_node<T, Policy>(state, start_index);
+}
+
+/**
+ * @brief Helper function to create an infinite ranking sequence in chunks.
+ *
+ * Like make_infinite_sequence(), but calls the generator for @p chunk_size
+ * consecutive indices at a time and links each batch eagerly. Only the last
+ * node of a chunk has a lazy next, so forcing N elements runs about
+ * N / chunk_size thunks instead of N, at the cost of generating up to
+ * chunk_size - 1 elements ahead of the consumer. The generator is shared by
+ * the whole sequence as in make_infinite_sequence().
+ *
+ * @tparam T The type of values in the sequence.
+ * @tparam Policy Promise policy of the nodes (default: DefaultPromisePolicy).
+ * @tparam Generator A callable that takes an index and returns std::pair<T, Rank>.
+ * @param generator Function that generates the (value, rank) pair for index i.
+ * @param chunk_size Elements generated per lazy step (0 is treated as 1).
+ * @param start_index The starting index (default 0).
+ * @param pool Pool for every node of the sequence (default: the current thread's pool).
+ * @return A shared pointer to the first element of the infinite sequence.
+ */
+template<typename T, typename Policy = DefaultPromisePolicy, Invocable<std::size_t> Generator>
+requires std::same_as<std::invoke_result_t<Generator&, std::size_t>, std::pair<T, Rank>>
+[[nodiscard]] std::shared_ptr<RankingElement<T, Policy>> make_chunked_sequence(
+    Generator generator,
+    std::size_t chunk_size,
+    std::size_t start_index = 0,
+    const std::shared_ptr<NodePool>& pool = current_node_pool()) {
+    chunk_size = chunk_size == 0 ? 1 : chunk_size;
+
+    using State = detail::SequenceState<T, Generator>;
+    auto state = std::make_shared<State>(State{std::move(generator), chunk_size, pool, {}});
+    state->items.reserve(chunk_size);
+    return detail::sequence_chunk<T, Policy>(state, start_index);
+}
+
+/**
+ * @brief Helper function to create a sequence from a batch generator.
+ *
+ * The generator is called as `generator(first_index, batch)` and appends the
+ * (value, rank) pairs for indices first_index, first_index + 1, ... to
+ * @c batch, as many as it finds convenient. The next call starts after the
+ * last index it produced. Each batch is linked eagerly as in
+ * make_chunked_sequence(); an empty batch ends the sequence, so batch
+ * generators can describe finite sequences too. The batch vector is reused
+ * across calls and the generator is shared by the whole sequence.
+ *
+ * @tparam T The type of values in the sequence.
+ * @tparam Policy Promise policy of the nodes (default: DefaultPromisePolicy).
+ * @tparam Generator A callable taking (std::size_t, std::vector<std::pair<T, Rank>>&).
+ * @param generator Function appending the batch that starts at a given index.
+ * @param start_index The starting index (default 0).
+ * @param pool Pool for every node of the sequence (default: the current thread's pool).
+ * @return A shared pointer to the first element, or nullptr if the first batch is empty.
+ *
+ * Example:
+ * @code
+ * // Squares in blocks of 64, as a vectorised kernel might produce them.
+ * auto squares = make_batched_sequence<long>(
+ *     [](std::size_t first, std::vector<std::pair<long, Rank>>& batch) {
+ *         for (std::size_t i = first; i < first + 64; ++i) {
+ *             batch.emplace_back(static_cast<long>(i * i), Rank::from_value(i));
+ *         }
+ *     });
+ * @endcode
+ */
+template<typename T, typename Policy = DefaultPromisePolicy, typename Generator>
+requires std::invocable<Generator&, std::size_t, std::vector<std::pair<T, Rank>>&>
+[[nodiscard]] std::shared_ptr<RankingElement<T, Policy>> make_batched_sequence(
+    Generator generator,
+    std::size_t start_index = 0,
+    const std::shared_ptr<NodePool>& pool = current_node_pool()) {
+    using State = detail::SequenceState<T, Generator>;
+    auto state = std::make_shared<State>(State{std::move(generator), 0, pool, {}});
+    return detail::sequence_batch<T, Policy>(state, start_index);
 }
 
 /**
@@ -338,6 +566,7 @@ requires std::same_as<std::invoke_result_t<Generator, std::size_t>, std::pair<T,
  * @param value_promise The promise for the value.
  * @param rank The rank of the value.
  * @param next The lazy next element computation.
+ * @param pool Pool to allocate the node from (default: the current thread's pool).
  * @return A shared pointer to the new element.
  *
  * Example:
@@ -346,12 +575,14 @@ requires std::same_as<std::invoke_result_t<Generator, std::size_t>, std::pair<T,
  *                            make_promise([]{ return nullptr; }));
  * @endcode
  */
-template<typename T>
-[[nodiscard]] std::shared_ptr<RankingElement<T>> make_lazy_node(
-    Promise<T>&& value_promise,
+template<typename T, typename Policy>
+[[nodiscard]] std::shared_ptr<RankingElement<T, Policy>> make_lazy_node(
+    Promise<T, Policy>&& value_promise,
     Rank rank,
-    LazyNext<T> next) {
-    return std::make_shared<RankingElement<T>>(
+    LazyNext<T, Policy> next,
+    const std::shared_ptr<NodePool>& pool = current_node_pool()) {
+    return allocate_pooled<RankingElement<T, Policy>>(
+        pool,
         std::move(value_promise),
         std::move(rank),
         std::move(next));
@@ -366,26 +597,30 @@ template<typename T>
  *
  * @tparam T The value type.
  * @param orig The head of the sequence to copy.
+ * @param pool Pool for every copied node (default: the current thread's pool).
  * @return A new, independent copy of the sequence (or nullptr if orig is nullptr).
  */
-template<typename T>
-std::shared_ptr<RankingElement<T>> lazy_deepcopy_ranking_sequence(const std::shared_ptr<RankingElement<T>>& orig) {
+template<typename T, typename Policy>
+std::shared_ptr<RankingElement<T, Policy>> lazy_deepcopy_ranking_sequence(
+    const std::shared_ptr<RankingElement<T, Policy>>& orig,
+    const std::shared_ptr<NodePool>& pool = current_node_pool()) {
     if (!orig) return nullptr;
     // Copy value lazily: new promise that forces the original's value promise
-    auto value_promise = make_promise([orig]() { return orig->value(); });
+    auto value_promise = make_promise<Policy>([orig]() { return orig->value(); });
     // Copy next lazily: new promise that recursively deep-copies the next pointer
-    auto next_promise = make_promise([orig]() {
+    auto next_promise = make_promise<Policy>([orig, pool]() {
         auto orig_next = orig->next();
-        return lazy_deepcopy_ranking_sequence<T>(orig_next);
+        return lazy_deepcopy_ranking_sequence<T>(orig_next, pool);
     });
-    return std::make_shared<RankingElement<T>>(std::move(value_promise), orig->rank(), std::move(next_promise));
+    return allocate_pooled<RankingElement<T, Policy>>(
+        pool, std::move(value_promise), orig->rank(), std::move(next_promise));
 }
 
 /**
  * Debug: Print the structure of a ranking sequence (for troubleshooting deep copy).
  */
-template<typename T>
-void debug_print_ranking_sequence(const std::shared_ptr<RankingElement<T>>& elem, const std::string& prefix = "", int max_depth = 10) {
+template<typename T, typename Policy>
+void debug_print_ranking_sequence(const std::shared_ptr<RankingElement<T, Policy>>& elem, const std::string& prefix = "", int max_depth = 10) {
     auto current = elem;
     int depth = 0;
     while (current && depth < max_depth) {
@@ -398,6 +633,6 @@ void debug_print_ranking_sequence(const std::shared_ptr<RankingElement<T>>& elem
     }
 }
 
-}  // namespace ranked_belief
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI
 
 #endif  // RANKED_BELIEF_RANKING_ELEMENT_HPP
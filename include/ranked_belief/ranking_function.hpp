@@ -15,6 +15,8 @@
  * - Range interface: compatible with C++20 ranges and algorithms
  * - Immutable semantics: ranking functions don't change after construction
  * - Memory efficient: shared storage via std::shared_ptr
+ * - O(1) rank shifts: a constant rank offset is carried alongside the nodes
+ *   and applied on read
  *
  * Invariants:
  * - Ranks are non-decreasing (rank[i] <= rank[i+1])
@@ -32,11 +34,72 @@
 #include "ranking_element.hpp"
 #include "ranking_iterator.hpp"
 #include "types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
+#include <stdexcept>
 #include <utility>
 
-namespace ranked_belief {
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
+
+namespace detail {
+
+/**
+ * @brief Lazily copy a sequence, replacing each rank by @p rank_fn(rank).
+ *
+ * Values are read through from the source nodes on demand. Used where a
+ * shifted sequence has to exist as nodes (see RankingFunction::head()).
+ */
+template<typename T, typename Policy, typename RankFn>
+[[nodiscard]] std::shared_ptr<RankingElement<T, Policy>> remap_ranks(
+    std::shared_ptr<RankingElement<T, Policy>> head,
+    RankFn rank_fn)
+{
+    using Node = RankingElement<T, Policy>;
+    using BuildFunc = std::function<std::shared_ptr<Node>(std::shared_ptr<Node>)>;
+    auto build_remapped = std::make_shared<BuildFunc>();
+    std::weak_ptr<BuildFunc> weak_build = build_remapped;
+
+    *build_remapped = [weak_build, rank_fn, pool = current_node_pool()](
+        std::shared_ptr<Node> elem)
+        -> std::shared_ptr<Node>
+    {
+        if (!elem) {
+            return nullptr;
+        }
+
+        const Rank new_rank = rank_fn(elem->rank());
+        auto build_ref = weak_build.lock();
+
+        auto compute_next = [weak_build, build_ref, elem]()
+            -> std::shared_ptr<Node>
+        {
+            auto next_elem = elem->next();
+
+            if (auto locked = weak_build.lock()) {
+                return (*locked)(next_elem);
+            }
+
+            if (build_ref) {
+                return (*build_ref)(next_elem);
+            }
+            return nullptr;
+        };
+
+        return allocate_pooled<Node>(
+            pool,
+            make_promise<Policy>([elem]() -> T { return elem->value(); }),
+            new_rank,
+            make_promise<Policy>(std::move(compute_next))
+        );
+    };
+
+    return (*build_remapped)(std::move(head));
+}
+
+}  // namespace detail
 
 /**
  * @brief A ranking function representing a sequence of ranked values.
@@ -50,8 +113,18 @@ namespace ranked_belief {
  * instances, making it compatible with C++20 ranges and standard algorithms.
  * It also provides query methods for common operations like first() and is_empty().
  *
+ * Besides the nodes, a ranking function carries a signed rank offset that is
+ * added to every stored rank when it is read. shifted() adjusts the offset
+ * instead of rebuilding the sequence, so shift_ranks() and the normalization
+ * in observe() are O(1), and nested shifts compose by addition. Operations
+ * that understand the offset read raw_head() and rank_of(); head() yields
+ * nodes with the offset already applied.
+ *
  * @tparam T The value type stored in the ranking function. Must be copyable and
  *           equality-comparable if deduplication is enabled.
+ * @tparam Policy Promise policy of the nodes (default: DefaultPromisePolicy).
+ *           Operations deduce it from their inputs and build their results
+ *           with the same policy, so a whole pipeline shares it.
  *
  * Example usage:
  * @code
@@ -73,18 +146,24 @@ namespace ranked_belief {
  * }
  * @endcode
  */
-template<typename T>
+template<typename T, typename Policy = DefaultPromisePolicy>
 class RankingFunction {
 public:
     /// Iterator type for this ranking function
-    using iterator = RankingIterator<T>;
+    using iterator = RankingIterator<T, Policy>;
     
     /// Const iterator type (same as iterator since elements are immutable)
-    using const_iterator = RankingIterator<T>;
+    using const_iterator = RankingIterator<T, Policy>;
     
     /// Value type yielded by iteration
     using value_type = std::pair<T, Rank>;
 
+    /// Node type of the underlying sequence
+    using element_type = RankingElement<T, Policy>;
+
+    /// Promise policy of the nodes
+    using policy_type = Policy;
+
     /**
      * @brief Construct an empty ranking function.
      *
@@ -94,6 +173,9 @@ public:
     RankingFunction() noexcept
         : head_(nullptr)
         , deduplicate_(true)
+        , chunk_size_(1)
+        , rank_offset_(0)
+        , overflow_(RankOverflow::Throw)
     {}
 
     /**
@@ -104,14 +186,20 @@ public:
      *
      * @param head The first element of the sequence (nullptr for empty)
      * @param deduplicate If Enabled, iterators will skip consecutive equal values
+     * @param chunk_size Number of elements the sequence produces per lazy step
+     *        (see chunk_size(); 0 is treated as 1)
      *
      * @note The head element is stored via shared_ptr, so ownership is shared
      *       with the caller if they retain a reference.
      */
-    explicit RankingFunction(std::shared_ptr<RankingElement<T>> head,
-                            Deduplication deduplicate = Deduplication::Enabled) noexcept
+    explicit RankingFunction(std::shared_ptr<element_type> head,
+                            Deduplication deduplicate = Deduplication::Enabled,
+                            std::size_t chunk_size = 1) noexcept
         : head_(std::move(head))
         , deduplicate_(to_bool(deduplicate))
+        , chunk_size_(chunk_size == 0 ? 1 : chunk_size)
+        , rank_offset_(0)
+        , overflow_(RankOverflow::Throw)
     {}
 
     /**
@@ -129,7 +217,7 @@ public:
      *       at the start. Each iterator can advance independently.
      */
     [[nodiscard]] iterator begin() const noexcept {
-        return iterator(head_, from_bool(deduplicate_));
+        return iterator(head_, from_bool(deduplicate_), rank_offset_, overflow_);
     }
 
     /**
@@ -160,7 +248,7 @@ public:
         if (!head_) {
             return std::nullopt;
         }
-        return std::make_pair(head_->value(), head_->rank());
+        return std::make_pair(head_->value(), rank_of(*head_));
     }
 
     /**
@@ -187,19 +275,139 @@ public:
         return deduplicate_;
     }
 
+    /**
+     * @brief Get the laziness granularity of the sequence.
+     *
+     * A chunk size of K means the sequence is built K elements at a time:
+     * the nodes of one chunk are linked eagerly and only the last carries a
+     * lazy next. Operations that support chunking (map, filter) preserve the
+     * chunk size of their input; all others produce per-element sequences
+     * (chunk size 1).
+     *
+     * @return Elements produced per lazy step (at least 1)
+     */
+    [[nodiscard]] std::size_t chunk_size() const noexcept {
+        return chunk_size_;
+    }
+
     /**
      * @brief Get the head element (for advanced use/testing).
      *
-     * Returns the underlying shared_ptr to the first RankingElement. This is
-     * primarily useful for testing, debugging, or advanced operations that
-     * need direct access to the element structure.
+     * Returns the first RankingElement of the sequence with ranks as this
+     * ranking function reports them. With a zero rank_offset() that is the
+     * stored head itself; otherwise a lazily shifted copy of the sequence is
+     * built on each call. Offset-aware code should use raw_head() instead.
      *
      * @return Shared pointer to head element (may be nullptr)
      */
-    [[nodiscard]] std::shared_ptr<RankingElement<T>> head() const noexcept {
+    [[nodiscard]] std::shared_ptr<element_type> head() const {
+        if (rank_offset_ == 0) {
+            return head_;
+        }
+        return detail::remap_ranks<T>(
+            head_, [offset = rank_offset_, overflow = overflow_](Rank rank) {
+                return detail::offset_rank(rank, offset, overflow);
+            });
+    }
+
+    /**
+     * @brief Get the stored head element, without the rank offset applied.
+     *
+     * Use rank_of() to read the ranks of this node and its successors.
+     *
+     * @return Shared pointer to the stored head (may be nullptr)
+     */
+    [[nodiscard]] const std::shared_ptr<element_type>& raw_head() const noexcept {
         return head_;
     }
 
+    /**
+     * @brief Offset added to every stored rank when it is read.
+     */
+    [[nodiscard]] std::int64_t rank_offset() const noexcept {
+        return rank_offset_;
+    }
+
+    /**
+     * @brief How a positive rank_offset() handles ranks that overflow.
+     */
+    [[nodiscard]] RankOverflow rank_overflow() const noexcept {
+        return overflow_;
+    }
+
+    /**
+     * @brief Rank of a node reachable from raw_head(), as this ranking reports it.
+     *
+     * @throws std::overflow_error if the shifted rank overflows and
+     *         rank_overflow() is RankOverflow::Throw.
+     */
+    [[nodiscard]] Rank rank_of(const element_type& raw) const {
+        return detail::offset_rank(raw.rank(), rank_offset_, overflow_);
+    }
+
+    /**
+     * @brief Copy of this ranking function with the given absolute rank offset.
+     *
+     * Used by rank-preserving operations to carry their input's offset over
+     * to a sequence built from raw_head().
+     *
+     * @param rank_offset The new offset (replaces the current one)
+     * @param overflow How a positive offset handles rank overflow
+     * @throws std::out_of_range if |rank_offset| exceeds detail::kMaxRankOffset.
+     */
+    [[nodiscard]] RankingFunction with_rank_offset(
+        std::int64_t rank_offset,
+        RankOverflow overflow = RankOverflow::Throw) const
+    {
+        if (rank_offset > detail::kMaxRankOffset || rank_offset < -detail::kMaxRankOffset) {
+            throw std::out_of_range("RankingFunction: rank offset out of range");
+        }
+        RankingFunction result = *this;
+        result.rank_offset_ = rank_offset;
+        result.overflow_ = overflow;
+        return result;
+    }
+
+    /**
+     * @brief Shift every rank by @p delta in O(1).
+     *
+     * The delta is added to the carried offset. Successive shifts are applied
+     * as one exact addition, so an intermediate overflow that a later
+     * negative shift cancels is not reported. The one exception is a negative
+     * shift of a saturating positive offset: saturation does not commute with
+     * subtraction, so the current offset is first applied to a copy of the
+     * nodes (as head() does). The same happens if the combined offset would
+     * leave the representable range.
+     *
+     * @param delta Amount to add to every rank (|delta| <= detail::kMaxRankOffset)
+     * @param overflow How a positive @p delta handles rank overflow
+     * @return The shifted ranking function
+     * @throws std::out_of_range if |delta| exceeds detail::kMaxRankOffset.
+     * @throws std::underflow_error when read, if a shifted rank would be negative.
+     */
+    [[nodiscard]] RankingFunction shifted(
+        std::int64_t delta,
+        RankOverflow overflow = RankOverflow::Throw) const
+    {
+        if (delta > detail::kMaxRankOffset || delta < -detail::kMaxRankOffset) {
+            throw std::out_of_range("RankingFunction: rank shift out of range");
+        }
+        if (delta == 0 || !head_) {
+            return *this;
+        }
+
+        const bool composes = rank_offset_ <= 0 ||
+            (delta > 0 ? overflow == overflow_ : overflow_ == RankOverflow::Throw);
+        // Both terms are within +/-kMaxRankOffset, so the sum cannot overflow int64.
+        const std::int64_t combined = rank_offset_ + delta;
+        if (composes && combined <= detail::kMaxRankOffset && combined >= -detail::kMaxRankOffset) {
+            return with_rank_offset(combined, delta > 0 ? overflow : overflow_);
+        }
+
+        RankingFunction baked(head(), from_bool(deduplicate_), chunk_size_);
+        return baked.with_rank_offset(delta, overflow);
+    }
+
     /**
      * @brief Get the number of elements in the ranking function.
      *
@@ -225,9 +433,9 @@ public:
     /**
      * @brief Compare two ranking functions for equality.
      *
-     * Two ranking functions are equal if they point to the same head element.
-     * This is a shallow comparison (pointer equality), not a deep comparison
-     * of sequence contents.
+     * Two ranking functions are equal if they point to the same head element
+     * with the same rank offset. This is a shallow comparison (pointer
+     * equality), not a deep comparison of sequence contents.
      *
      * @param other The ranking function to compare with
      * @return true if both have the same head element, false otherwise
@@ -237,7 +445,8 @@ public:
      *       as unequal. For deep equality, use std::ranges::equal with iterators.
      */
     [[nodiscard]] bool operator==(const RankingFunction& other) const noexcept {
-        return head_ == other.head_ && deduplicate_ == other.deduplicate_;
+        return head_ == other.head_ && deduplicate_ == other.deduplicate_ &&
+               rank_offset_ == other.rank_offset_;
     }
 
     /**
@@ -252,10 +461,19 @@ public:
 
 private:
     /// The first element of the ranking sequence (nullptr for empty)
-    std::shared_ptr<RankingElement<T>> head_;
+    std::shared_ptr<element_type> head_;
     
     /// Flag controlling whether iterators deduplicate consecutive equal values
     bool deduplicate_;
+
+    /// Elements produced per lazy step (1 for per-element sequences)
+    std::size_t chunk_size_;
+
+    /// Offset added to every stored rank when read (see shifted())
+    std::int64_t rank_offset_;
+
+    /// Overflow behaviour of a positive rank_offset_
+    RankOverflow overflow_;
 };
 
 /**
@@ -265,6 +483,7 @@ private:
  * Equivalent to RankingFunction<T>() but with type deduction from context.
  *
  * @tparam T The value type (typically inferred from usage context)
+ * @tparam Policy Promise policy of the ranking (default: DefaultPromisePolicy)
  * @return An empty ranking function
  *
  * Example:
@@ -273,9 +492,9 @@ private:
  * assert(empty.is_empty());
  * @endcode
  */
-template<typename T>
-[[nodiscard]] RankingFunction<T> make_empty_ranking() noexcept {
-    return RankingFunction<T>();
+template<typename T, typename Policy = DefaultPromisePolicy>
+[[nodiscard]] RankingFunction<T, Policy> make_empty_ranking() noexcept {
+    return RankingFunction<T, Policy>();
 }
 
 /**
@@ -295,12 +514,12 @@ template<typename T>
  * auto rf = make_ranking_function(head);
  * @endcode
  */
-template<typename T>
-[[nodiscard]] RankingFunction<T> make_ranking_function(
-    std::shared_ptr<RankingElement<T>> head,
+template<typename T, typename Policy>
+[[nodiscard]] RankingFunction<T, Policy> make_ranking_function(
+    std::shared_ptr<RankingElement<T, Policy>> head,
     Deduplication deduplicate = Deduplication::Enabled) noexcept
 {
-    return RankingFunction<T>(std::move(head), deduplicate);
+    return RankingFunction<T, Policy>(std::move(head), deduplicate);
 }
 
 /**
@@ -309,6 +528,7 @@ template<typename T>
  * Convenience factory for creating a ranking function with exactly one element.
  *
  * @tparam T The value type (deduced from value)
+ * @tparam Policy Promise policy of the ranking (default: DefaultPromisePolicy)
  * @param value The single value in the ranking
  * @param rank The rank of the value (default: Rank::zero())
  * @return A ranking function containing only the given value-rank pair
@@ -320,15 +540,15 @@ template<typename T>
  * assert(rf.first()->first == 42);
  * @endcode
  */
-template<typename T>
-[[nodiscard]] RankingFunction<T> make_singleton_ranking(
+template<typename T, typename Policy = DefaultPromisePolicy>
+[[nodiscard]] RankingFunction<T, Policy> make_singleton_ranking(
     T value,
     Rank rank = Rank::zero()) noexcept
 {
-    auto head = make_terminal(std::move(value), rank);
-    return RankingFunction<T>(std::move(head), Deduplication::Enabled);
+    auto head = make_terminal<T, Policy>(std::move(value), rank);
+    return RankingFunction<T, Policy>(std::move(head), Deduplication::Enabled);
 }
 
-} // namespace ranked_belief
+} // namespace ranked_belief::inline RANKED_BELIEF_ABI
 
 #endif // RANKED_BELIEF_RANKING_FUNCTION_HPP
@@ -27,12 +27,62 @@
 #include "detail/any_equality_registry.hpp"
 #include "types.hpp"
 #include <any>
+#include <cstdint>
 #include <iterator>
 #include <memory>
 #include <type_traits>
 #include <utility>
 
-namespace ranked_belief {
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
+
+namespace detail {
+
+/// Largest magnitude of a rank offset carried by RankingFunction / RankingIterator.
+inline constexpr std::int64_t kMaxRankOffset =
+    static_cast<std::int64_t>(Rank::max_finite_value() - 1);
+
+/**
+ * @brief Apply a signed rank offset to a stored rank.
+ *
+ * Infinity absorbs any offset. A positive offset overflows according to
+ * @p overflow; a negative offset must not take a finite rank below zero.
+ *
+ * @pre |offset| <= kMaxRankOffset
+ * @throws std::overflow_error if the result exceeds Rank::max_finite_value()
+ *         and @p overflow is RankOverflow::Throw.
+ * @throws std::underflow_error if the result would be negative.
+ */
+[[nodiscard]] inline Rank offset_rank(Rank rank, std::int64_t offset, RankOverflow overflow) {
+    if (offset == 0 || rank.is_infinity()) {
+        return rank;
+    }
+    if (offset > 0) {
+        const Rank amount = Rank::from_value(static_cast<std::uint64_t>(offset));
+        return overflow == RankOverflow::Saturate ? rank.saturating_add(amount) : rank + amount;
+    }
+    return rank - Rank::from_value(static_cast<std::uint64_t>(-offset));
+}
+
+/**
+ * @brief Whether deduplication treats @p lhs and @p rhs as the same value.
+ *
+ * std::any values compare through the registered equality functions; types
+ * without operator== are never considered duplicates.
+ */
+template<typename T>
+[[nodiscard]] bool duplicate_values(const T& lhs, const T& rhs) {
+    if constexpr (std::is_same_v<T, std::any>) {
+        return any_values_equal(lhs, rhs);
+    } else if constexpr (requires { lhs == rhs; }) {
+        return static_cast<bool>(lhs == rhs);
+    } else {
+        (void)lhs;
+        (void)rhs;
+        return false;
+    }
+}
+
+}  // namespace detail
 
 /**
  * @brief Input iterator for traversing ranking sequences.
@@ -42,11 +92,13 @@ namespace ranked_belief {
  * consecutive equal values.
  *
  * The iterator is lightweight and copyable, maintaining only a shared_ptr to the
- * current element and a deduplication flag. Advancing the iterator forces evaluation
- * of lazy next pointers as needed.
+ * current element, a deduplication flag and the rank offset of the ranking it
+ * came from (see RankingFunction::rank_offset()). Advancing the iterator forces
+ * evaluation of lazy next pointers as needed.
  *
  * @tparam T The value type stored in the ranking sequence. Must be equality-comparable
  *           if deduplication is enabled.
+ * @tparam Policy Promise policy of the traversed nodes.
  *
  * @note This is an input iterator (single-pass, read-only). It does not support
  *       multi-pass guarantees of forward iterators.
@@ -66,7 +118,7 @@ namespace ranked_belief {
  * }
  * @endcode
  */
-template<typename T>
+template<typename T, typename Policy = DefaultPromisePolicy>
 class RankingIterator {
 public:
     // C++20 iterator traits
@@ -85,6 +137,8 @@ public:
     RankingIterator() noexcept 
         : current_(nullptr)
         , deduplicate_(false) 
+        , rank_offset_(0)
+        , overflow_(RankOverflow::Throw)
     {}
 
     /**
@@ -96,11 +150,17 @@ public:
      *
      * @param start The starting element (nullptr for end sentinel)
      * @param deduplicate If Enabled, skip consecutive elements with equal values
+     * @param rank_offset Offset added to every stored rank on dereference
+     * @param overflow How a positive offset handles rank overflow
      */
-    explicit RankingIterator(std::shared_ptr<RankingElement<T>> start, 
-                            Deduplication deduplicate = Deduplication::Enabled)
+    explicit RankingIterator(std::shared_ptr<RankingElement<T, Policy>> start, 
+                            Deduplication deduplicate = Deduplication::Enabled,
+                            std::int64_t rank_offset = 0,
+                            RankOverflow overflow = RankOverflow::Throw)
         : current_(std::move(start))
         , deduplicate_(to_bool(deduplicate)) 
+        , rank_offset_(rank_offset)
+        , overflow_(overflow)
     {
         // Constructor does not skip - first element is always valid
     }
@@ -109,15 +169,18 @@ public:
      * @brief Dereference the iterator to access the current value-rank pair.
      *
      * Returns a pair containing the value and rank of the current element.
-     * The pair is constructed on-demand from the underlying element.
+     * The pair is constructed on-demand from the underlying element, with the
+     * iterator's rank offset applied to the stored rank.
      *
      * @return std::pair<T, Rank> containing the current value and rank
      *
      * @pre Iterator must not be at end (current_ != nullptr)
      * @note Undefined behavior if called on end sentinel
+     * @throws std::overflow_error if the offset rank overflows (see detail::offset_rank).
      */
     [[nodiscard]] value_type operator*() const {
-        return std::make_pair(current_->value(), current_->rank());
+        return std::make_pair(
+            current_->value(), detail::offset_rank(current_->rank(), rank_offset_, overflow_));
     }
 
     /**
@@ -137,10 +200,11 @@ public:
     RankingIterator& operator++() {
         if (current_) {
             if (deduplicate_) {
-                // Save current value, then skip all elements with this value
-                const T current_value = current_->value();
-                current_ = current_->next();
-                skip_duplicates_of(current_value);
+                // Keep the element we leave alive and skip all elements with
+                // its value (compared in place, without copying it)
+                const auto previous = std::move(current_);
+                current_ = previous->next();
+                skip_duplicates_of(previous->value());
             } else {
                 // Without deduplication, just move to next
                 current_ = current_->next();
@@ -208,11 +272,12 @@ public:
      * @brief Get the current element pointer (for testing/debugging).
      *
      * Returns the underlying shared_ptr to the current RankingElement.
-     * This is primarily useful for testing and debugging scenarios.
+     * This is primarily useful for testing and debugging scenarios. The
+     * element's own rank does not include rank_offset().
      *
      * @return Shared pointer to current element (may be nullptr)
      */
-    [[nodiscard]] std::shared_ptr<RankingElement<T>> current() const noexcept {
+    [[nodiscard]] std::shared_ptr<RankingElement<T, Policy>> current() const noexcept {
         return current_;
     }
 
@@ -225,6 +290,13 @@ public:
         return deduplicate_;
     }
 
+    /**
+     * @brief Offset added to stored ranks on dereference.
+     */
+    [[nodiscard]] std::int64_t rank_offset() const noexcept {
+        return rank_offset_;
+    }
+
 private:
     /**
      * @brief Skip consecutive elements with duplicate values.
@@ -246,26 +318,24 @@ private:
      * @note This is only called by operator++ when deduplication is enabled
      */
     void skip_duplicates_of(const T& prev_value) {
-        if constexpr (std::is_same_v<T, std::any>) {
-            while (current_ && detail::any_values_equal(current_->value(), prev_value)) {
-                current_ = current_->next();
-            }
-        } else if constexpr (requires(const T& lhs, const T& rhs) { lhs == rhs; }) {
-            while (current_ && current_->value() == prev_value) {
-                current_ = current_->next();
-            }
-        } else {
-            (void)prev_value;
+        while (current_ && detail::duplicate_values(current_->value(), prev_value)) {
+            current_ = current_->next();
         }
     }
 
     /// Pointer to the current element in the ranking sequence
-    std::shared_ptr<RankingElement<T>> current_;
+    std::shared_ptr<RankingElement<T, Policy>> current_;
     
     /// Flag controlling deduplication behavior
     bool deduplicate_;
+
+    /// Offset applied to stored ranks on dereference
+    std::int64_t rank_offset_;
+
+    /// Overflow behaviour of a positive rank_offset_
+    RankOverflow overflow_;
 };
 
-} // namespace ranked_belief
+} // namespace ranked_belief::inline RANKED_BELIEF_ABI
 
 #endif // RANKED_BELIEF_RANKING_ITERATOR_HPP
@@ -7,10 +7,14 @@
  * the underlying computations. The wrapper exposes a reduced API that operates
  * on `std::any` values and reuses the existing lazy operations (map/filter/
  * merge/observe/merge-apply/etc.) under the hood.
+ *
+ * Every callback-taking operation also accepts callables over `ValueCell`,
+ * which lend each element to the callback instead of boxing a copy of it.
  */
 
 #pragma once
 
+#include "ranked_belief/node_pool.hpp"
 #include "ranked_belief/operations/filter.hpp"
 #include "ranked_belief/operations/map.hpp"
 #include "ranked_belief/operations/merge.hpp"
@@ -18,19 +22,23 @@
 #include "ranked_belief/operations/nrm_exc.hpp"
 #include "ranked_belief/operations/observe.hpp"
 #include "ranked_belief/ranking_function.hpp"
+#include "ranked_belief/value_cell.hpp"
 
+#include <algorithm>
 #include <any>
+#include <atomic>
 #include <concepts>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <stdexcept>
+#include <type_traits>
 #include <typeinfo>
 #include <utility>
 #include <vector>
 
-namespace ranked_belief {
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
 
 namespace detail {
 
@@ -39,6 +47,43 @@ concept EqualityComparable = requires(const T& lhs, const T& rhs) {
 	{ lhs == rhs } -> std::convertible_to<bool>;
 };
 
+/**
+ * @brief Callables over `const ValueCell&` that cannot take `const std::any&`.
+ *
+ * Selects the `ValueCell` overloads of `RankingFunctionAny`; callables that
+ * accept either (generic lambdas, for instance) keep using `std::any`.
+ */
+template<typename F, typename R, typename... Args>
+concept CellCallback = std::is_invocable_r_v<R, F&, const ValueCell&, Args...>
+	&& !std::is_invocable_v<F&, const std::any&, Args...>;
+
+/// Box @p value as `std::any`; a cell contributes its payload, not itself.
+template<typename T>
+[[nodiscard]] std::any to_any_value(T&& value)
+{
+	if constexpr (std::is_same_v<std::remove_cvref_t<T>, ValueCell>) {
+		return value.to_any();
+	} else {
+		return std::any{std::forward<T>(value)};
+	}
+}
+
+/// Tags identifying the erased models of RankingFunctionAny.
+template<typename T>
+inline constexpr char erased_model_tag = 0;
+inline constexpr char deferred_model_tag = 0;
+
+/// Call @p visit with the first @p count elements of @p rf, by reference.
+template<typename T, typename Visit>
+void visit_prefix(const RankingFunction<T>& rf, std::size_t count, Visit&& visit)
+{
+	std::size_t visited = 0;
+	for (auto it = rf.begin(); visited < count && it != rf.end(); ++it, ++visited) {
+		const auto& element = *it.current();
+		visit(element.value(), rf.rank_of(element));
+	}
+}
+
 } // namespace detail
 
 /**
@@ -70,7 +115,7 @@ public:
 	 */
 	template<typename T>
 	explicit RankingFunctionAny(RankingFunction<T> rf)
-		: impl_{make_shared(std::make_unique<Model<T>>(std::move(rf)))} {}
+		: impl_{make_model<T>(std::move(rf))} {}
 
 	RankingFunctionAny(const RankingFunctionAny&) = default;
 	RankingFunctionAny(RankingFunctionAny&&) noexcept = default;
@@ -128,6 +173,61 @@ public:
 		const std::function<bool(const std::any&)>& predicate,
 		Deduplication deduplicate = Deduplication::Enabled) const;
 
+	/**
+	 * @brief Map a callable over borrowed `ValueCell` values.
+	 *
+	 * Each element is lent to @p func without being copied. The resulting
+	 * ranking stores `ValueCell` values, which deduplicate through the
+	 * equality of their payload type.
+	 */
+	template<typename F>
+		requires detail::CellCallback<F, ValueCell>
+	[[nodiscard]] RankingFunctionAny map(
+		F&& func,
+		Deduplication deduplicate = Deduplication::Disabled) const
+	{
+		return RankingFunctionAny{impl_->map_cells(CellMap(std::forward<F>(func)), deduplicate)};
+	}
+
+	/**
+	 * @brief Rank-aware map over borrowed `ValueCell` values.
+	 */
+	template<typename F>
+		requires detail::CellCallback<F, std::pair<ValueCell, Rank>, Rank>
+	[[nodiscard]] RankingFunctionAny map_with_rank(
+		F&& func,
+		Deduplication deduplicate = Deduplication::Disabled) const
+	{
+		return RankingFunctionAny{
+			impl_->map_cells_with_rank(CellRankMap(std::forward<F>(func)), deduplicate)};
+	}
+
+	/**
+	 * @brief Index-aware map over borrowed `ValueCell` values.
+	 */
+	template<typename F>
+		requires detail::CellCallback<F, ValueCell, std::size_t>
+	[[nodiscard]] RankingFunctionAny map_with_index(
+		F&& func,
+		Deduplication deduplicate = Deduplication::Disabled) const
+	{
+		return RankingFunctionAny{
+			impl_->map_cells_with_index(CellIndexMap(std::forward<F>(func)), deduplicate)};
+	}
+
+	/**
+	 * @brief Filter with a predicate over borrowed `ValueCell` values.
+	 */
+	template<typename F>
+		requires detail::CellCallback<F, bool>
+	[[nodiscard]] RankingFunctionAny filter(
+		F&& predicate,
+		Deduplication deduplicate = Deduplication::Enabled) const
+	{
+		return RankingFunctionAny{
+			impl_->filter_cells(CellPredicate(std::forward<F>(predicate)), deduplicate)};
+	}
+
 	/**
 	 * @brief Take the first @p n elements lazily.
 	 */
@@ -166,6 +266,10 @@ public:
 	 * invoked lazily with the underlying value (wrapped in `std::any`) and must
 	 * return another `RankingFunctionAny`. The returned ranking contains
 	 * `std::any` values.
+	 *
+	 * Functions of type `std::function<RankingFunctionAny(const ValueCell&)>`
+	 * are also accepted; they receive each value borrowed rather than boxed,
+	 * and the returned ranking contains `ValueCell` values.
 	 */
 	[[nodiscard]] RankingFunctionAny merge_apply(
 		const RankingFunctionAny& functions,
@@ -178,6 +282,19 @@ public:
 		const std::function<bool(const std::any&)>& predicate,
 		Deduplication deduplicate = Deduplication::Enabled) const;
 
+	/**
+	 * @brief Condition on a predicate over borrowed `ValueCell` values.
+	 */
+	template<typename F>
+		requires detail::CellCallback<F, bool>
+	[[nodiscard]] RankingFunctionAny observe(
+		F&& predicate,
+		Deduplication deduplicate = Deduplication::Enabled) const
+	{
+		return RankingFunctionAny{
+			impl_->observe_cells(CellPredicate(std::forward<F>(predicate)), deduplicate)};
+	}
+
 	/**
 	 * @brief Condition on equality with a specific value.
 	 *
@@ -188,11 +305,39 @@ public:
 		const std::any& value,
 		Deduplication deduplicate = Deduplication::Enabled) const;
 
+	/**
+	 * @brief Condition on equality with the value held by a cell.
+	 *
+	 * Unlike the `std::any` overload this also works on rankings of
+	 * `std::any` or `ValueCell` values, since cells carry their equality.
+	 *
+	 * @throws std::bad_any_cast if the stored type does not match the argument.
+	 * @throws std::logic_error if the stored type is not equality comparable.
+	 */
+	[[nodiscard]] RankingFunctionAny observe_value(
+		const ValueCell& value,
+		Deduplication deduplicate = Deduplication::Enabled) const;
+
 	/**
 	 * @brief Materialise the first @p n elements as `std::any`/`Rank` pairs.
 	 */
 	[[nodiscard]] std::vector<std::pair<std::any, Rank>> take_n(std::size_t n) const;
 
+	/**
+	 * @brief Obtain the first value as a cell (one copy at most).
+	 *
+	 * @throws std::logic_error if the ranking is empty.
+	 */
+	[[nodiscard]] ValueCell first_cell() const;
+
+	/**
+	 * @brief Materialise the first @p n elements as `ValueCell`/`Rank` pairs.
+	 *
+	 * Each value is copied once; values already held in shared cells are not
+	 * copied at all.
+	 */
+	[[nodiscard]] std::vector<std::pair<ValueCell, Rank>> take_n_cells(std::size_t n) const;
+
 	/**
 	 * @brief Attempt to retrieve the underlying typed ranking.
 	 *
@@ -202,7 +347,7 @@ public:
 	template<typename T>
 	[[nodiscard]] RankingFunction<T> cast() const
 	{
-		auto model = dynamic_cast<const Model<T>*>(impl_.get());
+		auto model = as_model<T>(realise(*impl_));
 		if (!model) {
 			throw std::bad_any_cast();
 		}
@@ -218,45 +363,98 @@ public:
 	 */
 	[[nodiscard]] RankingFunction<std::any> to_any_ranking(Deduplication deduplicate = Deduplication::Disabled) const;
 
+	/**
+	 * @brief Convert to a `RankingFunction<ValueCell>` representation.
+	 *
+	 * Each value is copied into a cell once, when forced; rankings that
+	 * already hold cells are returned without copying. Unlike
+	 * to_any_ranking(), deduplication compares values with their own
+	 * operator==.
+	 */
+	[[nodiscard]] RankingFunction<ValueCell> to_cell_ranking(
+		Deduplication deduplicate = Deduplication::Disabled) const;
+
 private:
+	using CellMap = std::function<ValueCell(const ValueCell&)>;
+	using CellRankMap = std::function<std::pair<ValueCell, Rank>(const ValueCell&, Rank)>;
+	using CellIndexMap = std::function<ValueCell(const ValueCell&, std::size_t)>;
+	using CellPredicate = std::function<bool(const ValueCell&)>;
+
+	struct Concept;
+	using ConceptPtr = std::shared_ptr<const Concept>;
+
+	/**
+	 * Operations return the new model directly (allocated together with its
+	 * control block, from the current NodePool if one is installed). Each
+	 * model carries a tag naming its value type, so finding the typed model
+	 * of an operand is a pointer comparison rather than a dynamic_cast.
+	 */
 	struct Concept {
+		explicit Concept(const void* model_tag) noexcept
+			: tag{model_tag} {}
+		Concept(const Concept&) = delete;
+		Concept& operator=(const Concept&) = delete;
+
 		virtual ~Concept() = default;
 
-		[[nodiscard]] virtual std::unique_ptr<Concept> clone() const = 0;
 		[[nodiscard]] virtual bool is_empty() const = 0;
 		[[nodiscard]] virtual std::any first_value() const = 0;
 		[[nodiscard]] virtual std::optional<Rank> first_rank() const = 0;
-		[[nodiscard]] virtual std::unique_ptr<Concept> map(
-			const std::function<std::any(const std::any&)>& func,
+		[[nodiscard]] virtual ConceptPtr map(
+			std::function<std::any(const std::any&)> func,
 			Deduplication deduplicate) const = 0;
-		[[nodiscard]] virtual std::unique_ptr<Concept> map_with_rank(
-			const std::function<std::pair<std::any, Rank>(const std::any&, Rank)>& func,
+		[[nodiscard]] virtual ConceptPtr map_with_rank(
+			std::function<std::pair<std::any, Rank>(const std::any&, Rank)> func,
 			Deduplication deduplicate) const = 0;
-		[[nodiscard]] virtual std::unique_ptr<Concept> map_with_index(
-			const std::function<std::any(const std::any&, std::size_t)>& func,
+		[[nodiscard]] virtual ConceptPtr map_with_index(
+			std::function<std::any(const std::any&, std::size_t)> func,
 			Deduplication deduplicate) const = 0;
-		[[nodiscard]] virtual std::unique_ptr<Concept> filter(
-			const std::function<bool(const std::any&)>& predicate,
+		[[nodiscard]] virtual ConceptPtr filter(
+			std::function<bool(const std::any&)> predicate,
 			Deduplication deduplicate) const = 0;
-		[[nodiscard]] virtual std::unique_ptr<Concept> take(std::size_t n) const = 0;
-		[[nodiscard]] virtual std::unique_ptr<Concept> take_while_rank(Rank max_rank) const = 0;
-		[[nodiscard]] virtual std::unique_ptr<Concept> merge(
+		[[nodiscard]] virtual ConceptPtr take(std::size_t n) const = 0;
+		[[nodiscard]] virtual ConceptPtr take_while_rank(Rank max_rank) const = 0;
+		[[nodiscard]] virtual ConceptPtr merge(
 			const Concept& other,
 			Deduplication deduplicate) const = 0;
-		[[nodiscard]] virtual std::unique_ptr<Concept> merge_apply(
+		[[nodiscard]] virtual ConceptPtr merge_apply(
 			const Concept& functions,
 			Deduplication deduplicate) const = 0;
-		[[nodiscard]] virtual std::unique_ptr<Concept> observe(
-			const std::function<bool(const std::any&)>& predicate,
+		[[nodiscard]] virtual ConceptPtr observe(
+			std::function<bool(const std::any&)> predicate,
 			Deduplication deduplicate) const = 0;
-		[[nodiscard]] virtual std::unique_ptr<Concept> observe_value(
+		[[nodiscard]] virtual ConceptPtr observe_value(
 			const std::any& value,
 			Deduplication deduplicate) const = 0;
-		[[nodiscard]] virtual std::unique_ptr<Concept> shift_ranks(
+		[[nodiscard]] virtual ConceptPtr shift_ranks(
 			Rank offset,
 			Deduplication deduplicate) const = 0;
 		[[nodiscard]] virtual std::vector<std::pair<std::any, Rank>> take_n(std::size_t n) const = 0;
 		[[nodiscard]] virtual RankingFunction<std::any> to_any_ranking(Deduplication deduplicate) const = 0;
+
+		[[nodiscard]] virtual ValueCell first_cell() const = 0;
+		[[nodiscard]] virtual ConceptPtr map_cells(
+			CellMap func,
+			Deduplication deduplicate) const = 0;
+		[[nodiscard]] virtual ConceptPtr map_cells_with_rank(
+			CellRankMap func,
+			Deduplication deduplicate) const = 0;
+		[[nodiscard]] virtual ConceptPtr map_cells_with_index(
+			CellIndexMap func,
+			Deduplication deduplicate) const = 0;
+		[[nodiscard]] virtual ConceptPtr filter_cells(
+			CellPredicate predicate,
+			Deduplication deduplicate) const = 0;
+		[[nodiscard]] virtual ConceptPtr observe_cells(
+			CellPredicate predicate,
+			Deduplication deduplicate) const = 0;
+		[[nodiscard]] virtual ConceptPtr observe_cell_value(
+			const ValueCell& value,
+			Deduplication deduplicate) const = 0;
+		[[nodiscard]] virtual std::vector<std::pair<ValueCell, Rank>> take_n_cells(std::size_t n) const = 0;
+		[[nodiscard]] virtual RankingFunction<ValueCell> to_cell_ranking(Deduplication deduplicate) const = 0;
+
+		const void* const tag;  ///< detail::erased_model_tag of the model
 	};
 
 	template<typename T>
@@ -264,24 +462,35 @@ private:
 
 	struct Deferred;
 
-	[[nodiscard]] static std::shared_ptr<const Concept> make_shared(std::unique_ptr<Concept> impl);
-	[[nodiscard]] static std::shared_ptr<const Concept> empty_impl();
+	template<typename U, typename... Args>
+	[[nodiscard]] static ConceptPtr make_model(Args&&... args)
+	{
+		return allocate_pooled<Model<U>>(current_node_pool(), std::forward<Args>(args)...);
+	}
+
+	/**
+	 * The Model<U> behind @p impl, or nullptr. Deferrals are looked through
+	 * only once realised, so the lookup never forces a thunk.
+	 */
+	template<typename U>
+	[[nodiscard]] static const Model<U>* as_model(const Concept& impl);
+
+	/// @p impl with any deferrals realised.
+	[[nodiscard]] static const Concept& realise(const Concept& impl);
+
+	[[nodiscard]] static ConceptPtr empty_impl();
 
-	explicit RankingFunctionAny(std::shared_ptr<const Concept> impl)
+	explicit RankingFunctionAny(ConceptPtr impl)
 		: impl_{std::move(impl)} {}
 
-	std::shared_ptr<const Concept> impl_;
+	ConceptPtr impl_;
 };
 
 	template<typename T>
 	struct RankingFunctionAny::Model final : Concept {
 		explicit Model(RankingFunction<T> ranking)
-			: rf{std::move(ranking)} {}
-
-		[[nodiscard]] std::unique_ptr<Concept> clone() const override
-		{
-			return std::make_unique<Model<T>>(rf);
-		}
+			: Concept{&detail::erased_model_tag<T>}
+			, rf{std::move(ranking)} {}
 
 		[[nodiscard]] bool is_empty() const override
 		{
@@ -290,11 +499,11 @@ private:
 
 		[[nodiscard]] std::any first_value() const override
 		{
-			auto first = rf.first();
-			if (!first) {
+			auto it = rf.begin();
+			if (it == rf.end()) {
 				throw std::logic_error{"RankingFunctionAny::first_value called on empty ranking"};
 			}
-			return std::any{first->first};
+			return detail::to_any_value(it.current()->value());
 		}
 
 		[[nodiscard]] std::optional<Rank> first_rank() const override
@@ -306,159 +515,181 @@ private:
 			return first->second;
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> map(
-			const std::function<std::any(const std::any&)>& func,
+		[[nodiscard]] ConceptPtr map(
+			std::function<std::any(const std::any&)> func,
 			Deduplication deduplicate) const override
 		{
-			auto captured = func;
+			auto captured = std::move(func);
 			auto mapped = ranked_belief::map(
 				rf,
 				[captured](const T& value) -> std::any {
-					return captured(std::any{value});
+					return captured(detail::to_any_value(value));
 				},
 				deduplicate);
-			return std::make_unique<Model<std::any>>(std::move(mapped));
+			return make_model<std::any>(std::move(mapped));
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> map_with_rank(
-			const std::function<std::pair<std::any, Rank>(const std::any&, Rank)>& func,
+		[[nodiscard]] ConceptPtr map_with_rank(
+			std::function<std::pair<std::any, Rank>(const std::any&, Rank)> func,
 			Deduplication deduplicate) const override
 		{
-			auto captured = func;
+			auto captured = std::move(func);
 			auto mapped = ranked_belief::map_with_rank(
 				rf,
 				[captured](const T& value, Rank rank) {
-					return captured(std::any{value}, rank);
+					return captured(detail::to_any_value(value), rank);
 				},
 				deduplicate);
-			return std::make_unique<Model<std::any>>(std::move(mapped));
+			return make_model<std::any>(std::move(mapped));
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> map_with_index(
-			const std::function<std::any(const std::any&, std::size_t)>& func,
+		[[nodiscard]] ConceptPtr map_with_index(
+			std::function<std::any(const std::any&, std::size_t)> func,
 			Deduplication deduplicate) const override
 		{
-			auto captured = func;
+			auto captured = std::move(func);
 			auto mapped = ranked_belief::map_with_index(
 				rf,
 				[captured](const T& value, std::size_t index) -> std::any {
-					return captured(std::any{value}, index);
+					return captured(detail::to_any_value(value), index);
 				},
 				deduplicate);
-			return std::make_unique<Model<std::any>>(std::move(mapped));
+			return make_model<std::any>(std::move(mapped));
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> filter(
-			const std::function<bool(const std::any&)>& predicate,
+		[[nodiscard]] ConceptPtr filter(
+			std::function<bool(const std::any&)> predicate,
 			Deduplication deduplicate) const override
 		{
-			auto captured = predicate;
+			auto captured = std::move(predicate);
 			auto filtered = ranked_belief::filter(
 				rf,
-				[captured](const T& value) { return captured(std::any{value}); },
+				[captured](const T& value) { return captured(detail::to_any_value(value)); },
 				deduplicate);
-			return std::make_unique<Model<T>>(std::move(filtered));
+			return make_model<T>(std::move(filtered));
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> take(std::size_t n) const override
+		[[nodiscard]] ConceptPtr take(std::size_t n) const override
 		{
 			auto taken = ranked_belief::take(rf, n);
-			return std::make_unique<Model<T>>(std::move(taken));
+			return make_model<T>(std::move(taken));
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> take_while_rank(Rank max_rank) const override
+		[[nodiscard]] ConceptPtr take_while_rank(Rank max_rank) const override
 		{
 			auto taken = ranked_belief::take_while_rank(rf, max_rank);
-			return std::make_unique<Model<T>>(std::move(taken));
+			return make_model<T>(std::move(taken));
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> merge(
+		[[nodiscard]] ConceptPtr merge(
 			const Concept& other,
 			Deduplication deduplicate) const override
 		{
-			if (auto other_model = dynamic_cast<const Model<T>*>(&other)) {
+			if (auto other_model = as_model<T>(other)) {
 				auto merged = ranked_belief::merge(rf, other_model->rf, deduplicate);
-				return std::make_unique<Model<T>>(std::move(merged));
+				return make_model<T>(std::move(merged));
+			}
+			if (std::is_same_v<T, ValueCell> || as_model<ValueCell>(other)) {
+				auto merged_cells = ranked_belief::merge(
+					to_cell_ranking(deduplicate),
+					other.to_cell_ranking(deduplicate),
+					deduplicate);
+				return make_model<ValueCell>(std::move(merged_cells));
 			}
 			auto merged_any = ranked_belief::merge(
 				to_any_ranking(deduplicate),
 				other.to_any_ranking(deduplicate),
 				deduplicate);
-			return std::make_unique<Model<std::any>>(std::move(merged_any));
+			return make_model<std::any>(std::move(merged_any));
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> merge_apply(
+		[[nodiscard]] ConceptPtr merge_apply(
 			const Concept& functions,
 			Deduplication deduplicate) const override
 		{
 			using AnyFunction = std::function<RankingFunctionAny(const std::any&)>;
+			using CellFunction = std::function<RankingFunctionAny(const ValueCell&)>;
+
+			if (auto func_model = as_model<CellFunction>(functions)) {
+				auto result = ranked_belief::merge_apply(
+					rf,
+					[func_rf = func_model->rf, deduplicate](const T& value) {
+						return ranked_belief::merge_apply(
+							func_rf,
+							[&value, deduplicate](const CellFunction& fn) {
+								return fn(ValueCell::borrow(value)).to_cell_ranking(deduplicate);
+							},
+							deduplicate);
+					},
+					deduplicate);
+				return make_model<ValueCell>(std::move(result));
+			}
 
-			if (auto func_model = dynamic_cast<const Model<AnyFunction>*>(&functions)) {
+			if (auto func_model = as_model<AnyFunction>(functions)) {
 				auto result = ranked_belief::merge_apply(
 					rf,
 					[func_rf = func_model->rf, deduplicate](const T& value) {
 						return ranked_belief::merge_apply(
 							func_rf,
 							[&value, deduplicate](const AnyFunction& fn) {
-								return fn(std::any{value}).to_any_ranking(deduplicate);
+								return fn(detail::to_any_value(value)).to_any_ranking(deduplicate);
 							},
 							deduplicate);
 					},
 					deduplicate);
-				return std::make_unique<Model<std::any>>(std::move(result));
+				return make_model<std::any>(std::move(result));
 			}
 
 			throw std::logic_error{
-				"RankingFunctionAny::merge_apply requires functions of type std::function<RankingFunctionAny(const std::any&)>"};
+				"RankingFunctionAny::merge_apply requires functions of type std::function<RankingFunctionAny(const std::any&)>"
+				" or std::function<RankingFunctionAny(const ValueCell&)>"};
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> observe(
-			const std::function<bool(const std::any&)>& predicate,
+		[[nodiscard]] ConceptPtr observe(
+			std::function<bool(const std::any&)> predicate,
 			Deduplication deduplicate) const override
 		{
-			auto captured = predicate;
+			auto captured = std::move(predicate);
 			auto observed = ranked_belief::observe(
 				rf,
-				[captured](const T& value) { return captured(std::any{value}); },
+				[captured](const T& value) { return captured(detail::to_any_value(value)); },
 				deduplicate);
-			return std::make_unique<Model<T>>(std::move(observed));
+			return make_model<T>(std::move(observed));
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> observe_value(
+		[[nodiscard]] ConceptPtr observe_value(
 			const std::any& value,
 			Deduplication deduplicate) const override
 		{
-			if constexpr (!detail::EqualityComparable<T>) {
+			if constexpr (std::is_same_v<T, ValueCell>) {
+				auto observed = ranked_belief::observe(rf, ValueCell{value}, deduplicate);
+				return make_model<T>(std::move(observed));
+			} else if constexpr (!detail::EqualityComparable<T>) {
 				throw std::logic_error{
 					"RankingFunctionAny::observe_value requires equality comparable stored type"};
 			} else {
 				const auto& typed = std::any_cast<const T&>(value);
 				auto observed = ranked_belief::observe(rf, typed, deduplicate);
-				return std::make_unique<Model<T>>(std::move(observed));
+				return make_model<T>(std::move(observed));
 			}
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> shift_ranks(
+		[[nodiscard]] ConceptPtr shift_ranks(
 			Rank offset,
 			Deduplication deduplicate) const override
 		{
-			auto shifted = ranked_belief::map_with_rank(
-				rf,
-				[offset](const T& value, Rank rank) {
-					return std::make_pair(value, rank + offset);
-				},
-				deduplicate);
-			return std::make_unique<Model<T>>(std::move(shifted));
+			auto shifted = ranked_belief::shift_ranks(rf, offset);
+			return make_model<T>(
+				RankingFunction<T>(shifted.raw_head(), deduplicate)
+					.with_rank_offset(shifted.rank_offset(), shifted.rank_overflow()));
 		}
 
 		[[nodiscard]] std::vector<std::pair<std::any, Rank>> take_n(std::size_t n) const override
 		{
-			auto values = ranked_belief::take_n(rf, n);
 			std::vector<std::pair<std::any, Rank>> result;
-			result.reserve(values.size());
-			for (auto& [value, rank] : values) {
-				result.emplace_back(std::any{value}, rank);
-			}
+			detail::visit_prefix(rf, n, [&result](const T& value, Rank rank) {
+				result.emplace_back(detail::to_any_value(value), rank);
+			});
 			return result;
 		}
 
@@ -466,8 +697,117 @@ private:
 		{
 			return ranked_belief::map(
 				rf,
-				[](const T& value) -> std::any { return std::any{value}; },
+				[](const T& value) -> std::any { return detail::to_any_value(value); },
+				deduplicate);
+		}
+
+		[[nodiscard]] ValueCell first_cell() const override
+		{
+			auto it = rf.begin();
+			if (it == rf.end()) {
+				throw std::logic_error{"RankingFunctionAny::first_cell called on empty ranking"};
+			}
+			return ValueCell{it.current()->value()};
+		}
+
+		[[nodiscard]] ConceptPtr map_cells(
+			CellMap func,
+			Deduplication deduplicate) const override
+		{
+			auto mapped = ranked_belief::map(
+				rf,
+				[captured = std::move(func)](const T& value) { return captured(ValueCell::borrow(value)); },
+				deduplicate);
+			return make_model<ValueCell>(std::move(mapped));
+		}
+
+		[[nodiscard]] ConceptPtr map_cells_with_rank(
+			CellRankMap func,
+			Deduplication deduplicate) const override
+		{
+			auto mapped = ranked_belief::map_with_rank(
+				rf,
+				[captured = std::move(func)](const T& value, Rank rank) {
+					return captured(ValueCell::borrow(value), rank);
+				},
+				deduplicate);
+			return make_model<ValueCell>(std::move(mapped));
+		}
+
+		[[nodiscard]] ConceptPtr map_cells_with_index(
+			CellIndexMap func,
+			Deduplication deduplicate) const override
+		{
+			auto mapped = ranked_belief::map_with_index(
+				rf,
+				[captured = std::move(func)](const T& value, std::size_t index) {
+					return captured(ValueCell::borrow(value), index);
+				},
+				deduplicate);
+			return make_model<ValueCell>(std::move(mapped));
+		}
+
+		[[nodiscard]] ConceptPtr filter_cells(
+			CellPredicate predicate,
+			Deduplication deduplicate) const override
+		{
+			auto filtered = ranked_belief::filter(
+				rf,
+				[captured = std::move(predicate)](const T& value) { return captured(ValueCell::borrow(value)); },
+				deduplicate);
+			return make_model<T>(std::move(filtered));
+		}
+
+		[[nodiscard]] ConceptPtr observe_cells(
+			CellPredicate predicate,
+			Deduplication deduplicate) const override
+		{
+			auto observed = ranked_belief::observe(
+				rf,
+				[captured = std::move(predicate)](const T& value) { return captured(ValueCell::borrow(value)); },
 				deduplicate);
+			return make_model<T>(std::move(observed));
+		}
+
+		[[nodiscard]] ConceptPtr observe_cell_value(
+			const ValueCell& value,
+			Deduplication deduplicate) const override
+		{
+			if constexpr (std::is_same_v<T, ValueCell>) {
+				auto observed = ranked_belief::observe(rf, value, deduplicate);
+				return make_model<T>(std::move(observed));
+			} else if constexpr (!detail::EqualityComparable<T>) {
+				throw std::logic_error{
+					"RankingFunctionAny::observe_value requires equality comparable stored type"};
+			} else {
+				auto observed = ranked_belief::observe(rf, value.get<T>(), deduplicate);
+				return make_model<T>(std::move(observed));
+			}
+		}
+
+		[[nodiscard]] std::vector<std::pair<ValueCell, Rank>> take_n_cells(std::size_t n) const override
+		{
+			std::vector<std::pair<ValueCell, Rank>> result;
+			detail::visit_prefix(rf, n, [&result](const T& value, Rank rank) {
+				result.emplace_back(ValueCell{value}, rank);
+			});
+			return result;
+		}
+
+		[[nodiscard]] RankingFunction<ValueCell> to_cell_ranking(Deduplication deduplicate) const override
+		{
+			if constexpr (std::is_same_v<T, ValueCell>) {
+				if (rf.is_deduplicating() == to_bool(deduplicate)) {
+					return rf;
+				}
+				return RankingFunction<ValueCell>(rf.raw_head(), deduplicate)
+					.with_rank_offset(rf.rank_offset(), rf.rank_overflow());
+			} else {
+				return ranked_belief::map(
+					rf,
+					[](const T& value) { return ValueCell{value}; },
+					deduplicate);
+			}
 		}
 
 		RankingFunction<T> rf;
@@ -476,12 +816,8 @@ private:
 	template<>
 	struct RankingFunctionAny::Model<std::any> final : Concept {
 		explicit Model(RankingFunction<std::any> ranking)
-			: rf{std::move(ranking)} {}
-
-		[[nodiscard]] std::unique_ptr<Concept> clone() const override
-		{
-			return std::make_unique<Model<std::any>>(rf);
-		}
+			: Concept{&detail::erased_model_tag<std::any>}
+			, rf{std::move(ranking)} {}
 
 		[[nodiscard]] bool is_empty() const override
 		{
@@ -506,102 +842,126 @@ private:
 			return first->second;
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> map(
-			const std::function<std::any(const std::any&)>& func,
+		[[nodiscard]] ConceptPtr map(
+			std::function<std::any(const std::any&)> func,
 			Deduplication deduplicate) const override
 		{
-			auto captured = func;
+			auto captured = std::move(func);
 			auto mapped = ranked_belief::map(
 				rf,
 				[captured](const std::any& value) { return captured(value); },
 				deduplicate);
-			return std::make_unique<Model<std::any>>(std::move(mapped));
+			return make_model<std::any>(std::move(mapped));
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> map_with_rank(
-			const std::function<std::pair<std::any, Rank>(const std::any&, Rank)>& func,
+		[[nodiscard]] ConceptPtr map_with_rank(
+			std::function<std::pair<std::any, Rank>(const std::any&, Rank)> func,
 			Deduplication deduplicate) const override
 		{
-			auto captured = func;
+			auto captured = std::move(func);
 			auto mapped = ranked_belief::map_with_rank(
 				rf,
 				[captured](const std::any& value, Rank rank) {
 					return captured(value, rank);
 				},
 				deduplicate);
-			return std::make_unique<Model<std::any>>(std::move(mapped));
+			return make_model<std::any>(std::move(mapped));
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> map_with_index(
-			const std::function<std::any(const std::any&, std::size_t)>& func,
+		[[nodiscard]] ConceptPtr map_with_index(
+			std::function<std::any(const std::any&, std::size_t)> func,
 			Deduplication deduplicate) const override
 		{
-			auto captured = func;
+			auto captured = std::move(func);
 			auto mapped = ranked_belief::map_with_index(
 				rf,
 				[captured](const std::any& value, std::size_t index) {
 					return captured(value, index);
 				},
 				deduplicate);
-			return std::make_unique<Model<std::any>>(std::move(mapped));
+			return make_model<std::any>(std::move(mapped));
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> filter(
-			const std::function<bool(const std::any&)>& predicate,
+		[[nodiscard]] ConceptPtr filter(
+			std::function<bool(const std::any&)> predicate,
 			Deduplication deduplicate) const override
 		{
-			auto captured = predicate;
+			auto captured = std::move(predicate);
 			auto filtered = ranked_belief::filter(
 				rf,
 				[captured](const std::any& value) { return captured(value); },
 				deduplicate);
-			return std::make_unique<Model<std::any>>(std::move(filtered));
+			return make_model<std::any>(std::move(filtered));
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> take(std::size_t n) const override
+		[[nodiscard]] ConceptPtr take(std::size_t n) const override
 		{
 			auto taken = ranked_belief::take(rf, n);
-			return std::make_unique<Model<std::any>>(std::move(taken));
+			return make_model<std::any>(std::move(taken));
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> take_while_rank(Rank max_rank) const override
+		[[nodiscard]] ConceptPtr take_while_rank(Rank max_rank) const override
 		{
 			auto taken = ranked_belief::take_while_rank(rf, max_rank);
-			return std::make_unique<Model<std::any>>(std::move(taken));
+			return make_model<std::any>(std::move(taken));
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> merge(
+		[[nodiscard]] ConceptPtr merge(
 			const Concept& other,
 			Deduplication deduplicate) const override
 		{
+			if (as_model<ValueCell>(other)) {
+				auto merged_cells = ranked_belief::merge(
+					to_cell_ranking(deduplicate),
+					other.to_cell_ranking(deduplicate),
+					deduplicate);
+				return make_model<ValueCell>(std::move(merged_cells));
+			}
 			auto merged = ranked_belief::merge(
 				rf,
 				other.to_any_ranking(deduplicate),
 				deduplicate);
-			return std::make_unique<Model<std::any>>(std::move(merged));
+			return make_model<std::any>(std::move(merged));
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> merge_apply(
-			const Concept& /*functions*/,
-			Deduplication /*deduplicate*/) const override
+		[[nodiscard]] ConceptPtr merge_apply(
+			const Concept& functions,
+			Deduplication deduplicate) const override
 		{
+			using CellFunction = std::function<RankingFunctionAny(const ValueCell&)>;
+
+			if (auto func_model = as_model<CellFunction>(functions)) {
+				auto result = ranked_belief::merge_apply(
+					rf,
+					[func_rf = func_model->rf, deduplicate](const std::any& value) {
+						return ranked_belief::merge_apply(
+							func_rf,
+							[&value, deduplicate](const CellFunction& fn) {
+								return fn(ValueCell::borrow(value)).to_cell_ranking(deduplicate);
+							},
+							deduplicate);
+					},
+					deduplicate);
+				return make_model<ValueCell>(std::move(result));
+			}
+
 			throw std::logic_error{
 				"RankingFunctionAny::merge_apply requires function rankings with concrete types"};
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> observe(
-			const std::function<bool(const std::any&)>& predicate,
+		[[nodiscard]] ConceptPtr observe(
+			std::function<bool(const std::any&)> predicate,
 			Deduplication deduplicate) const override
 		{
-			auto captured = predicate;
+			auto captured = std::move(predicate);
 			auto observed = ranked_belief::observe(
 				rf,
 				[captured](const std::any& value) { return captured(value); },
 				deduplicate);
-			return std::make_unique<Model<std::any>>(std::move(observed));
+			return make_model<std::any>(std::move(observed));
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> observe_value(
+		[[nodiscard]] ConceptPtr observe_value(
 			const std::any& /*value*/,
 			Deduplication /*deduplicate*/) const override
 		{
@@ -609,7 +969,7 @@ private:
 				"RankingFunctionAny::observe_value is unavailable for std::any payloads"};
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> shift_ranks(
+		[[nodiscard]] ConceptPtr shift_ranks(
 			Rank offset,
 			Deduplication deduplicate) const override
 		{
@@ -619,7 +979,7 @@ private:
 					return std::make_pair(value, rank + offset);
 				},
 				deduplicate);
-			return std::make_unique<Model<std::any>>(std::move(shifted));
+			return make_model<std::any>(std::move(shifted));
 		}
 
 		[[nodiscard]] std::vector<std::pair<std::any, Rank>> take_n(std::size_t n) const override
@@ -638,17 +998,121 @@ private:
 				deduplicate);
 		}
 
+		[[nodiscard]] ValueCell first_cell() const override
+		{
+			auto it = rf.begin();
+			if (it == rf.end()) {
+				throw std::logic_error{"RankingFunctionAny::first_cell called on empty ranking"};
+			}
+			return ValueCell{it.current()->value()};
+		}
+
+		[[nodiscard]] ConceptPtr map_cells(
+			CellMap func,
+			Deduplication deduplicate) const override
+		{
+			auto mapped = ranked_belief::map(
+				rf,
+				[captured = std::move(func)](const std::any& value) { return captured(ValueCell::borrow(value)); },
+				deduplicate);
+			return make_model<ValueCell>(std::move(mapped));
+		}
+
+		[[nodiscard]] ConceptPtr map_cells_with_rank(
+			CellRankMap func,
+			Deduplication deduplicate) const override
+		{
+			auto mapped = ranked_belief::map_with_rank(
+				rf,
+				[captured = std::move(func)](const std::any& value, Rank rank) {
+					return captured(ValueCell::borrow(value), rank);
+				},
+				deduplicate);
+			return make_model<ValueCell>(std::move(mapped));
+		}
+
+		[[nodiscard]] ConceptPtr map_cells_with_index(
+			CellIndexMap func,
+			Deduplication deduplicate) const override
+		{
+			auto mapped = ranked_belief::map_with_index(
+				rf,
+				[captured = std::move(func)](const std::any& value, std::size_t index) {
+					return captured(ValueCell::borrow(value), index);
+				},
+				deduplicate);
+			return make_model<ValueCell>(std::move(mapped));
+		}
+
+		[[nodiscard]] ConceptPtr filter_cells(
+			CellPredicate predicate,
+			Deduplication deduplicate) const override
+		{
+			auto filtered = ranked_belief::filter(
+				rf,
+				[captured = std::move(predicate)](const std::any& value) { return captured(ValueCell::borrow(value)); },
+				deduplicate);
+			return make_model<std::any>(std::move(filtered));
+		}
+
+		[[nodiscard]] ConceptPtr observe_cells(
+			CellPredicate predicate,
+			Deduplication deduplicate) const override
+		{
+			auto observed = ranked_belief::observe(
+				rf,
+				[captured = std::move(predicate)](const std::any& value) { return captured(ValueCell::borrow(value)); },
+				deduplicate);
+			return make_model<std::any>(std::move(observed));
+		}
+
+		[[nodiscard]] ConceptPtr observe_cell_value(
+			const ValueCell& value,
+			Deduplication deduplicate) const override
+		{
+			auto observed = ranked_belief::observe(
+				rf,
+				[value](const std::any& candidate) { return ValueCell::borrow(candidate) == value; },
+				deduplicate);
+			return make_model<std::any>(std::move(observed));
+		}
+
+		[[nodiscard]] std::vector<std::pair<ValueCell, Rank>> take_n_cells(std::size_t n) const override
+		{
+			std::vector<std::pair<ValueCell, Rank>> result;
+			detail::visit_prefix(rf, n, [&result](const std::any& value, Rank rank) {
+				result.emplace_back(ValueCell{value}, rank);
+			});
+			return result;
+		}
+
+		[[nodiscard]] RankingFunction<ValueCell> to_cell_ranking(Deduplication deduplicate) const override
+		{
+			return ranked_belief::map(
+				rf,
+				[](const std::any& value) { return ValueCell{value}; },
+				deduplicate);
+		}
+
 		RankingFunction<std::any> rf;
 	};
 
 	struct RankingFunctionAny::Deferred final : Concept {
 		explicit Deferred(std::function<RankingFunctionAny()> thunk)
-			: thunk_{std::move(thunk)} {}
+			: Concept{&detail::deferred_model_tag}
+			, thunk_{std::move(thunk)} {}
 
-		[[nodiscard]] std::unique_ptr<Concept> clone() const override
+		/// The model the thunk produced; realises it on first use.
+		[[nodiscard]] const Concept& realised() const
 		{
 			ensure_realised();
-			return realised_->clone();
+			return *realised_;
+		}
+
+		/// The model the thunk produced, or nullptr if it has not run yet.
+		[[nodiscard]] const Concept* realised_if_ready() const noexcept
+		{
+			return ready_.load(std::memory_order_acquire);
 		}
 
 		[[nodiscard]] bool is_empty() const override
@@ -669,51 +1133,51 @@ private:
 			return realised_->first_rank();
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> map(
-			const std::function<std::any(const std::any&)>& func,
+		[[nodiscard]] ConceptPtr map(
+			std::function<std::any(const std::any&)> func,
 			Deduplication deduplicate) const override
 		{
 			ensure_realised();
-			return realised_->map(func, deduplicate);
+			return realised_->map(std::move(func), deduplicate);
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> map_with_rank(
-			const std::function<std::pair<std::any, Rank>(const std::any&, Rank)>& func,
+		[[nodiscard]] ConceptPtr map_with_rank(
+			std::function<std::pair<std::any, Rank>(const std::any&, Rank)> func,
 			Deduplication deduplicate) const override
 		{
 			ensure_realised();
-			return realised_->map_with_rank(func, deduplicate);
+			return realised_->map_with_rank(std::move(func), deduplicate);
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> map_with_index(
-			const std::function<std::any(const std::any&, std::size_t)>& func,
+		[[nodiscard]] ConceptPtr map_with_index(
+			std::function<std::any(const std::any&, std::size_t)> func,
 			Deduplication deduplicate) const override
 		{
 			ensure_realised();
-			return realised_->map_with_index(func, deduplicate);
+			return realised_->map_with_index(std::move(func), deduplicate);
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> filter(
-			const std::function<bool(const std::any&)>& predicate,
+		[[nodiscard]] ConceptPtr filter(
+			std::function<bool(const std::any&)> predicate,
 			Deduplication deduplicate) const override
 		{
 			ensure_realised();
-			return realised_->filter(predicate, deduplicate);
+			return realised_->filter(std::move(predicate), deduplicate);
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> take(std::size_t n) const override
+		[[nodiscard]] ConceptPtr take(std::size_t n) const override
 		{
 			ensure_realised();
 			return realised_->take(n);
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> take_while_rank(Rank max_rank) const override
+		[[nodiscard]] ConceptPtr take_while_rank(Rank max_rank) const override
 		{
 			ensure_realised();
 			return realised_->take_while_rank(max_rank);
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> merge(
+		[[nodiscard]] ConceptPtr merge(
 			const Concept& other,
 			Deduplication deduplicate) const override
 		{
@@ -721,7 +1185,7 @@ private:
 			return realised_->merge(other, deduplicate);
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> merge_apply(
+		[[nodiscard]] ConceptPtr merge_apply(
 			const Concept& functions,
 			Deduplication deduplicate) const override
 		{
@@ -729,15 +1193,15 @@ private:
 			return realised_->merge_apply(functions, deduplicate);
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> observe(
-			const std::function<bool(const std::any&)>& predicate,
+		[[nodiscard]] ConceptPtr observe(
+			std::function<bool(const std::any&)> predicate,
 			Deduplication deduplicate) const override
 		{
 			ensure_realised();
-			return realised_->observe(predicate, deduplicate);
+			return realised_->observe(std::move(predicate), deduplicate);
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> observe_value(
+		[[nodiscard]] ConceptPtr observe_value(
 			const std::any& value,
 			Deduplication deduplicate) const override
 		{
@@ -745,7 +1209,7 @@ private:
 			return realised_->observe_value(value, deduplicate);
 		}
 
-		[[nodiscard]] std::unique_ptr<Concept> shift_ranks(
+		[[nodiscard]] ConceptPtr shift_ranks(
 			Rank offset,
 			Deduplication deduplicate) const override
 		{
@@ -765,35 +1229,114 @@ private:
 			return realised_->to_any_ranking(deduplicate);
 		}
 
+		[[nodiscard]] ValueCell first_cell() const override
+		{
+			ensure_realised();
+			return realised_->first_cell();
+		}
+
+		[[nodiscard]] ConceptPtr map_cells(
+			CellMap func,
+			Deduplication deduplicate) const override
+		{
+			ensure_realised();
+			return realised_->map_cells(std::move(func), deduplicate);
+		}
+
+		[[nodiscard]] ConceptPtr map_cells_with_rank(
+			CellRankMap func,
+			Deduplication deduplicate) const override
+		{
+			ensure_realised();
+			return realised_->map_cells_with_rank(std::move(func), deduplicate);
+		}
+
+		[[nodiscard]] ConceptPtr map_cells_with_index(
+			CellIndexMap func,
+			Deduplication deduplicate) const override
+		{
+			ensure_realised();
+			return realised_->map_cells_with_index(std::move(func), deduplicate);
+		}
+
+		[[nodiscard]] ConceptPtr filter_cells(
+			CellPredicate predicate,
+			Deduplication deduplicate) const override
+		{
+			ensure_realised();
+			return realised_->filter_cells(std::move(predicate), deduplicate);
+		}
+
+		[[nodiscard]] ConceptPtr observe_cells(
+			CellPredicate predicate,
+			Deduplication deduplicate) const override
+		{
+			ensure_realised();
+			return realised_->observe_cells(std::move(predicate), deduplicate);
+		}
+
+		[[nodiscard]] ConceptPtr observe_cell_value(
+			const ValueCell& value,
+			Deduplication deduplicate) const override
+		{
+			ensure_realised();
+			return realised_->observe_cell_value(value, deduplicate);
+		}
+
+		[[nodiscard]] std::vector<std::pair<ValueCell, Rank>> take_n_cells(std::size_t n) const override
+		{
+			ensure_realised();
+			return realised_->take_n_cells(n);
+		}
+
+		[[nodiscard]] RankingFunction<ValueCell> to_cell_ranking(Deduplication deduplicate) const override
+		{
+			ensure_realised();
+			return realised_->to_cell_ranking(deduplicate);
+		}
+
 	private:
 		void ensure_realised() const
 		{
 			std::call_once(realise_flag_, [this]() {
 				RankingFunctionAny result = thunk_();
 				realised_ = result.impl_;
+				ready_.store(realised_.get(), std::memory_order_release);
 			});
 		}
 
 		std::function<RankingFunctionAny()> thunk_;
 		mutable std::once_flag realise_flag_;
-		mutable std::shared_ptr<const Concept> realised_;
+		mutable ConceptPtr realised_;
+		mutable std::atomic<const Concept*> ready_{nullptr};
 	};
 
-	inline std::shared_ptr<const RankingFunctionAny::Concept> RankingFunctionAny::make_shared(
-		std::unique_ptr<Concept> impl)
+	template<typename U>
+	inline const RankingFunctionAny::Model<U>* RankingFunctionAny::as_model(const Concept& impl)
+	{
+		const Concept* resolved = &impl;
+		while (resolved && resolved->tag == &detail::deferred_model_tag) {
+			resolved = static_cast<const Deferred*>(resolved)->realised_if_ready();
+		}
+		if (!resolved || resolved->tag != &detail::erased_model_tag<U>) {
+			return nullptr;
+		}
+		return static_cast<const Model<U>*>(resolved);
+	}
+
+	inline const RankingFunctionAny::Concept& RankingFunctionAny::realise(const Concept& impl)
 	{
-		if (!impl) {
-			return empty_impl();
+		const Concept* resolved = &impl;
+		while (resolved->tag == &detail::deferred_model_tag) {
+			resolved = &static_cast<const Deferred*>(resolved)->realised();
 		}
-		return std::shared_ptr<const Concept>(std::move(impl));
+		return *resolved;
 	}
 
-	inline std::shared_ptr<const RankingFunctionAny::Concept> RankingFunctionAny::empty_impl()
+	inline RankingFunctionAny::ConceptPtr RankingFunctionAny::empty_impl()
 	{
-		static const std::shared_ptr<const Concept> empty = [] {
-			auto ptr = std::make_shared<Model<std::any>>(RankingFunction<std::any>());
-			return std::static_pointer_cast<const Concept>(ptr);
-		}();
+		// Not pooled: the shared empty model must not pin whichever pool is current.
+		static const ConceptPtr empty = std::make_shared<Model<std::any>>(RankingFunction<std::any>());
 		return empty;
 	}
 
@@ -821,52 +1364,52 @@ inline RankingFunctionAny RankingFunctionAny::map(
 	const std::function<std::any(const std::any&)>& func,
 	Deduplication deduplicate) const
 {
-	return RankingFunctionAny{make_shared(impl_->map(func, deduplicate))};
+	return RankingFunctionAny{impl_->map(func, deduplicate)};
 }
 
 inline RankingFunctionAny RankingFunctionAny::map_with_rank(
 	const std::function<std::pair<std::any, Rank>(const std::any&, Rank)>& func,
 	Deduplication deduplicate) const
 {
-	return RankingFunctionAny{make_shared(impl_->map_with_rank(func, deduplicate))};
+	return RankingFunctionAny{impl_->map_with_rank(func, deduplicate)};
 }
 
 inline RankingFunctionAny RankingFunctionAny::map_with_index(
 	const std::function<std::any(const std::any&, std::size_t)>& func,
 	Deduplication deduplicate) const
 {
-	return RankingFunctionAny{make_shared(impl_->map_with_index(func, deduplicate))};
+	return RankingFunctionAny{impl_->map_with_index(func, deduplicate)};
 }
 
 inline RankingFunctionAny RankingFunctionAny::filter(
 	const std::function<bool(const std::any&)>& predicate,
 	Deduplication deduplicate) const
 {
-	return RankingFunctionAny{make_shared(impl_->filter(predicate, deduplicate))};
+	return RankingFunctionAny{impl_->filter(predicate, deduplicate)};
 }
 
 inline RankingFunctionAny RankingFunctionAny::take(std::size_t n) const
 {
-	return RankingFunctionAny{make_shared(impl_->take(n))};
+	return RankingFunctionAny{impl_->take(n)};
 }
 
 inline RankingFunctionAny RankingFunctionAny::take_while_rank(Rank max_rank) const
 {
-	return RankingFunctionAny{make_shared(impl_->take_while_rank(max_rank))};
+	return RankingFunctionAny{impl_->take_while_rank(max_rank)};
 }
 
 inline RankingFunctionAny RankingFunctionAny::merge(
 	const RankingFunctionAny& other,
 	Deduplication deduplicate) const
 {
-	return RankingFunctionAny{make_shared(impl_->merge(*other.impl_, deduplicate))};
+	return RankingFunctionAny{impl_->merge(*other.impl_, deduplicate)};
 }
 
 inline RankingFunctionAny RankingFunctionAny::shift_ranks(
 	Rank offset,
 	Deduplication deduplicate) const
 {
-	return RankingFunctionAny{make_shared(impl_->shift_ranks(std::move(offset), deduplicate))};
+	return RankingFunctionAny{impl_->shift_ranks(std::move(offset), deduplicate)};
 }
 
 inline RankingFunctionAny RankingFunctionAny::merge_all(
@@ -877,6 +1420,19 @@ inline RankingFunctionAny RankingFunctionAny::merge_all(
 		return RankingFunctionAny{};
 	}
 
+	const bool all_cells = std::all_of(rankings.begin(), rankings.end(), [](const RankingFunctionAny& rf) {
+		return as_model<ValueCell>(*rf.impl_) != nullptr;
+	});
+	if (all_cells) {
+		std::vector<RankingFunction<ValueCell>> cells;
+		cells.reserve(rankings.size());
+		for (const auto& rf : rankings) {
+			cells.emplace_back(rf.to_cell_ranking(deduplicate));
+		}
+		auto merged = ranked_belief::merge_all(cells, deduplicate);
+		return RankingFunctionAny{make_model<ValueCell>(std::move(merged))};
+	}
+
 	std::vector<RankingFunction<std::any>> as_any;
 	as_any.reserve(rankings.size());
 	for (const auto& rf : rankings) {
@@ -884,28 +1440,35 @@ inline RankingFunctionAny RankingFunctionAny::merge_all(
 	}
 
 	auto merged = ranked_belief::merge_all(as_any, deduplicate);
-	return RankingFunctionAny{make_shared(std::make_unique<Model<std::any>>(std::move(merged)))};
+	return RankingFunctionAny{make_model<std::any>(std::move(merged))};
 }
 
 inline RankingFunctionAny RankingFunctionAny::merge_apply(
 	const RankingFunctionAny& functions,
 	Deduplication deduplicate) const
 {
-	return RankingFunctionAny{make_shared(impl_->merge_apply(*functions.impl_, deduplicate))};
+	return RankingFunctionAny{impl_->merge_apply(*functions.impl_, deduplicate)};
 }
 
 inline RankingFunctionAny RankingFunctionAny::observe(
 	const std::function<bool(const std::any&)>& predicate,
 	Deduplication deduplicate) const
 {
-	return RankingFunctionAny{make_shared(impl_->observe(predicate, deduplicate))};
+	return RankingFunctionAny{impl_->observe(predicate, deduplicate)};
 }
 
 inline RankingFunctionAny RankingFunctionAny::observe_value(
 	const std::any& value,
 	Deduplication deduplicate) const
 {
-	return RankingFunctionAny{make_shared(impl_->observe_value(value, deduplicate))};
+	return RankingFunctionAny{impl_->observe_value(value, deduplicate)};
+}
+
+inline RankingFunctionAny RankingFunctionAny::observe_value(
+	const ValueCell& value,
+	Deduplication deduplicate) const
+{
+	return RankingFunctionAny{impl_->observe_cell_value(value, deduplicate)};
 }
 
 inline std::vector<std::pair<std::any, Rank>> RankingFunctionAny::take_n(std::size_t n) const
@@ -913,17 +1476,32 @@ inline std::vector<std::pair<std::any, Rank>> RankingFunctionAny::take_n(std::si
 	return impl_->take_n(n);
 }
 
+inline ValueCell RankingFunctionAny::first_cell() const
+{
+	return impl_->first_cell();
+}
+
+inline std::vector<std::pair<ValueCell, Rank>> RankingFunctionAny::take_n_cells(std::size_t n) const
+{
+	return impl_->take_n_cells(n);
+}
+
 inline RankingFunction<std::any> RankingFunctionAny::to_any_ranking(Deduplication deduplicate) const
 {
 	return impl_->to_any_ranking(deduplicate);
 }
 
+inline RankingFunction<ValueCell> RankingFunctionAny::to_cell_ranking(Deduplication deduplicate) const
+{
+	return impl_->to_cell_ranking(deduplicate);
+}
+
 inline RankingFunctionAny RankingFunctionAny::defer(std::function<RankingFunctionAny()> thunk)
 {
 	if (!thunk) {
 		throw std::invalid_argument{"RankingFunctionAny::defer requires a callable thunk"};
 	}
-	return RankingFunctionAny{make_shared(std::make_unique<Deferred>(std::move(thunk)))};
+	return RankingFunctionAny{allocate_pooled<Deferred>(current_node_pool(), std::move(thunk))};
 }
 
 inline RankingFunctionAny normal_exceptional_any(
@@ -946,5 +1524,5 @@ inline RankingFunctionAny normal_exceptional_any(
  return RankingFunctionAny{std::move(result)};
 }
 
-} // namespace ranked_belief
+} // namespace ranked_belief::inline RANKED_BELIEF_ABI
 
@@ -15,9 +15,11 @@
 #ifndef RANKED_BELIEF_TYPES_HPP
 #define RANKED_BELIEF_TYPES_HPP
 
+#include "abi.hpp"
+
 #include <type_traits>
 
-namespace ranked_belief {
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
 
 /**
  * @enum Deduplication
@@ -73,6 +75,52 @@ enum class Deduplication : bool {
     return enable ? Deduplication::Enabled : Deduplication::Disabled;
 }
 
+/**
+ * @enum RankOverflow
+ * @brief Controls how rank-shifting operations handle finite overflow.
+ *
+ * Checked addition throws std::overflow_error when a shifted rank would exceed
+ * Rank::max_finite_value(). Saturating addition clamps instead, which keeps
+ * the hot shift path free of exception handling.
+ *
+ * Example:
+ * @code
+ * auto shifted = shift_ranks(rf, offset, RankOverflow::Saturate);
+ * @endcode
+ */
+enum class RankOverflow : bool {
+    Throw = true,     ///< Throw std::overflow_error (default)
+    Saturate = false  ///< Clamp to Rank::max_finite_value()
+};
+
+/**
+ * @enum TopKTies
+ * @brief Controls whether a top-k query returns every element tied at the k-th rank.
+ *
+ * Example:
+ * @code
+ * auto best = top_k(rf, 10, TopKTies::Include);  // may return more than 10
+ * @endcode
+ */
+enum class TopKTies : bool {
+    Exclude = false,  ///< Stop after exactly k elements (default)
+    Include = true    ///< Also return the elements sharing the k-th element's rank
+};
+
+/**
+ * @enum PrefetchValues
+ * @brief Controls whether prefetch() also forces the values of the elements it reads ahead.
+ *
+ * Example:
+ * @code
+ * auto ahead = prefetch(rf, 8, default_executor(), PrefetchValues::Disabled);
+ * @endcode
+ */
+enum class PrefetchValues : bool {
+    Enabled = true,   ///< Force values on the executor too (default)
+    Disabled = false  ///< Only force the lazy tails
+};
+
 /**
  * @enum EvaluationStrategy
  * @brief Controls when computations are evaluated.
@@ -89,6 +137,6 @@ enum class EvaluationStrategy : bool {
     Eager = false  ///< Evaluate immediately (reserved for future use)
 };
 
-}  // namespace ranked_belief
+}  // namespace ranked_belief::inline RANKED_BELIEF_ABI
 
 #endif  // RANKED_BELIEF_TYPES_HPP
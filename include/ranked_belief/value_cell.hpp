@@ -0,0 +1,516 @@
+/**
+ * @file value_cell.hpp
+ * @brief Small-buffer type-erased value used on the `RankingFunctionAny` path.
+ *
+ * A `ValueCell` holds one value of any copyable type. Scalars and strings are
+ * stored inline; other payloads live in a reference-counted block, so copying
+ * a cell shares the payload instead of copying it. A cell can also borrow a
+ * value it does not own, which lets the type-erased ranking hand elements to
+ * callbacks without copying them.
+ *
+ * Every cell points at a per-type operations table that caches the type id
+ * and the equality and hash functions, so comparing and hashing cells needs
+ * no registry lookup.
+ */
+
+#pragma once
+
+#include "ranked_belief/detail/any_equality_registry.hpp"
+
+#include <any>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+namespace ranked_belief::inline RANKED_BELIEF_ABI {
+
+/**
+ * @brief Whether `ValueCell` keeps values of type @p T in its inline buffer.
+ *
+ * Only types that also fit the buffer and are nothrow movable are stored
+ * inline. The default covers trivially copyable types and `std::string`;
+ * specialise it for small handle types whose copies are cheap.
+ */
+template<typename T>
+inline constexpr bool value_cell_inline =
+	std::is_trivially_copyable_v<T> || std::is_same_v<T, std::string>;
+
+namespace detail {
+
+inline constexpr std::size_t kValueCellCapacity = 32;
+inline constexpr std::size_t kValueCellAlignment = alignof(std::max_align_t);
+
+template<typename T>
+inline constexpr bool stored_inline = value_cell_inline<T>
+	&& sizeof(T) <= kValueCellCapacity
+	&& alignof(T) <= kValueCellAlignment
+	&& std::is_nothrow_move_constructible_v<T>;
+
+/// Reference count at the start of every shared payload block.
+struct SharedValueHeader {
+	std::atomic<std::size_t> references{1};
+};
+
+template<typename T>
+struct SharedValue final : SharedValueHeader {
+	template<typename... Args>
+	explicit SharedValue(Args&&... args)
+		: value(std::forward<Args>(args)...) {}
+
+	T value;
+};
+
+/// A value held outside the cell: shared (with its block) or borrowed.
+struct ValueReference {
+	const void* value;
+	SharedValueHeader* block;
+};
+
+/**
+ * @brief Operations on one value type, shared by every cell holding it.
+ *
+ * `copy`, `relocate` and `destroy` act on inline storage; `share` copies a
+ * value into a new shared block. `equal` is nullptr for types without
+ * operator==, whose cells only compare equal when both are empty.
+ */
+struct ValueCellOps {
+	const std::type_info* type;
+	bool stored_inline;
+	void (*copy)(void* storage, const void* value);
+	void (*relocate)(void* storage, void* value) noexcept;
+	void (*destroy)(void* storage) noexcept;
+	ValueReference (*share)(const void* value);
+	void (*release)(SharedValueHeader* block) noexcept;
+	bool (*equal)(const void* lhs, const void* rhs);
+	std::size_t (*hash)(const void* value);
+	std::any (*to_any)(const void* value);
+};
+
+template<typename T>
+void copy_cell_value(void* storage, const void* value)
+{
+	::new (storage) T(*static_cast<const T*>(value));
+}
+
+template<typename T>
+void relocate_cell_value(void* storage, void* value) noexcept
+{
+	auto* source = static_cast<T*>(value);
+	::new (storage) T(std::move(*source));
+	source->~T();
+}
+
+template<typename T>
+void destroy_cell_value(void* storage) noexcept
+{
+	static_cast<T*>(storage)->~T();
+}
+
+template<typename T>
+ValueReference share_cell_value(const void* value)
+{
+	auto* block = new SharedValue<T>(*static_cast<const T*>(value));
+	return {&block->value, block};
+}
+
+template<typename T>
+void release_cell_value(SharedValueHeader* block) noexcept
+{
+	delete static_cast<SharedValue<T>*>(block);
+}
+
+template<typename T>
+bool cell_values_equal(const void* lhs, const void* rhs)
+{
+	if constexpr (std::is_same_v<T, std::any>) {
+		return any_values_equal(*static_cast<const std::any*>(lhs), *static_cast<const std::any*>(rhs));
+	} else {
+		return static_cast<bool>(*static_cast<const T*>(lhs) == *static_cast<const T*>(rhs));
+	}
+}
+
+template<typename T>
+std::size_t hash_cell_value(const void* value)
+{
+	if constexpr (std::is_same_v<T, std::any>) {
+		// std::any equality needs equal types, so the contained type is a valid hash.
+		return static_cast<const std::any*>(value)->type().hash_code();
+	} else if constexpr (requires(const T& v) { { std::hash<T>{}(v) } -> std::convertible_to<std::size_t>; }) {
+		return std::hash<T>{}(*static_cast<const T*>(value));
+	} else {
+		return typeid(T).hash_code();
+	}
+}
+
+template<typename T>
+std::any cell_value_to_any(const void* value)
+{
+	if constexpr (std::is_same_v<T, std::any>) {
+		return *static_cast<const std::any*>(value);
+	} else {
+		return std::any{*static_cast<const T*>(value)};
+	}
+}
+
+template<typename T>
+constexpr bool (*cell_equality() noexcept)(const void*, const void*)
+{
+	if constexpr (std::is_same_v<T, std::any> || std::equality_comparable<T>) {
+		return &cell_values_equal<T>;
+	} else {
+		return nullptr;
+	}
+}
+
+template<typename T>
+[[nodiscard]] const ValueCellOps& value_cell_ops() noexcept
+{
+	static const ValueCellOps ops{
+		&typeid(T),
+		stored_inline<T>,
+		&copy_cell_value<T>,
+		&relocate_cell_value<T>,
+		&destroy_cell_value<T>,
+		&share_cell_value<T>,
+		&release_cell_value<T>,
+		cell_equality<T>(),
+		&hash_cell_value<T>,
+		&cell_value_to_any<T>};
+	return ops;
+}
+
+} // namespace detail
+
+/**
+ * @brief Type-erased value with inline storage, shared payloads and borrowing.
+ *
+ * Values that satisfy `value_cell_inline` and fit in 32 bytes are stored
+ * inline and copied with the cell. Other values are moved into a
+ * reference-counted block when the cell is built; copies of the cell share
+ * the block and never copy the value again.
+ *
+ * `borrow()` makes a cell that refers to a value owned elsewhere. Copying a
+ * borrowed cell copies the value once, into an owning cell; moving it keeps
+ * the borrow, so a borrowed cell must not outlive the value it refers to.
+ *
+ * Cells built from (or borrowing) a `std::any` unwrap the built-in types that
+ * the any-equality registry knows (`bool`, integers, floating point,
+ * `std::string`, `std::nullptr_t`); other payloads are kept as a `std::any`
+ * and report `typeid(std::any)`.
+ *
+ * Two cells are equal when they hold the same type and the type's
+ * operator== says so; types without operator== never compare equal.
+ */
+class ValueCell {
+public:
+	/// Where the value of a cell lives.
+	enum class Storage : unsigned char {
+		Empty,    ///< No value
+		Inline,   ///< In the cell's own buffer
+		Shared,   ///< In a reference-counted block
+		Borrowed  ///< Owned by someone else
+	};
+
+	/** @brief Construct an empty cell. */
+	ValueCell() noexcept {}
+
+	/**
+	 * @brief Construct a cell owning @p value.
+	 *
+	 * Rvalues are moved into the cell, so building a cell copies nothing.
+	 */
+	template<typename T>
+		requires(!std::same_as<std::remove_cvref_t<T>, ValueCell>
+			&& std::copy_constructible<std::decay_t<T>>)
+	explicit ValueCell(T&& value)
+	{
+		using U = std::decay_t<T>;
+		if constexpr (std::is_same_v<U, std::any>) {
+			if (value.has_value() && !adopt_builtin(std::forward<T>(value))) {
+				emplace<std::any>(std::forward<T>(value));
+			}
+		} else {
+			emplace<U>(std::forward<T>(value));
+		}
+	}
+
+	ValueCell(const ValueCell& other)
+	{
+		copy_from(other);
+	}
+
+	ValueCell(ValueCell&& other) noexcept
+	{
+		move_from(other);
+	}
+
+	ValueCell& operator=(const ValueCell& other)
+	{
+		if (this != &other) {
+			ValueCell copy{other};
+			reset();
+			move_from(copy);
+		}
+		return *this;
+	}
+
+	ValueCell& operator=(ValueCell&& other) noexcept
+	{
+		if (this != &other) {
+			reset();
+			move_from(other);
+		}
+		return *this;
+	}
+
+	~ValueCell()
+	{
+		reset();
+	}
+
+	/**
+	 * @brief Borrow @p value without copying it.
+	 *
+	 * Borrowing a cell borrows its payload. The result must not outlive
+	 * @p value (or, for a cell, its payload).
+	 */
+	template<typename T>
+	[[nodiscard]] static ValueCell borrow(const T& value) noexcept
+	{
+		ValueCell cell;
+		if constexpr (std::is_same_v<T, ValueCell>) {
+			if (value.has_value()) {
+				cell.set_borrowed(value.ops_, value.data());
+			}
+		} else if constexpr (std::is_same_v<T, std::any>) {
+			if (value.has_value() && !cell.borrow_builtin(value)) {
+				cell.set_borrowed(&detail::value_cell_ops<std::any>(), &value);
+			}
+		} else {
+			cell.set_borrowed(&detail::value_cell_ops<T>(), &value);
+		}
+		return cell;
+	}
+
+	[[nodiscard]] bool has_value() const noexcept
+	{
+		return storage_ != Storage::Empty;
+	}
+
+	[[nodiscard]] Storage storage() const noexcept
+	{
+		return storage_;
+	}
+
+	/// Type of the held value, or `typeid(void)` when empty.
+	[[nodiscard]] const std::type_info& type() const noexcept
+	{
+		return has_value() ? *ops_->type : typeid(void);
+	}
+
+	/// Pointer to the held value if it has type @p T, else nullptr.
+	template<typename T>
+	[[nodiscard]] const T* get_if() const noexcept
+	{
+		if (!has_value()) {
+			return nullptr;
+		}
+		if (ops_ != &detail::value_cell_ops<T>() && *ops_->type != typeid(T)) {
+			return nullptr;
+		}
+		return static_cast<const T*>(data());
+	}
+
+	/**
+	 * @brief The held value as @p T.
+	 *
+	 * @throws std::bad_any_cast if the cell does not hold a @p T.
+	 */
+	template<typename T>
+	[[nodiscard]] const T& get() const
+	{
+		if (const T* value = get_if<T>()) {
+			return *value;
+		}
+		throw std::bad_any_cast();
+	}
+
+	/// Copy of the held value as `std::any` (a `std::any` payload is returned as is).
+	[[nodiscard]] std::any to_any() const
+	{
+		return has_value() ? ops_->to_any(data()) : std::any{};
+	}
+
+	/// Hash consistent with operator==; 0 for an empty cell.
+	[[nodiscard]] std::size_t hash() const
+	{
+		return has_value() ? ops_->hash(data()) : 0;
+	}
+
+	[[nodiscard]] friend bool operator==(const ValueCell& lhs, const ValueCell& rhs)
+	{
+		if (!lhs.has_value() || !rhs.has_value()) {
+			return lhs.has_value() == rhs.has_value();
+		}
+		if (lhs.ops_ != rhs.ops_ && *lhs.ops_->type != *rhs.ops_->type) {
+			return false;
+		}
+		return lhs.ops_->equal != nullptr && lhs.ops_->equal(lhs.data(), rhs.data());
+	}
+
+private:
+	[[nodiscard]] const void* data() const noexcept
+	{
+		return storage_ == Storage::Inline ? static_cast<const void*>(buffer_) : reference_.value;
+	}
+
+	template<typename U, typename... Args>
+	void emplace(Args&&... args)
+	{
+		ops_ = &detail::value_cell_ops<U>();
+		if constexpr (detail::stored_inline<U>) {
+			::new (static_cast<void*>(buffer_)) U(std::forward<Args>(args)...);
+			storage_ = Storage::Inline;
+		} else {
+			auto* block = new detail::SharedValue<U>(std::forward<Args>(args)...);
+			reference_ = {&block->value, block};
+			storage_ = Storage::Shared;
+		}
+	}
+
+	void set_borrowed(const detail::ValueCellOps* ops, const void* value) noexcept
+	{
+		ops_ = ops;
+		reference_ = {value, nullptr};
+		storage_ = Storage::Borrowed;
+	}
+
+	template<typename U, typename Any>
+	bool adopt_as(Any&& value)
+	{
+		auto* typed = std::any_cast<U>(&value);
+		if (!typed) {
+			return false;
+		}
+		if constexpr (std::is_lvalue_reference_v<Any>) {
+			emplace<U>(*typed);
+		} else {
+			emplace<U>(std::move(*typed));
+		}
+		return true;
+	}
+
+	template<typename Any>
+	bool adopt_builtin(Any&& value)
+	{
+		return adopt_as<std::nullptr_t>(std::forward<Any>(value))
+			|| adopt_as<bool>(std::forward<Any>(value))
+			|| adopt_as<int>(std::forward<Any>(value))
+			|| adopt_as<long>(std::forward<Any>(value))
+			|| adopt_as<long long>(std::forward<Any>(value))
+			|| adopt_as<unsigned long>(std::forward<Any>(value))
+			|| adopt_as<unsigned long long>(std::forward<Any>(value))
+			|| adopt_as<float>(std::forward<Any>(value))
+			|| adopt_as<double>(std::forward<Any>(value))
+			|| adopt_as<std::string>(std::forward<Any>(value));
+	}
+
+	template<typename U>
+	bool borrow_as(const std::any& value) noexcept
+	{
+		if (const U* typed = std::any_cast<U>(&value)) {
+			set_borrowed(&detail::value_cell_ops<U>(), typed);
+			return true;
+		}
+		return false;
+	}
+
+	bool borrow_builtin(const std::any& value) noexcept
+	{
+		return borrow_as<std::nullptr_t>(value)
+			|| borrow_as<bool>(value)
+			|| borrow_as<int>(value)
+			|| borrow_as<long>(value)
+			|| borrow_as<long long>(value)
+			|| borrow_as<unsigned long>(value)
+			|| borrow_as<unsigned long long>(value)
+			|| borrow_as<float>(value)
+			|| borrow_as<double>(value)
+			|| borrow_as<std::string>(value);
+	}
+
+	void copy_from(const ValueCell& other)
+	{
+		switch (other.storage_) {
+		case Storage::Empty:
+			return;
+		case Storage::Shared:
+			other.reference_.block->references.fetch_add(1, std::memory_order_relaxed);
+			ops_ = other.ops_;
+			reference_ = other.reference_;
+			storage_ = Storage::Shared;
+			return;
+		case Storage::Inline:
+		case Storage::Borrowed:
+			ops_ = other.ops_;
+			if (ops_->stored_inline) {
+				ops_->copy(buffer_, other.data());
+				storage_ = Storage::Inline;
+			} else {
+				reference_ = ops_->share(other.data());
+				storage_ = Storage::Shared;
+			}
+			return;
+		}
+	}
+
+	void move_from(ValueCell& other) noexcept
+	{
+		ops_ = other.ops_;
+		if (other.storage_ == Storage::Inline) {
+			ops_->relocate(buffer_, other.buffer_);
+		} else if (other.storage_ != Storage::Empty) {
+			reference_ = other.reference_;
+		}
+		storage_ = other.storage_;
+		other.storage_ = Storage::Empty;
+	}
+
+	void reset() noexcept
+	{
+		if (storage_ == Storage::Inline) {
+			ops_->destroy(buffer_);
+		} else if (storage_ == Storage::Shared
+			&& reference_.block->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			ops_->release(reference_.block);
+		}
+		storage_ = Storage::Empty;
+	}
+
+	const detail::ValueCellOps* ops_ = nullptr;
+	Storage storage_ = Storage::Empty;
+	union {
+		detail::ValueReference reference_;
+		alignas(detail::kValueCellAlignment) unsigned char buffer_[detail::kValueCellCapacity];
+	};
+};
+
+} // namespace ranked_belief::inline RANKED_BELIEF_ABI
+
+namespace std {
+
+template<>
+struct hash<ranked_belief::ValueCell> {
+	[[nodiscard]] std::size_t operator()(const ranked_belief::ValueCell& cell) const
+	{
+		return cell.hash();
+	}
+};
+
+} // namespace std
@@ -8,8 +8,10 @@
  * - from_values_sequential: Sequential rank assignment
  * - from_values_with_ranker: Custom rank function
  * - from_generator: Infinite sequences
+ * - from_batch_generator: Batched sequences
  * - from_range: C++20 range conversion
  * - from_pair_range: Range of pairs
+ * - lazy_from_range, lazy_from_pair_range: Ranges read on demand
  * - singleton, empty: Convenience aliases
  */
 
@@ -18,6 +20,7 @@
 #include <map>
 #include <numeric>
 #include <ranges>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -331,6 +334,45 @@ TEST_F(ConstructorsTest, FromGeneratorLazyEvaluation) {
     EXPECT_EQ(computation_count, 2);
 }
 
+TEST_F(ConstructorsTest, FromGeneratorChunked) {
+    int computation_count = 0;
+
+    auto rf = from_generator<int>(
+        [&computation_count](size_t i) {
+            ++computation_count;
+            return std::make_pair(static_cast<int>(i), Rank::from_value(i));
+        },
+        0, Deduplication::Enabled, 8);
+
+    EXPECT_EQ(rf.chunk_size(), 8u);
+    EXPECT_EQ(computation_count, 8);
+
+    std::vector<int> values;
+    for (auto it = rf.begin(); values.size() < 10; ++it) {
+        values.push_back((*it).first);
+    }
+    EXPECT_EQ(values, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    EXPECT_EQ(computation_count, 16);
+}
+
+TEST_F(ConstructorsTest, FromBatchGenerator) {
+    int calls = 0;
+    auto rf = from_batch_generator<int>(
+        [&calls](size_t first, std::vector<std::pair<int, Rank>>& batch) {
+            ++calls;
+            for (size_t i = first; i < first + 4 && i < 10; ++i) {
+                batch.emplace_back(static_cast<int>(i / 2), Rank::from_value(i / 2));
+            }
+        });
+    EXPECT_EQ(calls, 1);
+
+    // Pairs of equal values collapse under deduplication; the empty batch at 10 ends it.
+    std::vector<std::pair<int, Rank>> all(rf.begin(), rf.end());
+    ASSERT_EQ(all.size(), 5u);
+    EXPECT_EQ(all[4], std::make_pair(4, Rank::from_value(4)));
+    EXPECT_EQ(calls, 4);
+}
+
 // ============================================================================
 // from_range Tests
 // ============================================================================
@@ -451,6 +493,57 @@ TEST_F(ConstructorsTest, FromPairRangePreservesRanks) {
     EXPECT_EQ(ranks, (std::vector<uint64_t>{10, 20}));
 }
 
+// ============================================================================
+// lazy_from_range Tests
+// ============================================================================
+
+TEST_F(ConstructorsTest, LazyFromRangeUnbounded) {
+    auto rf = lazy_from_range(std::views::iota(10) | std::views::transform([](int x) { return x * 2; }));
+
+    std::vector<std::pair<int, Rank>> first;
+    for (auto it = rf.begin(); first.size() < 4; ++it) {
+        first.push_back(*it);
+    }
+    EXPECT_EQ(first, (std::vector<std::pair<int, Rank>>{
+        {20, Rank::zero()}, {22, Rank::from_value(1)}, {24, Rank::from_value(2)}, {26, Rank::from_value(3)}}));
+}
+
+TEST_F(ConstructorsTest, LazyFromRangeReadsOnlyTheForcedPrefix) {
+    std::istringstream input("1 2 3 4 5 6");
+    auto rf = lazy_from_range(std::views::istream<int>(input), Rank::from_value(2));
+
+    auto it = rf.begin();
+    EXPECT_EQ(*it, std::make_pair(1, Rank::from_value(2)));
+    ++it;
+    EXPECT_EQ(*it, std::make_pair(2, Rank::from_value(3)));
+    // Forcing the second element read nothing past it.
+    int next = 0;
+    input >> next;
+    EXPECT_EQ(next, 3);
+}
+
+TEST_F(ConstructorsTest, LazyFromRangeChunksAndEnds) {
+    std::vector<std::string> words = {"a", "b", "c", "d", "e"};
+    auto rf = lazy_from_range(words, Rank::zero(), Deduplication::Enabled, 2);
+    EXPECT_EQ(rf.chunk_size(), 2u);
+
+    std::vector<std::string> values;
+    for (auto [value, rank] : rf) {
+        values.push_back(value);
+    }
+    EXPECT_EQ(values, words);
+    EXPECT_TRUE(lazy_from_range(std::vector<int>{}).is_empty());
+}
+
+TEST_F(ConstructorsTest, LazyFromPairRangeOwnsRvalueRanges) {
+    auto rf = lazy_from_pair_range(std::map<int, Rank>{
+        {1, Rank::zero()}, {2, Rank::from_value(1)}, {3, Rank::from_value(4)}});
+
+    std::vector<std::pair<int, Rank>> all(rf.begin(), rf.end());
+    EXPECT_EQ(all, (std::vector<std::pair<int, Rank>>{
+        {1, Rank::zero()}, {2, Rank::from_value(1)}, {3, Rank::from_value(4)}}));
+}
+
 // ============================================================================
 // Convenience Alias Tests
 // ============================================================================
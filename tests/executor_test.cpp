@@ -0,0 +1,155 @@
+/**
+ * @file executor_test.cpp
+ * @brief Tests for executors (WorkStealingPool, default_executor) and prefetch().
+ */
+
+#include "ranked_belief/executor.hpp"
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/operations/map.hpp"
+#include "ranked_belief/operations/merge_apply.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+#include "ranked_belief/operations/prefetch.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace ranked_belief;
+
+namespace {
+
+constexpr bool kSingleThreaded = std::is_same_v<DefaultPromisePolicy, SingleThreadedPolicy>;
+
+/// Poll @p condition for up to a few seconds.
+template<typename Condition>
+bool eventually(Condition condition) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+RankingFunction<int> naturals() {
+    return from_generator<int>([](std::size_t i) {
+        return std::make_pair(static_cast<int>(i), Rank::from_value(i));
+    });
+}
+
+}  // namespace
+
+TEST(ExecutorTest, PoolRunsEverySubmittedTask) {
+    std::atomic<int> ran{0};
+    {
+        WorkStealingPool pool(4);
+        EXPECT_EQ(pool.size(), 4u);
+        for (int i = 0; i < 1000; ++i) {
+            pool.submit(Executor::Task([&ran]() { ran.fetch_add(1); }));
+        }
+    }  // the destructor drains the queues
+    EXPECT_EQ(ran.load(), 1000);
+}
+
+TEST(ExecutorTest, TasksMaySubmitFollowUpWork) {
+    std::atomic<int> ran{0};
+    {
+        WorkStealingPool pool(2);
+        for (int i = 0; i < 10; ++i) {
+            pool.submit(Executor::Task([&pool, &ran]() {
+                for (int j = 0; j < 10; ++j) {
+                    pool.submit(Executor::Task([&ran]() { ran.fetch_add(1); }));
+                }
+            }));
+        }
+        EXPECT_TRUE(eventually([&ran]() { return ran.load() == 100; }));
+    }
+    EXPECT_EQ(ran.load(), 100);
+}
+
+TEST(ExecutorTest, ThrowingTaskDoesNotStopPool) {
+    std::atomic<int> ran{0};
+    {
+        WorkStealingPool pool(1);
+        pool.submit(Executor::Task([]() { throw std::runtime_error("task"); }));
+        pool.submit(Executor::Task([&ran]() { ran.fetch_add(1); }));
+    }
+    EXPECT_EQ(ran.load(), 1);
+}
+
+TEST(ExecutorTest, DefaultExecutorCanBeReplaced) {
+    auto inline_executor = std::make_shared<InlineExecutor>();
+    auto previous = set_default_executor(inline_executor);
+    EXPECT_EQ(default_executor(), inline_executor);
+
+    bool ran = false;
+    default_executor()->submit(Executor::Task([&ran]() { ran = true; }));
+    EXPECT_TRUE(ran);
+
+    set_default_executor(previous);
+    EXPECT_NE(default_executor(), nullptr);
+}
+
+TEST(PrefetchTest, PreservesElements) {
+    auto rf = shift_ranks(from_values_sequential<int>({1, 1, 2, 3}), Rank::from_value(2));
+    auto pool = std::make_shared<WorkStealingPool>(2);
+
+    auto ahead = prefetch(rf, 2, pool);
+    EXPECT_EQ(take_n(ahead, 10), take_n(rf, 10));
+    EXPECT_EQ(ahead.rank_offset(), rf.rank_offset());
+    EXPECT_TRUE(prefetch(RankingFunction<int>(), 4, pool).is_empty());
+}
+
+TEST(PrefetchTest, ForcesAheadOfConsumer) {
+    if constexpr (kSingleThreaded) {
+        GTEST_SKIP() << "prefetch() is a no-op with unsynchronised promises";
+    }
+    std::atomic<int> computed{0};
+    auto mapped = map(naturals(), [&computed](int x) {
+        computed.fetch_add(1);
+        return x * 2;
+    });
+
+    auto ahead = prefetch(mapped, 4, std::make_shared<WorkStealingPool>(2));
+    EXPECT_EQ(ahead.first()->first, 0);
+    // The head plus four elements ahead of it are computed off this thread.
+    EXPECT_TRUE(eventually([&computed]() { return computed.load() == 5; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(computed.load(), 5);
+}
+
+TEST(PrefetchTest, ComputesEachValueOnce) {
+    std::atomic<int> computed{0};
+    auto mapped = map(from_values_sequential<int>({1, 2, 3, 4, 5, 6, 7, 8}), [&computed](int x) {
+        computed.fetch_add(1);
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        return x + 100;
+    });
+
+    auto values = take_n(prefetch(mapped, 3, std::make_shared<WorkStealingPool>(3)), 100);
+    ASSERT_EQ(values.size(), 8u);
+    EXPECT_EQ(values.back().first, 108);
+    EXPECT_EQ(computed.load(), 8);
+}
+
+TEST(PrefetchTest, RethrowsCallbackErrorsToConsumer) {
+    auto failing = map(from_values_sequential<int>({1, 2, 3}), [](int x) {
+        if (x == 2) {
+            throw std::runtime_error("bad value");
+        }
+        return x;
+    });
+
+    auto ahead = prefetch(failing, 2, std::make_shared<WorkStealingPool>(1));
+    EXPECT_EQ(ahead.first()->first, 1);
+    EXPECT_THROW((void)take_n(ahead, 10), std::runtime_error);
+}
@@ -1,10 +1,14 @@
 #include <gtest/gtest.h>
 
 #include "ranked_belief/constructors.hpp"
+#include "ranked_belief/operations/filter.hpp"
 #include "ranked_belief/operations/map.hpp"
+#include "ranked_belief/operations/merge.hpp"
 #include "ranked_belief/operations/merge_apply.hpp"
 #include "ranked_belief/operations/nrm_exc.hpp"
 #include "ranked_belief/operations/observe.hpp"
+#include "ranked_belief/operations/top_k.hpp"
+#include "ranked_belief/operations/views.hpp"
 #include "ranked_belief/promise.hpp"
 #include "ranked_belief/rank.hpp"
 #include "ranked_belief/ranking_element.hpp"
@@ -14,6 +18,7 @@
 #include <initializer_list>
 #include <memory>
 #include <optional>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -278,3 +283,41 @@ TEST(IntegrationTest, FibonacciSequenceRespectsLazyGeneration) {
     EXPECT_EQ(first_ten[9].first, first_ten[8].first + first_ten[7].first);
     EXPECT_EQ(first_ten[9].second, Rank::from_value(9));
 }
+
+TEST(IntegrationTest, ExplicitPromisePolicyFlowsThroughPipeline) {
+    // The policy DefaultPromisePolicy does not select, so the pipeline below
+    // never touches a default-policy ranking.
+    using OtherPolicy = std::conditional_t<std::is_same_v<ranked_belief::DefaultPromisePolicy,
+                                                          ranked_belief::ThreadSafePolicy>,
+                                           ranked_belief::SingleThreadedPolicy,
+                                           ranked_belief::ThreadSafePolicy>;
+    using Ranking = RankingFunction<int, OtherPolicy>;
+
+    auto base = ranked_belief::from_list<int, OtherPolicy>(
+        {{1, Rank::zero()}, {2, Rank::from_value(1)}, {3, Rank::from_value(2)}});
+    static_assert(std::is_same_v<decltype(base), Ranking>);
+
+    auto doubled = ranked_belief::map(base, [](int x) { return x * 2; });
+    auto evens = ranked_belief::filter(doubled, [](int x) { return x != 4; });
+    auto merged = ranked_belief::merge(evens, ranked_belief::singleton<int, OtherPolicy>(5, Rank::from_value(1)));
+    auto expanded = ranked_belief::merge_apply(merged, [](int x) {
+        return ranked_belief::from_list<int, OtherPolicy>({{x, Rank::zero()}, {-x, Rank::from_value(1)}});
+    });
+    auto observed = ranked_belief::observe(expanded, [](int x) { return x > 0; });
+    auto defaulted = ranked_belief::normal_exceptional(observed, [] {
+        return ranked_belief::singleton<int, OtherPolicy>(0);
+    });
+    Ranking fused = defaulted | ranked_belief::views::take(3);
+
+    static_assert(std::is_same_v<decltype(doubled), Ranking>);
+    static_assert(std::is_same_v<decltype(evens), Ranking>);
+    static_assert(std::is_same_v<decltype(merged), Ranking>);
+    static_assert(std::is_same_v<decltype(expanded), Ranking>);
+    static_assert(std::is_same_v<decltype(observed), Ranking>);
+    static_assert(std::is_same_v<decltype(defaulted), Ranking>);
+
+    const auto best = ranked_belief::top_k(fused, 3);
+    const std::vector<std::pair<int, Rank>> expected{
+        {2, Rank::zero()}, {5, Rank::from_value(1)}, {0, Rank::from_value(1)}};
+    EXPECT_EQ(best, expected);
+}
@@ -0,0 +1,174 @@
+/**
+ * @file intern_test.cpp
+ * @brief Tests for InternTable and InternScope.
+ *
+ * Tests cover:
+ * - Equal content mapping to one canonical ranking, deduplication included
+ * - Element lists and existing rankings sharing keys on their raw nodes
+ * - Results of take and map_with_index unchanged inside a scope
+ * - Interning existing rankings only once their structure is forced
+ * - from_list and singleton returning canonical rankings inside a scope
+ * - merge taking its shared-node shortcut on interned operands
+ * - Continuations forced outside the scope, or on workers, still interning
+ */
+
+#include "ranked_belief/intern.hpp"
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/operations/filter.hpp"
+#include "ranked_belief/operations/map.hpp"
+#include "ranked_belief/operations/merge.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+#include "ranked_belief/operations/parallel_merge_apply.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace ranked_belief;
+
+namespace {
+
+std::vector<std::pair<bool, Rank>> normal_true() {
+    return {{true, Rank::zero()}, {false, Rank::from_value(1)}};
+}
+
+}  // namespace
+
+TEST(InternTest, EqualContentSharesOneRanking) {
+    InternTable<bool> table;
+    const auto a = table.intern(normal_true());
+    const auto b = table.intern(normal_true());
+    const auto flipped = table.intern({{false, Rank::zero()}, {true, Rank::from_value(1)}});
+
+    EXPECT_EQ(a.raw_head(), b.raw_head());
+    EXPECT_NE(a.raw_head(), flipped.raw_head());
+    EXPECT_EQ(take_n(a, 3), normal_true());
+    EXPECT_EQ(table.size(), 2u);
+    EXPECT_EQ(table.hits(), 1u);
+
+    table.clear();
+    EXPECT_EQ(table.size(), 0u);
+    EXPECT_NE(table.intern(normal_true()).raw_head(), a.raw_head());
+}
+
+TEST(InternTest, DeduplicationIsPartOfTheContent) {
+    InternTable<std::string> table;
+    const std::vector<std::pair<std::string, Rank>> twice{{"a", Rank::zero()}, {"a", Rank::from_value(1)}};
+    const auto deduplicated = table.intern(twice, Deduplication::Enabled);
+    const auto kept = table.intern(twice, Deduplication::Disabled);
+
+    EXPECT_NE(deduplicated.raw_head(), kept.raw_head());
+    EXPECT_EQ(take_n(deduplicated, 3).size(), 1u);
+    EXPECT_EQ(take_n(kept, 3).size(), 2u);
+}
+
+TEST(InternTest, ElementsAndRankingsShareKeysOnRawNodes) {
+    InternTable<int> table;
+    const auto listed = table.intern({{1, Rank::zero()}, {1, Rank::zero()}}, Deduplication::Enabled);
+    const auto existing = RankingFunction<int>(
+        make_element(1, Rank::zero(), make_terminal(1, Rank::zero())), Deduplication::Enabled);
+
+    EXPECT_EQ(table.intern(existing).raw_head(), listed.raw_head());
+    EXPECT_NE(table.intern({{1, Rank::zero()}}, Deduplication::Enabled).raw_head(), listed.raw_head());
+    EXPECT_EQ(table.size(), 2u);
+}
+
+TEST(InternTest, ScopeDoesNotChangeResults) {
+    const std::vector<std::pair<int, Rank>> pairs{
+        {1, Rank::zero()}, {1, Rank::zero()}, {2, Rank::from_value(1)}};
+    const auto run = [&pairs] {
+        const auto rf = from_list<int>(pairs);
+        auto indexed = map_with_index(rf, [](int x, std::size_t i) {
+            return x * 10 + static_cast<int>(i);
+        });
+        return std::make_pair(take_n(take(rf, 2), 5), take_n(indexed, 5));
+    };
+
+    const auto plain = run();
+    InternScope scope(std::make_shared<InternTable<int>>());
+    EXPECT_EQ(run(), plain);
+    EXPECT_EQ(plain.first, (std::vector<std::pair<int, Rank>>{{1, Rank::zero()}}));
+}
+
+TEST(InternTest, ExistingRankingsAreInternedOnceForced) {
+    InternTable<int> table;
+    const auto canonical = table.intern({{2, Rank::zero()}, {4, Rank::from_value(1)}}, Deduplication::Disabled);
+    const auto doubled = map(from_list<int>({{1, Rank::zero()}, {2, Rank::from_value(1)}}, Deduplication::Disabled),
+                             [](int x) { return x * 2; }, Deduplication::Disabled);
+
+    // The lazy tail is left unforced and the ranking returned as is.
+    EXPECT_EQ(table.intern(doubled).raw_head(), doubled.raw_head());
+
+    (void)take_n(doubled, 3);
+    EXPECT_EQ(table.intern(doubled).raw_head(), canonical.raw_head());
+    EXPECT_EQ(table.hits(), 1u);
+}
+
+TEST(InternTest, ScopeInternsFromListAndSingleton) {
+    auto table = std::make_shared<InternTable<bool>>();
+    std::shared_ptr<RankingElement<bool>> scoped_head;
+    {
+        InternScope scope(table);
+        EXPECT_EQ(current_intern_table<bool>(), table);
+        const auto a = from_list<bool>(normal_true(), Deduplication::Disabled);
+        const auto b = from_list<bool>(normal_true(), Deduplication::Disabled);
+        EXPECT_EQ(a.raw_head(), b.raw_head());
+        EXPECT_EQ(singleton(true).raw_head(), singleton(true).raw_head());
+        scoped_head = a.raw_head();
+
+        InternScope disabled(std::shared_ptr<InternTable<bool>>{});
+        EXPECT_NE(from_list<bool>(normal_true(), Deduplication::Disabled).raw_head(), scoped_head);
+    }
+    EXPECT_EQ(current_intern_table<bool>(), nullptr);
+    EXPECT_NE(from_list<bool>(normal_true(), Deduplication::Disabled).raw_head(), scoped_head);
+    EXPECT_EQ(table->size(), 2u);
+}
+
+TEST(InternTest, MergeOfInternedRankingsSharesNodes) {
+    InternScope scope(std::make_shared<InternTable<bool>>());
+    const auto a = from_list<bool>(normal_true(), Deduplication::Disabled);
+    const auto b = from_list<bool>(normal_true(), Deduplication::Disabled);
+
+    const auto merged = merge(a, b, Deduplication::Enabled);
+    EXPECT_EQ(merged.raw_head(), a.raw_head());
+    EXPECT_EQ(take_n(merged, 3), normal_true());
+
+    // Without deduplication both copies of every element are still kept.
+    EXPECT_EQ(take_n(merge(a, b, Deduplication::Disabled), 5).size(), 4u);
+}
+
+TEST(InternTest, ContinuationsForcedOutsideScopeStillIntern) {
+    auto table = std::make_shared<InternTable<bool>>();
+    const auto inputs = from_values_sequential<int>({0, 1, 2});
+    const auto continuation = [](int) { return from_list<bool>(normal_true(), Deduplication::Disabled); };
+    RankingFunction<bool> sequential;
+    RankingFunction<bool> parallel;
+    {
+        InternScope scope(table);
+        sequential = merge_apply(inputs, continuation, Deduplication::Disabled);
+        parallel = parallel_merge_apply(inputs, continuation, std::make_shared<WorkStealingPool>(2), 2,
+                                        Rank::infinity(), Deduplication::Disabled);
+    }
+    EXPECT_EQ(current_intern_table<bool>(), nullptr);
+
+    EXPECT_EQ(take_n(sequential, 10).size(), 6u);
+    EXPECT_EQ(take_n(parallel, 10).size(), 6u);
+    EXPECT_EQ(table->size(), 1u);
+    EXPECT_EQ(table->hits(), 5u);  // Six continuations, one canonical ranking
+}
+
+TEST(InternTest, ScopesForDifferentTypesNest) {
+    auto bools = std::make_shared<InternTable<bool>>();
+    auto ints = std::make_shared<InternTable<int>>();
+    InternScope bool_scope(bools);
+    {
+        InternScope int_scope(ints);
+        EXPECT_EQ(current_intern_table<bool>(), bools);
+        EXPECT_EQ(current_intern_table<int>(), ints);
+    }
+    EXPECT_EQ(current_intern_table<bool>(), bools);
+    EXPECT_EQ(current_intern_table<int>(), nullptr);
+}
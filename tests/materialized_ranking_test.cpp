@@ -0,0 +1,187 @@
+/**
+ * @file materialized_ranking_test.cpp
+ * @brief Tests for the contiguous MaterializedRanking representation.
+ *
+ * Tests cover:
+ * - Construction, validation and deduplication
+ * - Random access and iteration
+ * - Conversion to and from lazy RankingFunction
+ * - take_n, most_normal and observe overloads
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/materialized_ranking.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+#include "ranked_belief/operations/observe.hpp"
+
+#include <gtest/gtest.h>
+
+#include <any>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ranked_belief;
+
+namespace {
+
+MaterializedRanking<int> sample_table() {
+    return MaterializedRanking<int>(
+        {10, 20, 30, 40},
+        {Rank::zero(), Rank::from_value(1), Rank::from_value(1), Rank::from_value(3)});
+}
+
+}  // namespace
+
+static_assert(std::random_access_iterator<MaterializedRanking<int>::iterator>);
+
+TEST(MaterializedRankingTest, DefaultConstructedIsEmpty) {
+    MaterializedRanking<int> table;
+
+    EXPECT_TRUE(table.is_empty());
+    EXPECT_EQ(table.size(), 0u);
+    EXPECT_EQ(table.begin(), table.end());
+    EXPECT_FALSE(table.first().has_value());
+}
+
+TEST(MaterializedRankingTest, RandomAccessReadsParallelArrays) {
+    auto table = sample_table();
+
+    ASSERT_EQ(table.size(), 4u);
+    EXPECT_EQ(table.value(2), 30);
+    EXPECT_EQ(table.rank(3), Rank::from_value(3));
+    EXPECT_EQ(table[1], std::make_pair(20, Rank::from_value(1)));
+    EXPECT_EQ(table.values().size(), 4u);
+    EXPECT_EQ(table.ranks()[0], Rank::zero());
+    EXPECT_THROW((void)table.at(4), std::out_of_range);
+}
+
+TEST(MaterializedRankingTest, IteratorSupportsRandomAccess) {
+    auto table = sample_table();
+
+    auto it = table.begin();
+    EXPECT_EQ(table.end() - it, 4);
+    EXPECT_EQ((*(it + 3)).first, 40);
+    EXPECT_EQ(it[2].first, 30);
+
+    std::vector<int> seen;
+    for (auto [value, rank] : table) {
+        seen.push_back(value);
+    }
+    EXPECT_EQ(seen, (std::vector<int>{10, 20, 30, 40}));
+}
+
+TEST(MaterializedRankingTest, RejectsMismatchedOrDecreasingRanks) {
+    EXPECT_THROW(MaterializedRanking<int>({1, 2}, {Rank::zero()}), std::invalid_argument);
+    EXPECT_THROW(MaterializedRanking<int>({1, 2}, {Rank::from_value(2), Rank::from_value(1)}),
+                 std::invalid_argument);
+}
+
+TEST(MaterializedRankingTest, CollapsesConsecutiveDuplicatesWhenEnabled) {
+    std::vector<std::pair<int, Rank>> pairs{
+        {1, Rank::zero()}, {1, Rank::from_value(1)}, {2, Rank::from_value(2)}, {1, Rank::from_value(3)}};
+
+    MaterializedRanking<int> dedup(pairs);
+    ASSERT_EQ(dedup.size(), 3u);
+    EXPECT_EQ(dedup[1], std::make_pair(2, Rank::from_value(2)));
+
+    MaterializedRanking<int> raw(pairs, Deduplication::Disabled);
+    EXPECT_EQ(raw.size(), 4u);
+    EXPECT_FALSE(raw.is_deduplicating());
+}
+
+TEST(MaterializedRankingTest, CollapsesAnyDuplicatesLikeLazyView) {
+    std::vector<std::pair<std::any, Rank>> pairs{
+        {std::any(1), Rank::zero()}, {std::any(1), Rank::zero()}, {std::any(2), Rank::from_value(1)}};
+
+    MaterializedRanking<std::any> dedup(pairs);
+    ASSERT_EQ(dedup.size(), 2u);
+    EXPECT_EQ(dedup.size(), dedup.to_ranking_function().size());
+    EXPECT_EQ(std::any_cast<int>(dedup.value(1)), 2);
+    EXPECT_EQ(dedup.rank(1), Rank::from_value(1));
+}
+
+TEST(MaterializedRankingTest, StoresBoolValuesContiguously) {
+    MaterializedRanking<bool> table({true, false}, {Rank::zero(), Rank::from_value(2)});
+
+    ASSERT_EQ(table.size(), 2u);
+    EXPECT_TRUE(table.value(0));
+    EXPECT_FALSE(table.value(1));
+    EXPECT_EQ(table.to_ranking_function().size(), 2u);
+}
+
+TEST(MaterializedRankingTest, MaterializeCopiesLazyRanking) {
+    auto rf = from_values_sequential<std::string>({"a", "b", "c"});
+    auto table = materialize(rf);
+
+    ASSERT_EQ(table.size(), 3u);
+    EXPECT_EQ(table.value(2), "c");
+    EXPECT_EQ(table.rank(2), Rank::from_value(2));
+}
+
+TEST(MaterializedRankingTest, MaterializeHonoursLimitOnInfiniteRanking) {
+    auto naturals = from_generator<int>([](std::size_t i) {
+        return std::make_pair(static_cast<int>(i), Rank::from_value(i));
+    });
+
+    auto table = materialize(naturals, 5);
+    ASSERT_EQ(table.size(), 5u);
+    EXPECT_EQ(table.value(4), 4);
+}
+
+TEST(MaterializedRankingTest, RoundTripsThroughRankingFunction) {
+    auto table = sample_table();
+    auto lazy = table.to_ranking_function();
+
+    EXPECT_TRUE(lazy.is_deduplicating());
+    EXPECT_EQ(take_n(lazy, 10), take_n(table, 10));
+
+    auto again = materialize(lazy);
+    ASSERT_EQ(again.size(), table.size());
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        EXPECT_EQ(again[i], table[i]);
+    }
+}
+
+TEST(MaterializedRankingTest, LazyViewOutlivesSourceTable) {
+    RankingFunction<int> lazy;
+    {
+        auto table = sample_table();
+        lazy = table.to_ranking_function();
+    }
+    EXPECT_EQ(lazy.size(), 4u);
+}
+
+TEST(MaterializedRankingTest, TakeNAndMostNormalReadStorageDirectly) {
+    auto table = sample_table();
+
+    auto prefix = take_n(table, 2);
+    ASSERT_EQ(prefix.size(), 2u);
+    EXPECT_EQ(prefix[1], std::make_pair(20, Rank::from_value(1)));
+    EXPECT_EQ(take_n(table, 100).size(), 4u);
+    EXPECT_EQ(most_normal(table), 10);
+    EXPECT_FALSE(most_normal(MaterializedRanking<int>{}).has_value());
+}
+
+TEST(MaterializedRankingTest, ObserveMatchesLazyObserve) {
+    auto table = sample_table();
+    auto is_large = [](int x) { return x >= 30; };
+
+    auto eager = observe(table, is_large);
+    auto lazy = observe(table.to_ranking_function(), is_large);
+
+    ASSERT_EQ(eager.size(), 2u);
+    EXPECT_EQ(eager.rank(0), Rank::zero());
+    EXPECT_EQ(eager.rank(1), Rank::from_value(2));
+    EXPECT_EQ(take_n(eager, 10), take_n(lazy, 10));
+}
+
+TEST(MaterializedRankingTest, ObserveValueOnMissingValueIsEmpty) {
+    auto table = sample_table();
+
+    EXPECT_TRUE(observe(table, 99).is_empty());
+    auto observed = observe(table, 40);
+    ASSERT_EQ(observed.size(), 1u);
+    EXPECT_EQ(observed[0], std::make_pair(40, Rank::zero()));
+}
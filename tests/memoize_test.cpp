@@ -0,0 +1,221 @@
+/**
+ * @file memoize_test.cpp
+ * @brief Tests for memoize_ranked and MemoizedRanked.
+ *
+ * Tests cover:
+ * - One evaluation per argument, with forced prefixes shared between calls
+ * - Recursive models reusing shared subproblems through the cache
+ * - Cached rankings built without the caller's rank horizon
+ * - LRU and insertion-order eviction of bounded caches
+ * - Lazy tails that outlive the memoized function
+ * - Concurrent callers sharing one ranking per argument
+ */
+
+#include "ranked_belief/memoize.hpp"
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/operations/filter.hpp"
+#include "ranked_belief/operations/merge.hpp"
+#include "ranked_belief/operations/merge_apply.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace ranked_belief;
+
+TEST(MemoizeTest, EvaluatesEachArgumentOnce) {
+    std::size_t calls = 0;
+    auto doubled = memoize_ranked<int>([&calls](int x) {
+        ++calls;
+        return singleton(x * 2);
+    });
+
+    EXPECT_EQ(doubled(1).first()->first, 2);
+    EXPECT_EQ(doubled(1).first()->first, 2);
+    EXPECT_EQ(doubled(2).first()->first, 4);
+    EXPECT_EQ(calls, 2u);
+    EXPECT_EQ(doubled.hits(), 1u);
+    EXPECT_EQ(doubled.misses(), 2u);
+    EXPECT_EQ(doubled.size(), 2u);
+
+    doubled.clear();
+    EXPECT_EQ(doubled.size(), 0u);
+    (void)doubled(1);
+    EXPECT_EQ(calls, 3u);
+}
+
+TEST(MemoizeTest, CallsShareTheForcedPrefix) {
+    auto generated = std::make_shared<std::size_t>(0);
+    auto naturals = memoize_ranked<int>([generated](int start) {
+        return from_generator<int>([generated, start](std::size_t i) {
+            ++*generated;
+            return std::make_pair(start + static_cast<int>(i), Rank::from_value(i));
+        }, 0, Deduplication::Disabled);
+    });
+
+    const auto first = take_n(naturals(10), 5);
+    const std::size_t after_first = *generated;
+    const auto second = take_n(naturals(10), 5);
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(*generated, after_first);
+    EXPECT_EQ(second.back().first, 14);
+}
+
+TEST(MemoizeTest, RecursiveModelsReuseSharedSubproblems) {
+    // walk(n) depends on walk(n - 1) and walk(n - 2): exponentially many
+    // calls without the cache, n + 1 with it.
+    std::size_t calls = 0;
+    auto walk = memoize_ranked<int, int>([&calls](const auto& self, int n) -> RankingFunction<int> {
+        ++calls;
+        if (n < 2) {
+            return singleton(n);
+        }
+        return merge(self(n - 1), shift_ranks(self(n - 2), Rank::from_value(1)),
+                     Deduplication::Disabled);
+    });
+
+    const auto ranking = walk(25);
+    EXPECT_EQ(calls, 26u);
+    EXPECT_EQ(take_n(ranking, 3).size(), 3u);
+    EXPECT_EQ(most_normal(ranking), 1);
+}
+
+TEST(MemoizeTest, CachedRankingsIgnoreTheCallersRankHorizon) {
+    auto walk = memoize_ranked<int, int>([](const auto& self, int n) -> RankingFunction<int> {
+        if (n == 0) {
+            return singleton(0);
+        }
+        return merge_apply(self(n - 1), [](int x) {
+            return normal_exceptional(singleton(x + 1), [x] { return singleton(x + 2); });
+        });
+    });
+
+    // walk(1) is first built inside a continuation at rank 1 under horizon
+    // 1, where its exceptional branch lies beyond the horizon.
+    const auto bounded = with_rank_horizon(Rank::from_value(1), [&walk] {
+        return merge_apply(singleton(0, Rank::from_value(1)), [&walk](int) { return walk(1); });
+    });
+    EXPECT_EQ(take_n(bounded, 3), (std::vector<std::pair<int, Rank>>{{1, Rank::from_value(1)}}));
+
+    EXPECT_EQ(take_n(walk(1), 3),
+              (std::vector<std::pair<int, Rank>>{{1, Rank::zero()}, {2, Rank::from_value(1)}}));
+}
+
+TEST(MemoizeTest, LeastRecentlyUsedEvictionKeepsRecentArguments) {
+    std::size_t calls = 0;
+    auto memo = memoize_ranked<int>([&calls](int x) {
+        ++calls;
+        return singleton(x);
+    }, MemoOptions{.capacity = 2});
+
+    (void)memo(1);
+    (void)memo(2);
+    (void)memo(1);  // 1 is now more recent than 2
+    (void)memo(3);  // evicts 2
+    EXPECT_EQ(memo.size(), 2u);
+    EXPECT_EQ(calls, 3u);
+
+    (void)memo(1);
+    EXPECT_EQ(calls, 3u);
+    (void)memo(2);
+    EXPECT_EQ(calls, 4u);
+}
+
+TEST(MemoizeTest, InsertionOrderEvictionIgnoresHits) {
+    std::size_t calls = 0;
+    auto memo = memoize_ranked<int>([&calls](int x) {
+        ++calls;
+        return singleton(x);
+    }, MemoOptions{.capacity = 2, .eviction = MemoEviction::InsertionOrder});
+
+    (void)memo(1);
+    (void)memo(2);
+    (void)memo(1);
+    (void)memo(3);  // evicts 1, the oldest entry
+    EXPECT_EQ(calls, 3u);
+
+    (void)memo(2);
+    EXPECT_EQ(calls, 3u);
+    (void)memo(1);
+    EXPECT_EQ(calls, 4u);
+}
+
+TEST(MemoizeTest, LazyTailsOutliveTheMemoizedFunction) {
+    // Each ranking's tail calls back into the memoized function lazily; the
+    // handle it captures must neither keep the cache alive nor dangle.
+    std::optional<RankingFunction<int>> ranking;
+    std::weak_ptr<int> sentinel;
+    {
+        auto alive = std::make_shared<int>(0);
+        sentinel = alive;
+        auto chain = memoize_ranked<int, int>([alive](const auto& self, int n) -> RankingFunction<int> {
+            return normal_exceptional(singleton(n), [self, n] { return self(n + 1); });
+        });
+        ranking = chain(0);
+    }
+
+    EXPECT_FALSE(sentinel.expired());  // the unforced tail still holds the function
+    const auto values = take_n(*ranking, 4);
+    ASSERT_EQ(values.size(), 4u);
+    EXPECT_EQ(values[3].first, 3);
+    EXPECT_EQ(values[3].second, Rank::from_value(3));
+}
+
+TEST(MemoizeTest, CachedRankingsDoNotKeepTheCacheAlive) {
+    std::weak_ptr<int> sentinel;
+    {
+        auto alive = std::make_shared<int>(0);
+        sentinel = alive;
+        auto chain = memoize_ranked<int, int>([alive](const auto& self, int n) -> RankingFunction<int> {
+            return normal_exceptional(singleton(n), [self, n] { return self(n + 1); });
+        });
+        (void)take_n(chain(0), 3);
+    }
+    EXPECT_TRUE(sentinel.expired());
+}
+
+TEST(MemoizeTest, ConcurrentCallersShareOneRankingPerArgument) {
+    std::atomic<std::size_t> calls{0};
+    auto memo = memoize_ranked<int>([&calls](int x) {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        return singleton(x);
+    });
+
+    constexpr int arguments = 64;
+    constexpr std::size_t thread_count = 4;
+    std::vector<std::vector<RankingFunction<int>>> seen(thread_count);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&memo, &seen, t] {
+            for (int x = 0; x < arguments; ++x) {
+                seen[t].push_back(memo(x));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(memo.size(), static_cast<std::size_t>(arguments));
+    EXPECT_GE(calls.load(), static_cast<std::size_t>(arguments));
+    for (int x = 0; x < arguments; ++x) {
+        const auto head = memo(x).raw_head();
+        for (const auto& results : seen) {
+            EXPECT_EQ(results[static_cast<std::size_t>(x)].raw_head(), head);
+        }
+    }
+}
+
+TEST(MemoizeTest, RejectsEmptyFunction) {
+    using Memo = MemoizedRanked<int, int>;
+    EXPECT_THROW(Memo(Memo::Function{}), std::invalid_argument);
+}
@@ -0,0 +1,250 @@
+/**
+ * @file node_pool_test.cpp
+ * @brief Tests for pooled node allocation (NodePool, NodePoolScope).
+ */
+
+#include "ranked_belief/node_pool.hpp"
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/operations/filter.hpp"
+#include "ranked_belief/operations/map.hpp"
+#include "ranked_belief/operations/merge.hpp"
+#include "ranked_belief/operations/merge_apply.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+#include "ranked_belief/operations/parallel_merge_apply.hpp"
+#include "ranked_belief/operations/prefetch.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
+using namespace ranked_belief;
+
+namespace {
+
+/// Upstream resource that counts the chunks a pool requests.
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        ++deallocations;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+/// Executor that counts submitted tasks and runs them inline.
+class CountingExecutor final : public Executor {
+public:
+    std::size_t submitted = 0;
+
+    void submit(Task task) override {
+        ++submitted;
+        task();
+    }
+};
+
+template<typename T>
+std::vector<T> collect_values(const RankingFunction<T>& rf, std::size_t limit = 100) {
+    std::vector<T> result;
+    for (auto it = rf.begin(); it != rf.end() && result.size() < limit; ++it) {
+        result.push_back((*it).first);
+    }
+    return result;
+}
+
+}  // namespace
+
+// ============================================================================
+// Scope Management
+// ============================================================================
+
+TEST(NodePoolTest, NoPoolByDefault) {
+    EXPECT_EQ(current_node_pool(), nullptr);
+}
+
+TEST(NodePoolTest, ScopeInstallsAndRestoresPool) {
+    auto outer = std::make_shared<NodePool>();
+    auto inner = std::make_shared<NodePool>();
+    {
+        NodePoolScope outer_scope(outer);
+        EXPECT_EQ(current_node_pool(), outer);
+        {
+            NodePoolScope inner_scope(inner);
+            EXPECT_EQ(current_node_pool(), inner);
+        }
+        EXPECT_EQ(current_node_pool(), outer);
+    }
+    EXPECT_EQ(current_node_pool(), nullptr);
+}
+
+TEST(NodePoolTest, ScopeIsThreadLocal) {
+    NodePoolScope scope(std::make_shared<NodePool>());
+    std::shared_ptr<NodePool> seen_on_other_thread = std::make_shared<NodePool>();
+    std::thread([&]() { seen_on_other_thread = current_node_pool(); }).join();
+    EXPECT_EQ(seen_on_other_thread, nullptr);
+}
+
+TEST(NodePoolTest, SharedPoolExcludesUnsynchronizedPools) {
+    EXPECT_EQ(current_shared_node_pool(), nullptr);
+    auto synchronized = std::make_shared<NodePool>(PoolSynchronization::Synchronized);
+    auto unsynchronized = std::make_shared<NodePool>(PoolSynchronization::Unsynchronized);
+    EXPECT_EQ(unsynchronized->synchronization(), PoolSynchronization::Unsynchronized);
+    {
+        NodePoolScope scope(synchronized);
+        EXPECT_EQ(current_shared_node_pool(), synchronized);
+        EXPECT_TRUE(current_node_pool_is_shareable());
+        NodePoolScope inner(unsynchronized);
+        EXPECT_EQ(current_node_pool(), unsynchronized);
+        EXPECT_EQ(current_shared_node_pool(), nullptr);
+        EXPECT_FALSE(current_node_pool_is_shareable());
+    }
+}
+
+// ============================================================================
+// Factory Allocation
+// ============================================================================
+
+TEST(NodePoolTest, FactoriesDrawFromExplicitPool) {
+    CountingResource upstream;
+    auto pool = std::make_shared<NodePool>(PoolSynchronization::Unsynchronized, 512, &upstream);
+
+    auto tail = make_terminal(2, Rank::from_value(1), pool);
+    auto head = make_element(1, Rank::zero(), tail, pool);
+
+    EXPECT_GT(upstream.allocations, 0u);
+    EXPECT_EQ(head->value(), 1);
+    EXPECT_EQ(head->next()->value(), 2);
+}
+
+TEST(NodePoolTest, ChunksAreReusedAcrossNodes) {
+    CountingResource upstream;
+    auto pool = std::make_shared<NodePool>(PoolSynchronization::Unsynchronized, 512, &upstream);
+    NodePoolScope scope(pool);
+
+    auto rf = from_values_sequential<int>({1, 2, 3, 4, 5, 6, 7, 8});
+    const auto chunks_after_build = upstream.allocations;
+    EXPECT_GT(chunks_after_build, 0u);
+    EXPECT_LT(chunks_after_build, 8u);  // far fewer chunks than nodes
+    EXPECT_EQ(rf.size(), 8u);
+}
+
+TEST(NodePoolTest, PoolOutlivesScopeWhileNodesAreAlive) {
+    CountingResource upstream;
+    RankingFunction<int> rf;
+    {
+        auto pool = std::make_shared<NodePool>(PoolSynchronization::Synchronized, 512, &upstream);
+        NodePoolScope scope(pool);
+        rf = from_values_sequential<int>({1, 2, 3});
+    }
+    EXPECT_EQ(upstream.deallocations, 0u);
+    EXPECT_EQ(collect_values(rf), (std::vector<int>{1, 2, 3}));
+    rf = RankingFunction<int>();
+    EXPECT_EQ(upstream.deallocations, upstream.allocations);
+}
+
+// ============================================================================
+// Operations Capture the Pool
+// ============================================================================
+
+TEST(NodePoolTest, LazyOperationsAllocateFromCapturedPool) {
+    CountingResource upstream;
+    auto pool = std::make_shared<NodePool>(PoolSynchronization::Synchronized, 512, &upstream);
+
+    auto source = from_generator<int>([](std::size_t i) {
+        return std::make_pair(static_cast<int>(i), Rank::from_value(i));
+    });
+
+    RankingFunction<int> pipeline;
+    {
+        NodePoolScope scope(pool);
+        pipeline = filter(map(source, [](int x) { return x * 3; }), [](int x) { return x % 2 == 0; });
+    }
+    pool.reset();
+
+    const auto chunks_before_forcing = upstream.allocations;
+    // Forcing outside the scope still allocates mapped/filtered nodes from the pool.
+    EXPECT_EQ(collect_values(pipeline, 200).size(), 200u);
+    EXPECT_GT(upstream.allocations, chunks_before_forcing);
+}
+
+TEST(NodePoolTest, MergeApplyContinuationsShareThePool) {
+    CountingResource upstream;
+    auto pool = std::make_shared<NodePool>(PoolSynchronization::Synchronized, 512, &upstream);
+
+    RankingFunction<int> result;
+    {
+        NodePoolScope scope(pool);
+        result = merge_apply(from_values_sequential<int>({1, 2, 3}), [](int x) {
+            EXPECT_NE(current_node_pool(), nullptr);
+            return from_values_sequential<int>({x, x * 10});
+        });
+    }
+
+    EXPECT_EQ(collect_values(result), (std::vector<int>{1, 10, 2, 20, 3, 30}));
+    EXPECT_GT(upstream.allocations, 0u);
+}
+
+TEST(NodePoolTest, PooledResultsMatchHeapResults) {
+    auto build = []() {
+        auto base = from_values_sequential<int>({1, 2, 3, 4});
+        auto merged = merge(base, from_values_uniform<int>({10, 20}, Rank::from_value(1)));
+        return normal_exceptional(merged, []() { return singleton(99); });
+    };
+
+    auto heap_result = collect_values(build());
+    std::vector<int> pooled_result;
+    {
+        NodePoolScope scope(std::make_shared<NodePool>());
+        pooled_result = collect_values(build());
+    }
+    EXPECT_EQ(pooled_result, heap_result);
+}
+
+TEST(NodePoolTest, PrefetchIsSequentialUnderUnsynchronizedPool) {
+    // map() captures the pool; forcing its tails on a worker would race with
+    // the consumer allocating from the same pool.
+    NodePoolScope scope(std::make_shared<NodePool>(PoolSynchronization::Unsynchronized));
+    const auto input = map(from_values_sequential<int>({1, 2, 3, 4, 5, 6, 7, 8}), [](int x) { return x * 2; });
+    auto executor = std::make_shared<CountingExecutor>();
+
+    const auto prefetched = prefetch(input, 4, executor);
+    EXPECT_EQ(prefetched.raw_head(), input.raw_head());
+    EXPECT_EQ(collect_values(prefetched), (std::vector<int>{2, 4, 6, 8, 10, 12, 14, 16}));
+    EXPECT_EQ(executor->submitted, 0u);
+}
+
+TEST(NodePoolTest, ParallelMergeApplyIsSequentialUnderUnsynchronizedPool) {
+    NodePoolScope scope(std::make_shared<NodePool>(PoolSynchronization::Unsynchronized));
+    const auto input = map(from_values_sequential<int>({1, 2, 3, 4, 5, 6}), [](int x) { return x + 1; });
+    auto continuation = [](int x) { return from_values_sequential<int>({x * 10, x * 10 + 1}); };
+    auto executor = std::make_shared<CountingExecutor>();
+
+    const auto values = collect_values(parallel_merge_apply(input, continuation, executor, 4));
+    EXPECT_EQ(values, collect_values(merge_apply(input, continuation)));
+    EXPECT_EQ(executor->submitted, 0u);
+}
+
+TEST(NodePoolTest, SynchronizedPoolKeepsWorkersPooled) {
+    auto pool = std::make_shared<NodePool>(PoolSynchronization::Synchronized);
+    NodePoolScope scope(pool);
+    const auto input = from_values_sequential<int>({1, 2, 3, 4});
+    auto executor = std::make_shared<CountingExecutor>();
+
+    EXPECT_EQ(collect_values(prefetch(input, 2, executor)), (std::vector<int>{1, 2, 3, 4}));
+    EXPECT_GT(executor->submitted, 0u);
+}
@@ -535,6 +535,16 @@ TEST_F(FilterTest, TakeWhileRankNonSequential) {
     EXPECT_EQ(ranks, expected_ranks);
 }
 
+TEST_F(FilterTest, TakeWhileRankKeepsInputRankOffset) {
+    auto rf = from_values_sequential<int>({1, 2, 3, 4}).shifted(2);  // ranks: 2,3,4,5
+    auto taken = take_while_rank(rf, Rank::from_value(3));
+
+    EXPECT_EQ(taken.rank_offset(), 2);
+    EXPECT_EQ(taken.raw_head()->rank(), Rank::zero());  // stored ranks are not copied shifted
+    EXPECT_EQ(collect_values(taken), (std::vector<int>{1, 2}));
+    EXPECT_EQ(collect_ranks(taken), (std::vector<Rank>{Rank::from_value(2), Rank::from_value(3)}));
+}
+
 // ============================================================================
 // take_while_rank() - Lazy Evaluation
 // ============================================================================
@@ -671,3 +681,113 @@ TEST_F(FilterTest, TakeLargeCount) {
     auto values = collect_values(taken, N + 100);
     EXPECT_EQ(values.size(), N);
 }
+
+TEST_F(FilterTest, FilterOverChunkedInputIsChunked) {
+    int checks = 0;
+    auto source = from_generator<int>(
+        [](size_t i) { return std::make_pair(static_cast<int>(i), Rank::from_value(i)); },
+        0, Deduplication::Enabled, 4);
+    auto evens = filter(source, [&checks](int x) {
+        ++checks;
+        return x % 2 == 0;
+    });
+
+    EXPECT_EQ(evens.chunk_size(), 4u);
+    EXPECT_EQ(checks, 1);  // Only the head is found eagerly
+
+    EXPECT_EQ(collect_values(evens, 6), (std::vector<int>{0, 2, 4, 6, 8, 10}));
+    EXPECT_EQ(checks, 16);  // Whole input chunks 0..3 through 12..15
+}
+
+TEST_F(FilterTest, SparseFilterOverInfiniteChunkedInputTerminates) {
+    // Matches stop after 9; collecting a full chunk of 64 matches never ends.
+    int checks = 0;
+    auto source = from_generator<int>(
+        [](size_t i) { return std::make_pair(static_cast<int>(i), Rank::from_value(i)); },
+        0, Deduplication::Enabled, 64);
+    auto small = filter(source, [&checks](int x) {
+        ++checks;
+        return x < 10;
+    });
+    EXPECT_EQ(checks, 1);
+
+    EXPECT_EQ(collect_values(take(small, 5)), (std::vector<int>{0, 1, 2, 3, 4}));
+    EXPECT_EQ(checks, 64);  // One input chunk
+}
+
+TEST_F(FilterTest, FilterOverFiniteChunkedInput) {
+    auto source = from_values_sequential<int>({1, 2, 3, 4, 5});
+    auto chunked = RankingFunction<int>(source.head(), Deduplication::Enabled, 3);
+
+    auto odds = filter(chunked, [](int x) { return x % 2 == 1; });
+    EXPECT_EQ(collect_values(odds), (std::vector<int>{1, 3, 5}));
+    EXPECT_TRUE(filter(chunked, [](int x) { return x > 10; }).is_empty());
+}
+
+TEST_F(FilterTest, LongRejectedRunDoesNotGrowStack) {
+    // Only every 300000th element passes; the old recursive builder needed
+    // one stack frame per rejected element.
+    constexpr int stride = 300000;
+    auto naturals = from_generator<int>(
+        [](size_t i) { return std::make_pair(static_cast<int>(i), Rank::from_value(i)); });
+    auto rare = filter(naturals, [](int x) { return x % stride == 0; });
+
+    EXPECT_EQ(collect_values(rare, 2), (std::vector<int>{0, stride}));
+}
+
+TEST_F(FilterTest, ScanBudgetThrowsWhenExceeded) {
+    auto naturals = from_generator<int>(
+        [](size_t i) { return std::make_pair(static_cast<int>(i), Rank::from_value(i)); });
+    FilterLimits limits;
+    limits.max_scanned = 10;
+
+    // Head search rejects 0..99 before the first match
+    EXPECT_THROW(filter(naturals, [](int x) { return x >= 100; }, Deduplication::Enabled, limits),
+                 std::length_error);
+
+    // Gaps of four fit the budget; the gap after 20 does not
+    auto gappy = filter(naturals, [](int x) { return x % 5 == 0 && (x <= 20 || x >= 50); },
+                        Deduplication::Enabled, limits);
+    EXPECT_EQ(collect_values(gappy, 4), (std::vector<int>{0, 5, 10, 15}));
+    EXPECT_THROW(collect_values(gappy, 6), std::length_error);
+}
+
+TEST_F(FilterTest, ScanBudgetCountsConsecutiveRejectionsOnly) {
+    auto naturals = from_generator<int>(
+        [](size_t i) { return std::make_pair(static_cast<int>(i), Rank::from_value(i)); });
+    FilterLimits limits;
+    limits.max_scanned = 2;
+
+    auto thirds = filter(naturals, [](int x) { return x % 3 == 0; }, Deduplication::Enabled, limits);
+    EXPECT_EQ(collect_values(thirds, 4), (std::vector<int>{0, 3, 6, 9}));
+}
+
+TEST_F(FilterTest, HorizonEndsInfiniteRanking) {
+    auto naturals = from_generator<int>(
+        [](size_t i) { return std::make_pair(static_cast<int>(i), Rank::from_value(i)); });
+    FilterLimits limits;
+    limits.horizon = Rank::from_value(1000);
+
+    auto never = filter(naturals, [](int) { return false; }, Deduplication::Enabled, limits);
+    EXPECT_TRUE(never.is_empty());
+
+    auto sevens = filter(naturals, [](int x) { return x % 7 == 0; }, Deduplication::Enabled, limits);
+    EXPECT_EQ(sevens.size(), 143u);  // 0, 7, ..., 994
+}
+
+TEST_F(FilterTest, LimitsApplyToChunkedInput) {
+    auto naturals = from_generator<int>(
+        [](size_t i) { return std::make_pair(static_cast<int>(i), Rank::from_value(i)); },
+        0, Deduplication::Enabled, 8);
+    FilterLimits limits;
+    limits.horizon = Rank::from_value(20);
+
+    auto evens = filter(naturals, [](int x) { return x % 2 == 0; }, Deduplication::Enabled, limits);
+    EXPECT_EQ(evens.size(), 11u);
+
+    limits.max_scanned = 3;
+    EXPECT_THROW(filter(naturals, [](int x) { return x >= 100; }, Deduplication::Enabled, limits),
+                 std::length_error);
+    auto gappy = filter(naturals, [](int x) { return x == 0 || x > 10; }, Deduplication::Enabled, limits);
+    EXPECT_THROW(collect_values(gappy, 2), std::length_error);
+}
@@ -8,6 +8,7 @@
 
 #include <gtest/gtest.h>
 
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -282,6 +283,18 @@ TEST_F(MapOperationsTest, MapWithRankBasic) {
     EXPECT_EQ(result, expected);
 }
 
+TEST_F(MapOperationsTest, MapWithRankSeesShiftedRanks) {
+    auto rf = from_values_sequential(std::vector<int>{10, 20}).shifted(3);
+
+    auto mapped = map_with_rank(rf, [](int x, Rank r) { return std::make_pair(x, r); });
+
+    std::vector<std::pair<int, Rank>> result;
+    for (auto [value, rank] : mapped) {
+        result.emplace_back(value, rank);
+    }
+    EXPECT_EQ(result, (std::vector<std::pair<int, Rank>>{{10, Rank::from_value(3)}, {20, Rank::from_value(4)}}));
+}
+
 TEST_F(MapOperationsTest, MapWithRankCanChangeRanks) {
     auto rf = from_values_sequential(std::vector<int>{10, 20, 30});
     
@@ -554,3 +567,50 @@ TEST_F(MapOperationsTest, MapWithMutableCapture) {
     std::vector<int> expected = {1, 3, 6};  // Running sum
     EXPECT_EQ(result, expected);
 }
+
+TEST_F(MapOperationsTest, MapOverChunkedInputIsChunked) {
+    int calls = 0;
+    auto source = from_generator<int>(
+        [](size_t i) { return std::make_pair(static_cast<int>(i), Rank::from_value(i)); },
+        0, Deduplication::Enabled, 4);
+    auto mapped = map(source, [&calls](int x) {
+        ++calls;
+        return x * 10;
+    });
+
+    EXPECT_EQ(mapped.chunk_size(), 4u);
+    EXPECT_EQ(calls, 0);  // Nothing is mapped until an element is needed
+
+    EXPECT_EQ(mapped.first()->first, 0);
+    EXPECT_EQ(calls, 4);  // The whole first chunk is mapped together
+
+    std::vector<int> values;
+    for (auto it = mapped.begin(); values.size() < 6; ++it) {
+        values.push_back((*it).first);
+    }
+    EXPECT_EQ(values, (std::vector<int>{0, 10, 20, 30, 40, 50}));
+    EXPECT_EQ(calls, 8);
+}
+
+TEST_F(MapOperationsTest, MapOverFiniteChunkedInputStopsAtEnd) {
+    auto source = from_values_sequential<int>({1, 2, 3});
+    auto chunked = RankingFunction<int>(source.head(), Deduplication::Enabled, 2);
+    auto mapped = map(chunked, [](int x) { return x + 1; });
+
+    EXPECT_EQ(mapped.size(), 3u);
+    EXPECT_EQ(mapped.first()->first, 2);
+}
+
+TEST_F(MapOperationsTest, MapOverChunkedInputDefersErrorsToAccess) {
+    auto source = from_values_sequential<int>({1, 2, 3});
+    auto chunked = RankingFunction<int>(source.head(), Deduplication::Disabled, 4);
+    auto mapped = map(chunked, [](int x) {
+        if (x == 2) {
+            throw std::runtime_error("bad value");
+        }
+        return x;
+    }, Deduplication::Disabled);
+
+    EXPECT_EQ(mapped.raw_head()->rank(), Rank::zero());
+    EXPECT_THROW((void)mapped.first(), std::runtime_error);
+}
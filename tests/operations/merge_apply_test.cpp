@@ -116,6 +116,27 @@ TEST_F(MergeApplyTest, ShiftRanksIsLazy) {
     EXPECT_EQ(pairs[2].second, Rank::from_value(102));
 }
 
+TEST_F(MergeApplyTest, ShiftRanksSharesNodesAndComposes) {
+    auto rf = from_values_sequential(std::vector<int>{1, 2, 3});
+    auto shifted = shift_ranks(shift_ranks(rf, Rank::from_value(3)), Rank::from_value(4));
+
+    EXPECT_EQ(shifted.raw_head(), rf.raw_head());
+    EXPECT_EQ(shifted.rank_offset(), 7);
+    auto pairs = collect_pairs(shifted);
+    ASSERT_EQ(pairs.size(), 3u);
+    EXPECT_EQ(pairs[2], std::make_pair(3, Rank::from_value(9)));
+}
+
+TEST_F(MergeApplyTest, ShiftRanksByInfinityBuildsNodes) {
+    auto rf = from_values_sequential(std::vector<int>{1, 2});
+    auto shifted = shift_ranks(rf, Rank::infinity());
+
+    EXPECT_EQ(shifted.rank_offset(), 0);
+    auto pairs = collect_pairs(shifted);
+    ASSERT_EQ(pairs.size(), 2u);
+    EXPECT_EQ(pairs[1].second, Rank::infinity());
+}
+
 // ============================================================================
 // merge_apply Basic Tests
 // ============================================================================
@@ -273,6 +294,54 @@ TEST_F(MergeApplyTest, MergeApplyDoesNotComputeAhead) {
     EXPECT_LE(func_calls, 3);  // Should not process more than needed
 }
 
+TEST_F(MergeApplyTest, MergeApplyDefersInputsThatCannotBeNext) {
+    int func_calls = 0;
+    auto rf = from_list<int>({{1, Rank::zero()}, {2, Rank::from_value(5)}, {3, Rank::from_value(9)}});
+
+    auto result = merge_apply(rf, [&func_calls](int n) {
+        func_calls++;
+        return from_list<int>({{n, Rank::zero()}, {n * 10, Rank::from_value(2)}, {n * 100, Rank::from_value(4)}});
+    });
+
+    // 1@0, 10@2 and 100@4 all rank below the second input (rank 5)
+    auto it = result.begin();
+    ++it;
+    ++it;
+    EXPECT_EQ((*it).first, 100);
+    EXPECT_EQ(func_calls, 1);
+
+    ++it;
+    EXPECT_EQ((*it).first, 2);
+    EXPECT_EQ(func_calls, 2);
+}
+
+TEST_F(MergeApplyTest, MergeApplyKeepsRankOrderWhenResultsStartAboveZero) {
+    auto rf = from_list<int>({{1, Rank::zero()}, {2, Rank::from_value(1)}});
+
+    auto result = merge_apply(rf, [](int n) {
+        if (n == 1) {
+            return from_list<int>({{10, Rank::zero()}, {11, Rank::from_value(3)}});
+        }
+        return from_list<int>({{20, Rank::from_value(5)}});
+    });
+
+    auto pairs = collect_pairs(result);
+    ASSERT_EQ(pairs.size(), 3u);
+    EXPECT_EQ(pairs[0], (std::pair<int, Rank>{10, Rank::zero()}));
+    EXPECT_EQ(pairs[1], (std::pair<int, Rank>{11, Rank::from_value(3)}));
+    EXPECT_EQ(pairs[2], (std::pair<int, Rank>{20, Rank::from_value(6)}));
+}
+
+TEST_F(MergeApplyTest, MergeApplyOrdersTiesByInputPosition) {
+    auto rf = from_list<int>({{1, Rank::zero()}, {2, Rank::zero()}, {3, Rank::from_value(1)}});
+
+    auto result = merge_apply(rf, [](int n) {
+        return from_list<int>({{n, Rank::zero()}, {n * 10, Rank::from_value(1)}});
+    }, Deduplication::Disabled);
+
+    EXPECT_EQ(collect_values(result), (std::vector<int>{1, 2, 10, 20, 3, 30}));
+}
+
 // ============================================================================
 // Deduplication Tests
 // ============================================================================
@@ -467,6 +536,21 @@ TEST_F(MergeApplyTest, MergeApplyManyElements) {
     EXPECT_EQ(result_values[3], 1001);
 }
 
+TEST_F(MergeApplyTest, MergeApplyOverLongInputOfEmptyResults) {
+    // Expanding many inputs in a row must not recurse once per input
+    std::vector<int> values(200000);
+    for (int i = 0; i < 200000; ++i) {
+        values[i] = i;
+    }
+    auto rf = from_values_uniform(values);
+
+    auto result = merge_apply(rf, [](int n) {
+        return n == 199999 ? singleton(n) : RankingFunction<int>();
+    });
+
+    EXPECT_EQ(collect_values(result), (std::vector<int>{199999}));
+}
+
 TEST_F(MergeApplyTest, MergeApplyWithVariableSizeResults) {
     auto rf = from_values_sequential(std::vector<int>{1, 2, 3, 4, 5});
     
@@ -483,3 +567,93 @@ TEST_F(MergeApplyTest, MergeApplyWithVariableSizeResults) {
     auto values = collect_values(result, 20);
     EXPECT_EQ(values.size(), 15);
 }
+
+// ============================================================================
+// Rank Overflow Tests
+// ============================================================================
+
+TEST_F(MergeApplyTest, ShiftRanksThrowsOnOverflowByDefault) {
+    auto rf = from_list<int>({{1, Rank::zero()}, {2, Rank::from_value(10)}});
+    auto near_max = Rank::from_value(Rank::max_finite_value() - 5);
+    EXPECT_THROW({
+        auto shifted = shift_ranks(rf, near_max);
+        collect_pairs(shifted);
+    }, std::overflow_error);
+}
+
+TEST_F(MergeApplyTest, ShiftRanksSaturatesWhenRequested) {
+    auto rf = from_list<int>({{1, Rank::zero()}, {2, Rank::from_value(10)}});
+    auto near_max = Rank::from_value(Rank::max_finite_value() - 5);
+    auto shifted = shift_ranks(rf, near_max, RankOverflow::Saturate);
+
+    auto pairs = collect_pairs(shifted);
+    ASSERT_EQ(pairs.size(), 2u);
+    EXPECT_EQ(pairs[0].second, near_max);
+    EXPECT_EQ(pairs[1].second.value(), Rank::max_finite_value());
+}
+
+TEST_F(MergeApplyTest, MergeApplySaturatesWhenRequested) {
+    auto near_max = Rank::from_value(Rank::max_finite_value() - 1);
+    auto rf = from_list<int>({{1, Rank::zero()}, {2, near_max}});
+    auto result = merge_apply(
+        rf,
+        [](int n) { return from_list<int>({{n, Rank::zero()}, {n * 10, Rank::from_value(5)}}); },
+        Deduplication::Disabled,
+        RankOverflow::Saturate);
+
+    auto pairs = collect_pairs(result);
+    ASSERT_EQ(pairs.size(), 4u);
+    EXPECT_EQ(pairs[0], (std::pair<int, Rank>{1, Rank::zero()}));
+    EXPECT_EQ(pairs[1], (std::pair<int, Rank>{10, Rank::from_value(5)}));
+    EXPECT_EQ(pairs[2], (std::pair<int, Rank>{2, near_max}));
+    EXPECT_EQ(pairs[3].first, 20);
+    EXPECT_EQ(pairs[3].second.value(), Rank::max_finite_value());
+}
+
+// ============================================================================
+// Rank Offset Tests
+// ============================================================================
+
+TEST_F(MergeApplyTest, MergeApplyReadsShiftedContinuations) {
+    auto rf = from_values_sequential(std::vector<int>{1, 2});
+    auto result = merge_apply(rf, [](int n) {
+        auto inner = from_values_sequential(std::vector<int>{n * 10, n * 10 + 1});
+        return shift_ranks(inner, Rank::from_value(n));
+    }, Deduplication::Disabled);
+
+    // 1 -> 10@1, 11@2 ; 2 (at rank 1) -> 20@3, 21@4
+    auto pairs = collect_pairs(result);
+    std::vector<std::pair<int, Rank>> expected{
+        {10, Rank::from_value(1)}, {11, Rank::from_value(2)},
+        {20, Rank::from_value(3)}, {21, Rank::from_value(4)}};
+    EXPECT_EQ(pairs, expected);
+}
+
+TEST_F(MergeApplyTest, MergeApplyReadsShiftedInput) {
+    auto rf = shift_ranks(from_values_sequential(std::vector<int>{1, 2}), Rank::from_value(5));
+    auto result = merge_apply(rf, [](int n) {
+        return from_list<int>({{n, Rank::zero()}, {-n, Rank::from_value(2)}});
+    }, Deduplication::Disabled);
+
+    auto pairs = collect_pairs(result);
+    std::vector<std::pair<int, Rank>> expected{
+        {1, Rank::from_value(5)}, {2, Rank::from_value(6)},
+        {-1, Rank::from_value(7)}, {-2, Rank::from_value(8)}};
+    EXPECT_EQ(pairs, expected);
+}
+
+TEST_F(MergeApplyTest, MergeOfDifferentlyShiftedInputs) {
+    auto base = from_values_sequential(std::vector<int>{1, 2, 3});
+    auto merged = merge(base, shift_ranks(base, Rank::from_value(1)), Deduplication::Disabled);
+
+    auto pairs = collect_pairs(merged);
+    std::vector<std::pair<int, Rank>> expected{
+        {1, Rank::zero()}, {2, Rank::from_value(1)}, {1, Rank::from_value(1)},
+        {3, Rank::from_value(2)}, {2, Rank::from_value(2)}, {3, Rank::from_value(3)}};
+    EXPECT_EQ(pairs, expected);
+
+    // A common offset is carried over to the merged result
+    auto both = merge(shift_ranks(base, Rank::from_value(2)), shift_ranks(base, Rank::from_value(2)));
+    EXPECT_EQ(both.rank_offset(), 2);
+    EXPECT_EQ(both.first()->second, Rank::from_value(2));
+}
@@ -8,6 +8,7 @@
 #include "ranked_belief/operations/filter.hpp"
 #include "ranked_belief/constructors.hpp"
 #include <gtest/gtest.h>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -351,6 +352,15 @@ TEST_F(MergeTest, MergeAllSingle) {
     EXPECT_EQ(result, expected);
 }
 
+TEST_F(MergeTest, MergeAllSingleAppliesDeduplication) {
+    auto rf = from_values_uniform<int>({1, 1, 2}, Rank::zero(), Deduplication::Disabled);
+
+    EXPECT_EQ(collect_values(merge_all(std::vector<RankingFunction<int>>{rf})),
+              (std::vector<int>{1, 2}));
+    EXPECT_EQ(collect_values(merge_all(std::vector<RankingFunction<int>>{rf}, Deduplication::Disabled)),
+              (std::vector<int>{1, 1, 2}));
+}
+
 TEST_F(MergeTest, MergeAllThreeSequences) {
     auto rf1 = from_list<int>({
         {1, Rank::zero()},
@@ -408,6 +418,121 @@ TEST_F(MergeTest, MergeAllManySequences) {
     }
 }
 
+TEST_F(MergeTest, MergeAllBreaksTiesByInputOrder) {
+    auto rf1 = from_list<int>({{1, Rank::zero()}, {2, Rank::from_value(1)}});
+    auto rf2 = from_list<int>({{3, Rank::zero()}, {4, Rank::from_value(1)}});
+    auto rf3 = from_list<int>({{5, Rank::zero()}});
+
+    auto merged = merge_all(std::vector<RankingFunction<int>>{rf1, rf2, rf3});
+
+    EXPECT_EQ(collect_values(merged), (std::vector<int>{1, 3, 5, 2, 4}));
+}
+
+TEST_F(MergeTest, MergeAllSkipsEmptyInputs) {
+    auto rf = from_values_sequential<int>({7, 8});
+
+    auto merged = merge_all(std::vector<RankingFunction<int>>{
+        RankingFunction<int>(), rf, RankingFunction<int>()});
+
+    EXPECT_EQ(collect_values(merged), (std::vector<int>{7, 8}));
+}
+
+TEST_F(MergeTest, MergeAllForcesOnlyEmittedInputs) {
+    std::vector<int> forced(3, 0);
+    std::vector<RankingFunction<int>> rankings;
+    for (int source = 0; source < 3; ++source) {
+        rankings.push_back(from_generator<int>([&forced, source](std::size_t i) {
+            ++forced[source];
+            return std::make_pair(source * 100 + static_cast<int>(i),
+                                  Rank::from_value(i * 10 + source * 4));
+        }));
+    }
+
+    auto merged = merge_all(rankings);
+    EXPECT_EQ(forced, (std::vector<int>{1, 1, 1}));  // Only the heads exist
+
+    // Ranks: source 0 -> 0, 10, ...; source 1 -> 4, 14, ...; source 2 -> 8, 18, ...
+    auto it = merged.begin();
+    EXPECT_EQ((*it).first, 0);
+    ++it;
+    EXPECT_EQ((*it).first, 100);
+    ++it;
+    EXPECT_EQ((*it).first, 200);
+    EXPECT_EQ(forced, (std::vector<int>{2, 2, 1}));  // Source 2 not advanced yet
+}
+
+TEST_F(MergeTest, MergeAllCollapsesIdenticalInputsWhenDeduplicating) {
+    auto rf = from_values_sequential<int>({1, 2, 3});
+
+    auto dedup = merge_all(std::vector<RankingFunction<int>>{rf, rf});
+    EXPECT_EQ(collect_values(dedup), (std::vector<int>{1, 2, 3}));
+
+    auto raw = merge_all(std::vector<RankingFunction<int>>{rf, rf}, Deduplication::Disabled);
+    EXPECT_EQ(collect_values(raw), (std::vector<int>{1, 1, 2, 2, 3, 3}));
+}
+
+TEST_F(MergeTest, MergeAllKeepsInputsDifferingOnlyInOverflowMode) {
+    const auto near_max = Rank::max_finite_value() - 1;
+    auto rf = from_list<int>({{1, Rank::from_value(near_max)}, {2, Rank::from_value(near_max)}});
+    auto saturating = rf.shifted(5, RankOverflow::Saturate);
+    auto throwing = rf.shifted(5, RankOverflow::Throw);
+    ASSERT_EQ(saturating.raw_head(), throwing.raw_head());
+
+    // Collapsing them would keep only the saturating input.
+    EXPECT_THROW(collect_values(merge_all(std::vector<RankingFunction<int>>{saturating, throwing})),
+                 std::overflow_error);
+}
+
+TEST_F(MergeTest, MergeAllCollapsesSharedSuffixesWhenDeduplicating) {
+    // 1@0 -> S and 2@0 -> S with S = 10@1, 11@1.
+    auto suffix = from_list<int>({{10, Rank::from_value(1)}, {11, Rank::from_value(1)}},
+                                 Deduplication::Disabled).raw_head();
+    RankingFunction<int> rf1(make_element(1, Rank::zero(), suffix), Deduplication::Disabled);
+    RankingFunction<int> rf2(make_element(2, Rank::zero(), suffix), Deduplication::Disabled);
+
+    auto dedup = merge_all(std::vector<RankingFunction<int>>{rf1, rf2});
+    EXPECT_EQ(collect_values(dedup), (std::vector<int>{1, 2, 10, 11}));
+    EXPECT_EQ(collect_values(dedup), collect_values(merge(rf1, rf2)));
+
+    // The shared suffix is walked once in both modes, as merge() does.
+    auto raw = merge_all(std::vector<RankingFunction<int>>{rf1, rf2}, Deduplication::Disabled);
+    EXPECT_EQ(collect_values(raw), (std::vector<int>{1, 2, 10, 11}));
+}
+
+TEST_F(MergeTest, MergeAllMatchesMergeOnSharedSuffixWithoutDeduplication) {
+    // a = 1@0 -> S and b = 2@0 -> S with S = 9@5.
+    auto suffix = make_terminal(9, Rank::from_value(5));
+    RankingFunction<int> a(make_element(1, Rank::zero(), suffix), Deduplication::Disabled);
+    RankingFunction<int> b(make_element(2, Rank::zero(), suffix), Deduplication::Disabled);
+
+    auto pairwise = merge(a, b, Deduplication::Disabled);
+    auto kway = merge_all(std::vector<RankingFunction<int>>{a, b}, Deduplication::Disabled);
+    EXPECT_EQ(collect_values(pairwise), (std::vector<int>{1, 2, 9}));
+    EXPECT_EQ(collect_values(kway), collect_values(pairwise));
+
+    // Identical inputs are kept twice by both.
+    EXPECT_EQ(collect_values(merge_all(std::vector<RankingFunction<int>>{a, a}, Deduplication::Disabled)),
+              collect_values(merge(a, a, Deduplication::Disabled)));
+}
+
+TEST_F(MergeTest, MergeAllHundredsOfInfiniteInputs) {
+    std::vector<RankingFunction<int>> rankings;
+    for (int source = 0; source < 300; ++source) {
+        rankings.push_back(from_generator<int>([source](std::size_t i) {
+            return std::make_pair(source, Rank::from_value(i * 300 + static_cast<std::size_t>(source)));
+        }));
+    }
+
+    auto merged = merge_all(rankings, Deduplication::Disabled);
+
+    auto pairs = collect_pairs(merged, 900);
+    ASSERT_EQ(pairs.size(), 900u);
+    for (std::size_t i = 0; i < pairs.size(); ++i) {
+        EXPECT_EQ(pairs[i].first, static_cast<int>(i % 300));
+        EXPECT_EQ(pairs[i].second, Rank::from_value(i));
+    }
+}
+
 // ============================================================================
 // Chaining with Other Operations
 // ============================================================================
@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
 
 #include "ranked_belief/constructors.hpp"
+#include "ranked_belief/operations/merge_apply.hpp"
 #include "ranked_belief/operations/observe.hpp"
 
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -228,3 +231,69 @@ TEST(ObserveTest, SequentialObservationsReNormalise) {
     EXPECT_EQ(items[0].first, 4);
     EXPECT_EQ(items[0].second, Rank::zero());
 }
+
+// =============================================================================
+// Scan limits
+// =============================================================================
+
+TEST(ObserveTest, ObserveRareEvidenceWithinHorizon) {
+    auto naturals = from_generator<int>(
+        [](std::size_t i) { return std::make_pair(static_cast<int>(i), Rank::from_value(i)); });
+    FilterLimits limits;
+    limits.horizon = Rank::from_value(250000);
+
+    auto observed = observe(naturals, [](int x) { return x % 100000 == 99999; },
+                            Deduplication::Enabled, limits);
+    auto items = collect_pairs(observed);
+
+    ASSERT_EQ(items.size(), 2u);
+    EXPECT_EQ(items[0], std::make_pair(99999, Rank::zero()));
+    EXPECT_EQ(items[1], std::make_pair(199999, Rank::from_value(100000)));
+}
+
+TEST(ObserveTest, ObserveValueHonoursScanBudget) {
+    auto naturals = from_generator<int>(
+        [](std::size_t i) { return std::make_pair(static_cast<int>(i), Rank::from_value(i)); });
+    FilterLimits limits;
+    limits.max_scanned = 100;
+
+    EXPECT_EQ(observe(naturals, 50, Deduplication::Enabled, limits).first()->first, 50);
+    EXPECT_THROW((void)observe(naturals, 500, Deduplication::Enabled, limits), std::length_error);
+}
+
+// =============================================================================
+// Rank offsets
+// =============================================================================
+
+TEST(ObserveTest, NormalizationIsCarriedAsRankOffset) {
+    auto rf = from_list<int>({
+        {1, Rank::from_value(2)},
+        {2, Rank::from_value(3)},
+        {3, Rank::from_value(7)}
+    });
+
+    auto observed = observe(rf, [](int value) { return value >= 2; });
+    EXPECT_EQ(observed.rank_offset(), -3);
+
+    auto items = collect_pairs(observed);
+    ASSERT_EQ(items.size(), 2u);
+    EXPECT_EQ(items[0], std::make_pair(2, Rank::zero()));
+    EXPECT_EQ(items[1], std::make_pair(3, Rank::from_value(4)));
+}
+
+TEST(ObserveTest, ObserveShiftedRankingCancelsOffset) {
+    auto rf = shift_ranks(from_values_sequential<int>({1, 2, 3}), Rank::from_value(10));
+
+    auto observed = observe(rf, [](int value) { return value != 1; });
+    EXPECT_EQ(observed.rank_offset(), -1);
+    EXPECT_EQ(observed.first(), std::make_optional(std::make_pair(2, Rank::zero())));
+}
+
+TEST(ObserveTest, ObserveDropsInfiniteTail) {
+    auto rf = from_list<int>({
+        {1, Rank::zero()},
+        {2, Rank::infinity()}
+    });
+
+    EXPECT_EQ(observe(rf, [](int) { return true; }).size(), 1u);
+}
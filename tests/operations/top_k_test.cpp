@@ -0,0 +1,124 @@
+/**
+ * @file top_k_test.cpp
+ * @brief Tests for top_k, top_k_distinct and TopKCursor.
+ */
+
+#include <gtest/gtest.h>
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/operations/merge_apply.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+#include "ranked_belief/operations/top_k.hpp"
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace ranked_belief;
+
+namespace {
+
+using Entries = std::vector<std::pair<int, Rank>>;
+
+/// Ranking of 0, 1, 2, ... with value i at rank i / 2 (two entries per rank).
+RankingFunction<int> pairs_per_rank() {
+    return from_generator<int>([](std::size_t i) {
+        return std::make_pair(static_cast<int>(i), Rank::from_value(i / 2));
+    });
+}
+
+}  // namespace
+
+TEST(TopKTest, MatchesTakeN) {
+    auto rf = from_list<int>({{1, Rank::zero()}, {2, Rank::from_value(1)}, {2, Rank::from_value(2)},
+                              {3, Rank::from_value(4)}});
+
+    EXPECT_EQ(top_k(rf, 2), take_n(rf, 2));
+    EXPECT_EQ(top_k(rf, 10), take_n(rf, 10));
+    EXPECT_TRUE(top_k(rf, 0).empty());
+    EXPECT_TRUE(top_k(RankingFunction<int>(), 5).empty());
+}
+
+TEST(TopKTest, IncludeTiesReturnsWholeKthRank) {
+    auto rf = pairs_per_rank();
+
+    EXPECT_EQ(top_k(rf, 3).size(), 3u);
+    EXPECT_EQ(top_k(rf, 3, TopKTies::Include),
+              (Entries{{0, Rank::zero()}, {1, Rank::zero()}, {2, Rank::from_value(1)},
+                       {3, Rank::from_value(1)}}));
+    EXPECT_TRUE(top_k(rf, 0, TopKTies::Include).empty());
+}
+
+TEST(TopKTest, FillsCallerBuffer) {
+    auto rf = from_values_sequential<std::string>({"a", "b", "c"});
+
+    std::array<std::pair<std::string, Rank>, 2> buffer;
+    EXPECT_EQ(top_k(rf, buffer), 2u);
+    EXPECT_EQ(buffer[1], std::make_pair(std::string("b"), Rank::from_value(1)));
+
+    std::vector<std::pair<std::string, Rank>> large(5);
+    EXPECT_EQ(top_k(rf, large), 3u);
+}
+
+TEST(TopKTest, DistinctSkipsRepeatedValuesAnywhere) {
+    auto rf = from_list<int>({{1, Rank::zero()}, {2, Rank::from_value(1)}, {1, Rank::from_value(2)},
+                              {3, Rank::from_value(3)}, {2, Rank::from_value(4)}, {4, Rank::from_value(5)}});
+
+    EXPECT_EQ(top_k_distinct(rf, 3),
+              (Entries{{1, Rank::zero()}, {2, Rank::from_value(1)}, {3, Rank::from_value(3)}}));
+    EXPECT_EQ(top_k(rf, 3).back(), std::make_pair(1, Rank::from_value(2)));
+
+    std::array<std::pair<int, Rank>, 4> buffer;
+    EXPECT_EQ(top_k_distinct(rf, buffer), 4u);
+    EXPECT_EQ(buffer[3], std::make_pair(4, Rank::from_value(5)));
+}
+
+TEST(TopKTest, CursorPagesWithoutRewalkingPrefix) {
+    std::size_t generated = 0;
+    auto rf = from_generator<int>([&generated](std::size_t i) {
+        ++generated;
+        return std::make_pair(static_cast<int>(i), Rank::from_value(i));
+    });
+
+    TopKCursor<int> cursor(rf);
+    auto first = cursor.next(3);
+    auto second = cursor.next(3);
+    ASSERT_EQ(second.size(), 3u);
+    EXPECT_EQ(first.back().first, 2);
+    EXPECT_EQ(second.front().first, 3);
+    EXPECT_EQ(cursor.returned(), 6u);
+    // Six entries plus the generator's one-element look-ahead; the first page
+    // is not generated again.
+    EXPECT_LE(generated, 7u);
+}
+
+TEST(TopKTest, CursorContinuesAfterTies) {
+    TopKCursor<int> cursor(pairs_per_rank());
+
+    auto first = cursor.next(1, TopKTies::Include);
+    EXPECT_EQ(first, (Entries{{0, Rank::zero()}, {1, Rank::zero()}}));
+    auto second = cursor.next(1);
+    EXPECT_EQ(second, (Entries{{2, Rank::from_value(1)}}));
+}
+
+TEST(TopKTest, CursorReportsExhaustion) {
+    auto rf = from_values_sequential<int>({1, 2, 3});
+    auto cursor = TopKCursor<int>::distinct(rf);
+
+    EXPECT_FALSE(cursor.exhausted());
+    std::vector<std::pair<int, Rank>> out;
+    EXPECT_EQ(cursor.append(out, 2), 2u);
+    EXPECT_EQ(cursor.append(out, 2), 1u);
+    EXPECT_TRUE(cursor.exhausted());
+    EXPECT_TRUE(cursor.next(5).empty());
+    EXPECT_EQ(out.size(), 3u);
+}
+
+TEST(TopKTest, AppliesRankOffsetAndDeduplication) {
+    auto rf = shift_ranks(from_values_sequential<int>({1, 1, 2}), Rank::from_value(5));
+
+    EXPECT_EQ(top_k(rf, 5), (Entries{{1, Rank::from_value(5)}, {2, Rank::from_value(7)}}));
+    EXPECT_EQ(top_k(rf, 5), take_n(rf, 5));
+}
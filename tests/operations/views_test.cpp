@@ -0,0 +1,137 @@
+/**
+ * @file views_test.cpp
+ * @brief Tests for fused pipeline adaptors (ranked_belief::views).
+ */
+
+#include "ranked_belief/operations/views.hpp"
+#include "ranked_belief/operations/filter.hpp"
+#include "ranked_belief/operations/map.hpp"
+#include "ranked_belief/operations/observe.hpp"
+#include "ranked_belief/constructors.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace ranked_belief;
+
+class ViewsTest : public ::testing::Test {
+protected:
+    template<typename T>
+    std::vector<std::pair<T, Rank>> collect_pairs(const RankingFunction<T>& rf, std::size_t max_count = 100) {
+        std::vector<std::pair<T, Rank>> result;
+        for (auto it = rf.begin(); it != rf.end() && result.size() < max_count; ++it) {
+            result.push_back(*it);
+        }
+        return result;
+    }
+
+    static RankingFunction<int> naturals(int* generated = nullptr) {
+        return from_generator<int>([generated](std::size_t i) {
+            if (generated) {
+                ++*generated;
+            }
+            return std::make_pair(static_cast<int>(i), Rank::from_value(i));
+        });
+    }
+};
+
+TEST_F(ViewsTest, MatchesChainedOperations) {
+    auto rf = from_values_sequential<int>({1, 2, 3, 4, 5, 6, 7, 8});
+    auto square = [](int x) { return x * x; };
+    auto is_even = [](int x) { return x % 2 == 0; };
+
+    RankingFunction<int> fused = rf | views::take(6) | views::map(square) | views::filter(is_even);
+    auto chained = filter(map(take(rf, 6), square), is_even);
+
+    EXPECT_EQ(collect_pairs(fused), collect_pairs(chained));
+}
+
+TEST_F(ViewsTest, MapCanChangeValueType) {
+    auto rf = from_values_sequential<int>({1, 22, 333});
+
+    auto lengths = (rf | views::map([](int x) { return std::to_string(x); })
+                       | views::map([](const std::string& s) { return s.size(); }))
+                       .ranking();
+
+    auto pairs = collect_pairs(lengths);
+    ASSERT_EQ(pairs.size(), 3u);
+    EXPECT_EQ(pairs[2], (std::pair<std::size_t, Rank>{3, Rank::from_value(2)}));
+}
+
+TEST_F(ViewsTest, PipelinesComposeBeforeBinding) {
+    auto pipeline = views::filter([](int x) { return x % 3 == 0; }) | views::take(3);
+    auto result = (naturals() | pipeline).ranking();
+
+    auto pairs = collect_pairs(result);
+    ASSERT_EQ(pairs.size(), 3u);
+    EXPECT_EQ(pairs[2], (std::pair<int, Rank>{6, Rank::from_value(6)}));
+}
+
+TEST_F(ViewsTest, TakeStopsForcingInput) {
+    int generated = 0;
+    auto result = (naturals(&generated) | views::take(3)).ranking();
+
+    EXPECT_EQ(collect_pairs(result).size(), 3u);
+    EXPECT_EQ(generated, 3);  // Nothing past the third element was generated
+    EXPECT_TRUE((naturals() | views::take(0)).ranking().is_empty());
+}
+
+TEST_F(ViewsTest, TakeWhileRankEndsSequence) {
+    auto result = (naturals() | views::map([](int x) { return -x; })
+                              | views::take_while_rank(Rank::from_value(2)))
+                      .ranking();
+
+    auto pairs = collect_pairs(result);
+    ASSERT_EQ(pairs.size(), 3u);
+    EXPECT_EQ(pairs.back(), (std::pair<int, Rank>{-2, Rank::from_value(2)}));
+}
+
+TEST_F(ViewsTest, StagesSeeShiftedSourceRanks) {
+    auto shifted = from_values_sequential<int>({1, 2, 3}).shifted(3);
+    auto result = (shifted | views::take_while_rank(Rank::from_value(4))).ranking();
+
+    EXPECT_EQ(collect_pairs(result),
+              (std::vector<std::pair<int, Rank>>{{1, Rank::from_value(3)}, {2, Rank::from_value(4)}}));
+}
+
+TEST_F(ViewsTest, ObserveMatchesObserve) {
+    auto rf = from_values_sequential<int>({1, 2, 3, 4, 5});
+    auto is_odd_large = [](int x) { return x > 2 && x % 2 == 1; };
+
+    auto fused = (rf | views::observe(is_odd_large)).ranking();
+
+    EXPECT_EQ(collect_pairs(fused), collect_pairs(observe(rf, is_odd_large)));
+    EXPECT_EQ(fused.first()->second, Rank::zero());
+}
+
+TEST_F(ViewsTest, EachRankingGetsFreshStageState) {
+    auto bound = naturals() | views::take(2) | views::normalize();
+
+    auto first = bound.ranking();
+    auto second = bound.ranking();
+
+    EXPECT_EQ(collect_pairs(first), collect_pairs(second));
+    EXPECT_EQ(collect_pairs(second).size(), 2u);
+}
+
+TEST_F(ViewsTest, OneNodePerForcedElement) {
+    auto result = (naturals() | views::map([](int x) { return x + 1; })
+                              | views::filter([](int x) { return x % 2 == 1; }))
+                      .ranking();
+
+    auto head = result.head();
+    ASSERT_TRUE(head);
+    EXPECT_EQ(head->value(), 1);
+    // The next output node is built directly from the source, with no intermediate layers
+    EXPECT_EQ(head->next()->value(), 3);
+    EXPECT_EQ(head->next()->rank(), Rank::from_value(2));
+}
+
+TEST_F(ViewsTest, LongRejectedRunDoesNotRecurse) {
+    auto result = (naturals() | views::filter([](int x) { return x >= 500000; })).ranking();
+
+    EXPECT_EQ(result.first()->first, 500000);
+}
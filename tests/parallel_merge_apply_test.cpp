@@ -0,0 +1,126 @@
+/**
+ * @file parallel_merge_apply_test.cpp
+ * @brief Tests for parallel_merge_apply.
+ *
+ * Kept out of the single-threaded test binary: the executor runs
+ * continuations on worker threads.
+ */
+
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/executor.hpp"
+#include "ranked_belief/operations/filter.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+#include "ranked_belief/operations/parallel_merge_apply.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ranked_belief;
+
+namespace {
+
+/// For input n: n@0, n*10@1, n*100@3.
+RankingFunction<int> fan_out(int n) {
+    return from_list<int>({{n, Rank::zero()}, {n * 10, Rank::from_value(1)},
+                           {n * 100, Rank::from_value(3)}});
+}
+
+RankingFunction<int> naturals() {
+    return from_generator<int>([](std::size_t i) {
+        return std::make_pair(static_cast<int>(i), Rank::from_value(i));
+    });
+}
+
+}  // namespace
+
+TEST(ParallelMergeApplyTest, MatchesMergeApply) {
+    auto input = from_list<int>({{1, Rank::zero()}, {2, Rank::zero()}, {3, Rank::from_value(1)},
+                                 {4, Rank::from_value(2)}, {5, Rank::from_value(2)}});
+    auto pool = std::make_shared<WorkStealingPool>(3);
+
+    for (std::size_t width : {0, 1, 2, 8}) {
+        auto parallel = parallel_merge_apply(input, fan_out, pool, width);
+        EXPECT_EQ(take_n(parallel, 100), take_n(merge_apply(input, fan_out), 100)) << width;
+    }
+    EXPECT_TRUE(parallel_merge_apply(RankingFunction<int>(), fan_out, pool).is_empty());
+}
+
+TEST(ParallelMergeApplyTest, RunsEachContinuationOnce) {
+    std::atomic<int> calls{0};
+    auto counted = [&calls](int n) {
+        calls.fetch_add(1);
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        return fan_out(n);
+    };
+    auto input = from_values_sequential<int>({1, 2, 3, 4, 5, 6});
+
+    auto result = take_n(parallel_merge_apply(input, counted, std::make_shared<WorkStealingPool>(4), 4), 100);
+    EXPECT_EQ(result.size(), 18u);
+    EXPECT_EQ(calls.load(), 6);
+}
+
+TEST(ParallelMergeApplyTest, OverlapsSlowContinuations) {
+    auto slow = [](int n) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return singleton(n);
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    auto rf = parallel_merge_apply(from_values_uniform<int>({1, 2, 3, 4}), slow,
+                                   std::make_shared<WorkStealingPool>(4), 4);
+    EXPECT_EQ(take_n(rf, 10).size(), 4u);
+    // Run one after another the four continuations would take 400 ms.
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(300));
+}
+
+TEST(ParallelMergeApplyTest, DoesNotSpeculatePastHorizon) {
+    std::atomic<int> calls{0};
+    auto counted = [&calls](int n) {
+        calls.fetch_add(1);
+        return singleton(n);
+    };
+    auto pool = std::make_shared<WorkStealingPool>(2);
+
+    (void)take_n(merge_apply(naturals(), counted), 5);
+    const int sequential_calls = calls.exchange(0);
+
+    auto rf = parallel_merge_apply(naturals(), counted, pool, 16, Rank::from_value(2));
+    auto first = take_n(rf, 5);
+    ASSERT_EQ(first.size(), 5u);
+    EXPECT_EQ(first.back(), std::make_pair(4, Rank::from_value(4)));
+    // Inputs 0..2 were speculated on; later inputs were expanded only when
+    // needed, as merge_apply does.
+    EXPECT_EQ(calls.load(), sequential_calls);
+
+    calls = 0;
+    auto bounded = with_rank_horizon(Rank::from_value(3), [&] {
+        return parallel_merge_apply(naturals(), counted, pool, 16);
+    });
+    EXPECT_EQ(take_n(bounded, 100).size(), 4u);
+    EXPECT_EQ(calls.load(), 4);
+}
+
+TEST(ParallelMergeApplyTest, RethrowsContinuationErrors) {
+    auto failing = [](int n) {
+        if (n == 3) {
+            throw std::runtime_error("bad input");
+        }
+        return singleton(n);
+    };
+
+    auto rf = parallel_merge_apply(from_values_sequential<int>({1, 2, 3, 4}), failing,
+                                   std::make_shared<WorkStealingPool>(2), 4);
+    auto it = rf.begin();
+    EXPECT_EQ((*it).first, 1);
+    ++it;
+    EXPECT_EQ((*it).first, 2);
+    EXPECT_THROW(++it, std::runtime_error);
+}
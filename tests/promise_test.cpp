@@ -7,8 +7,11 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <functional>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <thread>
@@ -511,3 +514,181 @@ TEST(PromiseTest, MakePromiseValueWithVariousTypes) {
     EXPECT_EQ(p_string.force(), "test");
     EXPECT_DOUBLE_EQ(p_double.force(), 3.14);
 }
+
+// ============================================================================
+// Single-Threaded Policy Tests
+// ============================================================================
+
+using SinglePromise = Promise<int, SingleThreadedPolicy>;
+
+TEST(PromiseTest, SingleThreadedForceExecutesOnlyOnce) {
+    int execution_count = 0;
+    SinglePromise p([&execution_count]() {
+        ++execution_count;
+        return 7;
+    });
+    EXPECT_FALSE(p.is_forced());
+    EXPECT_EQ(p.force(), 7);
+    EXPECT_EQ(p.force(), 7);
+    EXPECT_EQ(execution_count, 1);
+    EXPECT_TRUE(p.has_value());
+}
+
+TEST(PromiseTest, SingleThreadedConstructFromValue) {
+    const SinglePromise p(3);
+    EXPECT_TRUE(p.is_forced());
+    EXPECT_EQ(p.force(), 3);
+}
+
+TEST(PromiseTest, SingleThreadedNullFunctionThrows) {
+    std::function<int()> null_func;
+    int (*null_pointer)() = nullptr;
+    EXPECT_THROW(SinglePromise p(null_func), std::invalid_argument);
+    EXPECT_THROW(SinglePromise p(null_pointer), std::invalid_argument);
+}
+
+TEST(PromiseTest, SingleThreadedExceptionIsCached) {
+    int execution_count = 0;
+    SinglePromise p([&execution_count]() -> int {
+        ++execution_count;
+        throw std::runtime_error("boom");
+    });
+    EXPECT_THROW(p.force(), std::runtime_error);
+    EXPECT_THROW(p.force(), std::runtime_error);
+    EXPECT_EQ(execution_count, 1);
+    EXPECT_TRUE(p.has_exception());
+    EXPECT_FALSE(p.has_value());
+}
+
+TEST(PromiseTest, SingleThreadedAcceptsMoveOnlyCallables) {
+    auto owned = std::make_unique<int>(11);
+    auto p = make_promise<SingleThreadedPolicy>([owned = std::move(owned)]() { return *owned; });
+    EXPECT_EQ(p.force(), 11);
+}
+
+TEST(PromiseTest, SingleThreadedLargeCaptureSpillsToHeap) {
+    std::array<long, 32> payload{};
+    payload.fill(2);
+    auto p = make_promise<SingleThreadedPolicy>([payload]() {
+        long sum = 0;
+        for (long x : payload) {
+            sum += x;
+        }
+        return sum;
+    });
+    auto moved = std::move(p);
+    EXPECT_EQ(moved.force(), 64);
+}
+
+TEST(PromiseTest, SingleThreadedComputationReleasedAfterForce) {
+    auto tracker = std::make_shared<int>(0);
+    std::weak_ptr<int> weak = tracker;
+    SinglePromise p([tracker = std::move(tracker)]() { return *tracker; });
+    EXPECT_FALSE(weak.expired());
+    p.force();
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST(PromiseTest, SingleThreadedMoveLeavesSourceInvalid) {
+    SinglePromise p1([]() { return 5; });
+    SinglePromise p2(std::move(p1));
+    EXPECT_EQ(p2.force(), 5);
+    EXPECT_THROW({ [[maybe_unused]] auto v = p1.force(); }, std::logic_error);
+
+    SinglePromise p3(9);
+    p3 = std::move(p2);
+    EXPECT_EQ(p3.force(), 5);
+}
+
+TEST(PromiseTest, SingleThreadedReentrantForceThrows) {
+    std::shared_ptr<SinglePromise> self;
+    self = std::make_shared<SinglePromise>([&self]() { return self->force() + 1; });
+    EXPECT_THROW(self->force(), std::logic_error);
+}
+
+TEST(PromiseTest, SingleThreadedPromiseOfCallableUsesValueConstructor) {
+    std::function<int()> stored = []() { return 1; };
+    Promise<std::function<int()>, SingleThreadedPolicy> p(stored);
+    EXPECT_TRUE(p.has_value());
+    EXPECT_EQ(p.force()(), 1);
+}
+
+// ============================================================================
+// Concurrent Publication Tests
+// ============================================================================
+
+TEST(PromiseTest, ThreadSafeAcceptsMoveOnlyCallables) {
+    auto owned = std::make_unique<int>(21);
+    Promise<int, ThreadSafePolicy> p([owned = std::move(owned)]() { return *owned * 2; });
+    EXPECT_EQ(p.force(), 42);
+}
+
+TEST(PromiseTest, MovePreservesFailedState) {
+    Promise<int> p1([]() -> int { throw std::runtime_error("boom"); });
+    EXPECT_THROW(p1.force(), std::runtime_error);
+
+    Promise<int> p2(std::move(p1));
+    EXPECT_TRUE(p2.has_exception());
+    EXPECT_THROW(p2.force(), std::runtime_error);
+    EXPECT_FALSE(p1.is_forced());
+    EXPECT_THROW(p1.force(), std::logic_error);
+}
+
+TEST(PromiseTest, StateQueriesAreSafeDuringConcurrentForce) {
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+    Promise<int> p([&]() {
+        started = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+        return 5;
+    });
+
+    std::thread forcer([&p]() { p.force(); });
+    while (!started) {
+        std::this_thread::yield();
+    }
+    // Running: neither forced nor failed yet.
+    EXPECT_FALSE(p.is_forced());
+    EXPECT_FALSE(p.has_value());
+    EXPECT_FALSE(p.has_exception());
+
+    std::thread waiter([&p]() { EXPECT_EQ(p.force(), 5); });
+    release = true;
+    forcer.join();
+    waiter.join();
+    EXPECT_TRUE(p.has_value());
+}
+
+TEST(PromiseTest, ManyReadersObserveOnePublishedValue) {
+    constexpr int num_threads = 8;
+    constexpr int num_promises = 2000;
+    std::vector<Promise<std::string>> promises;
+    std::atomic<int> executions{0};
+    promises.reserve(num_promises);
+    for (int i = 0; i < num_promises; ++i) {
+        promises.emplace_back([i, &executions]() {
+            ++executions;
+            return std::to_string(i);
+        });
+    }
+
+    std::vector<std::thread> threads;
+    std::atomic<int> mismatches{0};
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&promises, &mismatches]() {
+            for (int i = 0; i < num_promises; ++i) {
+                if (promises[static_cast<std::size_t>(i)].force() != std::to_string(i)) {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(mismatches.load(), 0);
+    EXPECT_EQ(executions.load(), num_promises);
+}
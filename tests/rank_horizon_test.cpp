@@ -0,0 +1,172 @@
+/**
+ * @file rank_horizon_test.cpp
+ * @brief Tests for rank-bounded evaluation (RankHorizonScope, with_rank_horizon).
+ *
+ * Tests cover:
+ * - Installing and restoring the thread-local horizon
+ * - merge_apply skipping inputs and inner branches above the horizon
+ * - merge_apply cutting a passed-through last continuation at the horizon
+ * - normal_exceptional skipping exceptional thunks above the horizon
+ * - Recursive rankings terminating under a horizon
+ * - observe ignoring an enclosing horizon
+ */
+
+#include "ranked_belief/rank_horizon.hpp"
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/operations/filter.hpp"
+#include "ranked_belief/operations/merge_apply.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+#include "ranked_belief/operations/observe.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+using namespace ranked_belief;
+
+namespace {
+
+/// Ranking 0, 1, 2, ... where value n is ranked n and each step is an
+/// exceptional branch whose thunk counts as one call.
+RankingFunction<int> counting_chain(int n, std::size_t& calls) {
+    ++calls;
+    return normal_exceptional(
+        singleton(n),
+        [n, &calls]() { return counting_chain(n + 1, calls); });
+}
+
+}  // namespace
+
+TEST(RankHorizonTest, DefaultsToInfinityAndScopesRestore) {
+    EXPECT_TRUE(current_rank_horizon().is_infinity());
+    {
+        RankHorizonScope outer(Rank::from_value(5));
+        EXPECT_EQ(current_rank_horizon(), Rank::from_value(5));
+        {
+            RankHorizonScope inner(Rank::from_value(7));
+            EXPECT_EQ(current_rank_horizon(), Rank::from_value(7));
+        }
+        EXPECT_EQ(current_rank_horizon(), Rank::from_value(5));
+    }
+    EXPECT_TRUE(current_rank_horizon().is_infinity());
+}
+
+TEST(RankHorizonTest, MergeApplySkipsInputsAboveHorizon) {
+    auto input = from_values_sequential<int>({0, 1, 2, 3, 4, 5, 6, 7});
+    std::size_t calls = 0;
+    auto func = [&calls](int x) {
+        ++calls;
+        return singleton(x * 10);
+    };
+
+    auto unbounded = take_n(take_while_rank(merge_apply(input, func), Rank::from_value(3)), 100);
+    EXPECT_EQ(calls, 5u);  // the input at rank 4 is expanded to find the end
+
+    calls = 0;
+    auto bounded = with_rank_horizon(Rank::from_value(3), [&] {
+        return merge_apply(input, func);
+    });
+    EXPECT_EQ(take_n(bounded, 100), unbounded);
+    EXPECT_EQ(calls, 4u);
+}
+
+TEST(RankHorizonTest, MergeApplyCutsLastContinuationAtHorizon) {
+    // The only continuation ignores the horizon; merge_apply must still
+    // drop its elements ranked above it.
+    RankHorizonScope scope(Rank::from_value(2));
+    auto result = merge_apply(singleton(0), [](int) {
+        return from_values_sequential<int>({0, 1, 2, 3, 4, 5});
+    });
+
+    EXPECT_EQ(take_n(result, 100).size(), 3u);
+}
+
+TEST(RankHorizonTest, NestedMergeApplyInheritsLoweredHorizon) {
+    auto outer = from_values_sequential<int>({0, 1, 2, 3});
+    auto inner = from_values_sequential<int>({0, 1, 2, 3});
+    std::size_t inner_calls = 0;
+    auto build = [&] {
+        return merge_apply(outer, [&](int) {
+            return merge_apply(inner, [&inner_calls](int y) {
+                ++inner_calls;
+                return singleton(y);
+            });
+        });
+    };
+
+    auto unbounded = take_n(build(), 100);
+    EXPECT_EQ(unbounded.size(), 16u);
+    EXPECT_EQ(inner_calls, 16u);
+
+    inner_calls = 0;
+    auto bounded = take_n(with_rank_horizon(Rank::from_value(2), build), 100);
+    EXPECT_EQ(bounded.size(), 6u);
+    // Inner rankings at outer ranks 0, 1 and 2 see horizons 2, 1 and 0.
+    EXPECT_EQ(inner_calls, 6u);
+    for (const auto& [value, rank] : bounded) {
+        EXPECT_LE(rank, Rank::from_value(2));
+    }
+}
+
+TEST(RankHorizonTest, NormalExceptionalSkipsThunkAboveHorizon) {
+    bool called = false;
+    auto thunk = [&called]() {
+        called = true;
+        return singleton(99);
+    };
+
+    RankHorizonScope scope(Rank::from_value(1));
+    auto rf = normal_exceptional(singleton(1), thunk, Rank::from_value(2));
+    EXPECT_EQ(take_n(rf, 10), (std::vector<std::pair<int, Rank>>{{1, Rank::zero()}}));
+    EXPECT_FALSE(called);
+
+    auto only_exceptional = normal_exceptional(empty<int>(), thunk, Rank::from_value(2));
+    EXPECT_TRUE(only_exceptional.is_empty());
+    EXPECT_FALSE(called);
+
+    auto within = normal_exceptional(singleton(1), thunk, Rank::from_value(1));
+    EXPECT_EQ(take_n(within, 10).size(), 2u);
+    EXPECT_TRUE(called);
+}
+
+TEST(RankHorizonTest, RecursiveRankingTerminatesUnderHorizon) {
+    std::size_t calls = 0;
+    auto bounded = with_rank_horizon(Rank::from_value(3), [&] {
+        return counting_chain(0, calls);
+    });
+
+    // Without the horizon the chain is infinite and this would not return.
+    auto elements = take_n(bounded, 1000);
+    ASSERT_EQ(elements.size(), 4u);
+    for (std::size_t i = 0; i < elements.size(); ++i) {
+        EXPECT_EQ(elements[i], std::make_pair(static_cast<int>(i), Rank::from_value(i)));
+    }
+    EXPECT_EQ(calls, 4u);
+}
+
+TEST(RankHorizonTest, FilterStopsAtHorizon) {
+    std::size_t tested = 0;
+    auto rf = from_generator<int>([](std::size_t i) {
+        return std::make_pair(static_cast<int>(i), Rank::from_value(i));
+    });
+
+    RankHorizonScope scope(Rank::from_value(9));
+    auto odd = filter(rf, [&tested](int x) {
+        ++tested;
+        return x % 2 == 1;
+    });
+    EXPECT_EQ(take_n(odd, 100).size(), 5u);
+    EXPECT_EQ(tested, 10u);
+}
+
+TEST(RankHorizonTest, ObserveIgnoresEnclosingHorizon) {
+    auto rf = from_values_sequential<int>({1, 2, 3, 4});
+
+    RankHorizonScope scope(Rank::zero());
+    auto observed = observe(rf, [](int x) { return x >= 3; });
+    EXPECT_EQ(take_n(observed, 10),
+              (std::vector<std::pair<int, Rank>>{{3, Rank::zero()}, {4, Rank::from_value(1)}}));
+}
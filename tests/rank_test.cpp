@@ -7,8 +7,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
 #include <limits>
 #include <sstream>
+#include <type_traits>
 
 using namespace ranked_belief;
 
@@ -36,6 +38,13 @@ TEST(RankTest, InfinityFactoryCreatesInfinity) {
     EXPECT_FALSE(r.is_finite());
 }
 
+TEST(RankTest, MaxFiniteFactoryCreatesLargestFiniteRank) {
+    constexpr Rank r = Rank::max_finite();
+    EXPECT_TRUE(r.is_finite());
+    EXPECT_EQ(r.value(), Rank::max_finite_value());
+    EXPECT_EQ(Rank::from_value(Rank::max_finite_value() - 1).saturating_add(Rank::from_value(1)), r);
+}
+
 TEST(RankTest, FromValueCreatesFiniteRank) {
     Rank r = Rank::from_value(42);
     EXPECT_FALSE(r.is_infinity());
@@ -523,3 +532,58 @@ TEST(RankTest, ConstCorrectness) {
     const Rank inf = Rank::infinity();
     EXPECT_TRUE(inf.is_infinity());
 }
+
+// ============================================================================
+// Representation and Saturating Arithmetic Tests
+// ============================================================================
+
+TEST(RankTest, RankIsOneMachineWord) {
+    EXPECT_EQ(sizeof(Rank), sizeof(uint64_t));
+    EXPECT_TRUE(std::is_trivially_copyable_v<Rank>);
+}
+
+TEST(RankTest, ArithmeticIsConstexpr) {
+    static_assert(Rank::zero() < Rank::infinity());
+    static_assert((Rank::zero() + Rank::zero()) == Rank::zero());
+    static_assert((Rank::zero() + Rank::infinity()).is_infinity());
+    static_assert(Rank::infinity().saturating_add(Rank::zero()).is_infinity());
+    static_assert(Rank::zero().min(Rank::infinity()) == Rank::zero());
+    static_assert(Rank::zero().max(Rank::infinity()) == Rank::infinity());
+    SUCCEED();
+}
+
+TEST(RankTest, AdditionReachesMaxFiniteValue) {
+    Rank almost = Rank::from_value(Rank::max_finite_value() - 1);
+    Rank sum = almost + Rank::from_value(1);
+    EXPECT_TRUE(sum.is_finite());
+    EXPECT_EQ(sum.value(), Rank::max_finite_value());
+    EXPECT_THROW({ [[maybe_unused]] auto r = sum + Rank::from_value(1); }, std::overflow_error);
+}
+
+TEST(RankTest, LargestFiniteRanksSumWithoutWrapping) {
+    Rank big = Rank::from_value(Rank::max_finite_value() - 1);
+    EXPECT_THROW({ [[maybe_unused]] auto r = big + big; }, std::overflow_error);
+    EXPECT_EQ(big.saturating_add(big).value(), Rank::max_finite_value());
+    EXPECT_LT(big.saturating_add(big), Rank::infinity());
+}
+
+TEST(RankTest, SaturatingAddMatchesCheckedAddWhenInRange) {
+    for (uint64_t a : {0ULL, 1ULL, 7ULL, 1000ULL}) {
+        for (uint64_t b : {0ULL, 3ULL, 99ULL}) {
+            EXPECT_EQ(Rank::from_value(a).saturating_add(Rank::from_value(b)),
+                      Rank::from_value(a) + Rank::from_value(b));
+        }
+    }
+}
+
+TEST(RankTest, SaturatingAddWithInfinityIsInfinity) {
+    EXPECT_TRUE(Rank::from_value(5).saturating_add(Rank::infinity()).is_infinity());
+    EXPECT_TRUE(Rank::infinity().saturating_add(Rank::from_value(5)).is_infinity());
+    EXPECT_TRUE(Rank::infinity().saturating_add(Rank::infinity()).is_infinity());
+}
+
+TEST(RankTest, ValueOrIgnoresDefaultForMaxFinite) {
+    Rank max = Rank::from_value(Rank::max_finite_value() - 1) + Rank::from_value(1);
+    EXPECT_EQ(max.value_or(0), Rank::max_finite_value());
+    EXPECT_EQ(Rank::infinity().value_or(0), 0u);
+}
@@ -0,0 +1,165 @@
+/**
+ * @file ranked_generator_test.cpp
+ * @brief Tests for the ranked_generator coroutine type.
+ *
+ * Tests cover:
+ * - Resuming the coroutine only when a tail is forced
+ * - Finite and empty generators
+ * - Exceptions and decreasing ranks surfacing at the force
+ * - Deduplication and composition with lazy operations
+ * - Frame lifetime and allocation from the current NodePool
+ */
+
+#include "ranked_belief/ranked_generator.hpp"
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/node_pool.hpp"
+#include "ranked_belief/operations/map.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace ranked_belief;
+
+namespace {
+
+/// n@n for n = 0, 1, 2, ..., counting how many elements have been produced.
+ranked_generator<int> naturals(std::size_t& produced) {
+    for (int n = 0;; ++n) {
+        ++produced;
+        co_yield {n, Rank::from_value(static_cast<uint64_t>(n))};
+    }
+}
+
+ranked_generator<std::string> words(std::vector<std::pair<std::string, Rank>> items) {
+    for (auto& item : items) {
+        co_yield std::move(item);
+    }
+}
+
+/// Sets a flag when destroyed, to observe frame destruction.
+struct DestructionFlag {
+    bool* destroyed;
+    ~DestructionFlag() { *destroyed = true; }
+};
+
+ranked_generator<int> guarded(bool& destroyed) {
+    DestructionFlag flag{&destroyed};
+    for (int n = 0;; ++n) {
+        co_yield {n, Rank::zero()};
+    }
+}
+
+}  // namespace
+
+TEST(RankedGeneratorTest, ResumesOnlyWhenForced) {
+    std::size_t produced = 0;
+    auto generator = naturals(produced);
+    EXPECT_EQ(produced, 0u);
+
+    RankingFunction<int> rf = std::move(generator);
+    EXPECT_EQ(produced, 1u);
+
+    auto first = take_n(rf, 5);
+    ASSERT_EQ(first.size(), 5u);
+    EXPECT_EQ(first[4], std::make_pair(4, Rank::from_value(4)));
+    EXPECT_LE(produced, 6u);
+
+    // Forced nodes are memoized; iterating again does not resume the coroutine.
+    const std::size_t after_first = produced;
+    EXPECT_EQ(take_n(rf, 5), first);
+    EXPECT_EQ(produced, after_first);
+}
+
+TEST(RankedGeneratorTest, FiniteGeneratorsEnd) {
+    RankingFunction<std::string> rf = words({{"a", Rank::zero()}, {"b", Rank::from_value(2)}});
+    auto all = take_n(rf, 10);
+    ASSERT_EQ(all.size(), 2u);
+    EXPECT_EQ(all[1], std::make_pair(std::string("b"), Rank::from_value(2)));
+
+    RankingFunction<std::string> empty = words({});
+    EXPECT_TRUE(empty.is_empty());
+}
+
+TEST(RankedGeneratorTest, ErrorsSurfaceAtTheForce) {
+    auto failing = []() -> ranked_generator<int> {
+        co_yield {1, Rank::zero()};
+        throw std::runtime_error("generator failed");
+    };
+    RankingFunction<int> rf = failing();
+    auto it = rf.begin();
+    EXPECT_EQ((*it).first, 1);
+    EXPECT_THROW(++it, std::runtime_error);
+
+    RankingFunction<std::string> decreasing =
+        words({{"a", Rank::from_value(2)}, {"b", Rank::from_value(1)}});
+    EXPECT_THROW((void)take_n(decreasing, 10), std::invalid_argument);
+}
+
+TEST(RankedGeneratorTest, DeduplicatesLikeOtherConstructors) {
+    auto items = std::vector<std::pair<std::string, Rank>>{
+        {"a", Rank::zero()}, {"a", Rank::zero()}, {"b", Rank::from_value(1)}};
+    EXPECT_EQ(take_n(words(items).ranking(), 10).size(), 2u);
+    EXPECT_EQ(take_n(words(items).ranking(Deduplication::Disabled), 10).size(), 3u);
+}
+
+TEST(RankedGeneratorTest, ComposesWithLazyOperations) {
+    std::size_t produced = 0;
+    auto doubled = map(RankingFunction<int>(naturals(produced)), [](int n) { return n * 2; });
+    auto first = take_n(doubled, 3);
+    ASSERT_EQ(first.size(), 3u);
+    EXPECT_EQ(first[2], std::make_pair(4, Rank::from_value(2)));
+    EXPECT_LE(produced, 4u);
+}
+
+TEST(RankedGeneratorTest, FrameIsDestroyedWithTheRanking) {
+    bool destroyed = false;
+    {
+        auto generator = guarded(destroyed);
+    }
+    // The body never ran, so the flag was never constructed.
+    EXPECT_FALSE(destroyed);
+
+    {
+        RankingFunction<int> rf = guarded(destroyed);
+        (void)take_n(rf, 3);
+        EXPECT_FALSE(destroyed);
+    }
+    EXPECT_TRUE(destroyed);
+}
+
+TEST(RankedGeneratorTest, FrameAndNodesComeFromTheCurrentPool) {
+    struct CountingResource : std::pmr::memory_resource {
+        std::size_t allocations = 0;
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    } upstream;
+
+    std::size_t produced = 0;
+    RankingFunction<int> rf;
+    {
+        auto pool = std::make_shared<NodePool>(PoolSynchronization::Synchronized, 512, &upstream);
+        NodePoolScope scope(pool);
+        auto generator = naturals(produced);
+        EXPECT_GT(upstream.allocations, 0u);
+        rf = std::move(generator);
+    }
+    // Later nodes still come from the pool captured at conversion.
+    EXPECT_EQ(take_n(rf, 200).size(), 200u);
+    EXPECT_GT(upstream.allocations, 1u);
+}
@@ -0,0 +1,149 @@
+/**
+ * @file ranked_program_test.cpp
+ * @brief Tests for ranked_program coroutines and from_program.
+ *
+ * Tests cover:
+ * - Agreement with the equivalent nested merge_apply calls, ties included
+ * - Lazy search over infinite awaited rankings
+ * - Empty rankings abandoning a path
+ * - Errors and nondeterministic programs surfacing at the force
+ * - Rank horizons and frame allocation from the current NodePool
+ */
+
+#include "ranked_belief/ranked_program.hpp"
+#include "ranked_belief/constructors.hpp"
+#include "ranked_belief/node_pool.hpp"
+#include "ranked_belief/operations/filter.hpp"
+#include "ranked_belief/operations/merge_apply.hpp"
+#include "ranked_belief/operations/nrm_exc.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace ranked_belief;
+
+namespace {
+
+RankingFunction<bool> flip() {
+    return from_list<bool>({{true, Rank::zero()}, {false, Rank::from_value(1)}},
+                           Deduplication::Disabled);
+}
+
+RankingFunction<int> naturals() {
+    return from_generator<int>([](std::size_t i) {
+        return std::make_pair(static_cast<int>(i), Rank::from_value(i));
+    });
+}
+
+ranked_program<std::tuple<bool, bool, bool>> three_flips() {
+    const bool a = co_await flip();
+    const bool b = co_await flip();
+    const bool c = co_await flip();
+    co_return std::make_tuple(a, b, c);
+}
+
+}  // namespace
+
+TEST(RankedProgramTest, MatchesNestedMergeApply) {
+    auto program = from_program(three_flips, Deduplication::Disabled);
+    auto nested = merge_apply(flip(), [](bool a) {
+        return merge_apply(flip(), [a](bool b) {
+            return merge_apply(flip(), [a, b](bool c) {
+                return singleton(std::make_tuple(a, b, c));
+            }, Deduplication::Disabled);
+        }, Deduplication::Disabled);
+    }, Deduplication::Disabled);
+
+    const auto expected = take_n(nested, 100);
+    ASSERT_EQ(expected.size(), 8u);
+    EXPECT_EQ(take_n(program, 100), expected);
+}
+
+TEST(RankedProgramTest, SearchesInfiniteRankingsLazily) {
+    std::size_t runs = 0;
+    auto sums = from_program([&runs]() -> ranked_program<int> {
+        ++runs;
+        const int a = co_await naturals();
+        const int b = co_await naturals();
+        co_return a * 100 + b;
+    }, Deduplication::Disabled);
+
+    auto first = take_n(sums, 6);
+    auto expected = take_n(merge_apply(naturals(), [](int a) {
+        return merge_apply(naturals(), [a](int b) { return singleton(a * 100 + b); },
+                           Deduplication::Disabled);
+    }, Deduplication::Disabled), 6);
+    EXPECT_EQ(first, expected);
+    EXPECT_LT(runs, 20u);
+}
+
+TEST(RankedProgramTest, DependentBindsAndEmptyRankings) {
+    // Bind n, then only odd n continue; the even paths die at an empty ranking.
+    const auto inputs = from_values_sequential<int>({0, 1, 2, 3, 4, 5});
+    auto odd = from_program([inputs]() -> ranked_program<int> {
+        const int n = co_await inputs;
+        const auto tens = n % 2 == 1 ? singleton(n * 10) : RankingFunction<int>();
+        const int m = co_await tens;
+        co_return m;
+    });
+    auto values = take_n(odd, 10);
+    ASSERT_EQ(values.size(), 3u);
+    EXPECT_EQ(values[0], std::make_pair(10, Rank::from_value(1)));
+    EXPECT_EQ(values[2], std::make_pair(50, Rank::from_value(5)));
+}
+
+TEST(RankedProgramTest, ErrorsSurfaceAtTheForce) {
+    auto failing = from_program([]() -> ranked_program<int> {
+        const bool b = co_await flip();
+        if (!b) {
+            throw std::runtime_error("exceptional branch failed");
+        }
+        co_return 1;
+    });
+    auto it = failing.begin();
+    EXPECT_EQ((*it).first, 1);
+    EXPECT_THROW(++it, std::runtime_error);
+
+    // A body that binds a different type on replay is reported, not misread.
+    std::size_t runs = 0;
+    auto diverging = from_program([&runs]() -> ranked_program<int> {
+        if (runs++ == 0) {
+            const bool b = co_await flip();
+            co_return b ? 1 : 0;
+        }
+        const int n = co_await naturals();
+        co_return n;
+    });
+    EXPECT_THROW((void)take_n(diverging, 10), std::logic_error);
+}
+
+TEST(RankedProgramTest, RespectsRankHorizon) {
+    std::size_t runs = 0;
+    auto bounded = with_rank_horizon(Rank::from_value(2), [&runs] {
+        return from_program([&runs]() -> ranked_program<int> {
+            ++runs;
+            const int a = co_await naturals();
+            const int b = co_await naturals();
+            co_return a * 100 + b;
+        }, Deduplication::Disabled);
+    });
+    // Pairs (a, b) with a + b <= 2.
+    EXPECT_EQ(take_n(bounded, 100).size(), 6u);
+    EXPECT_LE(runs, 12u);
+}
+
+TEST(RankedProgramTest, FramesComeFromTheCurrentPool) {
+    auto pool = std::make_shared<NodePool>();
+    RankingFunction<std::tuple<bool, bool, bool>> rf;
+    {
+        NodePoolScope scope(pool);
+        rf = from_program(three_flips);
+    }
+    EXPECT_EQ(take_n(rf, 100).size(), 8u);
+}
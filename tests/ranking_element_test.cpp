@@ -7,10 +7,16 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <functional>
 #include <string>
 #include <thread>
 #include <vector>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#endif
+
 using namespace ranked_belief;
 
 // ============================================================================
@@ -301,6 +307,100 @@ TEST(RankingElementTest, InfiniteSequenceLazyEvaluation) {
     EXPECT_EQ(computation_count, 3);  // Third element now computed
 }
 
+TEST(RankingElementTest, ChunkedSequenceGeneratesOneChunkPerStep) {
+    int computation_count = 0;
+    auto chunked = make_chunked_sequence<int>(
+        [&computation_count](size_t i) {
+            ++computation_count;
+            return std::make_pair(static_cast<int>(i), Rank::from_value(i));
+        },
+        4);
+
+    EXPECT_EQ(computation_count, 4);  // First chunk generated eagerly
+
+    auto current = chunked;
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(current->next_is_forced());  // Links inside a chunk are eager
+        current = current->next();
+    }
+    EXPECT_EQ(current->value(), 3);
+    EXPECT_FALSE(current->next_is_forced());  // Only the chunk's tail is lazy
+    EXPECT_EQ(computation_count, 4);
+
+    EXPECT_EQ(current->next()->value(), 4);
+    EXPECT_EQ(computation_count, 8);
+}
+
+TEST(RankingElementTest, ChunkedSequenceMatchesInfiniteSequence) {
+    auto generator = [](size_t i) {
+        return std::make_pair(static_cast<int>(i * 3), Rank::from_value(i / 2));
+    };
+    auto chunked = make_chunked_sequence<int>(generator, 5, 7);
+    auto plain = make_infinite_sequence<int>(generator, 7);
+
+    for (int i = 0; i < 23; ++i) {
+        EXPECT_EQ(chunked->value(), plain->value());
+        EXPECT_EQ(chunked->rank(), plain->rank());
+        chunked = chunked->next();
+        plain = plain->next();
+    }
+}
+
+TEST(RankingElementTest, SequencesShareOneGenerator) {
+    // Carries a large table and counts how often it is copied.
+    struct TableGenerator {
+        std::shared_ptr<int> copies;
+        std::array<int, 1024> table{};
+
+        TableGenerator(std::shared_ptr<int> counter) : copies(std::move(counter)) {}
+        TableGenerator(const TableGenerator& other) : copies(other.copies), table(other.table) {
+            ++*copies;
+        }
+        TableGenerator(TableGenerator&&) = default;
+
+        std::pair<int, Rank> operator()(size_t i) const {
+            return {table[i % table.size()] + static_cast<int>(i), Rank::from_value(i)};
+        }
+    };
+
+    auto copies = std::make_shared<int>(0);
+    auto plain = make_infinite_sequence<int>(TableGenerator(copies));
+    auto chunked = make_chunked_sequence<int>(TableGenerator(copies), 3);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(plain->value(), i);
+        EXPECT_EQ(chunked->value(), i);
+        plain = plain->next();
+        chunked = chunked->next();
+    }
+    EXPECT_EQ(*copies, 0);
+}
+
+TEST(RankingElementTest, BatchedSequenceLinksEachBatch) {
+    std::vector<size_t> calls;
+    auto batched = make_batched_sequence<int>(
+        [&calls](size_t first, std::vector<std::pair<int, Rank>>& batch) {
+            calls.push_back(first);
+            // Batches of growing size; the sequence ends at index 10.
+            for (size_t i = first; i < std::min<size_t>(first + calls.size(), 10); ++i) {
+                batch.emplace_back(static_cast<int>(i), Rank::from_value(i));
+            }
+        });
+
+    EXPECT_EQ(calls, std::vector<size_t>{0});
+    EXPECT_EQ(batched->value(), 0);
+    EXPECT_FALSE(batched->next_is_forced());
+
+    std::vector<int> values;
+    for (auto current = batched; current; current = current->next()) {
+        values.push_back(current->value());
+    }
+    EXPECT_EQ(values, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    EXPECT_EQ(calls, (std::vector<size_t>{0, 1, 3, 6, 10}));
+
+    auto empty = make_batched_sequence<int>([](size_t, std::vector<std::pair<int, Rank>>&) {});
+    EXPECT_EQ(empty, nullptr);
+}
+
 // ============================================================================
 // Complex Type Tests
 // ============================================================================
@@ -504,3 +604,110 @@ TEST(RankingElementTest, RecursiveLazyConstruction) {
     EXPECT_EQ(seq->next()->value(), 2);
     EXPECT_EQ(seq->next()->next()->value(), 3);
 }
+
+// ============================================================================
+// Chain Teardown Tests
+// ============================================================================
+
+namespace {
+
+/// Run @p task on a thread with a 256 KiB stack and wait for it to finish.
+void run_with_small_stack(std::function<void()> task) {
+#if defined(__unix__) || defined(__APPLE__)
+    pthread_attr_t attributes;
+    ASSERT_EQ(pthread_attr_init(&attributes), 0);
+    ASSERT_EQ(pthread_attr_setstacksize(&attributes, 256 * 1024), 0);
+    pthread_t thread;
+    auto trampoline = [](void* argument) -> void* {
+        (*static_cast<std::function<void()>*>(argument))();
+        return nullptr;
+    };
+    ASSERT_EQ(pthread_create(&thread, &attributes, trampoline, &task), 0);
+    pthread_attr_destroy(&attributes);
+    pthread_join(thread, nullptr);
+#else
+    std::thread(std::move(task)).join();
+#endif
+}
+
+}  // namespace
+
+TEST(RankingElementTest, TeardownOfTenMillionElementChainUsesBoundedStack) {
+    constexpr int length = 10'000'000;
+    bool finished = false;
+    run_with_small_stack([&finished]() {
+        auto head = make_terminal(length - 1, Rank::from_value(length - 1));
+        for (int i = length - 2; i >= 0; --i) {
+            head = make_element(i, Rank::from_value(static_cast<uint64_t>(i)), std::move(head));
+        }
+        EXPECT_EQ(head->value(), 0);
+        head.reset();
+        finished = true;
+    });
+    EXPECT_TRUE(finished);
+}
+
+TEST(RankingElementTest, TeardownOfLazilyForcedChainUsesBoundedStack) {
+    bool finished = false;
+    run_with_small_stack([&finished]() {
+        auto head = make_infinite_sequence<int>([](size_t i) {
+            return std::make_pair(static_cast<int>(i), Rank::from_value(i));
+        });
+        auto current = head;
+        for (int i = 0; i < 1'000'000; ++i) {
+            current = current->next();
+        }
+        EXPECT_EQ(current->value(), 1'000'000);
+        current.reset();
+        head.reset();
+        finished = true;
+    });
+    EXPECT_TRUE(finished);
+}
+
+TEST(RankingElementTest, TeardownKeepsSharedSuffixIntact) {
+    auto head = make_terminal(9, Rank::from_value(9));
+    std::shared_ptr<RankingElement<int>> suffix;
+    for (int i = 8; i >= 0; --i) {
+        head = make_element(i, Rank::from_value(static_cast<uint64_t>(i)), std::move(head));
+        if (i == 5) {
+            suffix = head;
+        }
+    }
+
+    head.reset();
+
+    std::vector<int> values;
+    for (auto elem = suffix; elem; elem = elem->next()) {
+        values.push_back(elem->value());
+    }
+    EXPECT_EQ(values, (std::vector<int>{5, 6, 7, 8, 9}));
+}
+
+TEST(RankingElementTest, TeardownRacesWithReaderReleasingTheChain) {
+    // One thread walks the chain and drops each node as it moves on while
+    // the owner destroys the chain; whichever releases a node last unlinks
+    // it, which must not race with the other thread's earlier reads.
+    for (int round = 0; round < 20; ++round) {
+        auto head = make_terminal(9'999, Rank::from_value(9'999));
+        for (int i = 9'998; i >= 0; --i) {
+            head = make_element(i, Rank::from_value(static_cast<uint64_t>(i)), std::move(head));
+        }
+
+        std::atomic<bool> started{false};
+        long sum = 0;
+        std::thread reader([current = head, &started, &sum]() mutable {
+            started.store(true);
+            while (current) {
+                sum += current->value();
+                current = current->next();
+            }
+        });
+        while (!started.load()) {
+            std::this_thread::yield();
+        }
+        head.reset();
+        reader.join();
+        EXPECT_EQ(sum, 9'999L * 10'000L / 2);
+    }
+}
@@ -16,7 +16,9 @@
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <ranges>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 using namespace ranked_belief;
@@ -520,3 +522,90 @@ TEST_F(RankingFunctionTest, InfinityRankElement) {
     ASSERT_TRUE(first.has_value());
     EXPECT_EQ(first->second, Rank::infinity());
 }
+
+// ============================================================================
+// Rank Offset Tests
+// ============================================================================
+
+TEST_F(RankingFunctionTest, ShiftedAppliesOffsetOnRead) {
+    RankingFunction<int> rf(create_simple_sequence());
+    auto shifted = rf.shifted(10);
+
+    EXPECT_EQ(shifted.raw_head(), rf.raw_head());  // No nodes were built
+    EXPECT_EQ(shifted.rank_offset(), 10);
+    EXPECT_EQ(shifted.first()->second, Rank::from_value(10));
+
+    std::vector<Rank> ranks;
+    for (auto [value, rank] : shifted) {
+        ranks.push_back(rank);
+    }
+    EXPECT_EQ(ranks, (std::vector<Rank>{Rank::from_value(10), Rank::from_value(11), Rank::from_value(12)}));
+    EXPECT_NE(shifted, rf);
+}
+
+TEST_F(RankingFunctionTest, NestedShiftsComposeByAddition) {
+    RankingFunction<int> rf(create_simple_sequence());
+    auto shifted = rf.shifted(4).shifted(6).shifted(-3);
+
+    EXPECT_EQ(shifted.rank_offset(), 7);
+    EXPECT_EQ(shifted.raw_head(), rf.raw_head());
+    EXPECT_EQ(shifted.shifted(-7), rf);
+}
+
+TEST_F(RankingFunctionTest, HeadAppliesOffsetToNodes) {
+    RankingFunction<int> rf(create_simple_sequence());
+    auto shifted = rf.shifted(5);
+
+    auto head = shifted.head();
+    ASSERT_NE(head, nullptr);
+    EXPECT_NE(head, rf.raw_head());
+    EXPECT_EQ(head->rank(), Rank::from_value(5));
+    EXPECT_EQ(head->next()->next()->rank(), Rank::from_value(7));
+    EXPECT_EQ(rf.head(), rf.raw_head());
+}
+
+TEST_F(RankingFunctionTest, NegativeOffsetBelowZeroThrowsOnRead) {
+    RankingFunction<int> rf(create_simple_sequence());
+    auto shifted = rf.shifted(-1);
+
+    EXPECT_THROW((void)shifted.first(), std::underflow_error);
+    EXPECT_THROW((void)rf.shifted(detail::kMaxRankOffset + 1), std::out_of_range);
+}
+
+TEST_F(RankingFunctionTest, SaturatingOffsetIsBakedBeforeNegativeShift) {
+    auto near_max = Rank::max_finite_value() - 1;
+    auto rf = make_singleton_ranking(1, Rank::from_value(near_max - 1));
+
+    auto saturated = rf.shifted(5, RankOverflow::Saturate);
+    EXPECT_EQ(saturated.first()->second.value(), Rank::max_finite_value());
+
+    // Saturate-then-subtract differs from one exact addition, so the shift
+    // is applied to copied nodes first.
+    auto lowered = saturated.shifted(-10);
+    EXPECT_NE(lowered.raw_head(), rf.raw_head());
+    EXPECT_EQ(lowered.first()->second.value(), Rank::max_finite_value() - 10);
+}
+
+TEST_F(RankingFunctionTest, BakedShiftKeepsChunkSize) {
+    auto rf = RankingFunction<int>(make_singleton_ranking(1, Rank::from_value(3)).raw_head(),
+                                   Deduplication::Enabled, 4);
+
+    auto lowered = rf.shifted(5, RankOverflow::Saturate).shifted(-2);
+    EXPECT_NE(lowered.raw_head(), rf.raw_head());
+    EXPECT_EQ(lowered.chunk_size(), 4u);
+}
+
+TEST_F(RankingFunctionTest, PromisePolicySelectsInlineNamespace) {
+#ifdef RANKED_BELIEF_SINGLE_THREADED
+    static_assert(std::is_same_v<RankingFunction<int>, ranked_belief::single_threaded::RankingFunction<int>>);
+#else
+    static_assert(std::is_same_v<RankingFunction<int>, ranked_belief::thread_safe::RankingFunction<int>>);
+#endif
+    SUCCEED();
+}
+
+TEST_F(RankingFunctionTest, InfinityAbsorbsOffset) {
+    auto rf = make_singleton_ranking(999, Rank::infinity()).shifted(3);
+
+    EXPECT_EQ(rf.first()->second, Rank::infinity());
+}
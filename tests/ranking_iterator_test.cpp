@@ -16,8 +16,11 @@
 #include "ranked_belief/ranking_element.hpp"
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <atomic>
+#include <functional>
 #include <ranges>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace ranked_belief;
@@ -533,3 +536,46 @@ TEST_F(RankingIteratorTest, MixedDeduplicationBehavior) {
     
     EXPECT_EQ(values, (std::vector<int>{1, 2, 3}));
 }
+
+// ============================================================================
+// Concurrent Iteration
+// ============================================================================
+
+TEST_F(RankingIteratorTest, ConcurrentIterationSharesOneForcedPrefix) {
+    constexpr int num_threads = 8;
+    constexpr std::size_t prefix = 500;
+
+    std::vector<std::atomic<int>> evaluations(prefix + 8);
+    std::function<std::shared_ptr<RankingElement<int>>(int)> build;
+    build = [&build, &evaluations](int i) {
+        return make_lazy_element(i, Rank::from_value(static_cast<uint64_t>(i)), [&build, &evaluations, i]() {
+            evaluations[static_cast<std::size_t>(i)].fetch_add(1);
+            return build(i + 1);
+        });
+    };
+    auto head = build(0);
+
+    std::vector<std::thread> threads;
+    std::vector<std::vector<int>> seen(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&head, &seen, t]() {
+            RankingIterator<int> it(head, Deduplication::Enabled);
+            for (std::size_t i = 0; i < prefix; ++i, ++it) {
+                seen[t].push_back((*it).first);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (int t = 0; t < num_threads; ++t) {
+        ASSERT_EQ(seen[t].size(), prefix);
+        EXPECT_EQ(seen[t], seen[0]);
+    }
+    EXPECT_EQ(seen[0].back(), static_cast<int>(prefix) - 1);
+    // Each lazy link was forced exactly once across all threads.
+    for (std::size_t i = 0; i + 1 < prefix; ++i) {
+        EXPECT_EQ(evaluations[i].load(), 1) << "link " << i;
+    }
+}
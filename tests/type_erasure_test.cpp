@@ -2,10 +2,14 @@
 
 #include "ranked_belief/constructors.hpp"
 #include "ranked_belief/type_erasure.hpp"
+#include "ranked_belief/detail/any_equality_registry.hpp"
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace ranked_belief;
@@ -171,5 +175,156 @@ TEST(TypeErasureTest, LazyOperationsDeferEvaluation)
 	EXPECT_EQ(forced, 4u);
 }
 
+namespace
+{
+template<int N>
+struct Tagged
+{
+	int value;
+	friend bool operator==(const Tagged&, const Tagged&) = default;
+};
+}
+
+TEST(TypeErasureTest, AnyEqualityLookupsRunDuringRegistration)
+{
+	const std::any one{1};
+	const std::any tagged_a{Tagged<0>{7}};
+	const std::any tagged_b{Tagged<0>{7}};
+	EXPECT_FALSE(detail::any_values_equal(tagged_a, tagged_b));  // not registered yet
+
+	std::atomic<bool> stop{false};
+	std::atomic<bool> mismatch{false};
+	std::vector<std::thread> readers;
+	for (int t = 0; t < 4; ++t) {
+		readers.emplace_back([&] {
+			while (!stop.load()) {
+				if (!detail::any_values_equal(one, std::any{1}) ||
+					detail::any_values_equal(one, std::any{2})) {
+					mismatch = true;
+				}
+			}
+		});
+	}
+	detail::register_any_equality<Tagged<0>>();
+	detail::register_any_equality<Tagged<1>>();
+	detail::register_any_equality<Tagged<2>>();
+	stop = true;
+	for (auto& reader : readers) {
+		reader.join();
+	}
+
+	EXPECT_FALSE(mismatch.load());
+	EXPECT_TRUE(detail::any_values_equal(tagged_a, tagged_b));
+	EXPECT_FALSE(detail::any_values_equal(tagged_a, std::any{Tagged<0>{8}}));
+}
+
+namespace
+{
+struct Counted
+{
+	static inline std::size_t copies = 0;
+
+	explicit Counted(int v) : value(v) {}
+	Counted(const Counted& other) : value(other.value) { ++copies; }
+	Counted(Counted&&) noexcept = default;
+	Counted& operator=(const Counted&) = default;
+	Counted& operator=(Counted&&) noexcept = default;
+
+	friend bool operator==(const Counted& lhs, const Counted& rhs) { return lhs.value == rhs.value; }
+
+	int value;
+	std::string padding = std::string(64, 'x');
+};
+}
+
+TEST(TypeErasureTest, CellCallbacksBorrowValues)
+{
+	std::vector<std::pair<Counted, Rank>> pairs;
+	for (int i = 0; i < 4; ++i) {
+		pairs.emplace_back(Counted{i}, Rank::from_value(static_cast<std::uint64_t>(i)));
+	}
+	RankingFunctionAny erased{from_list<Counted>(std::move(pairs), Deduplication::Disabled)};
+	(void)erased.take_n_cells(4);  // force the values once
+
+	Counted::copies = 0;
+	auto labels = erased.map([](const ValueCell& cell) {
+		return ValueCell{std::to_string(cell.get<Counted>().value)};
+	});
+	auto nonzero = labels.filter([](const ValueCell& cell) {
+		return cell.get<std::string>() != "0";
+	});
+	auto values = nonzero.take_n_cells(4);
+	ASSERT_EQ(values.size(), 3u);
+	EXPECT_EQ(values[0].first.get<std::string>(), "1");
+	EXPECT_EQ(values[2].second, Rank::from_value(3));
+	EXPECT_EQ(Counted::copies, 0u);
+
+	// Materialising copies each value exactly once.
+	auto cells = erased.take_n_cells(4);
+	EXPECT_EQ(Counted::copies, 4u);
+	auto first = erased.first_cell();
+	EXPECT_EQ(Counted::copies, 5u);
+	EXPECT_EQ(first, cells[0].first);
+
+	// Cell rankings deduplicate with the payload's own equality.
+	auto collapsed = erased.map([](const ValueCell& cell) {
+		return ValueCell{Counted{cell.get<Counted>().value / 2}};
+	}, Deduplication::Enabled);
+	EXPECT_EQ(collapsed.take_n_cells(10).size(), 2u);
+	EXPECT_EQ(std::any_cast<Counted>(collapsed.first_value()).value, 0);
+}
 
+TEST(TypeErasureTest, CellRankingsInteroperate)
+{
+	RankingFunctionAny values{from_values_sequential<int>({1, 2}, Rank::zero(), Deduplication::Enabled)};
 
+	using CellFn = std::function<RankingFunctionAny(const ValueCell&)>;
+	auto function_rf = from_list<CellFn>({
+		{CellFn{[](const ValueCell& value) {
+			return RankingFunctionAny{singleton(value.get<int>() * 10)};
+		}}, Rank::zero()}
+	}, Deduplication::Disabled);
+
+	auto applied = values.merge_apply(RankingFunctionAny{function_rf});
+	auto results = applied.take_n_cells(2);
+	ASSERT_EQ(results.size(), 2u);
+	EXPECT_EQ(results[0].first.get<int>(), 10);
+	EXPECT_EQ(results[1].first.get<int>(), 20);
+	EXPECT_EQ(results[1].second.value(), 1u);
+
+	// Values produced through the std::any API are unwrapped when borrowed.
+	auto doubled = values.map([](const std::any& value) {
+		return std::any{std::any_cast<int>(value) * 2};
+	});
+	auto seen = doubled.filter([](const ValueCell& cell) { return cell.get<int>() > 2; });
+	EXPECT_EQ(std::any_cast<int>(seen.first_value()), 4);
+
+	auto merged = applied.merge(values, Deduplication::Disabled);
+	EXPECT_EQ(merged.take_n_cells(10).size(), 4u);
+	auto observed = merged.observe_value(ValueCell{20});
+	ASSERT_EQ(observed.take_n_cells(10).size(), 1u);
+	EXPECT_EQ(observed.first_rank()->value(), 0u);
+}
+
+TEST(TypeErasureTest, RealisedDeferralsKeepTypedFastPath)
+{
+	std::size_t realised = 0;
+	auto deferred = RankingFunctionAny::defer([&realised]() {
+		++realised;
+		return RankingFunctionAny{from_list<int>({{2, Rank::from_value(1)}})};
+	});
+	RankingFunctionAny ints{from_list<int>({{1, Rank::zero()}})};
+
+	EXPECT_EQ(realised, 0u);
+
+	auto typed = deferred.cast<int>();
+	EXPECT_EQ(realised, 1u);
+	EXPECT_EQ(typed.first()->first, 2);
+
+	auto merged = ints.merge(deferred, Deduplication::Disabled).cast<int>();
+	auto values = take_n(merged, 3);
+	ASSERT_EQ(values.size(), 2u);
+	EXPECT_EQ(values[0].first, 1);
+	EXPECT_EQ(values[1].first, 2);
+	EXPECT_EQ(realised, 1u);
+}
@@ -0,0 +1,159 @@
+/**
+ * @file value_cell_test.cpp
+ * @brief Tests for ValueCell, the erased value of RankingFunctionAny.
+ *
+ * Tests cover:
+ * - Inline storage for scalars and strings, shared blocks for the rest
+ * - Borrowing without copies, and copying a borrow exactly once
+ * - Cached equality and hashing
+ * - Conversion from and to std::any
+ */
+
+#include "ranked_belief/value_cell.hpp"
+
+#include <gtest/gtest.h>
+
+#include <any>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+using namespace ranked_belief;
+
+namespace {
+
+/// Large payload that counts how often it is copied.
+struct Payload {
+    static inline std::size_t copies = 0;
+
+    explicit Payload(int id) : id(id) {}
+    Payload(const Payload& other) : id(other.id), data(other.data) { ++copies; }
+    Payload(Payload&&) noexcept = default;
+    Payload& operator=(const Payload&) = default;
+    Payload& operator=(Payload&&) noexcept = default;
+
+    friend bool operator==(const Payload& lhs, const Payload& rhs) { return lhs.id == rhs.id; }
+
+    int id;
+    std::array<double, 16> data{};
+};
+
+struct Opaque {
+    int id;
+};
+
+}  // namespace
+
+TEST(ValueCellTest, ScalarsAndStringsAreStoredInline) {
+    const ValueCell number{42};
+    const ValueCell text{std::string("inline")};
+
+    EXPECT_EQ(number.storage(), ValueCell::Storage::Inline);
+    EXPECT_EQ(text.storage(), ValueCell::Storage::Inline);
+    EXPECT_EQ(number.type(), typeid(int));
+    EXPECT_EQ(number.get<int>(), 42);
+    EXPECT_EQ(text.get<std::string>(), "inline");
+    EXPECT_EQ(number.get_if<long>(), nullptr);
+    EXPECT_THROW((void)number.get<double>(), std::bad_any_cast);
+
+    ValueCell copy = text;
+    EXPECT_EQ(copy.get<std::string>(), "inline");
+    EXPECT_NE(&copy.get<std::string>(), &text.get<std::string>());
+
+    const ValueCell empty;
+    EXPECT_FALSE(empty.has_value());
+    EXPECT_EQ(empty.type(), typeid(void));
+}
+
+TEST(ValueCellTest, LargePayloadsAreSharedNotCopied) {
+    Payload::copies = 0;
+    ValueCell cell{Payload{7}};
+    EXPECT_EQ(cell.storage(), ValueCell::Storage::Shared);
+    EXPECT_EQ(Payload::copies, 0u);
+
+    ValueCell copy = cell;
+    ValueCell assigned;
+    assigned = copy;
+    EXPECT_EQ(Payload::copies, 0u);
+    EXPECT_EQ(&copy.get<Payload>(), &cell.get<Payload>());
+    EXPECT_EQ(&assigned.get<Payload>(), &cell.get<Payload>());
+
+    // The block lives as long as any cell refers to it.
+    cell = ValueCell{1};
+    copy = ValueCell{};
+    EXPECT_EQ(assigned.get<Payload>().id, 7);
+
+    ValueCell moved = std::move(assigned);
+    EXPECT_FALSE(assigned.has_value());
+    EXPECT_EQ(moved.get<Payload>().id, 7);
+    EXPECT_EQ(Payload::copies, 0u);
+}
+
+TEST(ValueCellTest, BorrowedValuesAreCopiedOnceWhenKept) {
+    Payload::copies = 0;
+    const Payload payload{3};
+    const ValueCell borrowed = ValueCell::borrow(payload);
+    EXPECT_EQ(borrowed.storage(), ValueCell::Storage::Borrowed);
+    EXPECT_EQ(&borrowed.get<Payload>(), &payload);
+    EXPECT_EQ(Payload::copies, 0u);
+
+    const ValueCell kept = borrowed;
+    EXPECT_EQ(kept.storage(), ValueCell::Storage::Shared);
+    EXPECT_EQ(Payload::copies, 1u);
+    const ValueCell shared = kept;
+    EXPECT_EQ(Payload::copies, 1u);
+
+    // Borrowing a cell borrows its payload.
+    const ValueCell view = ValueCell::borrow(kept);
+    EXPECT_EQ(view.storage(), ValueCell::Storage::Borrowed);
+    EXPECT_EQ(&view.get<Payload>(), &kept.get<Payload>());
+
+    const int number = 5;
+    const ValueCell borrowed_number = ValueCell::borrow(number);
+    const ValueCell small = borrowed_number;
+    EXPECT_EQ(small.storage(), ValueCell::Storage::Inline);
+    EXPECT_EQ(small.get<int>(), 5);
+}
+
+TEST(ValueCellTest, EqualityAndHashUseThePayloadType) {
+    EXPECT_EQ(ValueCell{1}, ValueCell{1});
+    EXPECT_NE(ValueCell{1}, ValueCell{2});
+    EXPECT_NE(ValueCell{1}, ValueCell{1L});
+    EXPECT_EQ(ValueCell{Payload{4}}, ValueCell::borrow(Payload{4}));
+    EXPECT_EQ(ValueCell{}, ValueCell{});
+    EXPECT_NE(ValueCell{}, ValueCell{0});
+
+    // Types without operator== never compare equal.
+    const ValueCell opaque{Opaque{1}};
+    EXPECT_NE(opaque, opaque);
+
+    EXPECT_EQ(ValueCell{std::string("key")}.hash(), std::hash<std::string>{}("key"));
+    std::unordered_set<ValueCell> seen;
+    seen.insert(ValueCell{std::string("a")});
+    seen.insert(ValueCell{std::string("a")});
+    seen.insert(ValueCell{1});
+    EXPECT_EQ(seen.size(), 2u);
+}
+
+TEST(ValueCellTest, ConvertsFromAndToAny) {
+    const ValueCell unwrapped{std::any{5}};
+    EXPECT_EQ(unwrapped.type(), typeid(int));
+    EXPECT_EQ(unwrapped, ValueCell{5});
+
+    const std::any text{std::string("text")};
+    const ValueCell borrowed = ValueCell::borrow(text);
+    EXPECT_EQ(borrowed.storage(), ValueCell::Storage::Borrowed);
+    EXPECT_EQ(&borrowed.get<std::string>(), std::any_cast<std::string>(&text));
+
+    // Payloads the equality registry does not know stay boxed.
+    const ValueCell boxed{std::any{Payload{9}}};
+    EXPECT_EQ(boxed.type(), typeid(std::any));
+    EXPECT_EQ(boxed.to_any().type(), typeid(Payload));
+    EXPECT_FALSE(ValueCell{std::any{}}.has_value());
+
+    EXPECT_EQ(std::any_cast<int>(ValueCell{8}.to_any()), 8);
+    EXPECT_FALSE(ValueCell{}.to_any().has_value());
+}